@@ -0,0 +1,108 @@
+﻿#include "BenchmarkReport.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+/// <summary>
+/// JSONの文字列として書き出せるようエスケープする
+/// </summary>
+static std::string EscapeJson(const std::string& _text)
+{
+	std::string result;
+	result.reserve(_text.size() + 2);
+	result += '"';
+	for (char c : _text)
+	{
+		if (c == '"' || c == '\\') {
+			result += '\\';
+			result += c;
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			result += escaped;
+		} else {
+			result += c;
+		}
+	}
+	result += '"';
+	return result;
+}
+
+/// <summary>
+/// JSONの数値として書き出す（整数値は小数点なし、NaN・無限大はnull）
+/// </summary>
+static std::string FormatJsonNumber(double _value)
+{
+	if (!std::isfinite(_value)) {
+		return "null";
+	}
+
+	char text[64];
+	if (_value == std::floor(_value) && std::fabs(_value) < 1.0e15) {
+		snprintf(text, sizeof(text), "%.0f", _value);
+	} else {
+		snprintf(text, sizeof(text), "%.6g", _value);
+	}
+	return text;
+}
+
+void BenchmarkReport::SetInfo(const std::string& _key, const std::string& _value)
+{
+	infos.emplace_back(_key, _value);
+}
+
+void BenchmarkReport::BeginScenario(const std::string& _name)
+{
+	scenarios.push_back({ _name, {} });
+}
+
+void BenchmarkReport::AddValue(const std::string& _key, double _value)
+{
+	assert(!scenarios.empty());
+	scenarios.back().values.emplace_back(_key, _value);
+}
+
+void BenchmarkReport::AddCheck(const std::string& _key, bool _isPassed)
+{
+	AddValue(_key, _isPassed ? 1.0 : 0.0);
+	if (!_isPassed) {
+		failedChecks.push_back(scenarios.back().name + "." + _key);
+	}
+}
+
+std::string BenchmarkReport::ToJson() const
+{
+	std::string json = "{\n";
+	for (const auto& info : infos)
+	{
+		json += "  " + EscapeJson(info.first) + ": " + EscapeJson(info.second) + ",\n";
+	}
+
+	json += "  \"scenarios\": [";
+	for (size_t i = 0; i < scenarios.size(); i++)
+	{
+		const SCENARIO_RESULT& scenario = scenarios[i];
+		json += i == 0 ? "\n" : ",\n";
+		json += "    {\n      \"name\": " + EscapeJson(scenario.name);
+		for (const auto& value : scenario.values)
+		{
+			json += ",\n      " + EscapeJson(value.first) + ": " + FormatJsonNumber(value.second);
+		}
+		json += "\n    }";
+	}
+	json += scenarios.empty() ? "]\n}\n" : "\n  ]\n}\n";
+
+	return json;
+}
+
+bool BenchmarkReport::WriteJson(const std::string& _filename) const
+{
+	std::ofstream file(_filename, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	file << ToJson();
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,107 @@
+﻿#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <utility>
+
+/// <summary>
+/// ベンチマーク結果をシナリオごとにまとめ、JSONで書き出す
+/// </summary>
+class BenchmarkReport
+{
+private: // サブクラス
+
+	// シナリオ1つ分の結果
+	struct SCENARIO_RESULT
+	{
+		// シナリオ名
+		std::string name;
+		// 計測値（キーと値の組、追加した順に書き出す）
+		std::vector<std::pair<std::string, double>> values;
+	};
+
+public: // メンバ関数
+
+	/// <summary>
+	/// 全体の情報をセット（結果と同じ階層に書き出す）
+	/// </summary>
+	/// <param name="_key">キー</param>
+	/// <param name="_value">値</param>
+	void SetInfo(const std::string& _key, const std::string& _value);
+
+	/// <summary>
+	/// シナリオを開始（以降のAddValueはこのシナリオに追加される）
+	/// </summary>
+	/// <param name="_name">シナリオ名</param>
+	void BeginScenario(const std::string& _name);
+
+	/// <summary>
+	/// 計測値を追加
+	/// </summary>
+	/// <param name="_key">キー</param>
+	/// <param name="_value">値</param>
+	void AddValue(const std::string& _key, double _value);
+
+	/// <summary>
+	/// 確認結果を追加（1か0で書き出し、失敗したものは別に覚えておく）
+	/// </summary>
+	/// <param name="_key">キー</param>
+	/// <param name="_isPassed">満たしているか</param>
+	void AddCheck(const std::string& _key, bool _isPassed);
+
+	/// <summary>
+	/// 失敗した確認の一覧を取得
+	/// </summary>
+	/// <returns>「シナリオ名.キー」の配列</returns>
+	const std::vector<std::string>& GetFailedChecks() const { return failedChecks; }
+
+	/// <summary>
+	/// JSON文字列を作る
+	/// </summary>
+	/// <returns>JSON文字列</returns>
+	std::string ToJson() const;
+
+	/// <summary>
+	/// JSONをファイルへ書き出す
+	/// </summary>
+	/// <param name="_filename">ファイル名</param>
+	/// <returns>成功か</returns>
+	bool WriteJson(const std::string& _filename) const;
+
+private:
+
+	//全体の情報
+	std::vector<std::pair<std::string, std::string>> infos;
+	//シナリオごとの結果
+	std::vector<SCENARIO_RESULT> scenarios;
+	//失敗した確認
+	std::vector<std::string> failedChecks;
+};
+
+/// <summary>
+/// 経過時間の計測
+/// </summary>
+class BenchmarkTimer
+{
+public:
+	BenchmarkTimer() : start(std::chrono::steady_clock::now()) {}
+
+	/// <summary>
+	/// 計測を始め直す
+	/// </summary>
+	void Reset() { start = std::chrono::steady_clock::now(); }
+
+	/// <summary>
+	/// 経過時間をナノ秒で取得
+	/// </summary>
+	/// <returns>経過時間（ナノ秒）</returns>
+	double GetNanoseconds() const
+	{
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+private:
+	//計測開始時刻
+	std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,1263 @@
+﻿#include "CollisionScenarios.h"
+#include "CollisionManager.h"
+#include "CollisionAttribute.h"
+#include "Collision.h"
+#include "SphereCollider.h"
+#include "ThreadPool.h"
+#include "MappedFile.h"
+#include "QuaternionKernel.h"
+#include "TransformKernel.h"
+#include "TransformSystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace
+{
+	// 地形のメッシュコライダーの当たり判定属性
+	const unsigned short meshAttribute = COLLISION_ATTR_LANDSHAPE;
+	// 地形のハイトフィールドコライダーの当たり判定属性（メッシュと分けて計測する）
+	const unsigned short heightfieldAttribute = 0b1 << 3;
+	// 球の当たり判定属性
+	const unsigned short sphereAttribute = COLLISION_ATTR_ALLIES;
+	// レイの始点の地面からの高さ
+	const float rayStartHeight = 100.0f;
+	// 距離の一致を判定する許容誤差
+	const float distanceEpsilon = 1.0e-3f;
+	// 一括レイキャストの時間を1本ずつと比べるときの許容倍率
+	const double batchTimeMargin = 1.1;
+	// 地形へのレイキャストを計測する回数（最も速い回を使う）
+	const int raycastRepeatNum = 3;
+
+	/// <summary>
+	/// リトルエンディアンの整数を読む
+	/// </summary>
+	template <class T>
+	T ReadLittleEndian(const char* _data)
+	{
+		T value = 0;
+		for (size_t i = 0; i < sizeof(T); i++)
+		{
+			value |= static_cast<T>(static_cast<unsigned char>(_data[i])) << (i * 8);
+		}
+		return value;
+	}
+}
+
+bool CollisionScenarios::LoadTerrain(const std::string& _filename)
+{
+	MappedFile file;
+	if (!file.Open(_filename)) {
+		return false;
+	}
+
+	//ファイルヘッダー(14byte)と情報ヘッダー(40byte)から必要な値だけ読む
+	const char* data = file.GetData();
+	const size_t headerSize = 54;
+	if (file.GetSize() < headerSize || data[0] != 'B' || data[1] != 'M') {
+		return false;
+	}
+	const uint32_t offBits = ReadLittleEndian<uint32_t>(data + 10);
+	const int width = static_cast<int>(ReadLittleEndian<uint32_t>(data + 18));
+	const int depth = static_cast<int>(ReadLittleEndian<uint32_t>(data + 22));
+	const uint16_t bitCount = ReadLittleEndian<uint16_t>(data + 28);
+	if (bitCount != 24 || width < 2 || depth < 2) {
+		return false;
+	}
+
+	//行は4byte境界に揃えられている
+	const size_t rowSize = (static_cast<size_t>(width) * 3 + 3) & ~static_cast<size_t>(3);
+	if (file.GetSize() < offBits + rowSize * depth) {
+		return false;
+	}
+
+	//HeightMapと同じく、画素の先頭の成分の1/3を高さにする
+	terrainWidth = width;
+	terrainDepth = depth;
+	terrainHeights.resize(static_cast<size_t>(width) * depth);
+	for (int z = 0; z < depth; z++)
+	{
+		const unsigned char* row = reinterpret_cast<const unsigned char*>(data + offBits + rowSize * z);
+		for (int x = 0; x < width; x++)
+		{
+			terrainHeights[static_cast<size_t>(z) * width + x] = row[x * 3] / 3.0f;
+		}
+	}
+
+	//地形は原点が中心に来るよう平行移動する
+	terrainObject = std::make_unique<InterfaceObject3d>();
+	const XMMATRIX matWorld = XMMatrixTranslation(-width * 0.5f, 0.0f, -depth * 0.5f);
+	terrainObject->SetMatWorld(matWorld);
+
+	//セルを対角線で分割した三角形（ハイトフィールドと同じ分割）
+	std::vector<Mesh::VERTEX> vertices(terrainHeights.size());
+	for (int z = 0; z < depth; z++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			Mesh::VERTEX& vertex = vertices[static_cast<size_t>(z) * width + x];
+			vertex = {};
+			vertex.pos = { static_cast<float>(x), terrainHeights[static_cast<size_t>(z) * width + x], static_cast<float>(z) };
+		}
+	}
+	std::vector<unsigned long> indices;
+	indices.reserve(static_cast<size_t>(width - 1) * (depth - 1) * 6);
+	for (int z = 0; z < depth - 1; z++)
+	{
+		for (int x = 0; x < width - 1; x++)
+		{
+			const unsigned long i00 = z * width + x;
+			const unsigned long i10 = i00 + 1;
+			const unsigned long i01 = i00 + width;
+			const unsigned long i11 = i01 + 1;
+			const unsigned long cellIndices[] = { i00, i01, i10, i10, i01, i11 };
+			indices.insert(indices.end(), std::begin(cellIndices), std::end(cellIndices));
+		}
+	}
+
+	terrainTriangles.resize(indices.size() / 3);
+	for (size_t i = 0; i < terrainTriangles.size(); i++)
+	{
+		Triangle& triangle = terrainTriangles[i];
+		triangle.p0 = XMVector3Transform(XMLoadFloat3(&vertices[indices[i * 3 + 0]].pos), matWorld);
+		triangle.p1 = XMVector3Transform(XMLoadFloat3(&vertices[indices[i * 3 + 1]].pos), matWorld);
+		triangle.p2 = XMVector3Transform(XMLoadFloat3(&vertices[indices[i * 3 + 2]].pos), matWorld);
+		triangle.ComputeNormal();
+	}
+
+	terrainMesh = std::make_unique<MeshCollider>();
+	terrainMesh->SetObject(terrainObject.get());
+	terrainMesh->ConstructTriangles(vertices, indices);
+	terrainMesh->SetAttribute(meshAttribute);
+	terrainMesh->Update();
+
+	terrainHeightfield = std::make_unique<HeightfieldCollider>();
+	terrainHeightfield->SetObject(terrainObject.get());
+	terrainHeightfield->ConstructHeightfield(terrainHeights, width, depth);
+	terrainHeightfield->SetAttribute(heightfieldAttribute);
+	terrainHeightfield->Update();
+
+	return true;
+}
+
+void CollisionScenarios::RunBroadphase(BenchmarkReport* _report, int _colliderNum, int _frameNum, int _bruteForceFrameNum)
+{
+	CollisionManager* collisionManager = CollisionManager::GetInstance();
+
+	//1つあたり平均2つ程度と接触する密度で、立方体の中に球を並べる
+	const float density = 0.14f;
+	const float boxSize = std::cbrt(_colliderNum / density);
+	std::uniform_real_distribution<float> positionRange(0.0f, boxSize);
+	std::uniform_real_distribution<float> velocityRange(-0.1f, 0.1f);
+	std::uniform_real_distribution<float> radiusRange(0.5f, 1.0f);
+
+	std::vector<std::unique_ptr<CountingObject>> objects(_colliderNum);
+	std::vector<std::unique_ptr<SphereCollider>> colliders(_colliderNum);
+	std::vector<XMVECTOR> positions(_colliderNum);
+	std::vector<XMVECTOR> velocities(_colliderNum);
+	for (int i = 0; i < _colliderNum; i++)
+	{
+		positions[i] = { positionRange(random), positionRange(random), positionRange(random), 1 };
+		velocities[i] = { velocityRange(random), velocityRange(random), velocityRange(random), 0 };
+
+		objects[i] = std::make_unique<CountingObject>();
+		colliders[i] = std::make_unique<SphereCollider>(XMVECTOR{ 0,0,0,0 }, radiusRange(random));
+		colliders[i]->SetObject(objects[i].get());
+		colliders[i]->SetAttribute(sphereAttribute);
+		objects[i]->SetMatWorld(XMMatrixTranslation(positions[i].m128_f32[0], positions[i].m128_f32[1], positions[i].m128_f32[2]));
+		colliders[i]->Update();
+		collisionManager->AddCollider(colliders[i].get());
+	}
+
+	double updateTime = 0.0;
+	double checkTime = 0.0;
+	double bruteForceTime = 0.0;
+	long long touchingPairNum = 0;
+	int mismatchFrameNum = 0;
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		//箱の中で跳ね返りながら動かす
+		BenchmarkTimer timer;
+		for (int i = 0; i < _colliderNum; i++)
+		{
+			positions[i] += velocities[i];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (positions[i].m128_f32[axis] < 0.0f || positions[i].m128_f32[axis] > boxSize) {
+					velocities[i].m128_f32[axis] = -velocities[i].m128_f32[axis];
+				}
+			}
+			objects[i]->SetMatWorld(XMMatrixTranslation(positions[i].m128_f32[0], positions[i].m128_f32[1], positions[i].m128_f32[2]));
+			objects[i]->collisionCount = 0;
+			colliders[i]->Update();
+		}
+		updateTime += timer.GetNanoseconds();
+
+		timer.Reset();
+		collisionManager->CheckAllCollisions();
+		checkTime += timer.GetNanoseconds();
+
+		//衝突時コールバックは接触ペアの両方に呼ばれる
+		int checkPairNum = 0;
+		for (const std::unique_ptr<CountingObject>& object : objects)
+		{
+			checkPairNum += object->collisionCount;
+		}
+		checkPairNum /= 2;
+		touchingPairNum += checkPairNum;
+
+		if (frame >= _bruteForceFrameNum) { continue; }
+
+		//以前の全ペア総当たり
+		timer.Reset();
+		int bruteForcePairNum = 0;
+		for (int i = 0; i < _colliderNum; i++)
+		{
+			for (int j = i + 1; j < _colliderNum; j++)
+			{
+				if (Collision::CheckSphere2Sphere(*colliders[i], *colliders[j])) {
+					bruteForcePairNum++;
+				}
+			}
+		}
+		bruteForceTime += timer.GetNanoseconds();
+
+		if (bruteForcePairNum != checkPairNum) {
+			mismatchFrameNum++;
+		}
+	}
+
+	for (const std::unique_ptr<SphereCollider>& collider : colliders)
+	{
+		collisionManager->RemoveCollider(collider.get());
+	}
+	//削除したコライダーの接触キャッシュを破棄しておく
+	collisionManager->CheckAllCollisions();
+
+	const double pairNum = static_cast<double>(_colliderNum) * (_colliderNum - 1) / 2.0;
+	const int bruteForceFrameNum = (std::min)(_bruteForceFrameNum, _frameNum);
+	_report->BeginScenario("broadphase_spheres_" + std::to_string(_colliderNum));
+	_report->AddValue("colliders", _colliderNum);
+	_report->AddValue("frames", _frameNum);
+	_report->AddValue("update_ns_per_frame", updateTime / _frameNum);
+	_report->AddValue("check_all_ns_per_frame", checkTime / _frameNum);
+	_report->AddValue("check_all_pairs_per_sec", pairNum * _frameNum / (checkTime * 1.0e-9));
+	_report->AddValue("touching_pairs_per_frame", static_cast<double>(touchingPairNum) / _frameNum);
+	if (bruteForceFrameNum > 0) {
+		_report->AddValue("brute_force_frames", bruteForceFrameNum);
+		_report->AddValue("brute_force_ns_per_frame", bruteForceTime / bruteForceFrameNum);
+		_report->AddValue("brute_force_pairs_per_sec", pairNum * bruteForceFrameNum / (bruteForceTime * 1.0e-9));
+		_report->AddValue("mismatch_frames", mismatchFrameNum);
+	}
+}
+
+void CollisionScenarios::SelfRemovingObject::OnCollisionEnter(const CollisionInfo& /*_info*/)
+{
+	CountCallback();
+	enterCount++;
+	if (isRemoveOnEnter) {
+		RemoveSelf();
+	}
+}
+
+void CollisionScenarios::SelfRemovingObject::OnCollisionStay(const CollisionInfo& /*_info*/)
+{
+	CountCallback();
+	if (isRemoveOnStay) {
+		RemoveSelf();
+	}
+}
+
+void CollisionScenarios::SelfRemovingObject::OnCollisionExit(const CollisionInfo& _info)
+{
+	CountCallback();
+	exitCount++;
+	if (!_info.collider) {
+		removedExitCount++;
+	}
+}
+
+void CollisionScenarios::SelfRemovingObject::RemoveSelf()
+{
+	if (!collider) { return; }
+	CollisionManager::GetInstance()->RemoveCollider(collider.get());
+	collider.reset();
+}
+
+void CollisionScenarios::RunSelfRemoval(BenchmarkReport* _report)
+{
+	CollisionManager* collisionManager = CollisionManager::GetInstance();
+
+	//全て重なる5つの球を、通し番号が先頭と末尾のペアの両方で削除が起きる順に登録する
+	//（0と3は2フレーム目の接触継続、4は1フレーム目の接触開始で削除し、1と2だけが残る）
+	const int objectNum = 5;
+	const int frameNum = 4;
+	std::vector<std::unique_ptr<SelfRemovingObject>> objects(objectNum);
+	for (int i = 0; i < objectNum; i++)
+	{
+		objects[i] = std::make_unique<SelfRemovingObject>();
+		objects[i]->collider = std::make_unique<SphereCollider>(XMVECTOR{ 0,0,0,0 }, 1.0f);
+		objects[i]->collider->SetObject(objects[i].get());
+		objects[i]->collider->SetAttribute(sphereAttribute);
+		objects[i]->SetMatWorld(XMMatrixTranslation(0.1f * i, 0, 0));
+		objects[i]->collider->Update();
+		collisionManager->AddCollider(objects[i]->collider.get());
+	}
+	objects[0]->isRemoveOnStay = true;
+	objects[3]->isRemoveOnStay = true;
+	objects[4]->isRemoveOnEnter = true;
+
+	for (int frame = 0; frame < frameNum; frame++)
+	{
+		collisionManager->CheckAllCollisions();
+	}
+
+	//残った2つは互いにまだ接触しているので、接触開始が接触終了より1回だけ多い
+	//（0は削除される前に、1フレーム目で削除された4との接触終了を受け取っている）
+	const SelfRemovingObject& survivorA = *objects[1];
+	const SelfRemovingObject& survivorB = *objects[2];
+	int afterRemovalCount = 0;
+	for (const std::unique_ptr<SelfRemovingObject>& object : objects)
+	{
+		afterRemovalCount += object->afterRemovalCount;
+	}
+
+	for (const std::unique_ptr<SelfRemovingObject>& object : objects)
+	{
+		if (object->collider) {
+			collisionManager->RemoveCollider(object->collider.get());
+		}
+	}
+	//削除したコライダーの接触キャッシュを破棄しておく
+	collisionManager->CheckAllCollisions();
+
+	_report->BeginScenario("collision_self_removal");
+	_report->AddValue("frames", frameNum);
+	_report->AddValue("survivor_enters", survivorA.enterCount + survivorB.enterCount);
+	_report->AddValue("survivor_exits", survivorA.exitCount + survivorB.exitCount);
+	_report->AddValue("survivor_removed_exits", survivorA.removedExitCount + survivorB.removedExitCount);
+	_report->AddValue("callbacks_after_removal", afterRemovalCount);
+	_report->AddCheck("no_callback_after_removal", afterRemovalCount == 0);
+	_report->AddCheck("exit_per_enter",
+		survivorA.enterCount - survivorA.exitCount == 1 && survivorB.enterCount - survivorB.exitCount == 1);
+	_report->AddCheck("exit_from_removed",
+		survivorA.removedExitCount == survivorA.exitCount && survivorB.removedExitCount == survivorB.exitCount &&
+		survivorA.exitCount == 2 && survivorB.exitCount == 2 &&
+		objects[0]->removedExitCount == 1);
+}
+
+void CollisionScenarios::RunRayTriangleKernel(BenchmarkReport* _report, int _rayNum, int _triangleNum)
+{
+	const int triangleNum = (std::min)(_triangleNum, static_cast<int>(terrainTriangles.size())) / 4 * 4;
+	const std::vector<Ray> rays = CreateTerrainRays(_rayNum / 4 * 4, false);
+	const int rayNum = static_cast<int>(rays.size());
+
+	std::vector<Triangle4> triangle4s(triangleNum / 4);
+	for (size_t i = 0; i < triangle4s.size(); i++)
+	{
+		triangle4s[i].Set(&terrainTriangles[i * 4], 4);
+	}
+	std::vector<Ray4> ray4s(rayNum / 4);
+	for (size_t i = 0; i < ray4s.size(); i++)
+	{
+		ray4s[i].Set(&rays[i * 4], 4);
+	}
+
+	//1対1の判定（各レイで最も近い距離を求める）
+	std::vector<float> scalarDistances(rayNum, D3D12_FLOAT32_MAX);
+	BenchmarkTimer timer;
+	for (int r = 0; r < rayNum; r++)
+	{
+		for (int t = 0; t < triangleNum; t++)
+		{
+			float distance;
+			if (Collision::CheckRay2Triangle(rays[r], terrainTriangles[t], &distance) && distance < scalarDistances[r]) {
+				scalarDistances[r] = distance;
+			}
+		}
+	}
+	const double scalarTime = timer.GetNanoseconds();
+
+	//三角形4つのSoA
+	std::vector<float> triangle4Distances(rayNum, D3D12_FLOAT32_MAX);
+	timer.Reset();
+	for (int r = 0; r < rayNum; r++)
+	{
+		for (const Triangle4& triangle4 : triangle4s)
+		{
+			float distance;
+			if (Collision::CheckRay2Triangle4(rays[r], triangle4, triangle4Distances[r], &distance)) {
+				triangle4Distances[r] = distance;
+			}
+		}
+	}
+	const double triangle4Time = timer.GetNanoseconds();
+
+	//レイ4本のSoA
+	std::vector<float> ray4Distances(rayNum);
+	timer.Reset();
+	for (size_t r = 0; r < ray4s.size(); r++)
+	{
+		XMVECTOR distance = XMVectorReplicate(D3D12_FLOAT32_MAX);
+		for (int t = 0; t < triangleNum; t++)
+		{
+			Collision::CheckRay4Triangle(ray4s[r], terrainTriangles[t], &distance);
+		}
+		for (int lane = 0; lane < 4; lane++)
+		{
+			ray4Distances[r * 4 + lane] = distance.m128_f32[lane];
+		}
+	}
+	const double ray4Time = timer.GetNanoseconds();
+
+	//1対1の結果と比べる
+	int mismatchNum = 0;
+	int hitNum = 0;
+	for (int r = 0; r < rayNum; r++)
+	{
+		const bool isHit = scalarDistances[r] < D3D12_FLOAT32_MAX;
+		hitNum += isHit ? 1 : 0;
+		const float tolerance = distanceEpsilon * (std::max)(1.0f, scalarDistances[r]);
+		if (isHit != (triangle4Distances[r] < D3D12_FLOAT32_MAX) || isHit != (ray4Distances[r] < D3D12_FLOAT32_MAX) ||
+			(isHit && (std::fabs(triangle4Distances[r] - scalarDistances[r]) > tolerance || std::fabs(ray4Distances[r] - scalarDistances[r]) > tolerance)))
+		{
+			mismatchNum++;
+		}
+	}
+
+	const double testNum = static_cast<double>(rayNum) * triangleNum;
+	_report->BeginScenario("ray_triangle_kernel");
+	_report->AddValue("rays", rayNum);
+	_report->AddValue("triangles", triangleNum);
+	_report->AddValue("hits", hitNum);
+	_report->AddValue("scalar_triangles_per_sec", testNum / (scalarTime * 1.0e-9));
+	_report->AddValue("triangle4_triangles_per_sec", testNum / (triangle4Time * 1.0e-9));
+	_report->AddValue("ray4_triangles_per_sec", testNum / (ray4Time * 1.0e-9));
+	_report->AddValue("mismatches", mismatchNum);
+}
+
+void CollisionScenarios::RunTerrainRaycast(BenchmarkReport* _report, int _rayNum)
+{
+	CollisionManager* collisionManager = CollisionManager::GetInstance();
+	RegisterTerrain(true);
+
+	const int threadNum = ThreadPool::GetInstance()->GetThreadNum();
+	const char* const rayNames[] = { "down", "line_of_sight" };
+	for (int type = 0; type < 2; type++)
+	{
+		const std::vector<Ray> rays = CreateTerrainRays(_rayNum, type == 0);
+		const int rayNum = static_cast<int>(rays.size());
+
+		//計測のぶれを抑えるため、各方法を交互に数回計測して最も速い時間を使う
+		std::vector<RAYCAST_HIT> meshHits(rayNum);
+		std::vector<RAYCAST_HIT> heightfieldHits(rayNum);
+		std::vector<RAYCAST_HIT> batchHits;
+		std::vector<RAYCAST_HIT> parallelHits;
+		double meshTime = DBL_MAX;
+		double heightfieldTime = DBL_MAX;
+		double batchTime = DBL_MAX;
+		double parallelTime = DBL_MAX;
+		for (int repeat = 0; repeat < raycastRepeatNum; repeat++)
+		{
+			//1本ずつ（メッシュ・ハイトフィールド）
+			BenchmarkTimer timer;
+			for (int i = 0; i < rayNum; i++)
+			{
+				if (!collisionManager->Raycast(rays[i], meshAttribute, &meshHits[i])) {
+					meshHits[i].collider = nullptr;
+				}
+			}
+			meshTime = (std::min)(meshTime, timer.GetNanoseconds());
+
+			timer.Reset();
+			for (int i = 0; i < rayNum; i++)
+			{
+				if (!collisionManager->Raycast(rays[i], heightfieldAttribute, &heightfieldHits[i])) {
+					heightfieldHits[i].collider = nullptr;
+				}
+			}
+			heightfieldTime = (std::min)(heightfieldTime, timer.GetNanoseconds());
+
+			//一括（1スレッド・全スレッド）
+			timer.Reset();
+			collisionManager->RaycastBatch(rays, meshAttribute, batchHits, D3D12_FLOAT32_MAX, 1);
+			batchTime = (std::min)(batchTime, timer.GetNanoseconds());
+
+			timer.Reset();
+			collisionManager->RaycastBatch(rays, meshAttribute, parallelHits, D3D12_FLOAT32_MAX, threadNum);
+			parallelTime = (std::min)(parallelTime, timer.GetNanoseconds());
+		}
+
+		//メッシュの1本ずつの結果と比べる
+		//面に沿って進むレイは判定方法ごとに接触点が変わるので別に数える
+		int hitNum = 0;
+		int mismatchNum = 0;
+		int alongSurfaceNum = 0;
+		for (int i = 0; i < rayNum; i++)
+		{
+			const bool isHit = meshHits[i].collider != nullptr;
+			hitNum += isHit ? 1 : 0;
+			const RAYCAST_HIT* others[] = { &heightfieldHits[i], &batchHits[i], &parallelHits[i] };
+			for (const RAYCAST_HIT* other : others)
+			{
+				const float tolerance = distanceEpsilon * (std::max)(1.0f, meshHits[i].distance);
+				if (isHit != (other->collider != nullptr) ||
+					(isHit && std::fabs(other->distance - meshHits[i].distance) > tolerance))
+				{
+					if (isHit && other->collider && IsRayAlongTerrain(rays[i], meshHits[i].distance, other->distance)) {
+						alongSurfaceNum++;
+					} else {
+						mismatchNum++;
+					}
+					break;
+				}
+			}
+		}
+
+		_report->BeginScenario(std::string("terrain_raycast_") + rayNames[type]);
+		_report->AddValue("rays", rayNum);
+		_report->AddValue("triangles", static_cast<double>(terrainTriangles.size()));
+		_report->AddValue("hits", hitNum);
+		_report->AddValue("mesh_ns_per_ray", meshTime / rayNum);
+		_report->AddValue("heightfield_ns_per_ray", heightfieldTime / rayNum);
+		_report->AddValue("mesh_batch_ns_per_ray", batchTime / rayNum);
+		_report->AddValue("mesh_batch_threads", threadNum);
+		_report->AddValue("mesh_batch_parallel_ns_per_ray", parallelTime / rayNum);
+		_report->AddValue("along_surface_rays", alongSurfaceNum);
+		_report->AddValue("mismatches", mismatchNum);
+		_report->AddCheck("results_match", mismatchNum == 0);
+		//一括判定が1本ずつより遅くなっていないか（計測のぶれの分だけ余裕を持たせる）
+		_report->AddCheck("batch_not_slower", batchTime <= meshTime * batchTimeMargin);
+	}
+
+	RegisterTerrain(false);
+}
+
+void CollisionScenarios::RunTerrainQueries(BenchmarkReport* _report, int _queryNum)
+{
+	CollisionManager* collisionManager = CollisionManager::GetInstance();
+	RegisterTerrain(true);
+
+	//地面付近に置いた形状で、半分程度が地形と重なるようにする
+	std::uniform_real_distribution<float> offsetRange(-1.0f, 3.0f);
+	std::uniform_real_distribution<float> directionRange(-1.0f, 1.0f);
+	std::vector<Capsule> capsules(_queryNum);
+	std::vector<Sphere> spheres(_queryNum);
+	std::vector<XMVECTOR> displacements(_queryNum);
+	for (int i = 0; i < _queryNum; i++)
+	{
+		const XMVECTOR start = GetRandomTerrainPoint(offsetRange(random));
+		const XMVECTOR end = start + XMVECTOR{ directionRange(random), directionRange(random), directionRange(random), 0 } * 2.0f;
+		capsules[i].startPosition = { start.m128_f32[0], start.m128_f32[1], start.m128_f32[2] };
+		capsules[i].endPosition = { end.m128_f32[0], end.m128_f32[1], end.m128_f32[2] };
+		capsules[i].radius = 0.5f;
+
+		spheres[i].center = GetRandomTerrainPoint(offsetRange(random) + 2.0f);
+		spheres[i].radius = 1.0f;
+		displacements[i] = XMVECTOR{ directionRange(random), -2.0f, directionRange(random), 0 } * 2.0f;
+	}
+
+	const unsigned short attributes[] = { meshAttribute, heightfieldAttribute };
+	const char* const colliderNames[] = { "mesh", "heightfield" };
+	for (int type = 0; type < 2; type++)
+	{
+		const unsigned short attribute = attributes[type];
+
+		int capsuleHitNum = 0;
+		BenchmarkTimer timer;
+		for (const Capsule& capsule : capsules)
+		{
+			capsuleHitNum += collisionManager->QueryCapsule(capsule, attribute) ? 1 : 0;
+		}
+		const double capsuleTime = timer.GetNanoseconds();
+
+		int sweepHitNum = 0;
+		timer.Reset();
+		for (int i = 0; i < _queryNum; i++)
+		{
+			sweepHitNum += collisionManager->SweepSphere(spheres[i], displacements[i], attribute) ? 1 : 0;
+		}
+		const double sweepTime = timer.GetNanoseconds();
+
+		int contactHitNum = 0;
+		int contactNum = 0;
+		ContactManifold manifold;
+		timer.Reset();
+		for (const Sphere& sphere : spheres)
+		{
+			contactHitNum += collisionManager->QuerySphereContacts(sphere, &manifold, attribute) ? 1 : 0;
+			contactNum += manifold.GetContactNum();
+		}
+		const double contactTime = timer.GetNanoseconds();
+
+		_report->BeginScenario(std::string("terrain_queries_") + colliderNames[type]);
+		_report->AddValue("queries", _queryNum);
+		_report->AddValue("capsule_ns_per_query", capsuleTime / _queryNum);
+		_report->AddValue("capsule_hits", capsuleHitNum);
+		_report->AddValue("sweep_sphere_ns_per_query", sweepTime / _queryNum);
+		_report->AddValue("sweep_sphere_hits", sweepHitNum);
+		_report->AddValue("sphere_contacts_ns_per_query", contactTime / _queryNum);
+		_report->AddValue("sphere_contacts_hits", contactHitNum);
+		_report->AddValue("sphere_contacts_per_hit", contactHitNum > 0 ? static_cast<double>(contactNum) / contactHitNum : 0.0);
+	}
+
+	RegisterTerrain(false);
+}
+
+void CollisionScenarios::RunFrustumCulling(BenchmarkReport* _report, int _objectNum, int _frameNum)
+{
+	//カメラの周囲に物体を散らす（水平方向の画角は約90度なので、4分の3程度は視界の外になる）
+	const float fieldRadius = 600.0f;
+	std::uniform_real_distribution<float> angleRange(0.0f, XM_PI * 2.0f);
+	std::uniform_real_distribution<float> unitRange(0.0f, 1.0f);
+	std::uniform_real_distribution<float> heightRange(-20.0f, 20.0f);
+	std::uniform_real_distribution<float> sizeRange(0.5f, 4.0f);
+
+	const XMFLOAT3 localMin = { -1.0f, 0.0f, -1.0f };
+	const XMFLOAT3 localMax = { 1.0f, 2.0f, 1.0f };
+	std::vector<XMMATRIX> matWorlds(_objectNum);
+	for (int i = 0; i < _objectNum; i++)
+	{
+		const float angle = angleRange(random);
+		const float distance = fieldRadius * std::sqrt(unitRange(random));
+		const float size = sizeRange(random);
+		matWorlds[i] = XMMatrixScaling(size, size, size) * XMMatrixRotationY(angleRange(random)) *
+			XMMatrixTranslation(std::cos(angle) * distance, heightRange(random), std::sin(angle) * distance);
+	}
+
+	const XMMATRIX matProjection = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 1200.0f);
+	std::vector<XMFLOAT3> centers(_objectNum);
+	std::vector<XMFLOAT3> extents(_objectNum);
+	std::vector<char> isVisibleReference(_objectNum);
+	std::unique_ptr<bool[]> isVisibleBatch(new bool[_objectNum]);
+
+	double updateTime = 0.0;
+	double objectTime = 0.0;
+	double batchTime = 0.0;
+	double referenceTime = 0.0;
+	long long visibleNum = 0;
+	int objectMismatchNum = 0;
+	int batchMismatchNum = 0;
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		//フレームごとにカメラを水平に回す
+		const float yaw = XM_PI * 2.0f * frame / _frameNum;
+		const XMVECTOR eye = { 0.0f, 10.0f, 0.0f, 1.0f };
+		const XMVECTOR target = eye + XMVECTOR{ std::sin(yaw), -0.1f, std::cos(yaw), 0.0f };
+		const XMMATRIX matView = XMMatrixLookAtLH(eye, target, XMVECTOR{ 0.0f, 1.0f, 0.0f, 0.0f });
+
+		BenchmarkTimer timer;
+		Frustum frustum;
+		frustum.Update(matView * matProjection);
+		updateTime += timer.GetNanoseconds();
+
+		//以前の判定（ローカルAABBの8頂点を変換して囲み直し、平面ごとに最も内側の頂点を比べる）
+		timer.Reset();
+		for (int i = 0; i < _objectNum; i++)
+		{
+			XMVECTOR worldMin = XMVectorReplicate(D3D12_FLOAT32_MAX);
+			XMVECTOR worldMax = XMVectorReplicate(-D3D12_FLOAT32_MAX);
+			for (int corner = 0; corner < 8; corner++)
+			{
+				const XMVECTOR point = XMVector3Transform(XMVectorSet(
+					(corner & 1) ? localMax.x : localMin.x,
+					(corner & 2) ? localMax.y : localMin.y,
+					(corner & 4) ? localMax.z : localMin.z, 1.0f), matWorlds[i]);
+				worldMin = XMVectorMin(worldMin, point);
+				worldMax = XMVectorMax(worldMax, point);
+			}
+
+			bool isVisible = true;
+			for (int j = 0; j < Frustum::planeNum && isVisible; j++)
+			{
+				const XMFLOAT4& plane = frustum.GetPlane(j);
+				const XMVECTOR inside = XMVectorSelect(worldMin, worldMax,
+					XMVectorGreaterOrEqual(XMVectorSet(plane.x, plane.y, plane.z, 0.0f), XMVectorZero()));
+				isVisible = XMVectorGetX(XMVector3Dot(inside, XMLoadFloat4(&plane))) + plane.w >= 0.0f;
+			}
+			isVisibleReference[i] = isVisible ? 1 : 0;
+		}
+		referenceTime += timer.GetNanoseconds();
+
+		//描画時と同じ1物体ずつの判定
+		timer.Reset();
+		int frameVisibleNum = 0;
+		for (int i = 0; i < _objectNum; i++)
+		{
+			const bool isVisible = frustum.IsVisibleAABB(matWorlds[i], localMin, localMax);
+			frameVisibleNum += isVisible ? 1 : 0;
+			if (isVisible != (isVisibleReference[i] != 0)) {
+				objectMismatchNum++;
+			}
+		}
+		objectTime += timer.GetNanoseconds();
+		visibleNum += frameVisibleNum;
+
+		//ワールドAABBを求めてからまとめて判定（AABBを求める時間も含める）
+		timer.Reset();
+		const XMVECTOR localCenter = (XMLoadFloat3(&localMin) + XMLoadFloat3(&localMax)) * 0.5f;
+		const XMVECTOR localExtent = (XMLoadFloat3(&localMax) - XMLoadFloat3(&localMin)) * 0.5f;
+		for (int i = 0; i < _objectNum; i++)
+		{
+			const XMMATRIX& matWorld = matWorlds[i];
+			XMStoreFloat3(&centers[i], XMVector3Transform(localCenter, matWorld));
+			XMStoreFloat3(&extents[i],
+				XMVectorAbs(matWorld.r[0]) * XMVectorSplatX(localExtent) +
+				XMVectorAbs(matWorld.r[1]) * XMVectorSplatY(localExtent) +
+				XMVectorAbs(matWorld.r[2]) * XMVectorSplatZ(localExtent));
+		}
+		frustum.CullAABBs(centers.data(), extents.data(), _objectNum, isVisibleBatch.get());
+		batchTime += timer.GetNanoseconds();
+		for (int i = 0; i < _objectNum; i++)
+		{
+			if (isVisibleBatch[i] != (isVisibleReference[i] != 0)) {
+				batchMismatchNum++;
+			}
+		}
+	}
+
+	const double testNum = static_cast<double>(_objectNum) * _frameNum;
+	_report->BeginScenario("frustum_culling_" + std::to_string(_objectNum));
+	_report->AddValue("objects", _objectNum);
+	_report->AddValue("frames", _frameNum);
+	_report->AddValue("visible_ratio", visibleNum / testNum);
+	_report->AddValue("frustum_update_ns", updateTime / _frameNum);
+	_report->AddValue("corners_ns_per_object", referenceTime / testNum);
+	_report->AddValue("object_ns_per_object", objectTime / testNum);
+	_report->AddValue("object_mismatches", objectMismatchNum);
+	_report->AddValue("batch_ns_per_object", batchTime / testNum);
+	_report->AddValue("batch_mismatches", batchMismatchNum);
+}
+
+void CollisionScenarios::RunSimdMath(BenchmarkReport* _report, int _count)
+{
+	std::uniform_real_distribution<float> valueRange(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> angleRange(-XM_PI, XM_PI);
+
+	//既存の型で入力を作り、SimdMathへは変換して渡す
+	std::vector<Vector3> points(_count);
+	std::vector<Quaternion> rotations(_count);
+	std::vector<Matrix4> matrices(_count);
+	for (int i = 0; i < _count; i++)
+	{
+		points[i] = Vector3(valueRange(random), valueRange(random), valueRange(random));
+		const Vector3 axis = Vector3(valueRange(random), valueRange(random), valueRange(random)).normalize();
+		rotations[i] = quaternion(axis, angleRange(random));
+		matrices[i] = scale(Vector3(1.5f, 0.5f, 2.0f)) * rotate(rotations[i]) * translate(points[i]);
+	}
+
+	//座標変換（Vector3とMatrix4の積とMat4の比較）
+	double maxError = 0.0;
+	BenchmarkTimer timer;
+	Vector3 scalarSum;
+	for (int i = 0; i < _count; i++)
+	{
+		scalarSum += points[i] * matrices[(i + 1) % _count];
+	}
+	const double scalarTransformTime = timer.GetNanoseconds();
+
+	timer.Reset();
+	SimdMath::Vec3A simdSum;
+	for (int i = 0; i < _count; i++)
+	{
+		simdSum += SimdMath::TransformPoint(SimdMath::Vec3A(points[i]), SimdMath::Mat4(matrices[(i + 1) % _count]));
+	}
+	const double simdTransformTime = timer.GetNanoseconds();
+	maxError = (std::max)(maxError, static_cast<double>((scalarSum - simdSum.ToVector3()).length() / (std::max)(scalarSum.length(), 1.0f)));
+
+	//行列の積（XMMATRIXとMat4の比較）
+	std::vector<Matrix4> scalarProducts(_count);
+	timer.Reset();
+	for (int i = 0; i < _count; i++)
+	{
+		scalarProducts[i] = matrices[i] * matrices[(i + 1) % _count];
+	}
+	const double xmMultiplyTime = timer.GetNanoseconds();
+
+	std::vector<SimdMath::Mat4> simdProducts(_count);
+	timer.Reset();
+	for (int i = 0; i < _count; i++)
+	{
+		simdProducts[i] = SimdMath::Mat4(matrices[i]) * SimdMath::Mat4(matrices[(i + 1) % _count]);
+	}
+	const double simdMultiplyTime = timer.GetNanoseconds();
+	for (int i = 0; i < _count; i++)
+	{
+		const Matrix4 simdProduct = simdProducts[i].ToMatrix4();
+		for (int element = 0; element < 16; element++)
+		{
+			const float scalarValue = scalarProducts[i].r[element / 4].m128_f32[element % 4];
+			const float difference = std::fabs(scalarValue - simdProduct.r[element / 4].m128_f32[element % 4]);
+			maxError = (std::max)(maxError, static_cast<double>(difference / (std::max)(std::fabs(scalarValue), 1.0f)));
+		}
+	}
+
+	//クォータニオンの積と回転（Quaternionとの比較）
+	timer.Reset();
+	Vector3 scalarRotated;
+	for (int i = 0; i < _count; i++)
+	{
+		const Quaternion rotation = rotations[i] * rotations[(i + 1) % _count];
+		const Quaternion rotated = quaternion(points[i], rotation);
+		scalarRotated += Vector3(rotated.x, rotated.y, rotated.z);
+	}
+	const double scalarQuaternionTime = timer.GetNanoseconds();
+
+	timer.Reset();
+	SimdMath::Vec3A simdRotated;
+	for (int i = 0; i < _count; i++)
+	{
+		const SimdMath::Quat rotation = SimdMath::Quat(rotations[i]) * SimdMath::Quat(rotations[(i + 1) % _count]);
+		simdRotated += SimdMath::Rotate(SimdMath::Vec3A(points[i]), rotation);
+	}
+	const double simdQuaternionTime = timer.GetNanoseconds();
+	maxError = (std::max)(maxError, static_cast<double>((scalarRotated - simdRotated.ToVector3()).length() / (std::max)(scalarRotated.length(), 1.0f)));
+
+	//回転行列への変換はrotateと一致させる
+	for (int i = 0; i < _count; i++)
+	{
+		const Matrix4 scalarMatrix = rotate(rotations[i]);
+		const Matrix4 simdMatrix = SimdMath::ToMat4(SimdMath::Quat(rotations[i])).ToMatrix4();
+		for (int element = 0; element < 16; element++)
+		{
+			const float difference = scalarMatrix.r[element / 4].m128_f32[element % 4] - simdMatrix.r[element / 4].m128_f32[element % 4];
+			maxError = (std::max)(maxError, static_cast<double>(std::fabs(difference)));
+		}
+	}
+
+	_report->BeginScenario("simd_math");
+	_report->AddValue("count", _count);
+	_report->AddValue("vector3_transform_ns", scalarTransformTime / _count);
+	_report->AddValue("simd_transform_ns", simdTransformTime / _count);
+	_report->AddValue("xmmatrix_multiply_ns", xmMultiplyTime / _count);
+	_report->AddValue("simd_multiply_ns", simdMultiplyTime / _count);
+	_report->AddValue("quaternion_ns", scalarQuaternionTime / _count);
+	_report->AddValue("simd_quaternion_ns", simdQuaternionTime / _count);
+	_report->AddValue("max_error", maxError);
+}
+
+void CollisionScenarios::RunTransformKernel(BenchmarkReport* _report, int _objectNum, int _frameNum)
+{
+	std::uniform_real_distribution<float> positionRange(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> rotationRange(-360.0f, 360.0f);
+	std::uniform_real_distribution<float> scaleRange(0.5f, 2.0f);
+
+	std::vector<XMFLOAT3> positions(_objectNum);
+	std::vector<XMFLOAT3> rotations(_objectNum);
+	std::vector<XMFLOAT3> scales(_objectNum);
+	std::vector<Quaternion> quaternions(_objectNum);
+	for (int i = 0; i < _objectNum; i++)
+	{
+		positions[i] = { positionRange(random), positionRange(random), positionRange(random) };
+		rotations[i] = { rotationRange(random), rotationRange(random), rotationRange(random) };
+		scales[i] = { scaleRange(random), scaleRange(random), scaleRange(random) };
+		const Vector3 axis = Vector3(positionRange(random), positionRange(random), positionRange(random)).normalize();
+		quaternions[i] = quaternion(axis, XMConvertToRadians(rotationRange(random)));
+	}
+
+	//行列の成分ごとの誤差（大きい値は相対誤差）
+	double maxError = 0.0;
+	auto compareMatrices = [&maxError](const std::vector<XMMATRIX>& _expected, const std::vector<XMMATRIX>& _actual)
+	{
+		for (size_t i = 0; i < _expected.size(); i++)
+		{
+			for (int element = 0; element < 16; element++)
+			{
+				const float expected = _expected[i].r[element / 4].m128_f32[element % 4];
+				const float difference = std::fabs(expected - _actual[i].r[element / 4].m128_f32[element % 4]);
+				maxError = (std::max)(maxError, static_cast<double>(difference / (std::max)(std::fabs(expected), 1.0f)));
+			}
+		}
+	};
+
+	//以前のUpdateWorldMatrix（5つの行列を順に掛ける）
+	std::vector<XMMATRIX> expected(_objectNum);
+	BenchmarkTimer timer;
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		for (int i = 0; i < _objectNum; i++)
+		{
+			XMMATRIX matWorld = XMMatrixIdentity();
+			matWorld *= XMMatrixScaling(scales[i].x, scales[i].y, scales[i].z);
+			matWorld *= XMMatrixRotationZ(XMConvertToRadians(rotations[i].z));
+			matWorld *= XMMatrixRotationX(XMConvertToRadians(rotations[i].x));
+			matWorld *= XMMatrixRotationY(XMConvertToRadians(rotations[i].y));
+			matWorld *= XMMatrixTranslation(positions[i].x, positions[i].y, positions[i].z);
+			expected[i] = matWorld;
+		}
+	}
+	const double matrixChainTime = timer.GetNanoseconds();
+
+	std::vector<XMMATRIX> actual(_objectNum);
+	timer.Reset();
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		TransformKernel::ComposeEuler(positions.data(), rotations.data(), scales.data(), _objectNum, actual.data());
+	}
+	const double composeEulerTime = timer.GetNanoseconds();
+	compareMatrices(expected, actual);
+
+	//クォータニオン（scale*rotate*translate）
+	timer.Reset();
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		for (int i = 0; i < _objectNum; i++)
+		{
+			const Vector3& s = static_cast<const Vector3&>(scales[i]);
+			const Vector3& t = static_cast<const Vector3&>(positions[i]);
+			expected[i] = scale(s) * rotate(quaternions[i]) * translate(t);
+		}
+	}
+	const double quaternionChainTime = timer.GetNanoseconds();
+
+	timer.Reset();
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		TransformKernel::ComposeQuaternion(positions.data(), quaternions.data(), scales.data(), _objectNum, actual.data());
+	}
+	const double composeQuaternionTime = timer.GetNanoseconds();
+	compareMatrices(expected, actual);
+
+	//親子階層（4分の1を根にし、残りは少し前の物体を親にする）
+	std::vector<int> parents(_objectNum);
+	std::vector<XMMATRIX> matLocals(_objectNum);
+	TransformKernel::ComposeEuler(positions.data(), rotations.data(), scales.data(), _objectNum, matLocals.data());
+	for (int i = 0; i < _objectNum; i++)
+	{
+		matLocals[i].r[3] = XMVectorSet(positions[i].x * 0.01f, positions[i].y * 0.01f, positions[i].z * 0.01f, 1.0f);
+		const bool isRoot = i == 0 || (random() % 4) == 0;
+		parents[i] = isRoot ? -1 : i - 1 - static_cast<int>(random() % (std::min)(i, 8));
+	}
+
+	//以前のように、物体ごとに根までの行列を全て掛け直す
+	timer.Reset();
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		for (int i = 0; i < _objectNum; i++)
+		{
+			XMMATRIX matWorld = matLocals[i];
+			for (int parent = parents[i]; parent >= 0; parent = parents[parent])
+			{
+				matWorld *= matLocals[parent];
+			}
+			expected[i] = matWorld;
+		}
+	}
+	const double hierarchyChainTime = timer.GetNanoseconds();
+
+	timer.Reset();
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		TransformKernel::UpdateHierarchy(matLocals.data(), parents.data(), _objectNum, actual.data());
+	}
+	const double hierarchyTime = timer.GetNanoseconds();
+	compareMatrices(expected, actual);
+
+	//sin,cosの近似誤差
+	double sinCosError = 0.0;
+	for (int i = 0; i <= 100000; i++)
+	{
+		const float angle = XMConvertToRadians(-720.0f + 1440.0f * i / 100000);
+		SimdMath::detail::Float4 sin, cos;
+		SimdMath::detail::SinCos(SimdMath::detail::Splat(angle), &sin, &cos);
+		sinCosError = (std::max)(sinCosError, std::fabs(static_cast<double>(SimdMath::detail::GetLane<0>(sin)) - std::sin(static_cast<double>(angle))));
+		sinCosError = (std::max)(sinCosError, std::fabs(static_cast<double>(SimdMath::detail::GetLane<0>(cos)) - std::cos(static_cast<double>(angle))));
+	}
+
+	const double matrixNum = static_cast<double>(_objectNum) * _frameNum;
+	_report->BeginScenario("transform_kernel_" + std::to_string(_objectNum));
+	_report->AddValue("objects", _objectNum);
+	_report->AddValue("frames", _frameNum);
+	_report->AddValue("matrix_chain_ns_per_object", matrixChainTime / matrixNum);
+	_report->AddValue("compose_euler_ns_per_object", composeEulerTime / matrixNum);
+	_report->AddValue("quaternion_chain_ns_per_object", quaternionChainTime / matrixNum);
+	_report->AddValue("compose_quaternion_ns_per_object", composeQuaternionTime / matrixNum);
+	_report->AddValue("hierarchy_chain_ns_per_object", hierarchyChainTime / matrixNum);
+	_report->AddValue("hierarchy_pass_ns_per_object", hierarchyTime / matrixNum);
+	_report->AddValue("max_error", maxError);
+	_report->AddValue("sincos_max_error", sinCosError);
+}
+
+void CollisionScenarios::RunTransformSystem(BenchmarkReport* _report, int _objectNum, int _frameNum)
+{
+	std::uniform_real_distribution<float> positionRange(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> rotationRange(-180.0f, 180.0f);
+	std::uniform_real_distribution<float> scaleRange(0.8f, 1.2f);
+
+	//16分の1を根にし、残りは少し前の物体を親にする（親は必ず子より前）
+	std::vector<XMFLOAT3> positions(_objectNum);
+	std::vector<XMFLOAT3> rotations(_objectNum);
+	std::vector<XMFLOAT3> scales(_objectNum);
+	std::vector<int> parents(_objectNum);
+	for (int i = 0; i < _objectNum; i++)
+	{
+		positions[i] = { positionRange(random), positionRange(random), positionRange(random) };
+		rotations[i] = { rotationRange(random), rotationRange(random), rotationRange(random) };
+		scales[i] = { scaleRange(random), scaleRange(random), scaleRange(random) };
+		const bool isRoot = i == 0 || (random() % 16) == 0;
+		parents[i] = isRoot ? -1 : i - 1 - static_cast<int>(random() % (std::min)(i, 32));
+	}
+
+	TransformSystem* transformSystem = TransformSystem::GetInstance();
+	std::vector<int> handles(_objectNum);
+	for (int i = 0; i < _objectNum; i++)
+	{
+		handles[i] = transformSystem->Create(parents[i] < 0 ? TransformSystem::invalid_handle : handles[parents[i]]);
+		transformSystem->SetLocal(handles[i], positions[i], rotations[i], scales[i]);
+	}
+	transformSystem->Update();
+
+	//毎フレーム全てのローカル行列とワールド行列を作り直す場合
+	std::vector<XMMATRIX> matLocals(_objectNum);
+	std::vector<XMMATRIX> matWorlds(_objectNum);
+	BenchmarkTimer timer;
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		TransformKernel::ComposeEuler(positions.data(), rotations.data(), scales.data(), _objectNum, matLocals.data());
+		TransformKernel::UpdateHierarchy(matLocals.data(), parents.data(), _objectNum, matWorlds.data());
+	}
+	const double fullRebuildTime = timer.GetNanoseconds();
+
+	//静的な物体（何もセットしない場合と、同じ値を毎フレームセットし直す場合）
+	timer.Reset();
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		transformSystem->Update();
+	}
+	const double staticTime = timer.GetNanoseconds();
+	timer.Reset();
+	for (int frame = 0; frame < _frameNum; frame++)
+	{
+		for (int i = 0; i < _objectNum; i++)
+		{
+			transformSystem->SetLocal(handles[i], positions[i], rotations[i], scales[i]);
+		}
+		transformSystem->Update();
+	}
+	const double staticResetTime = timer.GetNanoseconds();
+	const int staticUpdatedNum = transformSystem->GetUpdatedNum();
+
+	//一部の物体だけを動かす（子孫も計算し直しになる）
+	auto runMoving = [&](int _movingNum, int* _updatedNum)
+	{
+		std::vector<int> moving(_movingNum);
+		for (int& index : moving) { index = static_cast<int>(random() % _objectNum); }
+
+		long long updatedTotal = 0;
+		BenchmarkTimer movingTimer;
+		for (int frame = 0; frame < _frameNum; frame++)
+		{
+			for (int index : moving)
+			{
+				rotations[index].y += 1.0f;
+				transformSystem->SetLocal(handles[index], positions[index], rotations[index], scales[index]);
+			}
+			transformSystem->Update();
+			updatedTotal += transformSystem->GetUpdatedNum();
+		}
+		*_updatedNum = static_cast<int>(updatedTotal / _frameNum);
+		return movingTimer.GetNanoseconds();
+	};
+	int updatedNumSmall = 0;
+	int updatedNumLarge = 0;
+	const double movingSmallTime = runMoving((std::max)(_objectNum / 100, 1), &updatedNumSmall);
+	const double movingLargeTime = runMoving((std::max)(_objectNum / 10, 1), &updatedNumLarge);
+
+	//作り直した結果との比較
+	TransformKernel::ComposeEuler(positions.data(), rotations.data(), scales.data(), _objectNum, matLocals.data());
+	TransformKernel::UpdateHierarchy(matLocals.data(), parents.data(), _objectNum, matWorlds.data());
+	double maxError = 0.0;
+	for (int i = 0; i < _objectNum; i++)
+	{
+		const XMMATRIX& matWorld = transformSystem->GetMatWorld(handles[i]);
+		for (int element = 0; element < 16; element++)
+		{
+			const float expected = matWorlds[i].r[element / 4].m128_f32[element % 4];
+			const float difference = std::fabs(expected - matWorld.r[element / 4].m128_f32[element % 4]);
+			maxError = (std::max)(maxError, static_cast<double>(difference / (std::max)(std::fabs(expected), 1.0f)));
+		}
+	}
+
+	for (int handle : handles)
+	{
+		transformSystem->Destroy(handle);
+	}
+
+	_report->BeginScenario("transform_system_" + std::to_string(_objectNum));
+	_report->AddValue("objects", _objectNum);
+	_report->AddValue("frames", _frameNum);
+	_report->AddValue("full_rebuild_us_per_frame", fullRebuildTime / _frameNum / 1000.0);
+	_report->AddValue("static_us_per_frame", staticTime / _frameNum / 1000.0);
+	_report->AddValue("static_reset_us_per_frame", staticResetTime / _frameNum / 1000.0);
+	_report->AddValue("static_updated", staticUpdatedNum);
+	_report->AddValue("moving_1pct_us_per_frame", movingSmallTime / _frameNum / 1000.0);
+	_report->AddValue("moving_1pct_updated", updatedNumSmall);
+	_report->AddValue("moving_10pct_us_per_frame", movingLargeTime / _frameNum / 1000.0);
+	_report->AddValue("moving_10pct_updated", updatedNumLarge);
+	_report->AddValue("max_error", maxError);
+}
+
+void CollisionScenarios::RunQuaternionInterpolation(BenchmarkReport* _report, int _count)
+{
+	std::uniform_real_distribution<float> axisRange(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> angleRange(-XM_PI, XM_PI);
+	std::uniform_real_distribution<float> smallAngleRange(-0.02f, 0.02f);
+	std::uniform_real_distribution<float> factorRange(0.0f, 1.0f);
+
+	//任意の角度差の組と、ほぼ平行な組（キーフレーム間の小さな回転）
+	auto createPairs = [&](bool _isNear, std::vector<Quaternion>* _starts, std::vector<Quaternion>* _ends)
+	{
+		_starts->resize(_count);
+		_ends->resize(_count);
+		for (int i = 0; i < _count; i++)
+		{
+			const Vector3 axis = Vector3(axisRange(random), axisRange(random), axisRange(random)).normalize();
+			(*_starts)[i] = quaternion(axis, angleRange(random));
+			const Vector3 deltaAxis = Vector3(axisRange(random), axisRange(random), axisRange(random)).normalize();
+			const Quaternion delta = quaternion(deltaAxis, _isNear ? smallAngleRange(random) : angleRange(random) * 2.0f);
+			(*_ends)[i] = normalize((*_starts)[i] * delta);
+		}
+	};
+	std::vector<float> ts(_count);
+	for (float& t : ts) { t = factorRange(random); }
+
+	//倍精度のslerpとの成分ごとの差
+	auto measureError = [&](const std::vector<Quaternion>& _starts, const std::vector<Quaternion>& _ends, const std::vector<Quaternion>& _results)
+	{
+		double maxError = 0.0;
+		for (int i = 0; i < _count; i++)
+		{
+			const double start[4] = { _starts[i].x, _starts[i].y, _starts[i].z, _starts[i].w };
+			double end[4] = { _ends[i].x, _ends[i].y, _ends[i].z, _ends[i].w };
+			double cos = start[0] * end[0] + start[1] * end[1] + start[2] * end[2] + start[3] * end[3];
+			if (cos < 0.0)
+			{
+				cos = -cos;
+				for (double& value : end) { value = -value; }
+			}
+			double k0 = 1.0 - ts[i];
+			double k1 = ts[i];
+			const double theta = std::acos((std::min)(cos, 1.0));
+			if (theta > 1e-9)
+			{
+				k0 = std::sin(theta * k0) / std::sin(theta);
+				k1 = std::sin(theta * k1) / std::sin(theta);
+			}
+			const double result[4] = { _results[i].x, _results[i].y, _results[i].z, _results[i].w };
+			for (int j = 0; j < 4; j++)
+			{
+				maxError = (std::max)(maxError, std::fabs(start[j] * k0 + end[j] * k1 - result[j]));
+			}
+		}
+		return maxError;
+	};
+
+	std::vector<Quaternion> starts;
+	std::vector<Quaternion> ends;
+	std::vector<Quaternion> nearStarts;
+	std::vector<Quaternion> nearEnds;
+	createPairs(false, &starts, &ends);
+	createPairs(true, &nearStarts, &nearEnds);
+	std::vector<Quaternion> results(_count);
+
+	//1組ずつのslerp（Quaternion.cpp）
+	BenchmarkTimer timer;
+	for (int i = 0; i < _count; i++)
+	{
+		results[i] = slerp(starts[i], ends[i], ts[i]);
+	}
+	const double scalarTime = timer.GetNanoseconds();
+	const double scalarError = measureError(starts, ends, results);
+
+	timer.Reset();
+	QuaternionKernel::Slerp(starts.data(), ends.data(), ts.data(), _count, results.data());
+	const double slerpTime = timer.GetNanoseconds();
+	const double slerpError = measureError(starts, ends, results);
+
+	timer.Reset();
+	QuaternionKernel::Nlerp(starts.data(), ends.data(), ts.data(), _count, results.data());
+	const double nlerpTime = timer.GetNanoseconds();
+	const double nlerpError = measureError(starts, ends, results);
+
+	//ほぼ平行な組だけならacos・sinを省く
+	timer.Reset();
+	QuaternionKernel::Slerp(nearStarts.data(), nearEnds.data(), ts.data(), _count, results.data());
+	const double nearSlerpTime = timer.GetNanoseconds();
+	const double nearSlerpError = measureError(nearStarts, nearEnds, results);
+
+	_report->BeginScenario("quaternion_interpolation");
+	_report->AddValue("pairs", _count);
+	_report->AddValue("scalar_slerp_ns_per_pair", scalarTime / _count);
+	_report->AddValue("batch_slerp_ns_per_pair", slerpTime / _count);
+	_report->AddValue("batch_nlerp_ns_per_pair", nlerpTime / _count);
+	_report->AddValue("batch_slerp_near_ns_per_pair", nearSlerpTime / _count);
+	_report->AddValue("scalar_slerp_max_error", scalarError);
+	_report->AddValue("batch_slerp_max_error", slerpError);
+	_report->AddValue("batch_slerp_near_max_error", nearSlerpError);
+	_report->AddValue("batch_nlerp_max_deviation", nlerpError);
+}
+
+std::vector<Ray> CollisionScenarios::CreateTerrainRays(int _rayNum, bool _isDown)
+{
+	std::vector<Ray> rays(_rayNum);
+	for (Ray& ray : rays)
+	{
+		if (_isDown) {
+			ray.start = GetRandomTerrainPoint(rayStartHeight);
+			ray.dir = { 0, -1, 0, 0 };
+		} else {
+			//地面近くの点から、地形上の別の点を狙う
+			ray.start = GetRandomTerrainPoint(2.0f);
+			const XMVECTOR target = GetRandomTerrainPoint(0.0f);
+			ray.dir = XMVector3Normalize(target - ray.start);
+		}
+	}
+	return rays;
+}
+
+XMVECTOR CollisionScenarios::GetRandomTerrainPoint(float _heightOffset)
+{
+	//端のセルを避け、格子の内側から選ぶ
+	std::uniform_real_distribution<float> xRange(1.0f, terrainWidth - 2.0f);
+	std::uniform_real_distribution<float> zRange(1.0f, terrainDepth - 2.0f);
+	const XMVECTOR local = { xRange(random), 0, zRange(random), 1 };
+	XMVECTOR point = XMVector3Transform(local, terrainObject->GetMatWorld());
+
+	float height = 0.0f;
+	terrainHeightfield->GetHeightAt(point.m128_f32[0], point.m128_f32[2], &height);
+	point.m128_f32[1] = height + _heightOffset;
+	return point;
+}
+
+bool CollisionScenarios::IsRayAlongTerrain(const Ray& _ray, float _distance0, float _distance1)
+{
+	const float distances[] = { _distance0, _distance1, (_distance0 + _distance1) * 0.5f };
+	for (float distance : distances)
+	{
+		const XMVECTOR point = XMVectorAdd(_ray.start, XMVectorScale(_ray.dir, distance));
+		float height = 0.0f;
+		if (!terrainHeightfield->GetHeightAt(point.m128_f32[0], point.m128_f32[2], &height)) {
+			return false;
+		}
+		if (std::fabs(point.m128_f32[1] - height) > distanceEpsilon * (std::max)(1.0f, distance)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void CollisionScenarios::RegisterTerrain(bool _isRegister)
+{
+	CollisionManager* collisionManager = CollisionManager::GetInstance();
+	if (_isRegister) {
+		collisionManager->AddCollider(terrainMesh.get());
+		collisionManager->AddCollider(terrainHeightfield.get());
+	} else {
+		collisionManager->RemoveCollider(terrainMesh.get());
+		collisionManager->RemoveCollider(terrainHeightfield.get());
+	}
+}
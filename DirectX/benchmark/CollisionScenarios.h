@@ -0,0 +1,209 @@
+﻿#pragma once
+
+#include "BenchmarkReport.h"
+#include "InterfaceObject3d.h"
+#include "CollisionPrimitive.h"
+#include "MeshCollider.h"
+#include "HeightfieldCollider.h"
+#include "SphereCollider.h"
+#include "Frustum.h"
+#include "SimdMath.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 当たり判定のベンチマークシナリオ（乱数の種を固定し、同じ環境なら毎回同じ入力で計測する）
+/// </summary>
+class CollisionScenarios
+{
+private: // サブクラス
+
+	/// <summary>
+	/// 衝突時コールバックの回数を数えるオブジェクト
+	/// </summary>
+	class CountingObject : public InterfaceObject3d
+	{
+	public:
+		void OnCollision(const CollisionInfo& /*_info*/) override { collisionCount++; }
+
+		// 衝突時コールバックが呼ばれた回数
+		int collisionCount = 0;
+	};
+
+	/// <summary>
+	/// 自分のコライダーを持ち、接触開始か接触継続のコールバックの中でそのコライダーを削除・解放するオブジェクト
+	/// </summary>
+	class SelfRemovingObject : public InterfaceObject3d
+	{
+	public:
+		void OnCollision(const CollisionInfo& /*_info*/) override { CountCallback(); }
+		void OnCollisionEnter(const CollisionInfo& /*_info*/) override;
+		void OnCollisionStay(const CollisionInfo& /*_info*/) override;
+		void OnCollisionExit(const CollisionInfo& _info) override;
+
+		// 自分のコライダー
+		std::unique_ptr<SphereCollider> collider;
+		// 接触開始で削除するか
+		bool isRemoveOnEnter = false;
+		// 接触継続で削除するか
+		bool isRemoveOnStay = false;
+		// 接触開始の回数
+		int enterCount = 0;
+		// 接触終了の回数
+		int exitCount = 0;
+		// 相手が削除済みの接触終了の回数
+		int removedExitCount = 0;
+		// コライダーの解放後に呼ばれたコールバックの回数
+		int afterRemovalCount = 0;
+
+	private:
+		/// <summary>
+		/// コールバックを数え、コライダーの解放後なら記録する
+		/// </summary>
+		void CountCallback() { if (!collider) { afterRemovalCount++; } }
+
+		/// <summary>
+		/// 自分のコライダーを削除して解放する
+		/// </summary>
+		void RemoveSelf();
+	};
+
+public: // メンバ関数
+
+	/// <summary>
+	/// 地形を読み込み、メッシュとハイトフィールドの両方のコライダーを作る
+	/// </summary>
+	/// <param name="_filename">ハイトマップ画像（24bitのBMP、赤成分を高さに使う）</param>
+	/// <returns>成功か</returns>
+	bool LoadTerrain(const std::string& _filename);
+
+	/// <summary>
+	/// 動く球同士の全衝突チェック（動的AABB木による検出と総当たりを比較する）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_colliderNum">球の数</param>
+	/// <param name="_frameNum">計測するフレーム数</param>
+	/// <param name="_bruteForceFrameNum">総当たりも計測するフレーム数（先頭から）</param>
+	void RunBroadphase(BenchmarkReport* _report, int _colliderNum, int _frameNum, int _bruteForceFrameNum);
+
+	/// <summary>
+	/// 衝突時コールバックの中でコライダーを削除・解放した場合の通知（解放後に触らず、接触終了が1度ずつ届くか）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	void RunSelfRemoval(BenchmarkReport* _report);
+
+	/// <summary>
+	/// レイと三角形の判定関数単体の速度（1対1、三角形4つのSoA、レイ4本のSoA）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_rayNum">レイの数</param>
+	/// <param name="_triangleNum">三角形の数（地形の先頭から）</param>
+	void RunRayTriangleKernel(BenchmarkReport* _report, int _rayNum, int _triangleNum);
+
+	/// <summary>
+	/// 地形へのレイキャスト（接地用の真下向きと、視線判定用の斜め向き）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_rayNum">レイの数</param>
+	void RunTerrainRaycast(BenchmarkReport* _report, int _rayNum);
+
+	/// <summary>
+	/// 地形への形状クエリ（カプセル、移動する球、球の接触点収集）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_queryNum">クエリの数</param>
+	void RunTerrainQueries(BenchmarkReport* _report, int _queryNum);
+
+	/// <summary>
+	/// 描画前の視錐台カリング（8頂点を変換する判定、1物体ずつのSIMD判定、4物体ずつの一括判定を比較する）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_objectNum">物体の数</param>
+	/// <param name="_frameNum">計測するフレーム数（カメラを1周させる）</param>
+	void RunFrustumCulling(BenchmarkReport* _report, int _objectNum, int _frameNum);
+
+	/// <summary>
+	/// SimdMathと既存の数学型（Vector3・Matrix4・Quaternion）の速度と誤差の比較
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_count">演算の回数</param>
+	void RunSimdMath(BenchmarkReport* _report, int _count);
+
+	/// <summary>
+	/// ワールド行列の作成（行列を順に掛ける以前の方法とTransformKernelの比較、親子階層の更新）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_objectNum">物体の数</param>
+	/// <param name="_frameNum">計測するフレーム数</param>
+	void RunTransformKernel(BenchmarkReport* _report, int _objectNum, int _frameNum);
+
+	/// <summary>
+	/// 親子階層の更新（毎フレーム全て作り直す場合と、TransformSystemで変更のあった部分木だけを更新する場合の比較）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_objectNum">物体の数</param>
+	/// <param name="_frameNum">計測するフレーム数</param>
+	void RunTransformSystem(BenchmarkReport* _report, int _objectNum, int _frameNum);
+
+	/// <summary>
+	/// クォータニオンの補間（1組ずつのslerpとQuaternionKernelのslerp・nlerpの比較）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_count">補間する組の数</param>
+	void RunQuaternionInterpolation(BenchmarkReport* _report, int _count);
+
+private:
+
+	/// <summary>
+	/// 地形の上空からランダムな向きのレイを作る
+	/// </summary>
+	/// <param name="_rayNum">レイの数</param>
+	/// <param name="_isDown">真下向きか（falseなら地形上の2点を結ぶ斜め向き）</param>
+	/// <returns>レイの配列</returns>
+	std::vector<Ray> CreateTerrainRays(int _rayNum, bool _isDown);
+
+	/// <summary>
+	/// 地形上のランダムな点を取得（高さはハイトフィールドから求める）
+	/// </summary>
+	/// <param name="_heightOffset">地面からの高さ</param>
+	/// <returns>ワールド座標</returns>
+	DirectX::XMVECTOR GetRandomTerrainPoint(float _heightOffset);
+
+	/// <summary>
+	/// レイが2つの距離の間で地形の面に沿って進んでいるか
+	/// （面と同一平面のレイは最初の接触点が判定方法で変わるため、不一致として数えない）
+	/// </summary>
+	/// <param name="_ray">レイ</param>
+	/// <param name="_distance0">1つ目の衝突距離</param>
+	/// <param name="_distance1">2つ目の衝突距離</param>
+	/// <returns>両端と中点が地形の面上にあるか</returns>
+	bool IsRayAlongTerrain(const Ray& _ray, float _distance0, float _distance1);
+
+	/// <summary>
+	/// 地形のコライダーをCollisionManagerへ登録・解除する
+	/// </summary>
+	/// <param name="_isRegister">登録するか</param>
+	void RegisterTerrain(bool _isRegister);
+
+private:
+
+	//乱数生成器
+	std::mt19937 random = std::mt19937(12345);
+	//地形のx方向のサンプル数
+	int terrainWidth = 0;
+	//地形のz方向のサンプル数
+	int terrainDepth = 0;
+	//地形の高さ（x方向が連続）
+	std::vector<float> terrainHeights;
+	//地形の三角形（ワールド座標）
+	std::vector<Triangle> terrainTriangles;
+	//地形のオブジェクト
+	std::unique_ptr<InterfaceObject3d> terrainObject;
+	//地形のメッシュコライダー
+	std::unique_ptr<MeshCollider> terrainMesh;
+	//地形のハイトフィールドコライダー
+	std::unique_ptr<HeightfieldCollider> terrainHeightfield;
+};
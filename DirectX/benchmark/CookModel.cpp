@@ -0,0 +1,80 @@
+﻿#include "CookedModel.h"
+#include "ModelCooker.h"
+#include "ObjParser.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/// <summary>
+/// OBJをModel::CreateFromOBJと同じ規則で調理し、.cmdlに書き出す（ModelはOBJと同じディレクトリの同じ名前の.cmdlを読む）
+/// 使い方: CookModel ファイル.obj [-o 出力.cmdl] [--smoothing] [--no-optimize] [--levels 段数]
+/// </summary>
+int main(int argc, char* argv[])
+{
+	std::string filename;
+	std::string outputFilename;
+	bool smoothing = false;
+	bool optimize = true;
+	int lodNum = 1;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			outputFilename = argv[++i];
+		} else if (strcmp(argv[i], "--smoothing") == 0) {
+			smoothing = true;
+		} else if (strcmp(argv[i], "--no-optimize") == 0) {
+			optimize = false;
+		} else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) {
+			lodNum = atoi(argv[++i]);
+		} else if (filename.empty() && argv[i][0] != '-') {
+			filename = argv[i];
+		} else {
+			filename.clear();
+			break;
+		}
+	}
+	if (filename.empty() || lodNum < 1) {
+		fprintf(stderr, "usage: %s file.obj [-o file.cmdl] [--smoothing] [--no-optimize] [--levels num]\n", argv[0]);
+		return 1;
+	}
+	if (outputFilename.empty()) {
+		const size_t dot = filename.find_last_of('.');
+		outputFilename = (dot == std::string::npos ? filename : filename.substr(0, dot)) + ".cmdl";
+	}
+
+	const size_t slash = filename.find_last_of("/\\");
+	const std::string directoryPath = slash == std::string::npos ? "" : filename.substr(0, slash + 1);
+	ObjParser parser;
+	if (!parser.Load(directoryPath, filename.substr(directoryPath.size()))) {
+		fprintf(stderr, "failed to load %s\n", filename.c_str());
+		return 1;
+	}
+	parser.Weld();
+
+	CookedModel::CONTENT content;
+	ModelCooker::CookObj(parser, smoothing, optimize, lodNum, &content);
+	// Modelは元ファイルのハッシュが一致するときだけ.cmdlを使う
+	if (!ModelCooker::HashSource(directoryPath, filename.substr(directoryPath.size()), &content.sourceStamp)) {
+		fprintf(stderr, "failed to hash %s\n", filename.c_str());
+		return 1;
+	}
+	if (!CookedModel::Write(outputFilename, content)) {
+		fprintf(stderr, "failed to write %s\n", outputFilename.c_str());
+		return 1;
+	}
+
+	// 書き出したものを開き直して確かめる
+	CookedModel cooked;
+	if (!cooked.Open(outputFilename, sizeof(ModelCooker::VERTEX)) || cooked.GetHeader().sourceStamp != content.sourceStamp) {
+		fprintf(stderr, "failed to open %s\n", outputFilename.c_str());
+		return 1;
+	}
+	const CookedModel::HEADER& header = cooked.GetHeader();
+	printf("%s: meshes %u, materials %u, vertices %u, indices %u, lod ranges %u\n", outputFilename.c_str(),
+		header.meshNum, header.materialNum, header.vertexNum, header.indexNum, header.lodNum);
+	printf("bounds (%.3f, %.3f, %.3f) - (%.3f, %.3f, %.3f)\n",
+		header.boundsMin.x, header.boundsMin.y, header.boundsMin.z, header.boundsMax.x, header.boundsMax.y, header.boundsMax.z);
+	return 0;
+}
@@ -0,0 +1,86 @@
+﻿#include "MeshSimplifier.h"
+#include "ObjParser.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace DirectX;
+
+/// <summary>
+/// OBJの各グループ（Modelのメッシュ1つ分）の詳細度を生成し、段ごとの三角形の数と誤差を表示する
+/// 使い方: LodTool ファイル.obj [--levels 段数] [--reduction 1段ごとに残す割合]
+/// </summary>
+int main(int argc, char* argv[])
+{
+	std::string filename;
+	int lodNum = 5;
+	float reduction = 0.5f;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc) {
+			lodNum = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--reduction") == 0 && i + 1 < argc) {
+			reduction = static_cast<float>(atof(argv[++i]));
+		} else if (filename.empty() && argv[i][0] != '-') {
+			filename = argv[i];
+		} else {
+			filename.clear();
+			break;
+		}
+	}
+	if (filename.empty() || lodNum < 1 || reduction <= 0.0f || reduction >= 1.0f) {
+		fprintf(stderr, "usage: %s file.obj [--levels num] [--reduction ratio]\n", argv[0]);
+		return 1;
+	}
+
+	// Model::LoadModelと同じく、頂点をまとめてから使う
+	const size_t slash = filename.find_last_of("/\\");
+	const std::string directoryPath = slash == std::string::npos ? "" : filename.substr(0, slash + 1);
+	ObjParser parser;
+	if (!parser.Load(directoryPath, filename.substr(directoryPath.size()))) {
+		fprintf(stderr, "failed to load %s\n", filename.c_str());
+		return 1;
+	}
+	parser.Weld();
+
+	const std::vector<XMFLOAT3>& positions = parser.GetPositions();
+	const std::vector<ObjParser::CORNER>& corners = parser.GetCorners();
+	const std::vector<uint32_t>& indices = parser.GetIndices();
+
+	printf("%s: levels %d, reduction %.3f\n", filename.c_str(), lodNum, reduction);
+	printf("%-24s %5s %10s %8s %12s %10s\n", "group", "level", "triangles", "ratio", "error", "error/size");
+	for (const ObjParser::GROUP& group : parser.GetGroups())
+	{
+		if (group.indexNum == 0) { continue; }
+
+		// グループの頂点の座標（Mesh::VERTEXと同じく、まとめた頂点ごとに1つ）
+		std::vector<XMFLOAT3> groupPositions(group.cornerNum);
+		XMFLOAT3 boundsMin = positions[corners[group.cornerStart].position];
+		XMFLOAT3 boundsMax = boundsMin;
+		for (uint32_t i = 0; i < group.cornerNum; i++)
+		{
+			const XMFLOAT3& position = positions[corners[group.cornerStart + i].position];
+			groupPositions[i] = position;
+			boundsMin = { (std::min)(boundsMin.x, position.x), (std::min)(boundsMin.y, position.y), (std::min)(boundsMin.z, position.z) };
+			boundsMax = { (std::max)(boundsMax.x, position.x), (std::max)(boundsMax.y, position.y), (std::max)(boundsMax.z, position.z) };
+		}
+		const float size = (std::max)((std::max)(boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y), boundsMax.z - boundsMin.z);
+
+		std::vector<uint32_t> lodIndices;
+		std::vector<MeshSimplifier::LOD> lods;
+		MeshSimplifier::GenerateLods(&indices[group.indexStart], group.indexNum, groupPositions.data(), groupPositions.size(), sizeof(XMFLOAT3),
+			lodNum, reduction, &lodIndices, &lods);
+
+		for (size_t i = 0; i < lods.size(); i++)
+		{
+			printf("%-24s %5d %10u %8.3f %12.6f %10.6f\n", group.name.empty() ? "(default)" : group.name.c_str(), static_cast<int>(i),
+				lods[i].indexNum / 3, static_cast<double>(lods[i].indexNum) / lods[0].indexNum, lods[i].error,
+				size > 0.0f ? lods[i].error / size : 0.0f);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,862 @@
+﻿#include "ModelScenarios.h"
+#include "CookedModel.h"
+#include "MeshCollider.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ModelCooker.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+using namespace DirectX;
+
+namespace
+{
+	/// <summary>
+	/// 以前のModel::LoadModelの読み込み（テクスチャありのマテリアルの場合）
+	/// （1行ごと・面の頂点ごとにistringstreamを作り、番号はunsigned shortで読む）
+	/// </summary>
+	/// <param name="_filename">.objファイル名</param>
+	/// <param name="_vertices">頂点（出力用）</param>
+	/// <param name="_indices">インデックス（出力用）</param>
+	/// <returns>成功か</returns>
+	bool LoadObjLegacy(const std::string& _filename, std::vector<ModelScenarios::VERTEX>* _vertices, std::vector<uint32_t>* _indices)
+	{
+		std::ifstream file;
+		file.open(_filename);
+		if (file.fail()) { return false; }
+
+		int indexCountTex = 0;
+		std::vector<XMFLOAT3> positions;
+		std::vector<XMFLOAT3> normals;
+		std::vector<XMFLOAT2> texcoords;
+		std::string line;
+		while (std::getline(file, line)) {
+			std::istringstream line_stream(line);
+			std::string key;
+			std::getline(line_stream, key, ' ');
+
+			if (key == "v") {
+				XMFLOAT3 position{};
+				line_stream >> position.x;
+				line_stream >> position.y;
+				line_stream >> position.z;
+				positions.emplace_back(position);
+			}
+			if (key == "vt") {
+				XMFLOAT2 texcoord{};
+				line_stream >> texcoord.x;
+				line_stream >> texcoord.y;
+				texcoord.y = 1.0f - texcoord.y;
+				texcoords.emplace_back(texcoord);
+			}
+			if (key == "vn") {
+				XMFLOAT3 normal{};
+				line_stream >> normal.x;
+				line_stream >> normal.y;
+				line_stream >> normal.z;
+				normals.emplace_back(normal);
+			}
+			if (key == "f") {
+				int faceIndexCount = 0;
+				std::string index_string;
+				while (std::getline(line_stream, index_string, ' ')) {
+					std::istringstream index_stream(index_string);
+					unsigned short indexPosition, indexNormal, indexTexcoord;
+					index_stream >> indexPosition;
+					index_stream.seekg(1, std::ios_base::cur);
+					index_stream >> indexTexcoord;
+					index_stream.seekg(1, std::ios_base::cur);
+					index_stream >> indexNormal;
+					ModelScenarios::VERTEX vertex{};
+					vertex.pos = positions[indexPosition - 1];
+					vertex.normal = normals[indexNormal - 1];
+					vertex.uv = texcoords[indexTexcoord - 1];
+					_vertices->push_back(vertex);
+					if (faceIndexCount >= 3) {
+						_indices->push_back(indexCountTex - 1);
+						_indices->push_back(indexCountTex);
+						_indices->push_back(indexCountTex - 3);
+					} else {
+						_indices->push_back(indexCountTex);
+					}
+					indexCountTex++;
+					faceIndexCount++;
+				}
+			}
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// 2つの頂点の成分ごとの差の最大値
+	/// </summary>
+	float GetVertexDifference(const ModelScenarios::VERTEX& _a, const ModelScenarios::VERTEX& _b)
+	{
+		const float* a = &_a.pos.x;
+		const float* b = &_b.pos.x;
+		float difference = 0.0f;
+		for (size_t i = 0; i < sizeof(ModelScenarios::VERTEX) / sizeof(float); i++)
+		{
+			difference = (std::max)(difference, std::fabs(a[i] - b[i]));
+		}
+		return difference;
+	}
+
+	/// <summary>
+	/// 三角形を、向きを保ったまま最小の番号が先頭になるように回した組の一覧（順番によらない比較用）
+	/// </summary>
+	std::vector<std::array<uint32_t, 3>> GetSortedTriangles(const std::vector<uint32_t>& _indices)
+	{
+		std::vector<std::array<uint32_t, 3>> triangles(_indices.size() / 3);
+		for (size_t i = 0; i < triangles.size(); i++)
+		{
+			const uint32_t* triangle = &_indices[i * 3];
+			const int first = triangle[0] <= triangle[1] && triangle[0] <= triangle[2] ? 0 : (triangle[1] <= triangle[2] ? 1 : 2);
+			triangles[i] = { triangle[first], triangle[(first + 1) % 3], triangle[(first + 2) % 3] };
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	/// <summary>
+	/// 起伏のある球を立方体状に並べた1つのメッシュを作る（どの向きから見ても球が数個重なる）
+	/// </summary>
+	/// <param name="_sideNum">1辺に並べる球の数</param>
+	/// <param name="_segmentNum">球の緯度方向の分割数（経度方向はその2倍）</param>
+	/// <param name="_random">起伏に使う乱数</param>
+	/// <param name="_positions">頂点の座標（出力用）</param>
+	/// <param name="_indices">インデックス（出力用、三角形の外積が球の外を向く）</param>
+	void CreateSphereLattice(int _sideNum, int _segmentNum, std::mt19937* _random, std::vector<XMFLOAT3>* _positions, std::vector<uint32_t>* _indices)
+	{
+		std::uniform_real_distribution<float> bumpRange(0.9f, 1.1f);
+		const float radius = 0.45f;
+		const int sectorNum = _segmentNum * 2;
+		for (int sphere = 0; sphere < _sideNum * _sideNum * _sideNum; sphere++)
+		{
+			const XMFLOAT3 center = {
+				static_cast<float>(sphere % _sideNum),
+				static_cast<float>(sphere / _sideNum % _sideNum),
+				static_cast<float>(sphere / (_sideNum * _sideNum)) };
+			const uint32_t base = static_cast<uint32_t>(_positions->size());
+
+			//両極と、その間の緯線ごとの頂点
+			auto addVertex = [&](float _y, float _ringRadius, float _angle)
+			{
+				const float bump = radius * bumpRange(*_random);
+				_positions->push_back({ center.x + std::cos(_angle) * _ringRadius * bump, center.y + _y * bump, center.z + std::sin(_angle) * _ringRadius * bump });
+			};
+			addVertex(1.0f, 0.0f, 0.0f);
+			for (int ring = 1; ring < _segmentNum; ring++)
+			{
+				const float latitude = XM_PI * ring / _segmentNum;
+				for (int sector = 0; sector < sectorNum; sector++)
+				{
+					addVertex(std::cos(latitude), std::sin(latitude), 2.0f * XM_PI * sector / sectorNum);
+				}
+			}
+			addVertex(-1.0f, 0.0f, 0.0f);
+
+			const uint32_t bottom = static_cast<uint32_t>(_positions->size()) - 1;
+			auto ringVertex = [&](int _ring, int _sector) { return base + 1 + (_ring - 1) * sectorNum + _sector % sectorNum; };
+			auto addTriangle = [&](uint32_t _a, uint32_t _b, uint32_t _c)
+			{
+				//外積が球の中心から外を向くように向きを揃える
+				const XMFLOAT3& p0 = (*_positions)[_a];
+				const XMFLOAT3& p1 = (*_positions)[_b];
+				const XMFLOAT3& p2 = (*_positions)[_c];
+				const XMFLOAT3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+				const XMFLOAT3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+				const XMFLOAT3 cross = { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+				const bool isOutward = cross.x * (p0.x - center.x) + cross.y * (p0.y - center.y) + cross.z * (p0.z - center.z) >= 0.0f;
+				_indices->insert(_indices->end(), { _a, isOutward ? _b : _c, isOutward ? _c : _b });
+			};
+			for (int sector = 0; sector < sectorNum; sector++)
+			{
+				addTriangle(base, ringVertex(1, sector), ringVertex(1, sector + 1));
+				for (int ring = 1; ring + 1 < _segmentNum; ring++)
+				{
+					addTriangle(ringVertex(ring, sector), ringVertex(ring + 1, sector), ringVertex(ring + 1, sector + 1));
+					addTriangle(ringVertex(ring, sector), ringVertex(ring + 1, sector + 1), ringVertex(ring, sector + 1));
+				}
+				addTriangle(bottom, ringVertex(_segmentNum - 1, sector + 1), ringVertex(_segmentNum - 1, sector));
+			}
+		}
+	}
+
+	/// <summary>
+	/// オーバードローの計測（いくつかの向きから平行投影で裏面を除いて描き、深度テストを通った数を画素の数で割る）
+	/// </summary>
+	/// <param name="_indices">インデックス</param>
+	/// <param name="_positions">頂点の座標</param>
+	/// <param name="_resolution">1辺の画素数</param>
+	/// <returns>描いた画素あたりの塗った回数（1が最良）</returns>
+	float AnalyzeOverdraw(const std::vector<uint32_t>& _indices, const std::vector<XMFLOAT3>& _positions, int _resolution)
+	{
+		//座標軸の6方向と、立方体の角の8方向から見る
+		std::vector<XMFLOAT3> directions;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			for (float sign : { 1.0f, -1.0f })
+			{
+				XMFLOAT3 direction = {};
+				(&direction.x)[axis] = sign;
+				directions.push_back(direction);
+			}
+		}
+		const float corner = 1.0f / std::sqrt(3.0f);
+		for (int i = 0; i < 8; i++)
+		{
+			directions.push_back({ (i & 1) ? corner : -corner, (i & 2) ? corner : -corner, (i & 4) ? corner : -corner });
+		}
+
+		long long shadedNum = 0;
+		long long coveredNum = 0;
+		std::vector<float> depths;
+		std::vector<XMFLOAT3> screens(_positions.size());
+		for (const XMFLOAT3& direction : directions)
+		{
+			//見る向きに垂直な2軸（画面の横と縦）を作り、手前ほど深度が小さくなるようにする
+			const XMVECTOR axisZ = XMLoadFloat3(&direction);
+			const XMVECTOR up = std::fabs(direction.y) > 0.9f ? XMVECTOR{ 1, 0, 0, 0 } : XMVECTOR{ 0, 1, 0, 0 };
+			const XMVECTOR axisX = XMVector3Normalize(XMVector3Cross(up, axisZ));
+			const XMVECTOR axisY = XMVector3Cross(axisZ, axisX);
+			float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX;
+			for (size_t i = 0; i < _positions.size(); i++)
+			{
+				const XMVECTOR position = XMLoadFloat3(&_positions[i]);
+				screens[i] = { XMVectorGetX(XMVector3Dot(position, axisX)), XMVectorGetX(XMVector3Dot(position, axisY)), -XMVectorGetX(XMVector3Dot(position, axisZ)) };
+				minX = (std::min)(minX, screens[i].x);
+				maxX = (std::max)(maxX, screens[i].x);
+				minY = (std::min)(minY, screens[i].y);
+				maxY = (std::max)(maxY, screens[i].y);
+			}
+			const float scale = (_resolution - 1) / (std::max)((std::max)(maxX - minX, maxY - minY), FLT_MIN);
+			for (XMFLOAT3& screen : screens)
+			{
+				screen.x = (screen.x - minX) * scale;
+				screen.y = (screen.y - minY) * scale;
+			}
+
+			depths.assign(static_cast<size_t>(_resolution) * _resolution, FLT_MAX);
+			for (size_t i = 0; i + 2 < _indices.size(); i += 3)
+			{
+				const XMFLOAT3& s0 = screens[_indices[i + 0]];
+				const XMFLOAT3& s1 = screens[_indices[i + 1]];
+				const XMFLOAT3& s2 = screens[_indices[i + 2]];
+
+				//外積が見る向きを向いている面だけ描く（画面上の面積の符号で判定する）
+				const float area = (s1.x - s0.x) * (s2.y - s0.y) - (s2.x - s0.x) * (s1.y - s0.y);
+				if (area <= 0.0f) { continue; }
+				const float invArea = 1.0f / area;
+
+				const int beginX = (std::max)(static_cast<int>(std::ceil((std::min)({ s0.x, s1.x, s2.x }) - 0.5f)), 0);
+				const int endX = (std::min)(static_cast<int>(std::floor((std::max)({ s0.x, s1.x, s2.x }) - 0.5f)), _resolution - 1);
+				const int beginY = (std::max)(static_cast<int>(std::ceil((std::min)({ s0.y, s1.y, s2.y }) - 0.5f)), 0);
+				const int endY = (std::min)(static_cast<int>(std::floor((std::max)({ s0.y, s1.y, s2.y }) - 0.5f)), _resolution - 1);
+				for (int y = beginY; y <= endY; y++)
+				{
+					const float py = y + 0.5f;
+					for (int x = beginX; x <= endX; x++)
+					{
+						const float px = x + 0.5f;
+						const float w0 = ((s2.x - s1.x) * (py - s1.y) - (s2.y - s1.y) * (px - s1.x)) * invArea;
+						const float w1 = ((s0.x - s2.x) * (py - s2.y) - (s0.y - s2.y) * (px - s2.x)) * invArea;
+						const float w2 = 1.0f - w0 - w1;
+						if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) { continue; }
+
+						const float depth = w0 * s0.z + w1 * s1.z + w2 * s2.z;
+						float& pixelDepth = depths[static_cast<size_t>(y) * _resolution + x];
+						if (depth >= pixelDepth) { continue; }
+						if (pixelDepth == FLT_MAX) { coveredNum++; }
+						pixelDepth = depth;
+						shadedNum++;
+					}
+				}
+			}
+		}
+		return coveredNum > 0 ? static_cast<float>(shadedNum) / coveredNum : 0.0f;
+	}
+}
+
+void ModelScenarios::RunObjParser(BenchmarkReport* _report, int _gridNum)
+{
+	//以前の読み込みはunsigned shortの番号なので、65535頂点未満の格子で結果を比較する
+	const std::string smallFilename = "obj_parser_small.obj";
+	const std::string largeFilename = "obj_parser_large.obj";
+	if (!WriteGridObj(smallFilename, 200) || !WriteGridObj(largeFilename, _gridNum)) {
+		fprintf(stderr, "failed to write obj files, obj_parser scenario is skipped\n");
+		return;
+	}
+
+	float maxDifference = 0.0f;
+	{
+		std::vector<VERTEX> legacyVertices;
+		std::vector<uint32_t> legacyIndices;
+		LoadObjLegacy(smallFilename, &legacyVertices, &legacyIndices);
+		ObjParser parser;
+		parser.Load("", smallFilename);
+		std::vector<VERTEX> vertices;
+		std::vector<uint32_t> indices;
+		ExpandVertices(parser, &vertices, &indices);
+		if (vertices.size() != legacyVertices.size() || indices != legacyIndices) {
+			maxDifference = INFINITY;
+		}
+		else {
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				maxDifference = (std::max)(maxDifference, GetVertexDifference(vertices[i], legacyVertices[i]));
+			}
+		}
+	}
+
+	//以前の読み込み
+	std::vector<VERTEX> legacyVertices;
+	std::vector<uint32_t> legacyIndices;
+	BenchmarkTimer timer;
+	LoadObjLegacy(largeFilename, &legacyVertices, &legacyIndices);
+	const double legacyTime = timer.GetNanoseconds();
+
+	//ObjParserでの解析と、頂点への展開
+	ObjParser parser;
+	timer.Reset();
+	const bool isLoaded = parser.Load("", largeFilename);
+	const double parseTime = timer.GetNanoseconds();
+	std::vector<VERTEX> vertices;
+	std::vector<uint32_t> indices;
+	ExpandVertices(parser, &vertices, &indices);
+	const double loadTime = timer.GetNanoseconds();
+
+	//以前の読み込みで、番号が65535を超えて別の頂点を指した数
+	size_t legacyWrongNum = 0;
+	for (size_t i = 0; i < (std::min)(vertices.size(), legacyVertices.size()); i++)
+	{
+		if (GetVertexDifference(vertices[i], legacyVertices[i]) > 1e-5f) { legacyWrongNum++; }
+	}
+
+	std::ifstream sizeFile(largeFilename, std::ios::binary | std::ios::ate);
+	const double fileSize = static_cast<double>(sizeFile.tellg());
+	sizeFile.close();
+	std::remove(smallFilename.c_str());
+	std::remove((smallFilename.substr(0, smallFilename.size() - 4) + ".mtl").c_str());
+	std::remove(largeFilename.c_str());
+	std::remove((largeFilename.substr(0, largeFilename.size() - 4) + ".mtl").c_str());
+
+	_report->BeginScenario("obj_parser_" + std::to_string(_gridNum));
+	_report->AddValue("loaded", isLoaded ? 1 : 0);
+	_report->AddValue("positions", static_cast<double>(parser.GetPositions().size()));
+	_report->AddValue("triangles", static_cast<double>(indices.size() / 3));
+	_report->AddValue("file_mb", fileSize / (1024.0 * 1024.0));
+	_report->AddValue("legacy_ms", legacyTime / 1e6);
+	_report->AddValue("parse_ms", parseTime / 1e6);
+	_report->AddValue("parse_and_expand_ms", loadTime / 1e6);
+	_report->AddValue("parse_mb_per_s", fileSize / (1024.0 * 1024.0) / (parseTime / 1e9));
+	_report->AddValue("speedup", legacyTime / loadTime);
+	_report->AddValue("small_max_difference", maxDifference);
+	_report->AddValue("legacy_wrong_vertices", static_cast<double>(legacyWrongNum));
+}
+
+void ModelScenarios::RunVertexWeld(BenchmarkReport* _report, int _gridNum)
+{
+	const std::string filename = "vertex_weld.obj";
+	if (!WriteGridObj(filename, _gridNum)) {
+		fprintf(stderr, "failed to write obj file, vertex_weld scenario is skipped\n");
+		return;
+	}
+	ObjParser parser;
+	const bool isLoaded = parser.Load("", filename);
+	std::remove(filename.c_str());
+	std::remove((filename.substr(0, filename.size() - 4) + ".mtl").c_str());
+
+	//結合前（面の頂点ごとに頂点を作る）
+	std::vector<VERTEX> vertices;
+	std::vector<uint32_t> indices;
+	ExpandVertices(parser, &vertices, &indices);
+
+	//結合
+	BenchmarkTimer timer;
+	parser.Weld();
+	const double weldTime = timer.GetNanoseconds();
+	std::vector<VERTEX> weldedVertices;
+	std::vector<uint32_t> weldedIndices;
+	ExpandVertices(parser, &weldedVertices, &weldedIndices);
+
+	//三角形ごとに同じ頂点を指しているか
+	float maxDifference = indices.size() == weldedIndices.size() ? 0.0f : INFINITY;
+	for (size_t i = 0; i < (std::min)(indices.size(), weldedIndices.size()); i++)
+	{
+		maxDifference = (std::max)(maxDifference, GetVertexDifference(vertices[indices[i]], weldedVertices[weldedIndices[i]]));
+	}
+
+	//メッシュコライダーの構築
+	auto buildCollider = [](const std::vector<VERTEX>& _vertices, const std::vector<uint32_t>& _indices) {
+		std::vector<Mesh::VERTEX> meshVertices(_vertices.size());
+		for (size_t i = 0; i < _vertices.size(); i++)
+		{
+			meshVertices[i].pos = _vertices[i].pos;
+			meshVertices[i].normal = _vertices[i].normal;
+			meshVertices[i].uv = _vertices[i].uv;
+		}
+		const std::vector<unsigned long> meshIndices(_indices.begin(), _indices.end());
+		MeshCollider collider;
+		BenchmarkTimer timer;
+		collider.ConstructTriangles(meshVertices, meshIndices);
+		return timer.GetNanoseconds();
+	};
+	const double colliderTime = buildCollider(vertices, indices);
+	const double weldedColliderTime = buildCollider(weldedVertices, weldedIndices);
+
+	_report->BeginScenario("vertex_weld_" + std::to_string(_gridNum));
+	_report->AddValue("loaded", isLoaded ? 1 : 0);
+	_report->AddValue("triangles", static_cast<double>(indices.size() / 3));
+	_report->AddValue("vertices", static_cast<double>(vertices.size()));
+	_report->AddValue("welded_vertices", static_cast<double>(weldedVertices.size()));
+	_report->AddValue("vertex_buffer_mb", vertices.size() * sizeof(VERTEX) / (1024.0 * 1024.0));
+	_report->AddValue("welded_vertex_buffer_mb", weldedVertices.size() * sizeof(VERTEX) / (1024.0 * 1024.0));
+	_report->AddValue("weld_ms", weldTime / 1e6);
+	_report->AddValue("collider_ms", colliderTime / 1e6);
+	_report->AddValue("welded_collider_ms", weldedColliderTime / 1e6);
+	_report->AddValue("max_difference", maxDifference);
+}
+
+void ModelScenarios::RunMeshOptimizer(BenchmarkReport* _report, int _gridNum)
+{
+	const std::string filename = "mesh_optimizer.obj";
+	if (!WriteGridObj(filename, _gridNum)) {
+		fprintf(stderr, "failed to write obj file, mesh_optimizer scenario is skipped\n");
+		return;
+	}
+	ObjParser parser;
+	const bool isLoaded = parser.Load("", filename);
+	std::remove(filename.c_str());
+	std::remove((filename.substr(0, filename.size() - 4) + ".mtl").c_str());
+	parser.Weld();
+	std::vector<VERTEX> vertices;
+	std::vector<uint32_t> fileIndices;
+	ExpandVertices(parser, &vertices, &fileIndices);
+	const size_t vertexNum = vertices.size();
+	const MeshOptimizer::VERTEX_CACHE_STATISTICS fileStatistics = MeshOptimizer::AnalyzeVertexCache(fileIndices.data(), fileIndices.size(), vertexNum);
+
+	//格子のファイルは初めから並びが良いので、三角形と頂点の順番を乱したものから始める
+	std::vector<uint32_t> triangleOrder(fileIndices.size() / 3);
+	std::iota(triangleOrder.begin(), triangleOrder.end(), 0);
+	std::shuffle(triangleOrder.begin(), triangleOrder.end(), random);
+	std::vector<uint32_t> vertexOrder(vertexNum);
+	std::iota(vertexOrder.begin(), vertexOrder.end(), 0);
+	std::shuffle(vertexOrder.begin(), vertexOrder.end(), random);
+	std::vector<uint32_t> indices(fileIndices.size());
+	for (size_t i = 0; i < triangleOrder.size(); i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			indices[i * 3 + j] = vertexOrder[fileIndices[triangleOrder[i] * 3 + j]];
+		}
+	}
+	const std::vector<VERTEX> fileVertices = vertices;
+	for (size_t i = 0; i < vertexNum; i++)
+	{
+		vertices[vertexOrder[i]] = fileVertices[i];
+	}
+	const std::vector<std::array<uint32_t, 3>> triangles = GetSortedTriangles(indices);
+	const MeshOptimizer::VERTEX_CACHE_STATISTICS shuffledStatistics = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexNum);
+
+	//ModelCooker::CookObjと同じ順に最適化する
+	BenchmarkTimer timer;
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertexNum);
+	const double vertexCacheTime = timer.GetNanoseconds();
+	const MeshOptimizer::VERTEX_CACHE_STATISTICS vertexCacheStatistics = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexNum);
+	timer.Reset();
+	const size_t clusterNum = MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), &vertices[0].pos, vertexNum, sizeof(VERTEX));
+	const double overdrawTime = timer.GetNanoseconds();
+	const MeshOptimizer::VERTEX_CACHE_STATISTICS overdrawStatistics = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexNum);
+
+	//頂点フェッチの前後で、読んだキャッシュラインの無駄
+	const float overfetch = MeshOptimizer::AnalyzeVertexFetch(indices.data(), indices.size(), vertexNum, sizeof(VERTEX));
+	std::vector<uint32_t> remap;
+	timer.Reset();
+	const size_t usedNum = MeshOptimizer::OptimizeVertexFetch(indices.data(), indices.size(), vertexNum, &remap);
+	MeshOptimizer::RemapVertices(&vertices, remap, usedNum);
+	const double vertexFetchTime = timer.GetNanoseconds();
+	const float optimizedOverfetch = MeshOptimizer::AnalyzeVertexFetch(indices.data(), indices.size(), usedNum, sizeof(VERTEX));
+
+	//元の番号に戻して、三角形（向きを含む）が全て残っているか
+	std::vector<uint32_t> inverse(usedNum);
+	for (size_t i = 0; i < remap.size(); i++)
+	{
+		if (remap[i] != MeshOptimizer::invalid_index) { inverse[remap[i]] = static_cast<uint32_t>(i); }
+	}
+	std::vector<uint32_t> originalIndices(indices.size());
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		originalIndices[i] = inverse[indices[i]];
+	}
+	const bool isPreserved = GetSortedTriangles(originalIndices) == triangles;
+
+	_report->BeginScenario("mesh_optimizer_" + std::to_string(_gridNum));
+	_report->AddValue("loaded", isLoaded ? 1 : 0);
+	_report->AddValue("triangles", static_cast<double>(indices.size() / 3));
+	_report->AddValue("vertices", static_cast<double>(vertexNum));
+	_report->AddValue("file_acmr", fileStatistics.acmr);
+	_report->AddValue("file_atvr", fileStatistics.atvr);
+	_report->AddValue("shuffled_acmr", shuffledStatistics.acmr);
+	_report->AddValue("shuffled_atvr", shuffledStatistics.atvr);
+	_report->AddValue("vertex_cache_acmr", vertexCacheStatistics.acmr);
+	_report->AddValue("vertex_cache_atvr", vertexCacheStatistics.atvr);
+	_report->AddValue("overdraw_acmr", overdrawStatistics.acmr);
+	_report->AddValue("overdraw_atvr", overdrawStatistics.atvr);
+	_report->AddValue("overdraw_clusters", static_cast<double>(clusterNum));
+	_report->AddValue("file_overfetch", MeshOptimizer::AnalyzeVertexFetch(fileIndices.data(), fileIndices.size(), vertexNum, sizeof(VERTEX)));
+	_report->AddValue("overfetch", overfetch);
+	_report->AddValue("vertex_fetch_overfetch", optimizedOverfetch);
+	_report->AddValue("vertex_cache_ms", vertexCacheTime / 1e6);
+	_report->AddValue("overdraw_ms", overdrawTime / 1e6);
+	_report->AddValue("vertex_fetch_ms", vertexFetchTime / 1e6);
+	_report->AddValue("triangles_preserved", isPreserved ? 1 : 0);
+}
+
+void ModelScenarios::RunOverdrawOptimizer(BenchmarkReport* _report, int _sideNum, int _segmentNum)
+{
+	std::vector<XMFLOAT3> positions;
+	std::vector<uint32_t> sourceIndices;
+	CreateSphereLattice(_sideNum, _segmentNum, &random, &positions, &sourceIndices);
+	const size_t vertexNum = positions.size();
+	const int resolution = 256;
+
+	//RunMeshOptimizerと同じく、三角形の順番を乱したものから始める
+	std::vector<uint32_t> triangleOrder(sourceIndices.size() / 3);
+	std::iota(triangleOrder.begin(), triangleOrder.end(), 0);
+	std::shuffle(triangleOrder.begin(), triangleOrder.end(), random);
+	std::vector<uint32_t> indices(sourceIndices.size());
+	for (size_t i = 0; i < triangleOrder.size(); i++)
+	{
+		std::copy(&sourceIndices[triangleOrder[i] * 3], &sourceIndices[triangleOrder[i] * 3] + 3, &indices[i * 3]);
+	}
+	const std::vector<std::array<uint32_t, 3>> triangles = GetSortedTriangles(indices);
+
+	MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertexNum);
+	const MeshOptimizer::VERTEX_CACHE_STATISTICS vertexCacheStatistics = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexNum);
+	const float vertexCacheOverdraw = AnalyzeOverdraw(indices, positions, resolution);
+
+	BenchmarkTimer timer;
+	const size_t clusterNum = MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), positions.data(), vertexNum, sizeof(XMFLOAT3));
+	const double overdrawTime = timer.GetNanoseconds();
+	const MeshOptimizer::VERTEX_CACHE_STATISTICS overdrawStatistics = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexNum);
+	const float optimizedOverdraw = AnalyzeOverdraw(indices, positions, resolution);
+	const bool isPreserved = GetSortedTriangles(indices) == triangles;
+
+	_report->BeginScenario("mesh_overdraw_" + std::to_string(_sideNum * _sideNum * _sideNum) + "_spheres");
+	_report->AddValue("triangles", static_cast<double>(indices.size() / 3));
+	_report->AddValue("vertices", static_cast<double>(vertexNum));
+	_report->AddValue("vertex_cache_acmr", vertexCacheStatistics.acmr);
+	_report->AddValue("overdraw_acmr", overdrawStatistics.acmr);
+	_report->AddValue("overdraw_clusters", static_cast<double>(clusterNum));
+	_report->AddValue("vertex_cache_overdraw", vertexCacheOverdraw);
+	_report->AddValue("optimized_overdraw", optimizedOverdraw);
+	_report->AddValue("overdraw_ms", overdrawTime / 1e6);
+	_report->AddCheck("triangles_preserved", isPreserved);
+	_report->AddCheck("overdraw_reduced", optimizedOverdraw < vertexCacheOverdraw);
+}
+
+void ModelScenarios::RunMeshSimplifier(BenchmarkReport* _report, int _gridNum, int _lodNum)
+{
+	const std::string filename = "mesh_simplifier.obj";
+	if (!WriteGridObj(filename, _gridNum)) {
+		fprintf(stderr, "failed to write obj file, mesh_simplifier scenario is skipped\n");
+		return;
+	}
+	ObjParser parser;
+	const bool isLoaded = parser.Load("", filename);
+	std::remove(filename.c_str());
+	std::remove((filename.substr(0, filename.size() - 4) + ".mtl").c_str());
+	parser.Weld();
+	std::vector<VERTEX> vertices;
+	std::vector<uint32_t> indices;
+	ExpandVertices(parser, &vertices, &indices);
+
+	//ModelCooker::CookObjと同じく、1段ごとに三角形を半分にする
+	std::vector<uint32_t> lodIndices;
+	std::vector<MeshSimplifier::LOD> lods;
+	BenchmarkTimer timer;
+	MeshSimplifier::GenerateLods(indices.data(), indices.size(), &vertices[0].pos, vertices.size(), sizeof(VERTEX), _lodNum, 0.5f, &lodIndices, &lods);
+	const double generateTime = timer.GetNanoseconds();
+
+	//各段の三角形が元の頂点だけを指し、潰れていないか
+	bool isValid = true;
+	for (size_t i = 1; i < lods.size(); i++)
+	{
+		const uint32_t* lodBegin = &lodIndices[lods[i].indexStart - indices.size()];
+		for (uint32_t j = 0; j < lods[i].indexNum; j += 3)
+		{
+			const uint32_t* triangle = lodBegin + j;
+			if (triangle[0] >= vertices.size() || triangle[1] >= vertices.size() || triangle[2] >= vertices.size()
+				|| triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0]) {
+				isValid = false;
+			}
+		}
+	}
+
+	_report->BeginScenario("mesh_simplifier_" + std::to_string(_gridNum));
+	_report->AddValue("loaded", isLoaded ? 1 : 0);
+	_report->AddValue("vertices", static_cast<double>(vertices.size()));
+	_report->AddValue("levels", static_cast<double>(lods.size()));
+	for (size_t i = 0; i < lods.size(); i++)
+	{
+		_report->AddValue("lod" + std::to_string(i) + "_triangles", lods[i].indexNum / 3);
+		_report->AddValue("lod" + std::to_string(i) + "_error", lods[i].error);
+	}
+	_report->AddValue("generate_ms", generateTime / 1e6);
+	_report->AddValue("valid", isValid ? 1 : 0);
+}
+
+void ModelScenarios::RunCookedModel(BenchmarkReport* _report, int _gridNum)
+{
+	const std::string filename = "cooked_model.obj";
+	const std::string cookedFilename = "cooked_model.cmdl";
+	if (!WriteGridObj(filename, _gridNum)) {
+		fprintf(stderr, "failed to write obj file, cooked_model scenario is skipped\n");
+		return;
+	}
+
+	//Model::LoadModelで.cmdlがないとき（解析・結合・平滑化・詳細度・最適化）
+	BenchmarkTimer timer;
+	ObjParser parser;
+	const bool isLoaded = parser.Load("", filename);
+	parser.Weld();
+	CookedModel::CONTENT content;
+	ModelCooker::CookObj(parser, true, true, 3, &content);
+	const double cookTime = timer.GetNanoseconds();
+
+	//元ファイルのハッシュ（.mtlだけを書き換えても変わるか）
+	timer.Reset();
+	const std::string materialFilename = filename.substr(0, filename.size() - 4) + ".mtl";
+	const bool isHashed = ModelCooker::HashSource("", filename, &content.sourceStamp);
+	const double hashTime = timer.GetNanoseconds();
+	bool isStampChanged = false;
+	if (FILE* fp = fopen(materialFilename.c_str(), "ab")) {
+		fputs("# edited\n", fp);
+		fclose(fp);
+		uint64_t editedStamp = 0;
+		isStampChanged = isHashed && ModelCooker::HashSource("", filename, &editedStamp) && editedStamp != content.sourceStamp;
+	}
+	std::remove(filename.c_str());
+	std::remove(materialFilename.c_str());
+	const bool isWritten = CookedModel::Write(cookedFilename, content);
+
+	//.cmdlがあるとき（メモリマップして、メッシュごとに頂点とインデックスをまとめてコピーする）
+	timer.Reset();
+	CookedModel cooked;
+	const bool isOpened = cooked.Open(cookedFilename, sizeof(VERTEX));
+	std::vector<VERTEX> vertices;
+	std::vector<uint32_t> indices;
+	if (isOpened)
+	{
+		const VERTEX* cookedVertices = reinterpret_cast<const VERTEX*>(cooked.GetVertices());
+		for (uint32_t i = 0; i < cooked.GetHeader().meshNum; i++)
+		{
+			const CookedModel::MESH& mesh = cooked.GetMeshes()[i];
+			vertices.insert(vertices.end(), cookedVertices + mesh.vertexStart, cookedVertices + mesh.vertexStart + mesh.vertexNum);
+			indices.insert(indices.end(), cooked.GetIndices() + mesh.indexStart, cooked.GetIndices() + mesh.indexStart + mesh.indexNum);
+		}
+	}
+	const double openTime = timer.GetNanoseconds();
+
+	//書き出した内容とメモリマップした内容が一致するか
+	const CookedModel::HEADER& header = cooked.GetHeader();
+	const bool isIdentical = isOpened &&
+		ModelCooker::IsMatch(header, true, true, 3) &&
+		header.vertexNum * header.vertexStride == content.vertices.size() &&
+		header.indexNum == content.indices.size() &&
+		header.meshNum == content.meshes.size() &&
+		header.materialNum == content.materials.size() &&
+		header.lodNum == content.lods.size() &&
+		header.sourceStamp == content.sourceStamp &&
+		memcmp(cooked.GetVertices(), content.vertices.data(), content.vertices.size()) == 0 &&
+		memcmp(cooked.GetIndices(), content.indices.data(), content.indices.size() * sizeof(uint32_t)) == 0 &&
+		memcmp(cooked.GetMeshes(), content.meshes.data(), content.meshes.size() * sizeof(CookedModel::MESH)) == 0 &&
+		memcmp(cooked.GetLods(), content.lods.data(), content.lods.size() * sizeof(MeshSimplifier::LOD)) == 0 &&
+		CookedModel::GetString(cooked.GetMaterials()[0].name) == "grid" &&
+		CookedModel::GetString(cooked.GetMaterials()[0].textureFilename) == "grid.png";
+	cooked.Close();
+
+	//途中で切れたファイルは開かない
+	MappedFile source;
+	bool isTruncatedRejected = false;
+	const std::string truncatedFilename = "cooked_model_truncated.cmdl";
+	if (source.Open(cookedFilename))
+	{
+		if (FILE* fp = fopen(truncatedFilename.c_str(), "wb")) {
+			fwrite(source.GetData(), 1, source.GetSize() / 2, fp);
+			fclose(fp);
+			CookedModel truncated;
+			isTruncatedRejected = !truncated.Open(truncatedFilename, sizeof(VERTEX));
+			std::remove(truncatedFilename.c_str());
+		}
+	}
+	const size_t fileSize = source.GetSize();
+	source.Close();
+
+	//頂点の形が違うファイルや、メッシュの頂点数以上のインデックスを持つファイルも開かない
+	CookedModel otherStride;
+	const bool isStrideRejected = !otherStride.Open(cookedFilename, sizeof(VERTEX) + sizeof(float));
+	std::remove(cookedFilename.c_str());
+	bool isBadIndexRejected = false;
+	if (!content.indices.empty())
+	{
+		const std::string badIndexFilename = "cooked_model_bad_index.cmdl";
+		CookedModel::CONTENT badIndexContent = content;
+		badIndexContent.indices.back() = badIndexContent.meshes.back().vertexNum;
+		CookedModel badIndex;
+		isBadIndexRejected = CookedModel::Write(badIndexFilename, badIndexContent) && !badIndex.Open(badIndexFilename, sizeof(VERTEX));
+		std::remove(badIndexFilename.c_str());
+	}
+
+	//スキン付きの内容（FbxModelの頂点と同じ64バイト、ボーン4本・30フレーム）の往復
+	CookedModel::CONTENT skinContent;
+	skinContent.flags = CookedModel::flag_skinned;
+	skinContent.vertexStride = 64;
+	skinContent.vertices.resize(skinContent.vertexStride * 3);
+	std::iota(skinContent.vertices.begin(), skinContent.vertices.end(), static_cast<uint8_t>(0));
+	skinContent.indices = { 0, 1, 2 };
+	skinContent.meshes.resize(1);
+	CookedModel::SetString(skinContent.meshes[0].name, "body");
+	skinContent.meshes[0].vertexNum = 3;
+	skinContent.meshes[0].indexNum = 3;
+	skinContent.materials.resize(1);
+	skinContent.bones.resize(4);
+	for (size_t i = 0; i < skinContent.bones.size(); i++)
+	{
+		CookedModel::SetString(skinContent.bones[i].name, "bone" + std::to_string(i));
+		XMStoreFloat4x4(&skinContent.bones[i].invInitialPose, XMMatrixTranslation(static_cast<float>(i), 0.0f, 0.0f));
+	}
+	skinContent.frameNum = 30;
+	skinContent.boneFrames.resize(skinContent.frameNum * skinContent.bones.size());
+	for (size_t i = 0; i < skinContent.boneFrames.size(); i++)
+	{
+		XMStoreFloat4x4(&skinContent.boneFrames[i], XMMatrixTranslation(0.0f, static_cast<float>(i), 0.0f));
+	}
+	const std::string skinFilename = "cooked_model_skin.cmdl";
+	CookedModel skin;
+	const bool isSkinRoundTrip = CookedModel::Write(skinFilename, skinContent) && skin.Open(skinFilename, skinContent.vertexStride) &&
+		skin.GetHeader().flags == CookedModel::flag_skinned &&
+		skin.GetHeader().boneNum == skinContent.bones.size() &&
+		skin.GetHeader().frameNum == skinContent.frameNum &&
+		memcmp(skin.GetVertices(), skinContent.vertices.data(), skinContent.vertices.size()) == 0 &&
+		memcmp(skin.GetBones(), skinContent.bones.data(), skinContent.bones.size() * sizeof(CookedModel::BONE)) == 0 &&
+		memcmp(skin.GetBoneFrames(), skinContent.boneFrames.data(), skinContent.boneFrames.size() * sizeof(XMFLOAT4X4)) == 0 &&
+		CookedModel::GetString(skin.GetBones()[3].name) == "bone3";
+	skin.Close();
+	std::remove(skinFilename.c_str());
+
+	_report->BeginScenario("cooked_model_" + std::to_string(_gridNum));
+	_report->AddValue("loaded", isLoaded && isWritten ? 1 : 0);
+	_report->AddValue("vertices", static_cast<double>(vertices.size()));
+	_report->AddValue("indices", static_cast<double>(indices.size()));
+	_report->AddValue("file_bytes", static_cast<double>(fileSize));
+	_report->AddValue("parse_cook_ms", cookTime / 1e6);
+	_report->AddValue("mapped_open_ms", openTime / 1e6);
+	_report->AddValue("source_hash_ms", hashTime / 1e6);
+	//.cmdlを使うときも元ファイルのハッシュは取るので、その分も含めて比べる
+	_report->AddValue("speedup", openTime + hashTime > 0.0 ? cookTime / (openTime + hashTime) : 0.0);
+	_report->AddCheck("identical", isIdentical);
+	_report->AddCheck("source_stamp_changed", isStampChanged);
+	_report->AddCheck("truncated_rejected", isTruncatedRejected);
+	_report->AddCheck("stride_rejected", isStrideRejected);
+	_report->AddCheck("bad_index_rejected", isBadIndexRejected);
+	_report->AddCheck("skin_round_trip", isSkinRoundTrip);
+}
+
+bool ModelScenarios::WriteGridObj(const std::string& _filename, int _gridNum)
+{
+	const std::string materialFilename = _filename.substr(0, _filename.size() - 4) + ".mtl";
+	FILE* fp = fopen(materialFilename.c_str(), "w");
+	if (!fp) { return false; }
+	fprintf(fp, "newmtl grid\n\tKa 0.3 0.3 0.3\n\tKd 0.8 0.8 0.8\n\tKs 0.0 0.0 0.0\n\tmap_Kd textures\\grid.png\n");
+	fclose(fp);
+
+	fp = fopen(_filename.c_str(), "w");
+	if (!fp) { return false; }
+	fprintf(fp, "# grid %d\nmtllib %s\n", _gridNum, materialFilename.c_str());
+
+	//起伏のある格子（頂点・UV・法線の番号は同じ）
+	std::uniform_real_distribution<float> heightRange(-0.5f, 0.5f);
+	const int sampleNum = _gridNum + 1;
+	for (int z = 0; z < sampleNum; z++)
+	{
+		for (int x = 0; x < sampleNum; x++)
+		{
+			fprintf(fp, "v %.6f %.6f %.6f\n", x * 0.25f, heightRange(random), z * -0.25f);
+		}
+	}
+	for (int z = 0; z < sampleNum; z++)
+	{
+		for (int x = 0; x < sampleNum; x++)
+		{
+			fprintf(fp, "vt %.6f %.6f\n", static_cast<float>(x) / _gridNum, static_cast<float>(z) / _gridNum);
+		}
+	}
+	for (int z = 0; z < sampleNum; z++)
+	{
+		for (int x = 0; x < sampleNum; x++)
+		{
+			const float nx = heightRange(random) * 0.2f;
+			const float nz = heightRange(random) * 0.2f;
+			const float length = std::sqrt(nx * nx + 1.0f + nz * nz);
+			fprintf(fp, "vn %.6f %.6f %.6f\n", nx / length, 1.0f / length, nz / length);
+		}
+	}
+
+	//4グループに分けて四角形を書く
+	const int groupNum = 4;
+	for (int group = 0; group < groupNum; group++)
+	{
+		fprintf(fp, "g part%d\nusemtl grid\n", group);
+		for (int z = _gridNum * group / groupNum; z < _gridNum * (group + 1) / groupNum; z++)
+		{
+			for (int x = 0; x < _gridNum; x++)
+			{
+				const int i0 = z * sampleNum + x + 1;
+				const int i1 = i0 + 1;
+				const int i2 = i1 + sampleNum;
+				const int i3 = i0 + sampleNum;
+				fprintf(fp, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", i0, i0, i0, i1, i1, i1, i2, i2, i2, i3, i3, i3);
+			}
+		}
+	}
+	fclose(fp);
+	return true;
+}
+
+void ModelScenarios::ExpandVertices(const ObjParser& _parser, std::vector<VERTEX>* _vertices, std::vector<uint32_t>* _indices)
+{
+	const std::vector<XMFLOAT3>& positions = _parser.GetPositions();
+	const std::vector<XMFLOAT3>& normals = _parser.GetNormals();
+	const std::vector<XMFLOAT2>& texcoords = _parser.GetTexcoords();
+	const std::vector<ObjParser::CORNER>& corners = _parser.GetCorners();
+	const std::vector<uint32_t>& indices = _parser.GetIndices();
+
+	_vertices->reserve(_vertices->size() + corners.size());
+	_indices->reserve(_indices->size() + indices.size());
+	for (const ObjParser::GROUP& group : _parser.GetGroups())
+	{
+		const uint32_t vertexStart = static_cast<uint32_t>(_vertices->size());
+		for (uint32_t i = 0; i < group.cornerNum; i++)
+		{
+			const ObjParser::CORNER& corner = corners[group.cornerStart + i];
+			VERTEX vertex{};
+			vertex.pos = positions[corner.position];
+			vertex.normal = corner.normal != ObjParser::invalid_index ? normals[corner.normal] : XMFLOAT3{ 0, 0, 1 };
+			vertex.uv = corner.texcoord != ObjParser::invalid_index ? texcoords[corner.texcoord] : XMFLOAT2{ 0, 0 };
+			_vertices->push_back(vertex);
+		}
+		for (uint32_t i = 0; i < group.indexNum; i++)
+		{
+			_indices->push_back(vertexStart + indices[group.indexStart + i]);
+		}
+	}
+}
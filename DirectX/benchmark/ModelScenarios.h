@@ -0,0 +1,93 @@
+﻿#pragma once
+
+#include "BenchmarkReport.h"
+#include "ObjParser.h"
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// モデル読み込み・加工のベンチマークシナリオ（描画を使わず、CPU側の処理だけを計測する）
+/// </summary>
+class ModelScenarios
+{
+public: // サブクラス
+
+	// Mesh::VERTEXと同じ並びの頂点
+	struct VERTEX
+	{
+		DirectX::XMFLOAT3 pos; // xyz座標
+		DirectX::XMFLOAT3 normal; // 法線ベクトル
+		DirectX::XMFLOAT2 uv; // uv座標
+	};
+
+public: // メンバ関数
+
+	/// <summary>
+	/// OBJの読み込み（1行ごとにistringstreamを作る以前の読み込みとObjParserの比較）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_gridNum">四角形を並べる1辺の数（三角形は2*_gridNum*_gridNum個）</param>
+	void RunObjParser(BenchmarkReport* _report, int _gridNum);
+
+	/// <summary>
+	/// 頂点の結合（面の頂点ごとの頂点とWeld後の頂点の数・メッシュコライダー構築時間の比較）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_gridNum">四角形を並べる1辺の数（三角形は2*_gridNum*_gridNum個）</param>
+	void RunVertexWeld(BenchmarkReport* _report, int _gridNum);
+
+	/// <summary>
+	/// 描画順の最適化（三角形を乱した順と、MeshOptimizerで並べ替えた後のACMR・ATVRの比較）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_gridNum">四角形を並べる1辺の数（三角形は2*_gridNum*_gridNum個）</param>
+	void RunMeshOptimizer(BenchmarkReport* _report, int _gridNum);
+
+	/// <summary>
+	/// オーバードローの最適化（起伏のある球を並べた立体で、描画順の並べ替え前後のオーバードローとACMRの比較）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_sideNum">1辺に並べる球の数</param>
+	/// <param name="_segmentNum">球の緯度方向の分割数（経度方向はその2倍）</param>
+	void RunOverdrawOptimizer(BenchmarkReport* _report, int _sideNum, int _segmentNum);
+
+	/// <summary>
+	/// 詳細度の生成（MeshSimplifierで段ごとに三角形を半分にしたときの三角形の数と誤差）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_gridNum">四角形を並べる1辺の数（三角形は2*_gridNum*_gridNum個）</param>
+	/// <param name="_lodNum">詳細度の段数</param>
+	void RunMeshSimplifier(BenchmarkReport* _report, int _gridNum, int _lodNum);
+
+	/// <summary>
+	/// 調理済みモデル（OBJの解析から調理までと、.cmdlをメモリマップして開く時間の比較・書き出した内容との一致・スキンの往復）
+	/// </summary>
+	/// <param name="_report">結果の追加先</param>
+	/// <param name="_gridNum">四角形を並べる1辺の数（三角形は2*_gridNum*_gridNum個）</param>
+	void RunCookedModel(BenchmarkReport* _report, int _gridNum);
+
+	/// <summary>
+	/// 格子状のOBJとMTLを書き出す（v/vt/vnの四角形、4グループ）
+	/// </summary>
+	/// <param name="_filename">.objファイル名（.mtlは拡張子を変えたもの）</param>
+	/// <param name="_gridNum">四角形を並べる1辺の数</param>
+	/// <returns>成功か</returns>
+	bool WriteGridObj(const std::string& _filename, int _gridNum);
+
+	/// <summary>
+	/// ObjParserの結果をModel::LoadModelと同じ規則で頂点に展開する（全グループをつなげる）
+	/// </summary>
+	/// <param name="_parser">解析済みのObjParser</param>
+	/// <param name="_vertices">頂点（出力用）</param>
+	/// <param name="_indices">インデックス（出力用、全体での番号）</param>
+	static void ExpandVertices(const ObjParser& _parser, std::vector<VERTEX>* _vertices, std::vector<uint32_t>* _indices);
+
+private:
+
+	//乱数生成器
+	std::mt19937 random = std::mt19937(12345);
+};
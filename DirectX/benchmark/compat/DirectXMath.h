@@ -0,0 +1,374 @@
+﻿#pragma once
+
+// MSVC以外でコライダーのソースをビルドするためのDirectXMath互換ヘッダ
+// （エンジンが使う関数だけをSSEで実装する。XMVECTORはMSVCの__m128と同じくm128_f32で成分を参照できる）
+
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+namespace DirectX
+{
+	const float XM_PI = 3.141592654f;
+
+	inline float XMConvertToRadians(float _degrees) { return _degrees * (XM_PI / 180.0f); }
+	inline float XMConvertToDegrees(float _radians) { return _radians * (180.0f / XM_PI); }
+
+	/// <summary>
+	/// 4成分ベクトル（__m128をMSVCと同じ名前の成分で参照できるよう共用体で包む）
+	/// </summary>
+	struct XMVECTOR
+	{
+		union
+		{
+			__m128 v;
+			float m128_f32[4];
+			uint32_t m128_u32[4];
+			int32_t m128_i32[4];
+		};
+
+		XMVECTOR() = default;
+		XMVECTOR(__m128 _v) : v(_v) {}
+		XMVECTOR(float _x, float _y = 0.0f, float _z = 0.0f, float _w = 0.0f) : v(_mm_set_ps(_w, _z, _y, _x)) {}
+		operator __m128() const { return v; }
+	};
+
+	using FXMVECTOR = const XMVECTOR;
+	using GXMVECTOR = const XMVECTOR;
+	using HXMVECTOR = const XMVECTOR&;
+	using CXMVECTOR = const XMVECTOR&;
+
+	/// <summary>
+	/// 4x4行列（行ベクトル形式）
+	/// </summary>
+	struct XMMATRIX
+	{
+		XMVECTOR r[4];
+
+		XMMATRIX() = default;
+		XMMATRIX(const XMVECTOR& _r0, const XMVECTOR& _r1, const XMVECTOR& _r2, const XMVECTOR& _r3) : r{ _r0, _r1, _r2, _r3 } {}
+		XMMATRIX(float _m00, float _m01, float _m02, float _m03,
+			float _m10, float _m11, float _m12, float _m13,
+			float _m20, float _m21, float _m22, float _m23,
+			float _m30, float _m31, float _m32, float _m33) :
+			r{ { _m00, _m01, _m02, _m03 }, { _m10, _m11, _m12, _m13 }, { _m20, _m21, _m22, _m23 }, { _m30, _m31, _m32, _m33 } } {}
+
+		XMMATRIX operator*(const XMMATRIX& _m) const;
+		XMMATRIX& operator*=(const XMMATRIX& _m) { *this = *this * _m; return *this; }
+	};
+
+	using FXMMATRIX = const XMMATRIX&;
+	using CXMMATRIX = const XMMATRIX&;
+
+	struct XMFLOAT2
+	{
+		float x, y;
+		XMFLOAT2() = default;
+		constexpr XMFLOAT2(float _x, float _y) : x(_x), y(_y) {}
+	};
+
+	struct XMFLOAT3
+	{
+		float x, y, z;
+		XMFLOAT3() = default;
+		constexpr XMFLOAT3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+	};
+
+	struct XMFLOAT4
+	{
+		float x, y, z, w;
+		XMFLOAT4() = default;
+		constexpr XMFLOAT4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+	};
+
+	struct alignas(16) XMFLOAT4A : public XMFLOAT4
+	{
+		XMFLOAT4A() = default;
+		constexpr XMFLOAT4A(float _x, float _y, float _z, float _w) : XMFLOAT4(_x, _y, _z, _w) {}
+	};
+
+	struct XMFLOAT4X4
+	{
+		float m[4][4];
+		XMFLOAT4X4() = default;
+	};
+
+	struct XMINT2
+	{
+		int32_t x, y;
+		XMINT2() = default;
+		constexpr XMINT2(int32_t _x, int32_t _y) : x(_x), y(_y) {}
+	};
+
+	struct XMUINT4
+	{
+		uint32_t x, y, z, w;
+		XMUINT4() = default;
+		constexpr XMUINT4(uint32_t _x, uint32_t _y, uint32_t _z, uint32_t _w) : x(_x), y(_y), z(_z), w(_w) {}
+	};
+
+	// 設定・取得
+
+	inline XMVECTOR XMVectorZero() { return _mm_setzero_ps(); }
+	inline XMVECTOR XMVectorReplicate(float _value) { return _mm_set1_ps(_value); }
+	inline XMVECTOR XMVectorSet(float _x, float _y, float _z, float _w) { return _mm_set_ps(_w, _z, _y, _x); }
+	inline XMVECTOR XMVectorSplatOne() { return _mm_set1_ps(1.0f); }
+	inline XMVECTOR XMVectorSplatX(FXMVECTOR _v) { return _mm_shuffle_ps(_v, _v, _MM_SHUFFLE(0, 0, 0, 0)); }
+	inline XMVECTOR XMVectorSplatY(FXMVECTOR _v) { return _mm_shuffle_ps(_v, _v, _MM_SHUFFLE(1, 1, 1, 1)); }
+	inline XMVECTOR XMVectorSplatZ(FXMVECTOR _v) { return _mm_shuffle_ps(_v, _v, _MM_SHUFFLE(2, 2, 2, 2)); }
+	inline XMVECTOR XMVectorSplatW(FXMVECTOR _v) { return _mm_shuffle_ps(_v, _v, _MM_SHUFFLE(3, 3, 3, 3)); }
+	inline XMVECTOR XMVectorSetW(FXMVECTOR _v, float _w) { XMVECTOR result = _v; result.m128_f32[3] = _w; return result; }
+	inline float XMVectorGetX(FXMVECTOR _v) { return _mm_cvtss_f32(_v); }
+	inline float XMVectorGetY(FXMVECTOR _v) { return _v.m128_f32[1]; }
+	inline float XMVectorGetZ(FXMVECTOR _v) { return _v.m128_f32[2]; }
+	inline float XMVectorGetW(FXMVECTOR _v) { return _v.m128_f32[3]; }
+
+	// 成分ごとの演算
+
+	inline XMVECTOR XMVectorAdd(FXMVECTOR _a, FXMVECTOR _b) { return _mm_add_ps(_a, _b); }
+	inline XMVECTOR XMVectorSubtract(FXMVECTOR _a, FXMVECTOR _b) { return _mm_sub_ps(_a, _b); }
+	inline XMVECTOR XMVectorMultiply(FXMVECTOR _a, FXMVECTOR _b) { return _mm_mul_ps(_a, _b); }
+	inline XMVECTOR XMVectorDivide(FXMVECTOR _a, FXMVECTOR _b) { return _mm_div_ps(_a, _b); }
+	inline XMVECTOR XMVectorMultiplyAdd(FXMVECTOR _a, FXMVECTOR _b, FXMVECTOR _c) { return _mm_add_ps(_mm_mul_ps(_a, _b), _c); }
+	inline XMVECTOR XMVectorNegativeMultiplySubtract(FXMVECTOR _a, FXMVECTOR _b, FXMVECTOR _c) { return _mm_sub_ps(_c, _mm_mul_ps(_a, _b)); }
+	inline XMVECTOR XMVectorScale(FXMVECTOR _v, float _scale) { return _mm_mul_ps(_v, _mm_set1_ps(_scale)); }
+	inline XMVECTOR XMVectorNegate(FXMVECTOR _v) { return _mm_sub_ps(_mm_setzero_ps(), _v); }
+	inline XMVECTOR XMVectorReciprocal(FXMVECTOR _v) { return _mm_div_ps(_mm_set1_ps(1.0f), _v); }
+	inline XMVECTOR XMVectorMin(FXMVECTOR _a, FXMVECTOR _b) { return _mm_min_ps(_a, _b); }
+	inline XMVECTOR XMVectorMax(FXMVECTOR _a, FXMVECTOR _b) { return _mm_max_ps(_a, _b); }
+	inline XMVECTOR XMVectorAbs(FXMVECTOR _v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), _v); }
+	inline XMVECTOR XMVectorSqrt(FXMVECTOR _v) { return _mm_sqrt_ps(_v); }
+	inline XMVECTOR XMVectorLerp(FXMVECTOR _a, FXMVECTOR _b, float _t) { return _mm_add_ps(_a, _mm_mul_ps(_mm_sub_ps(_b, _a), _mm_set1_ps(_t))); }
+
+	// 比較・ビット演算（比較結果は成分ごとに全bitが立つか0）
+
+	inline XMVECTOR XMVectorLess(FXMVECTOR _a, FXMVECTOR _b) { return _mm_cmplt_ps(_a, _b); }
+	inline XMVECTOR XMVectorLessOrEqual(FXMVECTOR _a, FXMVECTOR _b) { return _mm_cmple_ps(_a, _b); }
+	inline XMVECTOR XMVectorGreater(FXMVECTOR _a, FXMVECTOR _b) { return _mm_cmpgt_ps(_a, _b); }
+	inline XMVECTOR XMVectorGreaterOrEqual(FXMVECTOR _a, FXMVECTOR _b) { return _mm_cmpge_ps(_a, _b); }
+	inline XMVECTOR XMVectorEqual(FXMVECTOR _a, FXMVECTOR _b) { return _mm_cmpeq_ps(_a, _b); }
+	inline XMVECTOR XMVectorAndInt(FXMVECTOR _a, FXMVECTOR _b) { return _mm_and_ps(_a, _b); }
+	inline XMVECTOR XMVectorOrInt(FXMVECTOR _a, FXMVECTOR _b) { return _mm_or_ps(_a, _b); }
+	inline XMVECTOR XMVectorSelect(FXMVECTOR _a, FXMVECTOR _b, FXMVECTOR _control) { return _mm_or_ps(_mm_andnot_ps(_control, _a), _mm_and_ps(_b, _control)); }
+
+	// 4成分ベクトル
+
+	inline bool XMVector4GreaterOrEqual(FXMVECTOR _a, FXMVECTOR _b) { return _mm_movemask_ps(_mm_cmpge_ps(_a, _b)) == 0xf; }
+	inline bool XMVector4Less(FXMVECTOR _a, FXMVECTOR _b) { return _mm_movemask_ps(_mm_cmplt_ps(_a, _b)) == 0xf; }
+
+	// 3成分ベクトル
+
+	inline XMVECTOR XMVector3Dot(FXMVECTOR _a, FXMVECTOR _b)
+	{
+		const __m128 product = _mm_mul_ps(_a, _b);
+		const __m128 y = _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 z = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 dot = _mm_add_ss(_mm_add_ss(product, y), z);
+		return _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(0, 0, 0, 0));
+	}
+
+	inline XMVECTOR XMVector3Cross(FXMVECTOR _a, FXMVECTOR _b)
+	{
+		const __m128 aYZX = _mm_shuffle_ps(_a, _a, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 bZXY = _mm_shuffle_ps(_b, _b, _MM_SHUFFLE(3, 1, 0, 2));
+		const __m128 aZXY = _mm_shuffle_ps(_a, _a, _MM_SHUFFLE(3, 1, 0, 2));
+		const __m128 bYZX = _mm_shuffle_ps(_b, _b, _MM_SHUFFLE(3, 0, 2, 1));
+		XMVECTOR result = _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX));
+		result.m128_f32[3] = 0.0f;
+		return result;
+	}
+
+	inline XMVECTOR XMVector3LengthSq(FXMVECTOR _v) { return XMVector3Dot(_v, _v); }
+	inline XMVECTOR XMVector3Length(FXMVECTOR _v) { return _mm_sqrt_ps(XMVector3Dot(_v, _v)); }
+
+	inline XMVECTOR XMVector3Normalize(FXMVECTOR _v)
+	{
+		// 長さ0のベクトルはそのまま返す
+		const __m128 length = _mm_sqrt_ps(XMVector3Dot(_v, _v));
+		const __m128 isZero = _mm_cmpeq_ps(length, _mm_setzero_ps());
+		return _mm_andnot_ps(isZero, _mm_div_ps(_v, length));
+	}
+
+	inline XMVECTOR XMVector3Transform(FXMVECTOR _v, FXMMATRIX _m)
+	{
+		__m128 result = _mm_mul_ps(XMVectorSplatX(_v), _m.r[0]);
+		result = _mm_add_ps(result, _mm_mul_ps(XMVectorSplatY(_v), _m.r[1]));
+		result = _mm_add_ps(result, _mm_mul_ps(XMVectorSplatZ(_v), _m.r[2]));
+		return _mm_add_ps(result, _m.r[3]);
+	}
+
+	inline XMVECTOR XMVector3TransformNormal(FXMVECTOR _v, FXMMATRIX _m)
+	{
+		__m128 result = _mm_mul_ps(XMVectorSplatX(_v), _m.r[0]);
+		result = _mm_add_ps(result, _mm_mul_ps(XMVectorSplatY(_v), _m.r[1]));
+		return _mm_add_ps(result, _mm_mul_ps(XMVectorSplatZ(_v), _m.r[2]));
+	}
+
+	inline XMVECTOR XMVector3TransformCoord(FXMVECTOR _v, FXMMATRIX _m)
+	{
+		const XMVECTOR result = XMVector3Transform(_v, _m);
+		return _mm_div_ps(result, XMVectorSplatW(result));
+	}
+
+	inline XMVECTOR XMVector4Transform(FXMVECTOR _v, FXMMATRIX _m)
+	{
+		return _mm_add_ps(XMVector3TransformNormal(_v, _m), _mm_mul_ps(XMVectorSplatW(_v), _m.r[3]));
+	}
+
+	// 読み書き
+
+	inline XMVECTOR XMLoadFloat3(const XMFLOAT3* _source) { return _mm_set_ps(0.0f, _source->z, _source->y, _source->x); }
+	inline XMVECTOR XMLoadFloat4(const XMFLOAT4* _source) { return _mm_loadu_ps(&_source->x); }
+	inline XMMATRIX XMLoadFloat4x4(const XMFLOAT4X4* _source)
+	{
+		return XMMATRIX(_mm_loadu_ps(_source->m[0]), _mm_loadu_ps(_source->m[1]), _mm_loadu_ps(_source->m[2]), _mm_loadu_ps(_source->m[3]));
+	}
+	inline XMVECTOR XMLoadFloat4A(const XMFLOAT4A* _source) { return _mm_load_ps(&_source->x); }
+	inline void XMStoreFloat3(XMFLOAT3* _destination, FXMVECTOR _v) { *_destination = { _v.m128_f32[0], _v.m128_f32[1], _v.m128_f32[2] }; }
+	inline void XMStoreFloat4(XMFLOAT4* _destination, FXMVECTOR _v) { _mm_storeu_ps(&_destination->x, _v); }
+	inline void XMStoreFloat4A(XMFLOAT4A* _destination, FXMVECTOR _v) { _mm_store_ps(&_destination->x, _v); }
+	inline void XMStoreFloat4x4(XMFLOAT4X4* _destination, const XMMATRIX& _m)
+	{
+		for (int i = 0; i < 4; i++) { _mm_storeu_ps(_destination->m[i], _m.r[i]); }
+	}
+	inline void XMStoreUInt4(XMUINT4* _destination, FXMVECTOR _v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(&_destination->x), _mm_castps_si128(_v)); }
+
+	// 演算子
+
+	inline XMVECTOR operator+(FXMVECTOR _v) { return _v; }
+	inline XMVECTOR operator-(FXMVECTOR _v) { return XMVectorNegate(_v); }
+	inline XMVECTOR operator+(FXMVECTOR _a, FXMVECTOR _b) { return _mm_add_ps(_a, _b); }
+	inline XMVECTOR operator-(FXMVECTOR _a, FXMVECTOR _b) { return _mm_sub_ps(_a, _b); }
+	inline XMVECTOR operator*(FXMVECTOR _a, FXMVECTOR _b) { return _mm_mul_ps(_a, _b); }
+	inline XMVECTOR operator/(FXMVECTOR _a, FXMVECTOR _b) { return _mm_div_ps(_a, _b); }
+	inline XMVECTOR operator*(FXMVECTOR _v, float _s) { return _mm_mul_ps(_v, _mm_set1_ps(_s)); }
+	inline XMVECTOR operator*(float _s, FXMVECTOR _v) { return _mm_mul_ps(_v, _mm_set1_ps(_s)); }
+	inline XMVECTOR operator/(FXMVECTOR _v, float _s) { return _mm_div_ps(_v, _mm_set1_ps(_s)); }
+	inline XMVECTOR& operator+=(XMVECTOR& _a, FXMVECTOR _b) { _a = _a + _b; return _a; }
+	inline XMVECTOR& operator-=(XMVECTOR& _a, FXMVECTOR _b) { _a = _a - _b; return _a; }
+	inline XMVECTOR& operator*=(XMVECTOR& _a, FXMVECTOR _b) { _a = _a * _b; return _a; }
+	inline XMVECTOR& operator/=(XMVECTOR& _a, FXMVECTOR _b) { _a = _a / _b; return _a; }
+	inline XMVECTOR& operator*=(XMVECTOR& _a, float _s) { _a = _a * _s; return _a; }
+	inline XMVECTOR& operator/=(XMVECTOR& _a, float _s) { _a = _a / _s; return _a; }
+
+	// 行列
+
+	inline XMMATRIX XMMatrixIdentity()
+	{
+		return XMMATRIX(1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	inline XMMATRIX XMMatrixMultiply(FXMMATRIX _a, CXMMATRIX _b)
+	{
+		XMMATRIX result;
+		for (int i = 0; i < 4; i++)
+		{
+			result.r[i] = XMVector4Transform(_a.r[i], _b);
+		}
+		return result;
+	}
+
+	inline XMMATRIX XMMATRIX::operator*(const XMMATRIX& _m) const { return XMMatrixMultiply(*this, _m); }
+
+	inline XMMATRIX XMMatrixTranspose(FXMMATRIX _m)
+	{
+		XMMATRIX result = _m;
+		_MM_TRANSPOSE4_PS(result.r[0].v, result.r[1].v, result.r[2].v, result.r[3].v);
+		return result;
+	}
+
+	inline XMMATRIX XMMatrixInverse(XMVECTOR* _determinant, FXMMATRIX _m)
+	{
+		// 余因子展開で求める（正則でなければ全成分が無限大・NaNになる点は本家と同じ）
+		float m[16];
+		for (int i = 0; i < 4; i++)
+		{
+			_mm_storeu_ps(&m[i * 4], _m.r[i]);
+		}
+
+		float inv[16];
+		inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+		inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+		inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+		inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+		inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+		inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+		inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+		inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+		inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+		inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+		inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+		inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+		inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+		inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+		inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+		inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+		const float determinant = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+		if (_determinant) {
+			*_determinant = _mm_set1_ps(determinant);
+		}
+
+		const __m128 invDeterminant = _mm_set1_ps(1.0f / determinant);
+		XMMATRIX result;
+		for (int i = 0; i < 4; i++)
+		{
+			result.r[i] = _mm_mul_ps(_mm_loadu_ps(&inv[i * 4]), invDeterminant);
+		}
+		return result;
+	}
+
+	inline XMMATRIX XMMatrixTranslation(float _x, float _y, float _z)
+	{
+		return XMMATRIX(1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, _x, _y, _z, 1.0f);
+	}
+
+	inline XMMATRIX XMMatrixScaling(float _x, float _y, float _z)
+	{
+		return XMMATRIX(_x, 0.0f, 0.0f, 0.0f, 0.0f, _y, 0.0f, 0.0f, 0.0f, 0.0f, _z, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	inline XMMATRIX XMMatrixRotationX(float _angle)
+	{
+		const float s = std::sin(_angle);
+		const float c = std::cos(_angle);
+		return XMMATRIX(1.0f, 0.0f, 0.0f, 0.0f, 0.0f, c, s, 0.0f, 0.0f, -s, c, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	inline XMMATRIX XMMatrixRotationY(float _angle)
+	{
+		const float s = std::sin(_angle);
+		const float c = std::cos(_angle);
+		return XMMATRIX(c, 0.0f, -s, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, s, 0.0f, c, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	inline XMMATRIX XMMatrixRotationZ(float _angle)
+	{
+		const float s = std::sin(_angle);
+		const float c = std::cos(_angle);
+		return XMMATRIX(c, s, 0.0f, 0.0f, -s, c, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	inline XMMATRIX XMMatrixLookAtLH(FXMVECTOR _eye, FXMVECTOR _focus, FXMVECTOR _up)
+	{
+		const XMVECTOR axisZ = XMVector3Normalize(_focus - _eye);
+		const XMVECTOR axisX = XMVector3Normalize(XMVector3Cross(_up, axisZ));
+		const XMVECTOR axisY = XMVector3Cross(axisZ, axisX);
+		const XMVECTOR negEye = XMVectorNegate(_eye);
+		return XMMATRIX(
+			XMVectorGetX(axisX), XMVectorGetX(axisY), XMVectorGetX(axisZ), 0.0f,
+			XMVectorGetY(axisX), XMVectorGetY(axisY), XMVectorGetY(axisZ), 0.0f,
+			XMVectorGetZ(axisX), XMVectorGetZ(axisY), XMVectorGetZ(axisZ), 0.0f,
+			XMVectorGetX(XMVector3Dot(axisX, negEye)), XMVectorGetX(XMVector3Dot(axisY, negEye)), XMVectorGetX(XMVector3Dot(axisZ, negEye)), 1.0f);
+	}
+
+	inline XMMATRIX XMMatrixPerspectiveFovLH(float _fovAngleY, float _aspectRatio, float _nearZ, float _farZ)
+	{
+		const float height = 1.0f / std::tan(_fovAngleY * 0.5f);
+		const float width = height / _aspectRatio;
+		const float range = _farZ / (_farZ - _nearZ);
+		return XMMATRIX(width, 0.0f, 0.0f, 0.0f, 0.0f, height, 0.0f, 0.0f, 0.0f, 0.0f, range, 1.0f, 0.0f, 0.0f, -range * _nearZ, 0.0f);
+	}
+}
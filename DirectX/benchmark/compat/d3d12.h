@@ -0,0 +1,13 @@
+﻿#pragma once
+
+// MSVC以外でコライダーのソースをビルドするためのd3d12.h代替（コライダーが使う定数と関数のみ）
+
+#include <cstdio>
+
+#define D3D12_FLOAT32_MAX	( 3.402823466e+38f )
+
+inline int fopen_s(FILE** _fp, const char* _filename, const char* _mode)
+{
+	*_fp = fopen(_filename, _mode);
+	return *_fp ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+﻿#include "BenchmarkReport.h"
+#include "CollisionScenarios.h"
+#include "ModelScenarios.h"
+#include "ThreadPool.h"
+#include "SimdMath.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+/// <summary>
+/// 当たり判定とモデル読み込みのベンチマーク（描画を使わず、結果をJSONで出力する）
+/// 使い方: CollisionBenchmark [--quick] [--heightmap ハイトマップ画像] [--out 出力ファイル]
+/// </summary>
+int main(int argc, char* argv[])
+{
+	std::string heightmapFilename = "Resources/HeightMap/heightmap02.bmp";
+	std::string outputFilename;
+	bool isQuick = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--quick") == 0) {
+			isQuick = true;
+		} else if (strcmp(argv[i], "--heightmap") == 0 && i + 1 < argc) {
+			heightmapFilename = argv[++i];
+		} else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+			outputFilename = argv[++i];
+		} else {
+			fprintf(stderr, "usage: %s [--quick] [--heightmap file] [--out file]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	BenchmarkReport report;
+	report.SetInfo("benchmark", "collision");
+	report.SetInfo("format_version", "1");
+#if defined(_MSC_VER)
+	report.SetInfo("compiler", "msvc " + std::to_string(_MSC_VER));
+#elif defined(__clang__)
+	report.SetInfo("compiler", std::string("clang ") + __clang_version__);
+#elif defined(__GNUC__)
+	report.SetInfo("compiler", std::string("gcc ") + __VERSION__);
+#endif
+#ifdef NDEBUG
+	report.SetInfo("build", "release");
+#else
+	report.SetInfo("build", "debug");
+#endif
+	report.SetInfo("simd_backend", SimdMath::GetBackendName());
+	report.SetInfo("threads", std::to_string(ThreadPool::GetInstance()->GetThreadNum()));
+	report.SetInfo("heightmap", heightmapFilename);
+	report.SetInfo("mode", isQuick ? "quick" : "full");
+
+	CollisionScenarios scenarios;
+
+	//球の数ごとに、全フレーム計測する数と総当たりも計測する数
+	struct BROADPHASE_CASE
+	{
+		int colliderNum;
+		int frameNum;
+		int bruteForceFrameNum;
+	};
+	const BROADPHASE_CASE broadphaseCases[] = {
+		{ 100, 200, 200 },
+		{ 1000, 100, 20 },
+		{ 10000, 20, 2 },
+	};
+	const int scale = isQuick ? 10 : 1;
+	for (const BROADPHASE_CASE& broadphaseCase : broadphaseCases)
+	{
+		scenarios.RunBroadphase(&report, broadphaseCase.colliderNum,
+			(std::max)(broadphaseCase.frameNum / scale, 1), (std::max)(broadphaseCase.bruteForceFrameNum / scale, 1));
+	}
+
+	scenarios.RunSelfRemoval(&report);
+	scenarios.RunFrustumCulling(&report, 10000, 64 / scale);
+	scenarios.RunSimdMath(&report, 200000 / scale);
+	scenarios.RunTransformKernel(&report, 10000, 100 / scale);
+	scenarios.RunTransformSystem(&report, 10000, 100 / scale);
+	scenarios.RunQuaternionInterpolation(&report, 200000 / scale);
+
+	ModelScenarios modelScenarios;
+	modelScenarios.RunObjParser(&report, isQuick ? 300 : 1000);
+	modelScenarios.RunVertexWeld(&report, isQuick ? 300 : 1000);
+	modelScenarios.RunMeshOptimizer(&report, isQuick ? 300 : 1000);
+	modelScenarios.RunOverdrawOptimizer(&report, 4, isQuick ? 16 : 32);
+	modelScenarios.RunMeshSimplifier(&report, isQuick ? 300 : 1000, 5);
+	modelScenarios.RunCookedModel(&report, isQuick ? 300 : 1000);
+
+	if (scenarios.LoadTerrain(heightmapFilename)) {
+		scenarios.RunRayTriangleKernel(&report, 256 / scale, 16384);
+		scenarios.RunTerrainRaycast(&report, 100000 / scale);
+		scenarios.RunTerrainQueries(&report, 20000 / scale);
+	} else {
+		fprintf(stderr, "failed to load %s, terrain scenarios are skipped\n", heightmapFilename.c_str());
+	}
+
+	const std::string json = report.ToJson();
+	fputs(json.c_str(), stdout);
+	if (!outputFilename.empty() && !report.WriteJson(outputFilename)) {
+		fprintf(stderr, "failed to write %s\n", outputFilename.c_str());
+		return 1;
+	}
+
+	//確認に失敗した項目があれば終了コードで知らせる
+	for (const std::string& check : report.GetFailedChecks()) {
+		fprintf(stderr, "check failed: %s\n", check.c_str());
+	}
+	return report.GetFailedChecks().empty() ? 0 : 2;
+}
@@ -0,0 +1,22 @@
+﻿#pragma once
+
+// ベンチマーク用のHeightMap（HeightfieldColliderが参照する格子の頂点だけを持つ）
+
+#include "InterfaceObject3d.h"
+#include <vector>
+
+class HeightMap : public InterfaceObject3d
+{
+public:
+
+	int GetTerrainWidth() { return terrainWidth; }
+	int GetTerrainHeight() { return terrainHeight; }
+	const std::vector<XMFLOAT3>& GetHeightMapPositions() { return heightMap; }
+
+	// 格子の横幅
+	int terrainWidth = 0;
+	// 格子の縦幅
+	int terrainHeight = 0;
+	// 頂点座標
+	std::vector<XMFLOAT3> heightMap;
+};
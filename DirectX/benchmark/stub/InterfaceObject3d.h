@@ -0,0 +1,59 @@
+﻿#pragma once
+
+// ベンチマーク用のInterfaceObject3d（描画を持たず、ワールド行列と衝突時コールバックだけを持つ）
+// 本来のInterfaceObject3d.hと同じく、d3d12.hと<memory>も読み込んでおく
+
+#include <d3d12.h>
+#include <DirectXMath.h>
+#include <memory>
+#include "Model.h"
+#include "CollisionInfo.h"
+
+class BaseCollider;
+
+class InterfaceObject3d
+{
+protected:// エイリアス
+	// DirectX::を省略
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+	using XMVECTOR = DirectX::XMVECTOR;
+	using XMMATRIX = DirectX::XMMATRIX;
+
+public:
+
+	InterfaceObject3d() = default;
+	virtual ~InterfaceObject3d() = default;
+
+	/// <summary>
+	/// 衝突時コールバック関数
+	/// </summary>
+	/// <param name="_info">衝突情報</param>
+	virtual void OnCollision(const CollisionInfo& /*_info*/) {}
+
+	/// <summary>
+	/// 衝突開始時コールバック関数
+	/// </summary>
+	/// <param name="_info">衝突情報</param>
+	virtual void OnCollisionEnter(const CollisionInfo& /*_info*/) {}
+
+	/// <summary>
+	/// 衝突継続中コールバック関数
+	/// </summary>
+	/// <param name="_info">衝突情報</param>
+	virtual void OnCollisionStay(const CollisionInfo& /*_info*/) {}
+
+	/// <summary>
+	/// 衝突終了時コールバック関数
+	/// </summary>
+	/// <param name="_info">衝突情報</param>
+	virtual void OnCollisionExit(const CollisionInfo& /*_info*/) {}
+
+	const XMMATRIX& GetMatWorld() { return matWorld; }
+
+	void SetMatWorld(const XMMATRIX& _matWorld) { matWorld = _matWorld; }
+
+protected:
+
+	// ワールド行列
+	XMMATRIX matWorld = DirectX::XMMatrixIdentity();
+};
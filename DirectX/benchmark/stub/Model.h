@@ -0,0 +1,39 @@
+﻿#pragma once
+
+// ベンチマーク用のModel（MeshColliderが参照する頂点とインデックスだけを持つ）
+
+#include <DirectXMath.h>
+#include <vector>
+
+class Mesh
+{
+public: // サブクラス
+	// 頂点データ構造体
+	struct VERTEX
+	{
+		DirectX::XMFLOAT3 pos; // xyz座標
+		DirectX::XMFLOAT3 normal; // 法線ベクトル
+		DirectX::XMFLOAT2 uv;  // uv座標
+	};
+
+public:
+
+	const std::vector<VERTEX>& GetVertices() { return vertices; }
+
+	const std::vector<unsigned long>& GetIndices() { return indices; }
+
+	// 頂点データ配列
+	std::vector<VERTEX> vertices;
+	// 頂点インデックス配列
+	std::vector<unsigned long> indices;
+};
+
+class Model
+{
+public:
+
+	const std::vector<Mesh*>& GetMeshes() { return meshes; }
+
+	// メッシュ
+	std::vector<Mesh*> meshes;
+};
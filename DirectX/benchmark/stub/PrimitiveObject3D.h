@@ -0,0 +1,18 @@
+﻿#pragma once
+
+// ベンチマーク用のPrimitiveObject3D（判定の描画は行わない）
+
+#include "InterfaceObject3d.h"
+
+class PrimitiveObject3D : public InterfaceObject3d
+{
+public:
+
+	void SetVertex(const DirectX::XMFLOAT3&) {}
+
+	void ResetVertex() {}
+
+	void Initialize() {}
+
+	void Draw() {}
+};
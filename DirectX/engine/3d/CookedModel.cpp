@@ -0,0 +1,169 @@
+﻿#include "CookedModel.h"
+#include "CookedBinary.h"
+
+#include <cstdio>
+
+using namespace DirectX;
+
+#ifdef _DEBUG
+bool CookedModel::isWriteOnLoad = true;
+#else
+bool CookedModel::isWriteOnLoad = false;
+#endif
+
+bool CookedModel::Write(const std::string& _filename, const CONTENT& _content)
+{
+	//クッカーはLinuxでも動かすので、fopen_sのない環境ではfopenを使う
+	FILE* fp = nullptr;
+#ifdef _WIN32
+	if (fopen_s(&fp, _filename.c_str(), "wb") != 0) {
+		return false;
+	}
+#else
+	fp = fopen(_filename.c_str(), "wb");
+	if (fp == nullptr) {
+		return false;
+	}
+#endif
+
+	const HEADER header = CreateHeader(_content);
+
+	const bool result = CookedBinary::Write(fp, &header, 1) &&
+		CookedBinary::Write(fp, _content.vertices.data(), _content.vertices.size()) &&
+		CookedBinary::Write(fp, _content.indices.data(), _content.indices.size()) &&
+		CookedBinary::Write(fp, _content.meshes.data(), _content.meshes.size()) &&
+		CookedBinary::Write(fp, _content.materials.data(), _content.materials.size()) &&
+		CookedBinary::Write(fp, _content.lods.data(), _content.lods.size()) &&
+		CookedBinary::Write(fp, _content.bones.data(), _content.bones.size()) &&
+		CookedBinary::Write(fp, _content.boneFrames.data(), _content.boneFrames.size());
+
+	fclose(fp);
+	return result;
+}
+
+bool CookedModel::HashFile(const std::string& _filename, uint64_t* _hash)
+{
+	MappedFile source;
+	if (!source.Open(_filename)) {
+		return false;
+	}
+	*_hash = CookedBinary::Hash(source.GetData(), source.GetSize(), *_hash);
+	return true;
+}
+
+bool CookedModel::Open(const std::string& _filename, uint32_t _vertexStride)
+{
+	Close();
+	if (!file.Open(_filename)) {
+		return false;
+	}
+
+	const char* cursor = file.GetData();
+	const char* end = cursor + file.GetSize();
+
+	//識別子・バージョン・頂点の形が一致しなければ使わない
+	if (!CookedBinary::Read(cursor, end, &header, 1) ||
+		memcmp(header.magic, "CMDL", sizeof(header.magic)) != 0 ||
+		header.version != cookedVersion ||
+		header.vertexStride != _vertexStride)
+	{
+		Close();
+		return false;
+	}
+
+	//各ブロックはコピーせずにファイルの中を指す
+	if (!CookedBinary::Map(cursor, end, &vertices, static_cast<size_t>(header.vertexStride) * header.vertexNum) ||
+		!CookedBinary::Map(cursor, end, &indices, header.indexNum) ||
+		!CookedBinary::Map(cursor, end, &meshes, header.meshNum) ||
+		!CookedBinary::Map(cursor, end, &materials, header.materialNum) ||
+		!CookedBinary::Map(cursor, end, &lods, header.lodNum) ||
+		!CookedBinary::Map(cursor, end, &bones, header.boneNum) ||
+		!CookedBinary::Map(cursor, end, &boneFrames, static_cast<size_t>(header.frameNum) * header.boneNum))
+	{
+		Close();
+		return false;
+	}
+
+	//メッシュの範囲やインデックスの値がはみ出していれば使わない（壊れたファイルでGPUが範囲外を読まないように）
+	for (uint32_t i = 0; i < header.meshNum; i++)
+	{
+		const MESH& mesh = meshes[i];
+		if (static_cast<uint64_t>(mesh.vertexStart) + mesh.vertexNum > header.vertexNum ||
+			static_cast<uint64_t>(mesh.indexStart) + mesh.indexNum > header.indexNum ||
+			static_cast<uint64_t>(mesh.lodStart) + mesh.lodNum > header.lodNum ||
+			mesh.materialIndex >= static_cast<int32_t>(header.materialNum))
+		{
+			Close();
+			return false;
+		}
+		for (uint32_t j = 0; j < mesh.lodNum; j++)
+		{
+			const MeshSimplifier::LOD& lod = lods[mesh.lodStart + j];
+			if (static_cast<uint64_t>(lod.indexStart) + lod.indexNum > mesh.indexNum)
+			{
+				Close();
+				return false;
+			}
+		}
+		const uint32_t* meshIndices = indices + mesh.indexStart;
+		for (uint32_t j = 0; j < mesh.indexNum; j++)
+		{
+			if (meshIndices[j] >= mesh.vertexNum)
+			{
+				Close();
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void CookedModel::Attach(const CONTENT& _content)
+{
+	Close();
+
+	header = CreateHeader(_content);
+
+	vertices = _content.vertices.empty() ? nullptr : _content.vertices.data();
+	indices = _content.indices.empty() ? nullptr : _content.indices.data();
+	meshes = _content.meshes.empty() ? nullptr : _content.meshes.data();
+	materials = _content.materials.empty() ? nullptr : _content.materials.data();
+	lods = _content.lods.empty() ? nullptr : _content.lods.data();
+	bones = _content.bones.empty() ? nullptr : _content.bones.data();
+	boneFrames = _content.boneFrames.empty() ? nullptr : _content.boneFrames.data();
+}
+
+void CookedModel::Close()
+{
+	file.Close();
+	header = {};
+	vertices = nullptr;
+	indices = nullptr;
+	meshes = nullptr;
+	materials = nullptr;
+	lods = nullptr;
+	bones = nullptr;
+	boneFrames = nullptr;
+}
+
+CookedModel::HEADER CookedModel::CreateHeader(const CONTENT& _content)
+{
+	HEADER header = {};
+	memcpy(header.magic, "CMDL", sizeof(header.magic));
+	header.version = cookedVersion;
+	header.flags = _content.flags;
+	header.vertexStride = _content.vertexStride;
+	header.vertexNum = _content.vertexStride > 0 ? static_cast<uint32_t>(_content.vertices.size() / _content.vertexStride) : 0;
+	header.indexNum = static_cast<uint32_t>(_content.indices.size());
+	header.meshNum = static_cast<uint32_t>(_content.meshes.size());
+	header.materialNum = static_cast<uint32_t>(_content.materials.size());
+	header.lodNum = static_cast<uint32_t>(_content.lods.size());
+	header.lodLevelNum = _content.lodLevelNum;
+	header.boneNum = static_cast<uint32_t>(_content.bones.size());
+	header.frameNum = _content.frameNum;
+	header.boundsMin = _content.boundsMin;
+	header.boundsMax = _content.boundsMax;
+	header.sourceStamp = _content.sourceStamp;
+	return header;
+}
@@ -0,0 +1,253 @@
+﻿#pragma once
+#include "MappedFile.h"
+#include "MeshSimplifier.h"
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 調理済みモデル（まとめた頂点・インデックス・マテリアル・AABB・スキンとボーンを1つのバイナリにしたもの）
+/// （読み込みはメモリマップした先頭をそのまま参照し、頂点ごとの処理をせずにバッファ生成へ渡す）
+/// </summary>
+class CookedModel
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+	using XMFLOAT4X4 = DirectX::XMFLOAT4X4;
+
+public: // サブクラス
+
+	// ファイルの先頭
+	struct HEADER
+	{
+		char magic[4]; // ファイル識別子
+		uint32_t version; // 形式のバージョン
+		uint32_t flags; // flag_から始まる定数の組み合わせ
+		uint32_t vertexStride; // 頂点1つのバイト数
+		uint32_t vertexNum; // 頂点の数
+		uint32_t indexNum; // インデックスの数
+		uint32_t meshNum; // メッシュの数
+		uint32_t materialNum; // マテリアルの数
+		uint32_t lodNum; // 詳細度の範囲の数（全メッシュ分）
+		uint32_t lodLevelNum; // 調理時に指定した詳細度の段数
+		uint32_t boneNum; // ボーンの数
+		uint32_t frameNum; // 焼き込んだアニメーションのフレーム数
+		XMFLOAT3 boundsMin; // 全体のAABB最小値
+		XMFLOAT3 boundsMax; // 全体のAABB最大値
+		uint64_t sourceStamp; // 元ファイルの内容のハッシュ
+	};
+
+	// メッシュ（頂点とインデックスはメッシュごとに0から数える）
+	struct MESH
+	{
+		char name[64]; // メッシュ名
+		uint32_t vertexStart; // 頂点の先頭
+		uint32_t vertexNum; // 頂点の数
+		uint32_t indexStart; // インデックスの先頭
+		uint32_t indexNum; // インデックスの数（全ての詳細度の分）
+		uint32_t lodStart; // 詳細度の範囲の先頭
+		uint32_t lodNum; // 詳細度の段数
+		int32_t materialIndex; // マテリアルの番号（ないときは-1）
+		XMFLOAT3 boundsMin; // AABB最小値
+		XMFLOAT3 boundsMax; // AABB最大値
+	};
+
+	// マテリアル（OBJはambient～specular、FBXはambient・diffuse・alpha以降を使う）
+	struct MATERIAL
+	{
+		char name[64]; // マテリアル名
+		char textureFilename[128]; // テクスチャファイル名（ディレクトリは除く、ないときは空）
+		XMFLOAT3 ambient; // アンビエント色
+		XMFLOAT3 diffuse; // ディフューズ色
+		XMFLOAT3 specular; // スペキュラー色
+		float alpha; // アルファ
+		XMFLOAT3 baseColor; // ベースカラー
+		float metalness; // 金属度
+		float specularFactor; // 鏡面反射度
+		float roughness; // 粗さ
+	};
+
+	// ボーン
+	struct BONE
+	{
+		char name[64]; // ボーン名
+		XMFLOAT4X4 invInitialPose; // 初期姿勢行列の逆行列
+	};
+
+	// 書き出す内容
+	struct CONTENT
+	{
+		uint32_t flags = 0; // flag_から始まる定数の組み合わせ
+		uint32_t vertexStride = 0; // 頂点1つのバイト数
+		std::vector<uint8_t> vertices; // 頂点（vertexStrideごと）
+		std::vector<uint32_t> indices; // インデックス
+		std::vector<MESH> meshes; // メッシュ
+		std::vector<MATERIAL> materials; // マテリアル
+		std::vector<MeshSimplifier::LOD> lods; // 詳細度の範囲（メッシュのインデックスの先頭から数える）
+		std::vector<BONE> bones; // ボーン
+		std::vector<XMFLOAT4X4> boneFrames; // フレームごとのボーンの姿勢行列（frameNum*ボーン数）
+		uint32_t frameNum = 0; // 焼き込んだアニメーションのフレーム数
+		uint32_t lodLevelNum = 1; // 調理時に指定した詳細度の段数
+		XMFLOAT3 boundsMin = {}; // 全体のAABB最小値
+		XMFLOAT3 boundsMax = {}; // 全体のAABB最大値
+		uint64_t sourceStamp = 0; // 元ファイルの内容のハッシュ
+	};
+
+public: // 定数
+	// 形式のバージョン（構造体を変えたら上げる）
+	static const uint32_t cookedVersion = 2;
+	// ボーンと焼き込んだアニメーションがある
+	static const uint32_t flag_skinned = 1;
+	// 頂点法線を平滑化した
+	static const uint32_t flag_smoothing = 2;
+	// 描画順と頂点の並びを最適化した
+	static const uint32_t flag_optimized = 4;
+
+public: // 静的メンバ関数
+
+	/// <summary>
+	/// 調理済みモデルを書き出す
+	/// </summary>
+	/// <param name="_filename">ファイル名</param>
+	/// <param name="_content">内容</param>
+	/// <returns>成功か</returns>
+	static bool Write(const std::string& _filename, const CONTENT& _content);
+
+	/// <summary>
+	/// ファイルの内容をハッシュに混ぜる（元ファイルが調理後に変わっていないかの確認用）
+	/// </summary>
+	/// <param name="_filename">ファイル名</param>
+	/// <param name="_hash">ハッシュ（続けて計算するので、最初は0を入れておく）</param>
+	/// <returns>ファイルを読めたか</returns>
+	static bool HashFile(const std::string& _filename, uint64_t* _hash);
+
+	/// <summary>
+	/// 読み込み時に調理したモデルを.cmdlとして書き出すか設定（既定では_DEBUGのときだけ書き出す）
+	/// （製品ではツールで調理した.cmdlを同梱し、Resources/へは書き込まない）
+	/// </summary>
+	/// <param name="_isWriteOnLoad">書き出すか</param>
+	static void SetWriteOnLoad(bool _isWriteOnLoad) { isWriteOnLoad = _isWriteOnLoad; }
+
+	/// <summary>
+	/// 読み込み時に調理したモデルを.cmdlとして書き出すか
+	/// </summary>
+	static bool IsWriteOnLoad() { return isWriteOnLoad; }
+
+	/// <summary>
+	/// 文字列を固定長の配列に書き込む（入らない分は切り捨て、必ず終端を付ける）
+	/// </summary>
+	/// <param name="_destination">書き込み先</param>
+	/// <param name="_source">文字列</param>
+	template <size_t N>
+	static void SetString(char(&_destination)[N], const std::string& _source)
+	{
+		const size_t length = _source.size() < N - 1 ? _source.size() : N - 1;
+		_source.copy(_destination, length);
+		for (size_t i = length; i < N; i++) { _destination[i] = '\0'; }
+	}
+
+	/// <summary>
+	/// 固定長の配列から文字列を取り出す（終端がなければ配列の大きさまで）
+	/// </summary>
+	/// <param name="_source">配列</param>
+	/// <returns>文字列</returns>
+	template <size_t N>
+	static std::string GetString(const char(&_source)[N])
+	{
+		const void* terminator = memchr(_source, '\0', N);
+		return std::string(_source, terminator ? static_cast<size_t>(static_cast<const char*>(terminator) - _source) : N);
+	}
+
+public: // メンバ関数
+
+	/// <summary>
+	/// ファイルをメモリマップして読み込む（識別子・バージョン・頂点のバイト数・大きさが合わない、
+	/// またはメッシュの頂点数以上のインデックスがあれば失敗）
+	/// </summary>
+	/// <param name="_filename">ファイル名</param>
+	/// <param name="_vertexStride">呼び出し側の頂点1つのバイト数</param>
+	/// <returns>成功か</returns>
+	bool Open(const std::string& _filename, uint32_t _vertexStride);
+
+	/// <summary>
+	/// メモリ上の内容を参照する（調理前のモデルもOpenと同じ取得関数で扱うため。内容は参照中に変えない）
+	/// </summary>
+	/// <param name="_content">内容</param>
+	void Attach(const CONTENT& _content);
+
+	/// <summary>
+	/// 参照を外し、ファイルを閉じる
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// ヘッダーを取得
+	/// </summary>
+	const HEADER& GetHeader() const { return header; }
+
+	/// <summary>
+	/// 頂点の先頭を取得（vertexStrideごとに並ぶ）
+	/// </summary>
+	const uint8_t* GetVertices() const { return vertices; }
+
+	/// <summary>
+	/// インデックスの先頭を取得
+	/// </summary>
+	const uint32_t* GetIndices() const { return indices; }
+
+	/// <summary>
+	/// メッシュの先頭を取得
+	/// </summary>
+	const MESH* GetMeshes() const { return meshes; }
+
+	/// <summary>
+	/// マテリアルの先頭を取得
+	/// </summary>
+	const MATERIAL* GetMaterials() const { return materials; }
+
+	/// <summary>
+	/// 詳細度の範囲の先頭を取得
+	/// </summary>
+	const MeshSimplifier::LOD* GetLods() const { return lods; }
+
+	/// <summary>
+	/// ボーンの先頭を取得
+	/// </summary>
+	const BONE* GetBones() const { return bones; }
+
+	/// <summary>
+	/// 焼き込んだボーンの姿勢行列の先頭を取得（フレームごとにボーン数ずつ並ぶ）
+	/// </summary>
+	const XMFLOAT4X4* GetBoneFrames() const { return boneFrames; }
+
+private: // 静的メンバ関数
+
+	/// <summary>
+	/// 内容からヘッダーを作る
+	/// </summary>
+	/// <param name="_content">内容</param>
+	/// <returns>ヘッダー</returns>
+	static HEADER CreateHeader(const CONTENT& _content);
+
+private: // 静的メンバ変数
+	//読み込み時に調理したモデルを書き出すか
+	static bool isWriteOnLoad;
+
+private: // メンバ変数
+	//メモリマップしたファイル
+	MappedFile file;
+	//ヘッダー
+	HEADER header = {};
+	//各ブロックの先頭
+	const uint8_t* vertices = nullptr;
+	const uint32_t* indices = nullptr;
+	const MESH* meshes = nullptr;
+	const MATERIAL* materials = nullptr;
+	const MeshSimplifier::LOD* lods = nullptr;
+	const BONE* bones = nullptr;
+	const XMFLOAT4X4* boneFrames = nullptr;
+};
@@ -128,21 +128,30 @@ std::unique_ptr<Fbx> Fbx::Create(FbxModel* model)
 void Fbx::Update()
 {
 	HRESULT result;
-	XMMATRIX matScale, matRot, matTrans;
-
-	// XP[A]AsړšvZ
-	matScale = XMMatrixScaling(scale.x, scale.y, scale.z);
-	matRot = XMMatrixIdentity();
-	matRot *= XMMatrixRotationZ(XMConvertToRadians(rotation.z));
-	matRot *= XMMatrixRotationX(XMConvertToRadians(rotation.x));
-	matRot *= XMMatrixRotationY(XMConvertToRadians(rotation.y));
-	matTrans = XMMatrixTranslation(position.x, position.y, position.z);
-
-	// [hs̍
-	matWorld = XMMatrixIdentity(); // ό`Zbg
-	matWorld *= matScale; // [hsɃXP[O𔽉f
-	matWorld *= matRot; // [hsɉ]𔽉f
-	matWorld *= matTrans; // [hsɕsړ𔽉f
+
+	if (transformHandle != TransformSystem::invalid_handle)
+	{
+		// TransformSystemŋ߂[hsg
+		matWorld = TransformSystem::GetInstance()->GetMatWorld(transformHandle);
+	}
+	else
+	{
+		XMMATRIX matScale, matRot, matTrans;
+
+		// XP[A]AsړšvZ
+		matScale = XMMatrixScaling(scale.x, scale.y, scale.z);
+		matRot = XMMatrixIdentity();
+		matRot *= XMMatrixRotationZ(XMConvertToRadians(rotation.z));
+		matRot *= XMMatrixRotationX(XMConvertToRadians(rotation.x));
+		matRot *= XMMatrixRotationY(XMConvertToRadians(rotation.y));
+		matTrans = XMMatrixTranslation(position.x, position.y, position.z);
+
+		// [hs̍
+		matWorld = XMMatrixIdentity(); // ό`Zbg
+		matWorld *= matScale; // [hsɃXP[O𔽉f
+		matWorld *= matRot; // [hsɉ]𔽉f
+		matWorld *= matTrans; // [hsɕsړ𔽉f
+	}
 
 	const XMMATRIX& matViewProjection = camera->GetView() * camera->GetProjection();
 	const XMFLOAT3& cameraPos = camera->GetEye();
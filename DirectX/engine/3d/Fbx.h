@@ -2,6 +2,7 @@
 #include "FbxModel.h"
 #include "GraphicsPipelineManager.h"
 #include "Texture.h"
+#include "TransformSystem.h"
 
 class Camera;
 class LightGroup;
@@ -172,6 +173,8 @@ private://
 	XMFLOAT4 color = { 1,1,1,1 };
 	// [J[hϊs
 	XMMATRIX matWorld = {};
+	// [hsǂރgXtH[̃nh
+	int transformHandle = TransformSystem::invalid_handle;
 	//}eAω
 	bool isTransferMaterial = false;
 	//x[XJ\
@@ -227,6 +230,12 @@ public:
 	/// <returns>[hs</returns>
 	const XMMATRIX& GetMatWorld() { return matWorld; }
 
+	/// <summary>
+	/// [hsǂރgXtH[̃ZbgiZbg͍WE]EXP[gȂj
+	/// </summary>
+	/// <param name="_transformHandle">TransformSystem̃nhiOꍇinvalid_handlej</param>
+	void SetTransformHandle(int _transformHandle) { this->transformHandle = _transformHandle; }
+
 	/// <summary>
 	/// x[XJ[擾
 	/// </summary>
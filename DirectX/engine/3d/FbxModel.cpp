@@ -1,5 +1,6 @@
 #include "FbxModel.h"
 #include <DirectXTex.h>
+#include <algorithm>
 #include <string>
 
 using namespace Microsoft::WRL;
@@ -50,9 +51,6 @@ void FbxModel::LoadMaterial(FbxNode* fbxNode)
 		//擪̃}eA擾
 		FbxSurfaceMaterial* material = fbxNode->GetMaterial(0);
 
-		//eNX`̗LmF
-		bool textureLoaded = false;
-
 		if (material)
 		{
 			//}eA
@@ -122,22 +120,12 @@ void FbxModel::LoadMaterial(FbxNode* fbxNode)
 				{
 					const char* filePath = textureFile->GetFileName();
 
-					//t@CpXt@C擾
+					//t@CpXt@C擾ieNX`LoadCookedœǂݍށj
 					std::string path_str(filePath);
-					std::string fileName = ExtractFileName(path_str);
-
-					//eNX`ǂݍ
-					texture = Texture::Create(baseDirectory + name + '/' + fileName);
-					textureLoaded = true;
+					data->material.textureFilename = ExtractFileName(path_str);
 				}
 			}
 		}
-
-		//textureꍇɂ
-		if (!textureLoaded)
-		{
-			texture = Texture::Create(defaultTexture);
-		}
 	}
 }
 
@@ -502,8 +490,9 @@ void FbxModel::Initialize()
 {
 	HRESULT result = S_FALSE;
 
-	UINT sizeVB = static_cast<UINT>(sizeof(Vertex) * data->vertices.size());
-	UINT sizeIB = static_cast<UINT>(sizeof(unsigned short) * data->indices.size());
+	const CookedModel::HEADER& header = cooked.GetHeader();
+	UINT sizeVB = static_cast<UINT>(sizeof(Vertex) * header.vertexNum);
+	UINT sizeIB = static_cast<UINT>(sizeof(uint32_t) * header.indexNum);
 
 	//_obt@
 	result = device->CreateCommittedResource(
@@ -525,26 +514,26 @@ void FbxModel::Initialize()
 		IID_PPV_ARGS(&indexBuff));
 	assert(SUCCEEDED(result));
 
-	//_obt@ւ̃f[^]
+	//_obt@ւ̃f[^]iς݃f炻̂܂܃Rs[j
 	Vertex* vertMap = nullptr;
 	result = vertBuff->Map(0, nullptr, (void**)&vertMap);
-	std::copy(data->vertices.begin(), data->vertices.end(), vertMap);
+	memcpy(vertMap, cooked.GetVertices(), sizeVB);
 	vertBuff->Unmap(0, nullptr);
 
 	//CfbNXobt@ւ̃f[^]
-	unsigned short* indexMap = nullptr;
+	uint32_t* indexMap = nullptr;
 	result = indexBuff->Map(0, nullptr, (void**)&indexMap);
-	std::copy(data->indices.begin(), data->indices.end(), indexMap);
+	memcpy(indexMap, cooked.GetIndices(), sizeIB);
 	indexBuff->Unmap(0, nullptr);
 
 	//_obt@r[̐
 	vbView.BufferLocation = vertBuff->GetGPUVirtualAddress();
 	vbView.SizeInBytes = sizeVB;
-	vbView.StrideInBytes = sizeof(data->vertices[0]);
+	vbView.StrideInBytes = sizeof(Vertex);
 
 	//CfbNXobt@r[̍쐬
 	ibView.BufferLocation = indexBuff->GetGPUVirtualAddress();
-	ibView.Format = DXGI_FORMAT_R16_UINT;
+	ibView.Format = DXGI_FORMAT_R32_UINT;
 	ibView.SizeInBytes = sizeIB;
 
 	//萔obt@Skin̐
@@ -558,15 +547,146 @@ void FbxModel::Initialize()
 	assert(SUCCEEDED(result));
 }
 
+void FbxModel::Cook(CookedModel::CONTENT* content)
+{
+	content->flags = isSkinning ? CookedModel::flag_skinned : 0;
+	content->vertexStride = sizeof(Vertex);
+
+	//_͂̂܂܂̃oCgACfbNX32bitɂ
+	const uint8_t* vertexBytes = reinterpret_cast<const uint8_t*>(data->vertices.data());
+	content->vertices.assign(vertexBytes, vertexBytes + sizeof(Vertex) * data->vertices.size());
+	content->indices.assign(data->indices.begin(), data->indices.end());
+
+	//bV1ƃ}eA1
+	CookedModel::MESH mesh = {};
+	CookedModel::SetString(mesh.name, data->meshNode ? data->meshNode->name : name);
+	mesh.vertexNum = static_cast<uint32_t>(data->vertices.size());
+	mesh.indexNum = static_cast<uint32_t>(data->indices.size());
+	mesh.materialIndex = 0;
+	if (!data->vertices.empty())
+	{
+		mesh.boundsMin = data->vertices[0].pos;
+		mesh.boundsMax = data->vertices[0].pos;
+		for (const Vertex& vertex : data->vertices)
+		{
+			mesh.boundsMin = { (std::min)(mesh.boundsMin.x, vertex.pos.x), (std::min)(mesh.boundsMin.y, vertex.pos.y), (std::min)(mesh.boundsMin.z, vertex.pos.z) };
+			mesh.boundsMax = { (std::max)(mesh.boundsMax.x, vertex.pos.x), (std::max)(mesh.boundsMax.y, vertex.pos.y), (std::max)(mesh.boundsMax.z, vertex.pos.z) };
+		}
+	}
+	content->meshes.assign(1, mesh);
+	content->boundsMin = mesh.boundsMin;
+	content->boundsMax = mesh.boundsMax;
+
+	CookedModel::MATERIAL material = {};
+	CookedModel::SetString(material.name, data->material.name);
+	CookedModel::SetString(material.textureFilename, data->material.textureFilename);
+	material.ambient = data->material.ambient;
+	material.diffuse = data->material.diffuse;
+	material.alpha = data->material.alpha;
+	material.baseColor = data->material.baseColor;
+	material.metalness = data->material.metalness;
+	material.specularFactor = data->material.specular;
+	material.roughness = data->material.roughness;
+	content->materials.assign(1, material);
+
+	//{[
+	content->bones.resize(data->bones.size());
+	for (size_t i = 0; i < data->bones.size(); i++)
+	{
+		CookedModel::SetString(content->bones[i].name, data->bones[i].name);
+		XMStoreFloat4x4(&content->bones[i].invInitialPose, data->bones[i].invInitialPose);
+	}
+
+	//JnI܂Ńt[ƂɃ{[̎pĂށiAj[VȂΊJn̎p̂݁j
+	const FbxUpdate& fbxUpdate = data->fbxUpdate;
+	content->frameNum = 0;
+	for (FbxTime time = fbxUpdate.startTime; content->frameNum == 0 || (fbxUpdate.isAnimation && time <= fbxUpdate.stopTime); time += frameTime)
+	{
+		for (const Bone& bone : data->bones)
+		{
+			XMMATRIX matPose;
+			ConvertMatrixFormFbx(&matPose, bone.fbxCluster->GetLink()->EvaluateGlobalTransform(time));
+			content->boneFrames.emplace_back();
+			XMStoreFloat4x4(&content->boneFrames.back(), matPose);
+		}
+		content->frameNum++;
+	}
+}
+
+void FbxModel::LoadCooked()
+{
+	const CookedModel::HEADER& header = cooked.GetHeader();
+
+	//}eA
+	if (header.materialNum > 0)
+	{
+		const CookedModel::MATERIAL& material = cooked.GetMaterials()[0];
+		data->material.name = CookedModel::GetString(material.name);
+		data->material.textureFilename = CookedModel::GetString(material.textureFilename);
+		data->material.ambient = material.ambient;
+		data->material.diffuse = material.diffuse;
+		data->material.alpha = material.alpha;
+		data->material.baseColor = material.baseColor;
+		data->material.metalness = material.metalness;
+		data->material.specular = material.specularFactor;
+		data->material.roughness = material.roughness;
+	}
+
+	//eNX`ǂݍ݁itextureꍇɂj
+	if (data->material.textureFilename.size() > 0)
+	{
+		texture = Texture::Create(baseDirectory + name + '/' + data->material.textureFilename);
+	}
+	else
+	{
+		texture = Texture::Create(defaultTexture);
+	}
+
+	//XLjOƃAj[ViĂ񂾃t[1t[i߂j
+	isSkinning = (header.flags & CookedModel::flag_skinned) != 0 && header.boneNum > 0 && header.frameNum > 0;
+	data->fbxUpdate.startTime = FbxTime(0);
+	data->fbxUpdate.stopTime = FbxTime(frameTime.Get() * (header.frameNum > 0 ? header.frameNum - 1 : 0));
+	data->fbxUpdate.nowTime = data->fbxUpdate.startTime;
+	data->fbxUpdate.isAnimation = header.frameNum > 1;
+}
+
 std::unique_ptr<FbxModel> FbxModel::Create(const std::string fileName)
 {
 	// 3DIuWFNg̃CX^X𐶐
 	FbxModel* instance = new FbxModel();
 
 	instance->data = std::make_unique<Data>();
+	instance->name = fileName;
+
+	//.fbx΁Aς݃fꂩꂽẽnbVŊm߂i.fbx𓯍Ȃił͊m߂Ȃj
+	const std::string sourceFilename = baseDirectory + fileName + "/" + fileName + ".fbx";
+	uint64_t sourceStamp = 0;
+	const bool isSource = CookedModel::HashFile(sourceFilename, &sourceStamp);
+
+	//t@C̒ς݃fFBX SDKg킸Ƀ}bvĎg
+	const std::string cookedFilename = baseDirectory + fileName + "/" + fileName + ".cmdl";
+	if (!instance->cooked.Open(cookedFilename, sizeof(Vertex)) ||
+		(isSource && instance->cooked.GetHeader().sourceStamp != sourceStamp))
+	{
+		//Fbxt@C̓ǂݍ
+		instance->LoadFbx(fileName);
+
+		//Ĵ͎߂ɏoioȂEoȂ΃̓egj
+		CookedModel::CONTENT& content = instance->data->cookedContent;
+		instance->Cook(&content);
+		content.sourceStamp = sourceStamp;
+		if (CookedModel::IsWriteOnLoad() && CookedModel::Write(cookedFilename, content) && instance->cooked.Open(cookedFilename, sizeof(Vertex)))
+		{
+			content = CookedModel::CONTENT();
+		}
+		else
+		{
+			instance->cooked.Attach(content);
+		}
+	}
 
-	//Fbxt@C̓ǂݍ
-	instance->LoadFbx(fileName);
+	//}eAƃAj[V̐ݒ
+	instance->LoadCooked();
 
 	//Fbx̏ݒ
 	instance->Initialize();
@@ -590,24 +710,25 @@ void FbxModel::Update()
 	}
 
 	//{[z擾
-	std::vector<Bone>& bones = data->bones;
+	const CookedModel::HEADER& header = cooked.GetHeader();
+	const CookedModel::BONE* bones = cooked.GetBones();
 
 	// 萔obt@Skinփf[^]
 	ConstBufferDataSkin* constMapSkin = nullptr;
 	result = constBuffSkin->Map(0, nullptr, (void**)&constMapSkin);
 	if (isSkinning)
 	{
-		for (int i = 0; i < bones.size(); i++)
+		//̃t[ŏĂ񂾎pg
+		const FbxLongLong frame = (data->fbxUpdate.nowTime - data->fbxUpdate.startTime).Get() / frameTime.Get();
+		const uint32_t frameIndex = static_cast<uint32_t>((std::min)((std::max)(frame, FbxLongLong(0)), FbxLongLong(header.frameNum) - 1));
+		const XMFLOAT4X4* currentPoses = cooked.GetBoneFrames() + static_cast<size_t>(frameIndex) * header.boneNum;
+		const uint32_t boneNum = (std::min)(header.boneNum, static_cast<uint32_t>(MAX_BONES));
+		for (uint32_t i = 0; i < boneNum; i++)
 		{
 			//̎ps
-			XMMATRIX matCurrentPose;
-			//݂̎p擾
-			FbxAMatrix fbxCurrentPose =
-				bones[i].fbxCluster->GetLink()->EvaluateGlobalTransform(data->fbxUpdate.nowTime);
-			//XMMATRIXɕϊ
-			ConvertMatrixFormFbx(&matCurrentPose, fbxCurrentPose);
+			XMMATRIX matCurrentPose = XMLoadFloat4x4(&currentPoses[i]);
 			//ăXLjOsɕۑ
-			constMapSkin->bones[i] = bones[i].invInitialPose * matCurrentPose;
+			constMapSkin->bones[i] = XMLoadFloat4x4(&bones[i].invInitialPose) * matCurrentPose;
 		}
 	}
 	//XLjOȂꍇl𑗂
@@ -633,7 +754,7 @@ void FbxModel::Draw(ID3D12GraphicsCommandList* cmdList)
 	cmdList->SetGraphicsRootDescriptorTable(2, texture->descriptor->gpu);
 
 	//`R}h
-	cmdList->DrawIndexedInstanced((UINT)data->indices.size(), 1, 0, 0, 0);
+	cmdList->DrawIndexedInstanced(cooked.GetHeader().indexNum, 1, 0, 0, 0);
 }
 
 void FbxModel::Finalize()
@@ -5,6 +5,7 @@
 #include <d3dx12.h>
 #include <DirectXMath.h>
 #include <map>
+#include "CookedModel.h"
 #include "Texture.h"
 
 class FbxModel
@@ -16,6 +17,7 @@ private: // 
 	using XMFLOAT2 = DirectX::XMFLOAT2;
 	using XMFLOAT3 = DirectX::XMFLOAT3;
 	using XMFLOAT4 = DirectX::XMFLOAT4;
+	using XMFLOAT4X4 = DirectX::XMFLOAT4X4;
 	using XMMATRIX = DirectX::XMMATRIX;
 	using XMVECTOR = DirectX::XMVECTOR;
 
@@ -89,6 +91,7 @@ private://
 		float metalness = 0.0f;//x(0 or 1)
 		float specular = 0.5f;//ʔ˓x
 		float roughness = 0.0f;//e
+		std::string textureFilename;//eNX`t@CifBNg͏AȂƂ͋j
 	};
 
 	//XLp萔obt@f[^
@@ -117,6 +120,8 @@ private://
 		Node* meshNode;
 		std::vector<Bone> bones;
 		FbxUpdate fbxUpdate;
+		//ς݃foȂɎQƂe
+		CookedModel::CONTENT cookedContent;
 	};
 
 private://o֐
@@ -167,7 +172,18 @@ private://
 	void LoadFbx(const std::string modelName);
 
 	/// <summary>
-	/// 
+	/// ǂݍFbx𒲗ς݃f̓eɂiAj[V̓t[Ƃ̃{[̎pɏĂށj
+	/// </summary>
+	/// <param name="content">ς݃f̓eio͗pj</param>
+	void Cook(CookedModel::CONTENT* content);
+
+	/// <summary>
+	/// ς݃f}eAEeNX`EAj[Vݒ
+	/// </summary>
+	void LoadCooked();
+
+	/// <summary>
+	/// iς݃f̒_ƃCfbNX̂܂܃obt@֓]j
 	/// </summary>
 	void Initialize();
 
@@ -197,7 +213,8 @@ public://
 	static void StaticInitialize(ID3D12Device* device);
 
 	/// <summary>
-	/// CX^X̐
+	/// CX^X̐i.fbx.cmdlFBX SDKg킸ɓǂݍ݁AȂFbxǂݍŒB
+	/// ̂CookedModel::IsWriteOnLoad̂Ƃ.cmdlɏoj
 	/// </summary>
 	/// <param name="fileName">t@C</param>
 	static std::unique_ptr<FbxModel> Create(const std::string fileName);
@@ -236,6 +253,8 @@ private://
 	static const std::string baseDirectory;
 	//Fbx̃f[^
 	std::unique_ptr<Data> data = nullptr;
+	//ς݃fi_ECfbNXEĂ񂾃{[̎pj
+	CookedModel cooked;
 
 public://oϐ
 
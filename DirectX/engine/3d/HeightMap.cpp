@@ -269,98 +269,6 @@ void HeightMap::Initialize()
 		}
 	}
 
-	//蔻p_ۑ
-	{
-		int hitSurfaceNum = windthSize / 2 * heightSize / 2;
-		int hitVertNum = hitSurfaceNum * 4;
-		int hitIndexNum = hitSurfaceNum * 6;
-
-		hitVertices.resize(hitVertNum);
-		hitIndices.resize(hitIndexNum);
-		index = 0;
-		//_ۑ
-		for (int j = 0; j < heightSize - 1; ++j)
-		{
-			if (j % 2 == 1) { continue; }
-			for (int i = 0; i < windthSize - 1; ++i)
-			{
-				if (i % 2 == 1) { continue; }
-				int index1 = (hmInfo.terrainHeight * j) + i;// 
-				int index2 = (hmInfo.terrainHeight * j) + (i + 2);// E
-				int index3 = (hmInfo.terrainHeight * (j + 2)) + i;// 
-				int index4 = (hmInfo.terrainHeight * (j + 2)) + (i + 2);// E
-
-				int vertNum1 = index;
-				index++;
-				int vertNum2 = index;
-				index++;
-				int vertNum3 = index;
-				index++;
-				int vertNum4 = index;
-				index++;
-
-				// 
-				hitVertices[vertNum2].pos = hmInfo.heightMap[index3];
-				hitVertices[vertNum2].uv = XMFLOAT2(1.0f, 0.0f);
-
-				// E
-				hitVertices[vertNum4].pos = hmInfo.heightMap[index4];
-				hitVertices[vertNum4].uv = XMFLOAT2(0.0f, 1.0f);
-
-				// 
-				hitVertices[vertNum1].pos = hmInfo.heightMap[index1];
-				hitVertices[vertNum1].uv = XMFLOAT2(0.0f, 0.0f);
-
-				// E
-				hitVertices[vertNum3].pos = hmInfo.heightMap[index2];
-				hitVertices[vertNum3].uv = XMFLOAT2(1.0f, 1.0f);
-			}
-		}
-
-		//CfbNXۑ
-		for (int i = 0; i < hitSurfaceNum; i++)
-		{
-			int vertexNum = i * 4;
-			index = i * 6;
-			hitIndices[index] = basicsIndices[0] + vertexNum;
-			index++;
-			hitIndices[index] = basicsIndices[1] + vertexNum;
-			index++;
-			hitIndices[index] = basicsIndices[2] + vertexNum;
-			index++;
-			hitIndices[index] = basicsIndices[3] + vertexNum;
-			index++;
-			hitIndices[index] = basicsIndices[4] + vertexNum;
-			index++;
-			hitIndices[index] = basicsIndices[5] + vertexNum;
-		}
-
-		int normalNum = static_cast<int>(hitIndices.size() / 3);
-		for (int i = 0; i < normalNum; i++)
-		{
-			index = i * 3;
-			unsigned long index1 = hitIndices[index];
-			index++;
-			unsigned long index2 = hitIndices[index];
-			index++;
-			unsigned long index3 = hitIndices[index];
-
-			XMVECTOR p0 = XMLoadFloat3(&hitVertices[index1].pos);
-			XMVECTOR p1 = XMLoadFloat3(&hitVertices[index2].pos);
-			XMVECTOR p2 = XMLoadFloat3(&hitVertices[index3].pos);
-
-			XMVECTOR v1 = XMVectorSubtract(p0, p1);
-			XMVECTOR v2 = XMVectorSubtract(p0, p2);
-
-			XMVECTOR normal = XMVector3Cross(v1, v2);
-			normal = XMVector3Normalize(normal);
-
-			XMStoreFloat3(&hitVertices[index1].normal, normal);
-			XMStoreFloat3(&hitVertices[index2].normal, normal);
-			XMStoreFloat3(&hitVertices[index3].normal, normal);
-		}
-	}
-
 	Mesh* mesh = new Mesh;
 
 	//bV֕ۑ
@@ -380,6 +288,12 @@ void HeightMap::Initialize()
 	model = new Model;
 	model->SetMeshes(mesh);
 
+	// n`Ŝ͂AABBJOɎg
+	XMFLOAT3 modelMin, modelMax;
+	if (model->GetBounds(&modelMin, &modelMax)) {
+		SetLocalBounds(modelMin, modelMax);
+	}
+
 	// 萔obt@̐
 	result = device->CreateCommittedResource(
 		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD), 	// Abv[h\
@@ -416,6 +330,11 @@ void HeightMap::AddConstBufferUpdate(const float _ratio)
 
 void HeightMap::Draw()
 {
+	// ̊OɂΒ萔obt@̍XVƏȂ
+	if (!UpdateCulling()) {
+		return;
+	}
+
 	model->VIDraw(cmdList);
 
 	InterfaceObject3d::Draw();
@@ -107,13 +107,11 @@ private:
 	int vertNum = 0;
 	//nCg}bv̏
 	HEIGHT_MAP_INFO hmInfo;
-	//蔻p_
-	std::vector<Mesh::VERTEX> hitVertices;
-	std::vector<unsigned long> hitIndices;
 
 public:
 
 	Model* GetModel() { return model; }
-	std::vector<Mesh::VERTEX>& GetHitVertices() { return hitVertices; }
-	std::vector<unsigned long>& GetHitIndices() { return hitIndices; }
+	int GetTerrainWidth() { return hmInfo.terrainWidth; }
+	int GetTerrainHeight() { return hmInfo.terrainHeight; }
+	const std::vector<XMFLOAT3>& GetHeightMapPositions() { return hmInfo.heightMap; }
 };
\ No newline at end of file
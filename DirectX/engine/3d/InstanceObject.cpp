@@ -125,6 +125,13 @@ void InstanceObject::DrawInstance(const XMFLOAT3& _pos, const XMFLOAT3& _scale,
 	instanceDrawNum++;
 }
 
+void InstanceObject::DrawInstance(int _transformHandle, const XMFLOAT4& _color)
+{
+	objInform.baseColor[instanceDrawNum] = _color;
+	objInform.matWorld[instanceDrawNum] = TransformSystem::GetInstance()->GetMatWorld(_transformHandle);
+	instanceDrawNum++;
+}
+
 void InstanceObject::Update()
 {
 	//萔obt@Ƀf[^]
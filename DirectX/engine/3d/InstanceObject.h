@@ -6,6 +6,7 @@
 #include "GraphicsPipelineManager.h"
 #include "Texture.h"
 #include "Model.h"
+#include "TransformSystem.h"
 
 class Camera;
 class LightGroup;
@@ -109,6 +110,13 @@ public:
 	void DrawInstance(const XMFLOAT3& _pos, const XMFLOAT3& _scale,
 		const XMFLOAT3& _rotation, const XMFLOAT4& _color);
 
+	/// <summary>
+	/// `ZbgiTransformSystem̃[hsgj
+	/// </summary>
+	/// <param name="_transformHandle">TransformSystem̃nh</param>
+	/// <param name="_color">F</param>
+	void DrawInstance(int _transformHandle, const XMFLOAT4& _color);
+
 	/// <summary>
 	/// XV
 	/// </summary>
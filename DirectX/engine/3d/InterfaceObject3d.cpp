@@ -5,6 +5,7 @@
 #include "LightGroup.h"
 #include "Model.h"
 #include "Texture.h"
+#include "TransformKernel.h"
 
 ID3D12Device* InterfaceObject3d::device = nullptr;
 ID3D12GraphicsCommandList* InterfaceObject3d::cmdList = nullptr;
@@ -33,6 +34,11 @@ void InterfaceObject3d::StaticInitialize(ID3D12Device* _device)
 
 InterfaceObject3d::~InterfaceObject3d()
 {
+	//gXtH[̍폜iq͐eȂɂȂj
+	if (transformHandle != TransformSystem::invalid_handle) {
+		TransformSystem::GetInstance()->Destroy(transformHandle);
+	}
+
 	//RC_[
 	if (collider) {
 		CollisionManager::GetInstance()->RemoveCollider(collider);
@@ -60,8 +66,12 @@ void InterfaceObject3d::Initialize()
 
 void InterfaceObject3d::Update()
 {
-	UpdateWorldMatrix();
+	// `撆Ƀ[JlςƁAǂނтTransformSystemŜ̍XVN̂ŁAŔfĂ
+	SyncTransform();
+}
 
+void InterfaceObject3d::TransferConstBuffer()
+{
 	//萔obt@Ƀf[^]
 	CONST_BUFFER_DATA_B0* constMap = nullptr;
 	HRESULT result = constBuffB0->Map(0, nullptr, (void**)&constMap);//}bsO
@@ -85,16 +95,11 @@ void InterfaceObject3d::Update()
 		constMap->isLight = isLight;
 		constBuffB0->Unmap(0, nullptr);
 	}
-
-	// 蔻XV
-	if (collider) {
-		collider->Update();
-	}
 }
 
 void InterfaceObject3d::Draw()
 {
-	Update();
+	TransferConstBuffer();
 
 	// 萔obt@r[Zbg
 	cmdList->SetGraphicsRootConstantBufferView(0, constBuffB0->GetGPUVirtualAddress());
@@ -110,41 +115,36 @@ void InterfaceObject3d::ColliderDraw()
 
 void InterfaceObject3d::UpdateWorldMatrix()
 {
-	XMMATRIX matScale, matRot, matTrans;
-
-	// XP[A]AsړšvZ
-	matScale = XMMatrixScaling(scale.x, scale.y, scale.z);
-	matRot = XMMatrixIdentity();
-	matRot *= XMMatrixRotationZ(XMConvertToRadians(rotation.z));
-	matRot *= XMMatrixRotationX(XMConvertToRadians(rotation.x));
-	matRot *= XMMatrixRotationY(XMConvertToRadians(rotation.y));
-	matTrans = XMMatrixTranslation(position.x, position.y, position.z);
-
-	matWorld = XMMatrixIdentity(); // ό`Zbg
-	matWorld *= matScale; // [hsɃXP[O𔽉f
-	matWorld *= matRot; // [hsɉ]𔽉f
-	matWorld *= matTrans; // [hsɕsړ𔽉f
-
-	// eIuWFNg
-	if (parent != nullptr) {
-		XMFLOAT3 pPos = parent->GetPosition();
-		XMFLOAT3 pRota = parent->GetRotation();
-		// eIuWFNg̃[hs|
-		matWorld *= XMMatrixTranslation(-pPos.x, -pPos.y, -pPos.z);
-		matWorld *= XMMatrixRotationZ(XMConvertToRadians(pRota.z));
-		matWorld *= XMMatrixRotationZ(XMConvertToRadians(pRota.x));
-		matWorld *= XMMatrixRotationZ(XMConvertToRadians(pRota.y));
-		matWorld *= XMMatrixTranslation(pPos.x, pPos.y, pPos.z);
-
-		//XMFLOAT3 radiun = { asinf(-matWorld.r[2].m128_f32[1]),
-		//	asinf(-matWorld.r[0].m128_f32[2]),asinf(-matWorld.r[1].m128_f32[0]) };
-		//rotation = { XMConvertToDegrees(radiun.x),XMConvertToDegrees(radiun.y) ,XMConvertToDegrees(radiun.z) };
-		//position = { matWorld.r[3].m128_f32[0],matWorld.r[3].m128_f32[1],matWorld.r[3].m128_f32[2] };
-
-		//rotation = { rotation.x + pRota.x,rotation.y + pRota.y, rotation.z + pRota.z };
-
-		//matWorld *= parent->GetMatWorld();
+	// eq֌WȂ΁AXP[A](ZXY)Asړ1̍sƂĒڋ߂
+	if (transformHandle == TransformSystem::invalid_handle) {
+		TransformKernel::ComposeEuler(&position, &rotation, &scale, 1, &matWorld);
+		return;
 	}
+
+	// eq֌W΁At[TransformSystem::Updateł܂Ƃ߂ċ߂sǂނɂ
+	//i[Jl̓Zb^[UpdateŔfς݁BXV̕ύXcĂGetMatWorldɍXVj
+	matWorld = TransformSystem::GetInstance()->GetMatWorld(transformHandle);
+}
+
+bool InterfaceObject3d::IsVisible()
+{
+	// AABBȂEJOȂEJȂꍇ͏ɕ`悷
+	if (!isBounds || !isCulling || !camera) {
+		return true;
+	}
+
+	return camera->GetFrustum().IsVisibleAABB(matWorld, boundsMin, boundsMax);
+}
+
+bool InterfaceObject3d::UpdateCulling()
+{
+	UpdateWorldMatrix();
+
+	// 蔻͌ĂȂĂiĂ΁A߂s͂̂܂ܒ萔obt@̓]Ɏgj
+	if (collider) {
+		collider->Update();
+	}
+	return IsVisible();
 }
 
 void InterfaceObject3d::SetCollider(BaseCollider* _collider)
@@ -158,6 +158,34 @@ void InterfaceObject3d::SetCollider(BaseCollider* _collider)
 	_collider->Update();
 }
 
+void InterfaceObject3d::SetParent(InterfaceObject3d* _parent)
+{
+	if (!_parent) {
+		if (transformHandle != TransformSystem::invalid_handle) {
+			TransformSystem::GetInstance()->SetParent(transformHandle, TransformSystem::invalid_handle);
+		}
+		return;
+	}
+
+	TransformSystem::GetInstance()->SetParent(GetTransformHandle(), _parent->GetTransformHandle());
+}
+
+int InterfaceObject3d::GetTransformHandle()
+{
+	if (transformHandle == TransformSystem::invalid_handle) {
+		transformHandle = TransformSystem::GetInstance()->Create();
+		SyncTransform();
+	}
+	return transformHandle;
+}
+
+void InterfaceObject3d::SyncTransform()
+{
+	if (transformHandle != TransformSystem::invalid_handle) {
+		TransformSystem::GetInstance()->SetLocal(transformHandle, position, rotation, scale);
+	}
+}
+
 XMFLOAT3 InterfaceObject3d::GetWorldPosition()
 {
 	XMFLOAT3 worldpos;
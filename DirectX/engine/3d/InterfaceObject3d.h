@@ -8,6 +8,7 @@
 #include "Model.h"
 #include "Texture.h"
 #include "CollisionInfo.h"
+#include "TransformSystem.h"
 
 class BaseCollider;
 class Camera;
@@ -79,7 +80,8 @@ public:
 	static void SetLightGroup(Texture* _cubetex) { InterfaceObject3d::cubetex = _cubetex; }
 
 	/// <summary>
-	/// XV
+	/// XViV[̍XVɌĂсAWE]EXP[TransformSystem֔fB
+	/// hNXōWȂǂ𒼐ڏꍇɌĂԁB[hs̓t[TransformSystem::Updateł܂Ƃ߂ċ߂j
 	/// </summary>
 	void Update();
 
@@ -94,7 +96,7 @@ public:
 	virtual void Initialize() = 0;
 
 	/// <summary>
-	/// `
+	/// `ihNX͐UpdateCullingōsXVĂA̎Ăԁj
 	/// </summary>
 	virtual void Draw() = 0;
 
@@ -104,16 +106,60 @@ public:
 	virtual void ColliderDraw();
 
 	/// <summary>
-	/// s̍XV
+	/// s̍XVieq֌WTransformSystemŋ߂[hsǂނj
 	/// </summary>
 	void UpdateWorldMatrix();
 
+	/// <summary>
+	/// ƏdȂĂ邩ĩ݂[hsƃ[JWAABBŔj
+	/// </summary>
+	/// <returns>`悷Kv邩ۂ</returns>
+	bool IsVisible();
+
+	/// <summary>
+	/// `O̎JOisƓ蔻XVĔ肷BĂDraw͂̍ŝ܂ܓ]j
+	/// </summary>
+	/// <returns>`悷Kv邩ۂ</returns>
+	bool UpdateCulling();
+
+protected:
+
+	/// <summary>
+	/// 萔obt@ւ̓]is͌vZAUpdateCullingŋ߂̂gj
+	/// </summary>
+	void TransferConstBuffer();
+
+	/// <summary>
+	/// WE]EXP[TransformSystem֔fio^Ȃ牽Ȃj
+	/// </summary>
+	void SyncTransform();
+
+public:
+
 	/// <summary>
 	/// ՓˎR[obN֐
 	/// </summary>
 	/// <param name="_info">Փˏ</param>
 	virtual void OnCollision(const CollisionInfo& _info) {}
 
+	/// <summary>
+	/// ڐGn߂t[ɌĂ΂
+	/// </summary>
+	/// <param name="_info">Փˏ</param>
+	virtual void OnCollisionEnter(const CollisionInfo& _info) {}
+
+	/// <summary>
+	/// Ot[ڐGĂԁAt[Ă΂
+	/// </summary>
+	/// <param name="_info">Փˏ</param>
+	virtual void OnCollisionStay(const CollisionInfo& _info) {}
+
+	/// <summary>
+	/// ڐGȂȂt[ɌĂ΂i肪폜ꂽꍇAobjectcollidernullptrj
+	/// </summary>
+	/// <param name="_info">ՓˏiՓ˓_͍ŌɐڐGĂ_j</param>
+	virtual void OnCollisionExit(const CollisionInfo& _info) {}
+
 protected:
 
 	// foCX
@@ -153,8 +199,8 @@ protected:
 	Model* model = nullptr;
 	// RC_[
 	BaseCollider* collider = nullptr;
-	// eIuWFNg
-	InterfaceObject3d* parent = nullptr;
+	// eq֌Wꍇ̃gXtH[̃nhieq֌WȂΎgȂj
+	int transformHandle = TransformSystem::invalid_handle;
 	// [J[hϊs
 	XMMATRIX matWorld = {};
 	// [JXP[
@@ -163,6 +209,14 @@ protected:
 	XMFLOAT3 rotation = { 0,0,0 };
 	// [JW
 	XMFLOAT3 position = { 0,0,0 };
+	// [JWłAABBŏl
+	XMFLOAT3 boundsMin = { 0,0,0 };
+	// [JWłAABBől
+	XMFLOAT3 boundsMax = { 0,0,0 };
+	// AABBݒ肳Ă邩iݒȂɕ`悷j
+	bool isBounds = false;
+	// JO̗L
+	bool isCulling = true;
 
 public:
 
@@ -188,19 +242,28 @@ public:
 	/// W̐ݒ
 	/// </summary>
 	/// <param name="_position">W</param>
-	void SetPosition(const XMFLOAT3& _position) { this->position = _position; }
+	void SetPosition(const XMFLOAT3& _position) {
+		this->position = _position;
+		SyncTransform();
+	}
 
 	/// <summary>
 	/// ]p̐ݒ
 	/// </summary>
 	/// <param name="_rotation">]p</param>
-	void SetRotation(const XMFLOAT3& _rotation) { this->rotation = _rotation; }
+	void SetRotation(const XMFLOAT3& _rotation) {
+		this->rotation = _rotation;
+		SyncTransform();
+	}
 
 	/// <summary>
 	/// XP[̐ݒ
 	/// </summary>
 	/// <param name="_scale">XP[</param>
-	void SetScale(const XMFLOAT3& _scale) { this->scale = _scale; }
+	void SetScale(const XMFLOAT3& _scale) {
+		this->scale = _scale;
+		SyncTransform();
+	}
 
 	/// <summary>
 	/// XP[̐ݒ
@@ -287,7 +350,31 @@ public:
 	XMFLOAT3 GetWorldPosition();
 
 	/// <summary>
-	/// eIuWFNg̃Zbg
+	/// eIuWFNg̃ZbgiWE]EXP[͐e猩lɂȂj
+	/// </summary>
+	/// <param name="_parent">eIuWFNgieq֌WOꍇnullptrj</param>
+	void SetParent(InterfaceObject3d* _parent);
+
+	/// <summary>
+	/// TransformSystem̃nh擾io^Ȃ猻݂̍WE]EXP[œo^j
+	/// </summary>
+	/// <returns>nh</returns>
+	int GetTransformHandle();
+
+	/// <summary>
+	/// JOɎg[JWAABB̃Zbg
+	/// </summary>
+	/// <param name="_min">AABBŏl</param>
+	/// <param name="_max">AABBől</param>
+	void SetLocalBounds(const XMFLOAT3& _min, const XMFLOAT3& _max) {
+		this->boundsMin = _min;
+		this->boundsMax = _max;
+		this->isBounds = true;
+	}
+
+	/// <summary>
+	/// JÕZbg
 	/// </summary>
-	void SetParent(InterfaceObject3d* _parent) { parent = _parent; }
+	/// <param name="_isCulling">JOL->true / ->false</param>
+	void SetCulling(bool _isCulling) { this->isCulling = _isCulling; }
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 ﻿#include "Mesh.h"
 #include <cassert>
 #include <vector>
+#include <algorithm>
 
 using namespace DirectX;
 
@@ -38,28 +39,19 @@ void Mesh::AddIndex(const unsigned long& _index)
 	indices.emplace_back(_index);
 }
 
-void Mesh::AddSmoothData(const unsigned long& _indexPosition, const unsigned long& _indexVertex)
+void Mesh::SetCookedData(const VERTEX* _vertices, size_t _vertexNum, const uint32_t* _indices, size_t _indexNum,
+	const MeshSimplifier::LOD* _lods, size_t _lodNum, const XMFLOAT3& _boundsMin, const XMFLOAT3& _boundsMax)
 {
-	smoothData[_indexPosition].emplace_back(_indexVertex);
-}
-
-void Mesh::CalculateSmoothedVertexNormals()
-{
-	auto itr = smoothData.begin();
-	for (; itr != smoothData.end(); ++itr) {
-		// 各面用の共通頂点コレクション
-		std::vector<unsigned long>& v = itr->second;
-		// 全頂点の法線を平均する
-		XMVECTOR normal = {};
-		for (unsigned long index : v) {
-			normal += XMVectorSet(vertices[index].normal.x, vertices[index].normal.y, vertices[index].normal.z, 0);
-		}
-		normal = XMVector3Normalize(normal / float(v.size()));
-
-		for (unsigned long index : v) {
-			vertices[index].normal = { normal.m128_f32[0], normal.m128_f32[1], normal.m128_f32[2] };
-		}
-	}
+	// 頂点ごとの処理はせず、まとめてコピーする
+	vertices.assign(_vertices, _vertices + _vertexNum);
+	const size_t baseIndexNum = _lodNum > 0 ? _lods[0].indexNum : _indexNum;
+	indices.assign(_indices, _indices + baseIndexNum);
+	lodIndices.assign(_indices + baseIndexNum, _indices + _indexNum);
+	lods.assign(_lods, _lods + _lodNum);
+
+	boundsMin = _boundsMin;
+	boundsMax = _boundsMax;
+	isCookedBounds = true;
 }
 
 void Mesh::SetMaterial(Material* _material)
@@ -71,6 +63,23 @@ void Mesh::CreateBuffers()
 {
 	HRESULT result;
 
+	// 視錐台カリング用に頂点を囲むAABBを求めておく（調理済みなら求めてある）
+	if (!isCookedBounds)
+	{
+		boundsMin = {};
+		boundsMax = {};
+		if (!vertices.empty())
+		{
+			boundsMin = vertices[0].pos;
+			boundsMax = vertices[0].pos;
+			for (const VERTEX& vertex : vertices)
+			{
+				boundsMin = { (std::min)(boundsMin.x, vertex.pos.x), (std::min)(boundsMin.y, vertex.pos.y), (std::min)(boundsMin.z, vertex.pos.z) };
+				boundsMax = { (std::max)(boundsMax.x, vertex.pos.x), (std::max)(boundsMax.y, vertex.pos.y), (std::max)(boundsMax.z, vertex.pos.z) };
+			}
+		}
+	}
+
 	UINT sizeVB = static_cast<UINT>(sizeof(VERTEX) * vertices.size());
 	// 頂点バッファ生成
 	result = device->CreateCommittedResource(
@@ -100,7 +109,7 @@ void Mesh::CreateBuffers()
 		return;
 	}
 
-	UINT sizeIB = static_cast<UINT>(sizeof(unsigned long) * indices.size());
+	UINT sizeIB = static_cast<UINT>(sizeof(unsigned long) * (indices.size() + lodIndices.size()));
 	// インデックスバッファ生成
 	result = device->CreateCommittedResource(
 		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
@@ -116,6 +125,8 @@ void Mesh::CreateBuffers()
 	result = indexBuff->Map(0, nullptr, (void**)&indexMap);
 	if (SUCCEEDED(result)) {
 		std::copy(indices.begin(), indices.end(), indexMap);
+		// 2段目以降の詳細度は元の形状の後ろに続ける
+		std::copy(lodIndices.begin(), lodIndices.end(), indexMap + indices.size());
 		indexBuff->Unmap(0, nullptr);
 	}
 
@@ -125,7 +136,7 @@ void Mesh::CreateBuffers()
 	ibView.SizeInBytes = sizeIB;
 }
 
-void Mesh::Draw(ID3D12GraphicsCommandList* _cmdList,const int _shaderResourceView, const int _instanceDrawNum)
+void Mesh::Draw(ID3D12GraphicsCommandList* _cmdList,const int _shaderResourceView, const int _instanceDrawNum, const int _lod)
 {
 	// 頂点バッファをセット
 	_cmdList->IASetVertexBuffers(0, 1, &vbView);
@@ -138,8 +149,13 @@ void Mesh::Draw(ID3D12GraphicsCommandList* _cmdList,const int _shaderResourceVie
 	ID3D12Resource* constBuff = material->GetConstantBuffer();
 	_cmdList->SetGraphicsRootConstantBufferView(1, constBuff->GetGPUVirtualAddress());
 
-	// 描画コマンド
-	_cmdList->DrawIndexedInstanced((UINT)indices.size(), _instanceDrawNum, 0, 0, 0);
+	// 描画コマンド（詳細度の段のインデックスの範囲だけ描く）
+	if (lods.empty()) {
+		_cmdList->DrawIndexedInstanced((UINT)indices.size(), _instanceDrawNum, 0, 0, 0);
+		return;
+	}
+	const MeshSimplifier::LOD& lod = lods[(std::min)((std::max)(_lod, 0), GetLodNum() - 1)];
+	_cmdList->DrawIndexedInstanced(lod.indexNum, _instanceDrawNum, lod.indexStart, 0, 0);
 }
 
 void Mesh::VIDraw(ID3D12GraphicsCommandList* _cmdList)
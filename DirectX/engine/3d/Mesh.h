@@ -5,7 +5,8 @@
 #include <DirectXMath.h>
 #include <d3dx12.h>
 #include "Material.h"
-#include <unordered_map>
+#include "MeshSimplifier.h"
+#include <vector>
 
 /// <summary>
 /// 形状データ
@@ -88,16 +89,31 @@ public: // メンバ関数
 	inline size_t GetVertexCount() { return vertices.size(); }
 
 	/// <summary>
-	/// エッジ平滑化データの追加
+	/// 詳細度の段数を取得
 	/// </summary>
-	/// <param name="_indexPosition">座標インデックス</param>
-	/// <param name="_indexVertex">頂点インデックス</param>
-	void AddSmoothData(const unsigned long& _indexPosition, const unsigned long& _indexVertex);
+	/// <returns>段数（詳細度を持たなければ1）</returns>
+	inline int GetLodNum() { return lods.empty() ? 1 : static_cast<int>(lods.size()); }
 
 	/// <summary>
-	/// 平滑化された頂点法線の計算
+	/// 詳細度1段分の誤差を取得
 	/// </summary>
-	void CalculateSmoothedVertexNormals();
+	/// <param name="_lod">段（0が元の形状）</param>
+	/// <returns>元の形状からのずれ（モデルの座標系での距離）</returns>
+	inline float GetLodError(int _lod) { return _lod < static_cast<int>(lods.size()) ? lods[_lod].error : 0.0f; }
+
+	/// <summary>
+	/// 調理済みモデルの頂点・インデックス・詳細度・AABBをまとめて設定する（バッファ生成時にAABBを求め直さない）
+	/// </summary>
+	/// <param name="_vertices">頂点の先頭</param>
+	/// <param name="_vertexNum">頂点の数</param>
+	/// <param name="_indices">インデックスの先頭（元の形状の後ろに2段目以降が続く）</param>
+	/// <param name="_indexNum">インデックスの数（全ての詳細度の分）</param>
+	/// <param name="_lods">詳細度の範囲の先頭</param>
+	/// <param name="_lodNum">詳細度の段数（0なら元の形状のみ）</param>
+	/// <param name="_boundsMin">AABB最小値</param>
+	/// <param name="_boundsMax">AABB最大値</param>
+	void SetCookedData(const VERTEX* _vertices, size_t _vertexNum, const uint32_t* _indices, size_t _indexNum,
+		const MeshSimplifier::LOD* _lods, size_t _lodNum, const XMFLOAT3& _boundsMin, const XMFLOAT3& _boundsMax);
 
 	/// <summary>
 	/// マテリアルの取得
@@ -134,7 +150,8 @@ public: // メンバ関数
 	/// <param name="_cmdList">命令発行先コマンドリスト</param>
 	/// <param name="_shaderResourceView">シェーダーリソースビュー番号</param>
 	/// <param name="_instanceDrawNum">インスタンシング描画個数</param>
-	void Draw(ID3D12GraphicsCommandList* _cmdList, const int _shaderResourceView, const int _instanceDrawNum);
+	/// <param name="_lod">詳細度の段（段数を超えたら最も粗い段）</param>
+	void Draw(ID3D12GraphicsCommandList* _cmdList, const int _shaderResourceView, const int _instanceDrawNum, const int _lod = 0);
 
 	/// <summary>
 	/// 描画
@@ -149,11 +166,23 @@ public: // メンバ関数
 	inline const std::vector<VERTEX>& GetVertices() { return vertices; }
 
 	/// <summary>
-	/// インデックス配列を取得
+	/// インデックス配列を取得（元の形状の分のみ）
 	/// </summary>
 	/// <returns>インデックス配列</returns>
 	inline const std::vector<unsigned long>& GetIndices() { return indices; }
 
+	/// <summary>
+	/// ローカル座標でのAABB最小値を取得（CreateBuffers時点の頂点から求めたもの、調理済みならその値）
+	/// </summary>
+	/// <returns>AABB最小値</returns>
+	inline const XMFLOAT3& GetBoundsMin() { return boundsMin; }
+
+	/// <summary>
+	/// ローカル座標でのAABB最大値を取得（CreateBuffers時点の頂点から求めたもの、調理済みならその値）
+	/// </summary>
+	/// <returns>AABB最大値</returns>
+	inline const XMFLOAT3& GetBoundsMax() { return boundsMax; }
+
 private: // メンバ変数
 	// 名前
 	std::string name;
@@ -169,8 +198,16 @@ private: // メンバ変数
 	std::vector<VERTEX> vertices;
 	// 頂点インデックス配列
 	std::vector<unsigned long> indices;
-	// 頂点法線スムージング用データ
-	std::unordered_map<unsigned long, std::vector<unsigned long>> smoothData;
+	// 2段目以降の詳細度の頂点インデックス配列（インデックスバッファではindicesの後ろに続く）
+	std::vector<unsigned long> lodIndices;
+	// 詳細度ごとのインデックスの範囲
+	std::vector<MeshSimplifier::LOD> lods;
 	// マテリアル
 	Material* material = nullptr;
+	// ローカル座標でのAABB最小値
+	XMFLOAT3 boundsMin = {};
+	// ローカル座標でのAABB最大値
+	XMFLOAT3 boundsMax = {};
+	// AABBを調理済みモデルから設定したか
+	bool isCookedBounds = false;
 };
\ No newline at end of file
@@ -0,0 +1,427 @@
+﻿#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+	// Forsythの方法で想定するLRUキャッシュの大きさ
+	const int forsyth_cache_size = 32;
+	// 有効な三角形の数の得点を表にする上限
+	const int valence_score_num = 32;
+	// キャッシュ内の位置による得点の減り方
+	const float cacheDecayPower = 1.5f;
+	// 直前の三角形の頂点の得点
+	const float lastTriangleScore = 0.75f;
+	// 残りの三角形が少ない頂点を優先する強さ
+	const float valenceBoostScale = 2.0f;
+	// 残りの三角形の数による得点の減り方
+	const float valenceBoostPower = 0.5f;
+	// オーバードロー用のまとまりで許す、元の並びに対するACMRの倍率（Tipsifyのλ）
+	const float overdrawAcmrThreshold = 1.05f;
+
+	/// <summary>
+	/// 効率の計測と同じFIFOキャッシュの模擬（空にするときは時刻を進めるだけにする）
+	/// </summary>
+	class FifoCache
+	{
+	public:
+		FifoCache(size_t _vertexNum) : cacheTimes(_vertexNum, 0), transformNum(MeshOptimizer::fifo_cache_size) {}
+
+		/// <summary>
+		/// 三角形を描画する
+		/// </summary>
+		/// <param name="_triangle">三角形の3つのインデックス</param>
+		/// <returns>キャッシュになく頂点シェーダーを実行した数</returns>
+		int Transform(const uint32_t* _triangle)
+		{
+			int missNum = 0;
+			for (int i = 0; i < 3; i++)
+			{
+				const uint32_t index = _triangle[i];
+				if (transformNum - cacheTimes[index] < static_cast<uint32_t>(MeshOptimizer::fifo_cache_size)) { continue; }
+				transformNum++;
+				cacheTimes[index] = transformNum;
+				missNum++;
+			}
+			return missNum;
+		}
+
+		/// <summary>
+		/// キャッシュを空にする
+		/// </summary>
+		void Flush() { transformNum += MeshOptimizer::fifo_cache_size; }
+
+	private:
+		// FIFOに入った時の実行回数（実行回数との差がキャッシュの大きさ未満なら、まだ残っている）
+		std::vector<uint32_t> cacheTimes;
+		// 実行回数（最初はどの頂点もキャッシュにないように、キャッシュの大きさから始める）
+		uint32_t transformNum;
+	};
+
+	/// <summary>
+	/// 頂点の得点の表
+	/// </summary>
+	struct VERTEX_SCORE_TABLE
+	{
+		float cache[forsyth_cache_size]; // キャッシュ内の位置ごとの得点
+		float valence[valence_score_num]; // 残りの三角形の数ごとの得点
+
+		VERTEX_SCORE_TABLE()
+		{
+			for (int i = 0; i < forsyth_cache_size; i++)
+			{
+				if (i < 3) {
+					cache[i] = lastTriangleScore;
+				}
+				else {
+					const float scaler = 1.0f / (forsyth_cache_size - 3);
+					cache[i] = std::pow(1.0f - (i - 3) * scaler, cacheDecayPower);
+				}
+			}
+			valence[0] = 0.0f;
+			for (int i = 1; i < valence_score_num; i++)
+			{
+				valence[i] = valenceBoostScale * std::pow(static_cast<float>(i), -valenceBoostPower);
+			}
+		}
+
+		/// <summary>
+		/// 頂点の得点
+		/// </summary>
+		/// <param name="_cachePosition">キャッシュ内の位置（ないときは-1）</param>
+		/// <param name="_remainingNum">まだ描画順が決まっていない三角形の数</param>
+		/// <returns>得点（高いほど早く使いたい）</returns>
+		float GetScore(int _cachePosition, uint32_t _remainingNum) const
+		{
+			if (_remainingNum == 0) { return -1.0f; }
+			const float cacheScore = _cachePosition >= 0 ? cache[_cachePosition] : 0.0f;
+			const float valenceScore = _remainingNum < valence_score_num ? valence[_remainingNum]
+				: valenceBoostScale * std::pow(static_cast<float>(_remainingNum), -valenceBoostPower);
+			return cacheScore + valenceScore;
+		}
+	};
+
+	/// <summary>
+	/// 頂点の座標を取得
+	/// </summary>
+	const DirectX::XMFLOAT3& GetPosition(const DirectX::XMFLOAT3* _positions, size_t _vertexStride, uint32_t _index)
+	{
+		return *reinterpret_cast<const DirectX::XMFLOAT3*>(reinterpret_cast<const uint8_t*>(_positions) + _vertexStride * _index);
+	}
+}
+
+MeshOptimizer::VERTEX_CACHE_STATISTICS MeshOptimizer::AnalyzeVertexCache(const uint32_t* _indices, size_t _indexNum, size_t _vertexNum, int _cacheSize)
+{
+	VERTEX_CACHE_STATISTICS statistics;
+	if (_indexNum < 3) { return statistics; }
+
+	// FIFOに入った時の実行回数（実行回数との差がキャッシュの大きさ未満なら、まだ残っている）
+	std::vector<uint32_t> cacheTimes(_vertexNum, 0);
+	std::vector<uint8_t> isUsed(_vertexNum, 0);
+	uint32_t usedNum = 0;
+	for (size_t i = 0; i < _indexNum; i++)
+	{
+		const uint32_t index = _indices[i];
+		if (!isUsed[index]) {
+			isUsed[index] = 1;
+			usedNum++;
+		}
+		else if (statistics.transformNum - cacheTimes[index] < static_cast<uint32_t>(_cacheSize)) {
+			continue;
+		}
+		statistics.transformNum++;
+		cacheTimes[index] = statistics.transformNum;
+	}
+
+	statistics.acmr = static_cast<float>(statistics.transformNum) / static_cast<float>(_indexNum / 3);
+	statistics.atvr = static_cast<float>(statistics.transformNum) / usedNum;
+	return statistics;
+}
+
+float MeshOptimizer::AnalyzeVertexFetch(const uint32_t* _indices, size_t _indexNum, size_t _vertexNum, size_t _vertexSize)
+{
+	if (_indexNum == 0) { return 0.0f; }
+
+	std::vector<uint32_t> cacheTimes(_vertexNum, 0);
+	std::vector<uint8_t> isUsed(_vertexNum, 0);
+	uint32_t transformNum = 0;
+	size_t usedNum = 0;
+	// キャッシュラインごとに入っているラインの番号（+1、0は空）
+	std::vector<size_t> lines(fetch_line_num, 0);
+	size_t fetchedLineNum = 0;
+	for (size_t i = 0; i < _indexNum; i++)
+	{
+		const uint32_t index = _indices[i];
+		if (!isUsed[index]) {
+			isUsed[index] = 1;
+			usedNum++;
+		}
+		else if (transformNum - cacheTimes[index] < static_cast<uint32_t>(fifo_cache_size)) {
+			continue;
+		}
+		transformNum++;
+		cacheTimes[index] = transformNum;
+
+		// 頂点がまたがるキャッシュラインを読む
+		const size_t begin = index * _vertexSize / fetch_line_size;
+		const size_t end = ((index + 1) * _vertexSize - 1) / fetch_line_size;
+		for (size_t line = begin; line <= end; line++)
+		{
+			size_t& slot = lines[line % fetch_line_num];
+			if (slot != line + 1) {
+				slot = line + 1;
+				fetchedLineNum++;
+			}
+		}
+	}
+
+	return static_cast<float>(fetchedLineNum * fetch_line_size) / static_cast<float>(usedNum * _vertexSize);
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* _indices, size_t _indexNum, size_t _vertexNum)
+{
+	const size_t triangleNum = _indexNum / 3;
+	if (triangleNum == 0) { return; }
+	static const VERTEX_SCORE_TABLE scoreTable;
+
+	// 頂点ごとに、使っている三角形の一覧を作る
+	std::vector<uint32_t> remainingNums(_vertexNum, 0);
+	for (size_t i = 0; i < triangleNum * 3; i++)
+	{
+		remainingNums[_indices[i]]++;
+	}
+	std::vector<uint32_t> adjacencyStarts(_vertexNum + 1, 0);
+	for (size_t i = 0; i < _vertexNum; i++)
+	{
+		adjacencyStarts[i + 1] = adjacencyStarts[i] + remainingNums[i];
+	}
+	std::vector<uint32_t> adjacency(triangleNum * 3);
+	{
+		std::vector<uint32_t> fills(adjacencyStarts.begin(), adjacencyStarts.end() - 1);
+		for (size_t i = 0; i < triangleNum * 3; i++)
+		{
+			adjacency[fills[_indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	// 頂点と三角形の得点
+	std::vector<int> cachePositions(_vertexNum, -1);
+	std::vector<float> vertexScores(_vertexNum);
+	for (size_t i = 0; i < _vertexNum; i++)
+	{
+		vertexScores[i] = scoreTable.GetScore(-1, remainingNums[i]);
+	}
+	std::vector<float> triangleScores(triangleNum);
+	std::vector<uint8_t> isEmitted(triangleNum, 0);
+	uint32_t best = 0;
+	for (size_t i = 0; i < triangleNum; i++)
+	{
+		const uint32_t* triangle = &_indices[i * 3];
+		triangleScores[i] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+		if (triangleScores[i] > triangleScores[best]) { best = static_cast<uint32_t>(i); }
+	}
+
+	std::vector<uint32_t> result(triangleNum * 3);
+	uint32_t cache[forsyth_cache_size + 3];
+	uint32_t newCache[forsyth_cache_size + 3];
+	int cacheNum = 0;
+	size_t cursor = 0;
+	for (size_t emittedNum = 0; emittedNum < triangleNum; emittedNum++)
+	{
+		// キャッシュ内の頂点から続けられる三角形がなければ、まだ描画順が決まっていない先頭の三角形から始める
+		if (best == invalid_index) {
+			while (isEmitted[cursor]) { cursor++; }
+			best = static_cast<uint32_t>(cursor);
+		}
+		const uint32_t* triangle = &_indices[best * 3];
+		std::copy(triangle, triangle + 3, &result[emittedNum * 3]);
+		isEmitted[best] = 1;
+
+		// 使った頂点をキャッシュの先頭に入れ、三角形を頂点の一覧から取り除く
+		int newCacheNum = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			const uint32_t vertex = triangle[i];
+			if (std::find(newCache, newCache + newCacheNum, vertex) == newCache + newCacheNum) {
+				newCache[newCacheNum++] = vertex;
+			}
+			uint32_t* begin = &adjacency[adjacencyStarts[vertex]];
+			uint32_t* end = begin + remainingNums[vertex];
+			std::iter_swap(std::find(begin, end, best), end - 1);
+			remainingNums[vertex]--;
+		}
+		for (int i = 0; i < cacheNum; i++)
+		{
+			const uint32_t vertex = cache[i];
+			if (std::find(triangle, triangle + 3, vertex) == triangle + 3) {
+				newCache[newCacheNum++] = vertex;
+			}
+		}
+
+		// キャッシュ内の位置が変わった頂点と、その三角形の得点を更新し、次に描く三角形を選ぶ
+		for (int i = 0; i < newCacheNum; i++)
+		{
+			const uint32_t vertex = newCache[i];
+			cachePositions[vertex] = i < forsyth_cache_size ? i : -1;
+			vertexScores[vertex] = scoreTable.GetScore(cachePositions[vertex], remainingNums[vertex]);
+		}
+		best = invalid_index;
+		float bestScore = -1.0f;
+		for (int i = 0; i < newCacheNum; i++)
+		{
+			const uint32_t vertex = newCache[i];
+			const uint32_t* begin = &adjacency[adjacencyStarts[vertex]];
+			for (const uint32_t* itr = begin; itr != begin + remainingNums[vertex]; ++itr)
+			{
+				const uint32_t* other = &_indices[*itr * 3];
+				const float score = vertexScores[other[0]] + vertexScores[other[1]] + vertexScores[other[2]];
+				triangleScores[*itr] = score;
+				if (score > bestScore) {
+					bestScore = score;
+					best = *itr;
+				}
+			}
+		}
+
+		cacheNum = (std::min)(newCacheNum, forsyth_cache_size);
+		std::copy(newCache, newCache + cacheNum, cache);
+	}
+
+	std::copy(result.begin(), result.end(), _indices);
+}
+
+size_t MeshOptimizer::OptimizeOverdraw(uint32_t* _indices, size_t _indexNum, const XMFLOAT3* _positions, size_t _vertexNum, size_t _vertexStride)
+{
+	const size_t triangleNum = _indexNum / 3;
+	if (triangleNum == 0) { return 0; }
+
+	// 3頂点ともキャッシュにない三角形で大きく区切る（ここで区切って並べ替えてもキャッシュの効率は変わらない）
+	std::vector<uint32_t> hardStarts;
+	{
+		FifoCache cache(_vertexNum);
+		for (size_t i = 0; i < triangleNum; i++)
+		{
+			if (cache.Transform(&_indices[i * 3]) == 3 || i == 0) { hardStarts.push_back(static_cast<uint32_t>(i)); }
+		}
+	}
+	hardStarts.push_back(static_cast<uint32_t>(triangleNum));
+
+	// 大きなまとまりの中を、空のキャッシュから描いてもACMRがまとまり全体のλ倍に収まった所で細かく区切る
+	//（どの順に並べ替えても、キャッシュの効率の悪化はλ倍程度で済む）
+	std::vector<uint32_t> clusterStarts;
+	FifoCache cache(_vertexNum);
+	for (size_t hard = 0; hard + 1 < hardStarts.size(); hard++)
+	{
+		const uint32_t start = hardStarts[hard];
+		const uint32_t end = hardStarts[hard + 1];
+
+		cache.Flush();
+		int hardMissNum = 0;
+		for (uint32_t i = start; i < end; i++)
+		{
+			hardMissNum += cache.Transform(&_indices[i * 3]);
+		}
+		const float threshold = overdrawAcmrThreshold * hardMissNum / (end - start);
+
+		const size_t hardClusterIndex = clusterStarts.size();
+		clusterStarts.push_back(start);
+		cache.Flush();
+		int missNum = 0;
+		uint32_t clusterStart = start;
+		for (uint32_t i = start; i < end; i++)
+		{
+			missNum += cache.Transform(&_indices[i * 3]);
+			if (missNum <= threshold * (i + 1 - clusterStart)) {
+				clusterStart = i + 1;
+				clusterStarts.push_back(clusterStart);
+				cache.Flush();
+				missNum = 0;
+			}
+		}
+
+		// 最後のまとまりは目標に届かないので前のまとまりにつなげる（ちょうど届いた場合は空のまとまりを消すだけ）
+		if (clusterStarts.size() - 1 > hardClusterIndex) {
+			clusterStarts.pop_back();
+		}
+	}
+	clusterStarts.push_back(static_cast<uint32_t>(triangleNum));
+	const size_t clusterNum = clusterStarts.size() - 1;
+
+	// まとまりごとの面積で重み付けした中心と法線
+	std::vector<XMFLOAT3> centers(clusterNum);
+	std::vector<XMFLOAT3> normals(clusterNum);
+	XMFLOAT3 meshCenter = {};
+	float meshArea = 0.0f;
+	for (size_t i = 0; i < clusterNum; i++)
+	{
+		XMFLOAT3 center = {};
+		XMFLOAT3 normal = {};
+		float area = 0.0f;
+		for (uint32_t j = clusterStarts[i]; j < clusterStarts[i + 1]; j++)
+		{
+			const XMFLOAT3& p0 = GetPosition(_positions, _vertexStride, _indices[j * 3 + 0]);
+			const XMFLOAT3& p1 = GetPosition(_positions, _vertexStride, _indices[j * 3 + 1]);
+			const XMFLOAT3& p2 = GetPosition(_positions, _vertexStride, _indices[j * 3 + 2]);
+			const XMFLOAT3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+			const XMFLOAT3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+			const XMFLOAT3 cross = { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+			const float triangleArea = std::sqrt(cross.x * cross.x + cross.y * cross.y + cross.z * cross.z);
+			center.x += (p0.x + p1.x + p2.x) * triangleArea;
+			center.y += (p0.y + p1.y + p2.y) * triangleArea;
+			center.z += (p0.z + p1.z + p2.z) * triangleArea;
+			normal.x += cross.x;
+			normal.y += cross.y;
+			normal.z += cross.z;
+			area += triangleArea;
+		}
+		meshCenter.x += center.x;
+		meshCenter.y += center.y;
+		meshCenter.z += center.z;
+		meshArea += area;
+		const float invArea = area > 0.0f ? 1.0f / (area * 3.0f) : 0.0f;
+		centers[i] = { center.x * invArea, center.y * invArea, center.z * invArea };
+		const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		const float invLength = length > 0.0f ? 1.0f / length : 0.0f;
+		normals[i] = { normal.x * invLength, normal.y * invLength, normal.z * invLength };
+	}
+	const float invMeshArea = meshArea > 0.0f ? 1.0f / (meshArea * 3.0f) : 0.0f;
+	meshCenter = { meshCenter.x * invMeshArea, meshCenter.y * invMeshArea, meshCenter.z * invMeshArea };
+
+	// メッシュの中心から外を向いているまとまりほど、他を隠しやすいので先に描く
+	std::vector<float> occluderScores(clusterNum);
+	for (size_t i = 0; i < clusterNum; i++)
+	{
+		occluderScores[i] = (centers[i].x - meshCenter.x) * normals[i].x
+			+ (centers[i].y - meshCenter.y) * normals[i].y
+			+ (centers[i].z - meshCenter.z) * normals[i].z;
+	}
+	std::vector<uint32_t> order(clusterNum);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t _a, uint32_t _b) {
+		return occluderScores[_a] > occluderScores[_b];
+		});
+
+	std::vector<uint32_t> result;
+	result.reserve(triangleNum * 3);
+	for (uint32_t cluster : order)
+	{
+		result.insert(result.end(), _indices + clusterStarts[cluster] * 3, _indices + clusterStarts[cluster + 1] * 3);
+	}
+	std::copy(result.begin(), result.end(), _indices);
+	return clusterNum;
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch(uint32_t* _indices, size_t _indexNum, size_t _vertexNum, std::vector<uint32_t>* _remap)
+{
+	_remap->assign(_vertexNum, static_cast<uint32_t>(invalid_index));
+	uint32_t usedNum = 0;
+	for (size_t i = 0; i < _indexNum; i++)
+	{
+		uint32_t& newIndex = (*_remap)[_indices[i]];
+		if (newIndex == invalid_index) { newIndex = usedNum++; }
+		_indices[i] = newIndex;
+	}
+	return usedNum;
+}
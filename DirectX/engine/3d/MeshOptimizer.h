@@ -0,0 +1,104 @@
+﻿#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 三角形リストの描画順・頂点順の最適化（D3D12を使わないので、アセットの加工時にも使える）
+/// </summary>
+class MeshOptimizer
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+
+public: // サブクラス
+
+	// 頂点キャッシュの効率
+	struct VERTEX_CACHE_STATISTICS
+	{
+		uint32_t transformNum = 0; // 頂点シェーダーの実行回数
+		float acmr = 0.0f; // 三角形あたりの実行回数（0.5～3、小さいほど良い）
+		float atvr = 0.0f; // 使われる頂点あたりの実行回数（1が最良）
+	};
+
+public: // 定数
+	// 使われない頂点を表す番号
+	static const uint32_t invalid_index = 0xffffffff;
+	// 効率の計測に使うFIFOキャッシュの大きさ
+	static const int fifo_cache_size = 16;
+	// 頂点フェッチの計測に使うキャッシュライン1つのバイト数
+	static const int fetch_line_size = 64;
+	// 頂点フェッチの計測に使うキャッシュラインの数（ダイレクトマップ）
+	static const int fetch_line_num = 256;
+
+public: // 静的メンバ関数
+
+	/// <summary>
+	/// 頂点キャッシュの効率を計測（FIFOキャッシュを模擬する）
+	/// </summary>
+	/// <param name="_indices">インデックス</param>
+	/// <param name="_indexNum">インデックスの数</param>
+	/// <param name="_vertexNum">頂点の数</param>
+	/// <param name="_cacheSize">キャッシュの大きさ</param>
+	/// <returns>効率</returns>
+	static VERTEX_CACHE_STATISTICS AnalyzeVertexCache(const uint32_t* _indices, size_t _indexNum, size_t _vertexNum, int _cacheSize = fifo_cache_size);
+
+	/// <summary>
+	/// 頂点フェッチの無駄を計測（頂点キャッシュで外れた頂点を読むときのキャッシュラインを模擬する）
+	/// </summary>
+	/// <param name="_indices">インデックス</param>
+	/// <param name="_indexNum">インデックスの数</param>
+	/// <param name="_vertexNum">頂点の数</param>
+	/// <param name="_vertexSize">頂点1つのバイト数</param>
+	/// <returns>読んだバイト数と使われる頂点のバイト数の比（1が最良）</returns>
+	static float AnalyzeVertexFetch(const uint32_t* _indices, size_t _indexNum, size_t _vertexNum, size_t _vertexSize);
+
+	/// <summary>
+	/// 頂点キャッシュに合わせて三角形を並べ替える（Forsythの方法）
+	/// </summary>
+	/// <param name="_indices">インデックス（並べ替えて上書き）</param>
+	/// <param name="_indexNum">インデックスの数</param>
+	/// <param name="_vertexNum">頂点の数</param>
+	static void OptimizeVertexCache(uint32_t* _indices, size_t _indexNum, size_t _vertexNum);
+
+	/// <summary>
+	/// オーバードローが減るように三角形のまとまりを並べ替える（Tipsifyの方法）
+	/// （ACMRの悪化が約1.05倍に収まる所でまとまりを区切り、外を向いたまとまりほど先に描く。OptimizeVertexCacheの後に使う）
+	/// </summary>
+	/// <param name="_indices">インデックス（並べ替えて上書き）</param>
+	/// <param name="_indexNum">インデックスの数</param>
+	/// <param name="_positions">先頭の頂点の座標</param>
+	/// <param name="_vertexNum">頂点の数</param>
+	/// <param name="_vertexStride">頂点1つのバイト数</param>
+	/// <returns>まとまりの数</returns>
+	static size_t OptimizeOverdraw(uint32_t* _indices, size_t _indexNum, const XMFLOAT3* _positions, size_t _vertexNum, size_t _vertexStride);
+
+	/// <summary>
+	/// インデックスで初めて使われる順に頂点の番号を付け直す
+	/// </summary>
+	/// <param name="_indices">インデックス（新しい番号で上書き）</param>
+	/// <param name="_indexNum">インデックスの数</param>
+	/// <param name="_vertexNum">頂点の数</param>
+	/// <param name="_remap">元の番号から新しい番号への対応（出力用、使われない頂点はinvalid_index）</param>
+	/// <returns>使われる頂点の数</returns>
+	static size_t OptimizeVertexFetch(uint32_t* _indices, size_t _indexNum, size_t _vertexNum, std::vector<uint32_t>* _remap);
+
+	/// <summary>
+	/// 番号の対応に従って頂点を並べ替える
+	/// </summary>
+	/// <param name="_vertices">頂点（並べ替えて、使われないものは取り除く）</param>
+	/// <param name="_remap">OptimizeVertexFetchで求めた対応</param>
+	/// <param name="_usedNum">使われる頂点の数</param>
+	template <class T>
+	static void RemapVertices(std::vector<T>* _vertices, const std::vector<uint32_t>& _remap, size_t _usedNum)
+	{
+		std::vector<T> remapped(_usedNum);
+		for (size_t i = 0; i < _remap.size(); i++)
+		{
+			if (_remap[i] != invalid_index) { remapped[_remap[i]] = (*_vertices)[i]; }
+		}
+		_vertices->swap(remapped);
+	}
+};
@@ -0,0 +1,379 @@
+﻿#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+	/// <summary>
+	/// 平面からの距離の二乗の和を表す二次形式（対称4x4行列の上三角と、面積による重みの和）
+	/// </summary>
+	struct QUADRIC
+	{
+		double xx = 0.0, xy = 0.0, xz = 0.0, xw = 0.0;
+		double yy = 0.0, yz = 0.0, yw = 0.0;
+		double zz = 0.0, zw = 0.0;
+		double ww = 0.0;
+		double weight = 0.0;
+
+		/// <summary>
+		/// 平面ax+by+cz+d=0を重み付きで加える
+		/// </summary>
+		void AddPlane(double _a, double _b, double _c, double _d, double _weight)
+		{
+			xx += _a * _a * _weight; xy += _a * _b * _weight; xz += _a * _c * _weight; xw += _a * _d * _weight;
+			yy += _b * _b * _weight; yz += _b * _c * _weight; yw += _b * _d * _weight;
+			zz += _c * _c * _weight; zw += _c * _d * _weight;
+			ww += _d * _d * _weight;
+			weight += _weight;
+		}
+
+		/// <summary>
+		/// 二次形式を加える
+		/// </summary>
+		void Add(const QUADRIC& _other)
+		{
+			xx += _other.xx; xy += _other.xy; xz += _other.xz; xw += _other.xw;
+			yy += _other.yy; yz += _other.yz; yw += _other.yw;
+			zz += _other.zz; zw += _other.zw;
+			ww += _other.ww;
+			weight += _other.weight;
+		}
+
+		/// <summary>
+		/// 点と平面の距離の二乗の重み付き平均
+		/// </summary>
+		double Evaluate(const DirectX::XMFLOAT3& _point) const
+		{
+			if (weight <= 0.0) { return 0.0; }
+			const double x = _point.x, y = _point.y, z = _point.z;
+			const double sum = xx * x * x + yy * y * y + zz * z * z
+				+ 2.0 * (xy * x * y + xz * x * z + yz * y * z)
+				+ 2.0 * (xw * x + yw * y + zw * z) + ww;
+			return (std::max)(sum / weight, 0.0);
+		}
+	};
+
+	// 縮約の候補（fromをtoの位置へ動かしてまとめる）
+	struct COLLAPSE
+	{
+		uint32_t from;
+		uint32_t to;
+		double cost;
+	};
+
+	/// <summary>
+	/// 辺の縮約を繰り返してインデックスを減らす（目標を下げながら何度でも続けられる）
+	/// </summary>
+	class EdgeCollapser
+	{
+	public:
+		EdgeCollapser(const uint32_t* _indices, size_t _indexNum, const DirectX::XMFLOAT3* _positions, size_t _vertexNum, size_t _vertexStride);
+
+		/// <summary>
+		/// インデックスの数が目標以下になるか、縮約できる辺がなくなるまで縮約する
+		/// </summary>
+		/// <returns>これまでの縮約での元の形状からの最大のずれ</returns>
+		float Run(size_t _targetIndexNum);
+
+		/// <summary>
+		/// 現在のインデックスを取得
+		/// </summary>
+		const std::vector<uint32_t>& GetIndices() const { return indices; }
+
+	private:
+
+		/// <summary>
+		/// 頂点の座標を取得
+		/// </summary>
+		const DirectX::XMFLOAT3& GetPosition(uint32_t _index) const
+		{
+			return *reinterpret_cast<const DirectX::XMFLOAT3*>(positions + vertexStride * _index);
+		}
+
+		/// <summary>
+		/// fromをtoへ動かしたとき、周りの三角形が裏返るか
+		/// </summary>
+		bool IsFlipped(uint32_t _from, uint32_t _to) const;
+
+	private:
+		//現在のインデックス
+		std::vector<uint32_t> indices;
+		//先頭の頂点
+		const uint8_t* positions = nullptr;
+		//頂点1つのバイト数
+		size_t vertexStride = 0;
+		//頂点の数
+		size_t vertexNum = 0;
+		//頂点ごとの二次形式
+		std::vector<QUADRIC> quadrics;
+		//動かさない頂点
+		std::vector<uint8_t> isLocked;
+		//頂点ごとの三角形の一覧（縮約1回分の間だけ使う）
+		std::vector<uint32_t> adjacencyStarts;
+		std::vector<uint32_t> adjacency;
+		//これまでの縮約の最大のずれ（距離の二乗）
+		double maxError = 0.0;
+	};
+
+	EdgeCollapser::EdgeCollapser(const uint32_t* _indices, size_t _indexNum, const DirectX::XMFLOAT3* _positions, size_t _vertexNum, size_t _vertexStride)
+		: positions(reinterpret_cast<const uint8_t*>(_positions)), vertexStride(_vertexStride), vertexNum(_vertexNum),
+		quadrics(_vertexNum), isLocked(_vertexNum, 0)
+	{
+		// 潰れた三角形は初めから除く
+		indices.reserve(_indexNum);
+		for (size_t i = 0; i + 2 < _indexNum; i += 3)
+		{
+			const uint32_t* triangle = &_indices[i];
+			if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0]) { continue; }
+			indices.insert(indices.end(), triangle, triangle + 3);
+		}
+
+		// 同じ座標の頂点をまとめた番号
+		std::vector<uint32_t> positionIds(vertexNum);
+		std::vector<uint32_t> positionCounts;
+		{
+			struct POSITION_HASH
+			{
+				size_t operator()(const DirectX::XMFLOAT3& _p) const
+				{
+					uint32_t bits[3];
+					std::memcpy(bits, &_p, sizeof(bits));
+					return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+				}
+			};
+			struct POSITION_EQUAL
+			{
+				bool operator()(const DirectX::XMFLOAT3& _a, const DirectX::XMFLOAT3& _b) const
+				{
+					return _a.x == _b.x && _a.y == _b.y && _a.z == _b.z;
+				}
+			};
+			std::unordered_map<DirectX::XMFLOAT3, uint32_t, POSITION_HASH, POSITION_EQUAL> positionMap;
+			positionMap.reserve(vertexNum);
+			for (size_t i = 0; i < vertexNum; i++)
+			{
+				auto result = positionMap.emplace(GetPosition(static_cast<uint32_t>(i)), static_cast<uint32_t>(positionCounts.size()));
+				if (result.second) { positionCounts.push_back(0); }
+				positionIds[i] = result.first->second;
+				positionCounts[positionIds[i]]++;
+			}
+		}
+
+		// 継ぎ目（同じ座標に別の頂点がある）と、開いた縁（逆向きの辺がない）の座標を動かさない
+		std::vector<uint8_t> isLockedPosition(positionCounts.size(), 0);
+		for (size_t i = 0; i < positionCounts.size(); i++)
+		{
+			isLockedPosition[i] = positionCounts[i] > 1;
+		}
+		std::unordered_set<uint64_t> edges;
+		edges.reserve(indices.size());
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			const uint64_t a = positionIds[indices[i]];
+			const uint64_t b = positionIds[indices[i % 3 == 2 ? i - 2 : i + 1]];
+			edges.insert(a << 32 | b);
+		}
+		for (uint64_t edge : edges)
+		{
+			const uint64_t reverse = edge << 32 | edge >> 32;
+			if (edges.count(reverse) == 0) {
+				isLockedPosition[edge >> 32] = 1;
+				isLockedPosition[edge & 0xffffffff] = 1;
+			}
+		}
+		for (size_t i = 0; i < vertexNum; i++)
+		{
+			isLocked[i] = isLockedPosition[positionIds[i]];
+		}
+
+		// 三角形の平面を面積で重み付けして3頂点の二次形式に加える
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const DirectX::XMFLOAT3& p0 = GetPosition(indices[i + 0]);
+			const DirectX::XMFLOAT3& p1 = GetPosition(indices[i + 1]);
+			const DirectX::XMFLOAT3& p2 = GetPosition(indices[i + 2]);
+			const double e1[3] = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+			const double e2[3] = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+			double normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (length <= 0.0) { continue; }
+			normal[0] /= length;
+			normal[1] /= length;
+			normal[2] /= length;
+			const double d = -(normal[0] * p0.x + normal[1] * p0.y + normal[2] * p0.z);
+			for (int j = 0; j < 3; j++)
+			{
+				quadrics[indices[i + j]].AddPlane(normal[0], normal[1], normal[2], d, length * 0.5);
+			}
+		}
+	}
+
+	bool EdgeCollapser::IsFlipped(uint32_t _from, uint32_t _to) const
+	{
+		const DirectX::XMFLOAT3& to = GetPosition(_to);
+		for (uint32_t i = adjacencyStarts[_from]; i < adjacencyStarts[_from + 1]; i++)
+		{
+			const uint32_t* triangle = &indices[adjacency[i] * 3];
+			if (triangle[0] == _to || triangle[1] == _to || triangle[2] == _to) { continue; }
+
+			// fromから見た残りの2頂点
+			const int corner = triangle[0] == _from ? 0 : (triangle[1] == _from ? 1 : 2);
+			const DirectX::XMFLOAT3& from = GetPosition(_from);
+			const DirectX::XMFLOAT3& p1 = GetPosition(triangle[(corner + 1) % 3]);
+			const DirectX::XMFLOAT3& p2 = GetPosition(triangle[(corner + 2) % 3]);
+			const float e2[3] = { p2.x - p1.x, p2.y - p1.y, p2.z - p1.z };
+			const float oldE1[3] = { from.x - p1.x, from.y - p1.y, from.z - p1.z };
+			const float newE1[3] = { to.x - p1.x, to.y - p1.y, to.z - p1.z };
+			const float oldNormal[3] = { oldE1[1] * e2[2] - oldE1[2] * e2[1], oldE1[2] * e2[0] - oldE1[0] * e2[2], oldE1[0] * e2[1] - oldE1[1] * e2[0] };
+			const float newNormal[3] = { newE1[1] * e2[2] - newE1[2] * e2[1], newE1[2] * e2[0] - newE1[0] * e2[2], newE1[0] * e2[1] - newE1[1] * e2[0] };
+			if (oldNormal[0] * newNormal[0] + oldNormal[1] * newNormal[1] + oldNormal[2] * newNormal[2] <= 0.0f) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	float EdgeCollapser::Run(size_t _targetIndexNum)
+	{
+		const size_t targetTriangleNum = _targetIndexNum / 3;
+		std::vector<uint64_t> edges;
+		std::vector<COLLAPSE> collapses;
+		std::vector<uint32_t> targets(vertexNum);
+		std::vector<uint8_t> isTouched(vertexNum);
+
+		while (indices.size() / 3 > targetTriangleNum)
+		{
+			const size_t triangleNum = indices.size() / 3;
+
+			// 頂点ごとの三角形の一覧
+			adjacencyStarts.assign(vertexNum + 1, 0);
+			for (uint32_t index : indices)
+			{
+				adjacencyStarts[index + 1]++;
+			}
+			for (size_t i = 0; i < vertexNum; i++)
+			{
+				adjacencyStarts[i + 1] += adjacencyStarts[i];
+			}
+			adjacency.resize(indices.size());
+			{
+				std::vector<uint32_t> fills(adjacencyStarts.begin(), adjacencyStarts.end() - 1);
+				for (size_t i = 0; i < indices.size(); i++)
+				{
+					adjacency[fills[indices[i]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+
+			// 辺ごとに、安い方の向きの縮約を候補にする
+			edges.clear();
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				const uint64_t a = indices[i];
+				const uint64_t b = indices[i % 3 == 2 ? i - 2 : i + 1];
+				edges.push_back((std::min)(a, b) << 32 | (std::max)(a, b));
+			}
+			std::sort(edges.begin(), edges.end());
+			edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+			collapses.clear();
+			for (uint64_t edge : edges)
+			{
+				const uint32_t a = static_cast<uint32_t>(edge >> 32);
+				const uint32_t b = static_cast<uint32_t>(edge & 0xffffffff);
+				if (isLocked[a] && isLocked[b]) { continue; }
+				QUADRIC quadric = quadrics[a];
+				quadric.Add(quadrics[b]);
+				const double costAB = isLocked[a] ? (std::numeric_limits<double>::max)() : quadric.Evaluate(GetPosition(b));
+				const double costBA = isLocked[b] ? (std::numeric_limits<double>::max)() : quadric.Evaluate(GetPosition(a));
+				collapses.push_back(costAB <= costBA ? COLLAPSE{ a, b, costAB } : COLLAPSE{ b, a, costBA });
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const COLLAPSE& _a, const COLLAPSE& _b) {
+				return _a.cost < _b.cost;
+				});
+
+			// 安い順に、周りの頂点が同じ回で動かないものだけ縮約する
+			for (size_t i = 0; i < vertexNum; i++)
+			{
+				targets[i] = static_cast<uint32_t>(i);
+			}
+			std::fill(isTouched.begin(), isTouched.end(), 0);
+			size_t removedNum = 0;
+			for (const COLLAPSE& collapse : collapses)
+			{
+				if (isTouched[collapse.from] || isTouched[collapse.to]) { continue; }
+				if (IsFlipped(collapse.from, collapse.to)) { continue; }
+
+				targets[collapse.from] = collapse.to;
+				quadrics[collapse.to].Add(quadrics[collapse.from]);
+				maxError = (std::max)(maxError, collapse.cost);
+				for (uint32_t i = adjacencyStarts[collapse.from]; i < adjacencyStarts[collapse.from + 1]; i++)
+				{
+					const uint32_t* triangle = &indices[adjacency[i] * 3];
+					isTouched[triangle[0]] = isTouched[triangle[1]] = isTouched[triangle[2]] = 1;
+					if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) { removedNum++; }
+				}
+				if (triangleNum - removedNum <= targetTriangleNum) { break; }
+			}
+			if (removedNum == 0) { break; }
+
+			// 縮約した頂点を付け替え、潰れた三角形を除く
+			size_t writeNum = 0;
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const uint32_t a = targets[indices[i + 0]];
+				const uint32_t b = targets[indices[i + 1]];
+				const uint32_t c = targets[indices[i + 2]];
+				if (a == b || b == c || c == a) { continue; }
+				indices[writeNum + 0] = a;
+				indices[writeNum + 1] = b;
+				indices[writeNum + 2] = c;
+				writeNum += 3;
+			}
+			indices.resize(writeNum);
+		}
+
+		return static_cast<float>(std::sqrt(maxError));
+	}
+}
+
+float MeshSimplifier::Simplify(const uint32_t* _indices, size_t _indexNum, const XMFLOAT3* _positions, size_t _vertexNum, size_t _vertexStride,
+	size_t _targetIndexNum, std::vector<uint32_t>* _result)
+{
+	EdgeCollapser collapser(_indices, _indexNum, _positions, _vertexNum, _vertexStride);
+	const float error = collapser.Run(_targetIndexNum);
+	*_result = collapser.GetIndices();
+	return error;
+}
+
+void MeshSimplifier::GenerateLods(const uint32_t* _indices, size_t _indexNum, const XMFLOAT3* _positions, size_t _vertexNum, size_t _vertexStride,
+	int _lodNum, float _reduction, std::vector<uint32_t>* _lodIndices, std::vector<LOD>* _lods)
+{
+	_lodIndices->clear();
+	_lods->clear();
+	LOD original;
+	original.indexNum = static_cast<uint32_t>(_indexNum);
+	_lods->push_back(original);
+	if (_lodNum <= 1 || _indexNum < 3) { return; }
+
+	// 同じ縮約を続けるので、誤差は常に元の形状から測ったものになる
+	EdgeCollapser collapser(_indices, _indexNum, _positions, _vertexNum, _vertexStride);
+	for (int level = 1; level < _lodNum; level++)
+	{
+		const size_t targetIndexNum = static_cast<size_t>(_lods->back().indexNum / 3 * _reduction) * 3;
+		const float error = collapser.Run(targetIndexNum);
+		const std::vector<uint32_t>& result = collapser.GetIndices();
+		// これ以上減らせない
+		if (result.empty() || result.size() >= _lods->back().indexNum) { break; }
+
+		LOD lod;
+		lod.indexStart = static_cast<uint32_t>(_indexNum + _lodIndices->size());
+		lod.indexNum = static_cast<uint32_t>(result.size());
+		lod.error = error;
+		_lods->push_back(lod);
+		_lodIndices->insert(_lodIndices->end(), result.begin(), result.end());
+	}
+}
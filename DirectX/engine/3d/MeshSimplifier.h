@@ -0,0 +1,59 @@
+﻿#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 二次誤差（QEM）による辺の縮約で三角形を減らす（D3D12を使わないので、アセットの加工時にも使える）
+/// （頂点は新しく作らず、残った頂点を指すインデックスだけを作るので、全ての詳細度で頂点バッファを共有できる）
+/// </summary>
+class MeshSimplifier
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+
+public: // サブクラス
+
+	// 詳細度1段分のインデックスの範囲
+	struct LOD
+	{
+		uint32_t indexStart = 0; // インデックスの先頭
+		uint32_t indexNum = 0; // インデックスの数
+		float error = 0.0f; // 元の形状からのずれ（モデルの座標系での距離）
+	};
+
+public: // 静的メンバ関数
+
+	/// <summary>
+	/// 三角形の数を目標まで減らす
+	/// （開いた縁と、同じ座標に別の頂点がある継ぎ目の頂点は動かさない）
+	/// </summary>
+	/// <param name="_indices">インデックス</param>
+	/// <param name="_indexNum">インデックスの数</param>
+	/// <param name="_positions">先頭の頂点の座標</param>
+	/// <param name="_vertexNum">頂点の数</param>
+	/// <param name="_vertexStride">頂点1つのバイト数</param>
+	/// <param name="_targetIndexNum">目標のインデックスの数</param>
+	/// <param name="_result">減らしたインデックス（出力用）</param>
+	/// <returns>元の形状からのずれ</returns>
+	static float Simplify(const uint32_t* _indices, size_t _indexNum, const XMFLOAT3* _positions, size_t _vertexNum, size_t _vertexStride,
+		size_t _targetIndexNum, std::vector<uint32_t>* _result);
+
+	/// <summary>
+	/// 詳細度を段階的に下げたインデックスを作る
+	/// （_lods[0]は元のインデックス、_lods[1]以降は元のインデックスの後ろに_lodIndicesをつなげたものでの範囲）
+	/// </summary>
+	/// <param name="_indices">インデックス</param>
+	/// <param name="_indexNum">インデックスの数</param>
+	/// <param name="_positions">先頭の頂点の座標</param>
+	/// <param name="_vertexNum">頂点の数</param>
+	/// <param name="_vertexStride">頂点1つのバイト数</param>
+	/// <param name="_lodNum">詳細度の段数（元の形状を含む）</param>
+	/// <param name="_reduction">1段ごとに残す三角形の割合</param>
+	/// <param name="_lodIndices">2段目以降のインデックス（出力用）</param>
+	/// <param name="_lods">各段の範囲と誤差（出力用）</param>
+	static void GenerateLods(const uint32_t* _indices, size_t _indexNum, const XMFLOAT3* _positions, size_t _vertexNum, size_t _vertexStride,
+		int _lodNum, float _reduction, std::vector<uint32_t>* _lodIndices, std::vector<LOD>* _lods);
+};
@@ -1,6 +1,6 @@
 ﻿#include "Model.h"
-#include <fstream>
-#include <sstream>
+#include "ModelCooker.h"
+#include "ObjParser.h"
 #include <algorithm>
 
 using namespace std;
@@ -22,11 +22,11 @@ void Model::StaticInitialize(ID3D12Device* _device)
 	Mesh::StaticInitialize(_device);
 }
 
-std::unique_ptr<Model> Model::CreateFromOBJ(const std::string& _modelname, bool _smoothing)
+std::unique_ptr<Model> Model::CreateFromOBJ(const std::string& _modelname, bool _smoothing, bool _optimize, int _lodNum)
 {
 	// メモリ確保
 	Model* instance = new Model;
-	instance->Initialize(_modelname, _smoothing);
+	instance->Initialize(_modelname, _smoothing, _optimize, _lodNum);
 
 	return std::unique_ptr<Model>(instance);
 }
@@ -44,10 +44,10 @@ Model::~Model()
 	materials.clear();
 }
 
-void Model::Initialize(const std::string& _modelname, bool _smoothing)
+void Model::Initialize(const std::string& _modelname, bool _smoothing, bool _optimize, int _lodNum)
 {
 	// モデル読み込み
-	LoadModel(_modelname, _smoothing);
+	LoadModel(_modelname, _smoothing, _optimize, _lodNum);
 
 	// メッシュのマテリアルチェック
 	for (auto& m : meshes) {
@@ -78,286 +78,79 @@ void Model::Initialize(const std::string& _modelname, bool _smoothing)
 	LoadTextures();
 }
 
-void Model::LoadModel(const std::string& _modelname, bool _smoothing)
+void Model::LoadModel(const std::string& _modelname, bool _smoothing, bool _optimize, int _lodNum)
 {
 	const string filename = _modelname + ".obj";
 	const string directoryPath = baseDirectory + _modelname + "/";
-
-	// ファイルストリーム
-	std::ifstream file;
-	// .objファイルを開く
-	file.open(directoryPath + filename);
-	// ファイルオープン失敗をチェック
-	if (file.fail()) {
-		assert(0);
-	}
+	const string cookedFilename = directoryPath + _modelname + ".cmdl";
 
 	name = _modelname;
 
-	// メッシュ生成
-	meshes.emplace_back(new Mesh);
-	Mesh* mesh = meshes.back();
-	int indexCountTex = 0;
-	int indexCountNoTex = 0;
-
-	vector<XMFLOAT3> positions;	// 頂点座標
-	vector<XMFLOAT3> normals;	// 法線ベクトル
-	vector<XMFLOAT2> texcoords;	// テクスチャUV
-	// 1行ずつ読み込む
-	string line;
-	while (getline(file, line)) {
-
-		// 1行分の文字列をストリームに変換して解析しやすくする
-		std::istringstream line_stream(line);
-
-		// 半角スペース区切りで行の先頭文字列を取得
-		string key;
-		getline(line_stream, key, ' ');
-
-		//マテリアル
-		if (key == "mtllib")
-		{
-			// マテリアルのファイル名読み込み
-			string filename;
-			line_stream >> filename;
-			// マテリアル読み込み
-			LoadMaterial(directoryPath, filename);
-		}
-		// 先頭文字列がgならグループの開始
-		if (key == "g") {
-
-			// カレントメッシュの情報が揃っているなら
-			if (mesh->GetName().size() > 0 && mesh->GetVertexCount() > 0) {
-				// 頂点法線の平均によるエッジの平滑化
-				if (_smoothing) {
-					mesh->CalculateSmoothedVertexNormals();
-				}
-				// 次のメッシュ生成
-				meshes.emplace_back(new Mesh);
-				mesh = meshes.back();
-				indexCountTex = 0;
-			}
-
-			// グループ名読み込み
-			string groupName;
-			line_stream >> groupName;
-
-			// メッシュに名前をセット
-			mesh->SetName(groupName);
-		}
-		// 先頭文字列がvなら頂点座標
-		if (key == "v") {
-			// X,Y,Z座標読み込み
-			XMFLOAT3 position{};
-			line_stream >> position.x;
-			line_stream >> position.y;
-			line_stream >> position.z;
-			positions.emplace_back(position);
-		}
-		// 先頭文字列がvtならテクスチャ
-		if (key == "vt")
-		{
-			// U,V成分読み込み
-			XMFLOAT2 texcoord{};
-			line_stream >> texcoord.x;
-			line_stream >> texcoord.y;
-			// V方向反転
-			texcoord.y = 1.0f - texcoord.y;
-			// テクスチャ座標データに追加
-			texcoords.emplace_back(texcoord);
-		}
-		// 先頭文字列がvnなら法線ベクトル
-		if (key == "vn") {
-			// X,Y,Z成分読み込み
-			XMFLOAT3 normal{};
-			line_stream >> normal.x;
-			line_stream >> normal.y;
-			line_stream >> normal.z;
-			// 法線ベクトルデータに追加
-			normals.emplace_back(normal);
-		}
-		// 先頭文字列がusemtlならマテリアルを割り当てる
-		if (key == "usemtl")
-		{
-			if (mesh->GetMaterial() == nullptr) {
-				// マテリアルの名読み込み
-				string materialName;
-				line_stream >> materialName;
-
-				// マテリアル名で検索し、マテリアルを割り当てる
-				auto itr = materials.find(materialName);
-				if (itr != materials.end()) {
-					mesh->SetMaterial(itr->second);
-				}
-			}
-		}
-		// 先頭文字列がfならポリゴン（三角形）
-		if (key == "f")
-		{
-			int faceIndexCount = 0;
-			// 半角スペース区切りで行の続きを読み込む
-			string index_string;
-			while (getline(line_stream, index_string, ' ')) {
-				// 頂点インデックス1個分の文字列をストリームに変換して解析しやすくする
-				std::istringstream index_stream(index_string);
-				unsigned short indexPosition, indexNormal, indexTexcoord;
-				// 頂点番号
-				index_stream >> indexPosition;
-
-				Material* material = mesh->GetMaterial();
-				index_stream.seekg(1, ios_base::cur); // スラッシュを飛ばす
-				// マテリアル、テクスチャがある場合
-				if (material && material->textureFilename.size() > 0) {
-					index_stream >> indexTexcoord;
-					index_stream.seekg(1, ios_base::cur); // スラッシュを飛ばす
-					index_stream >> indexNormal;
-					// 頂点データの追加
-					Mesh::VERTEX vertex{};
-					vertex.pos = positions[indexPosition - 1];
-					vertex.normal = normals[indexNormal - 1];
-					vertex.uv = texcoords[indexTexcoord - 1];
-					mesh->AddVertex(vertex);
-					// エッジ平滑化用のデータを追加
-					if (_smoothing) {
-						mesh->AddSmoothData(indexPosition, (unsigned short)mesh->GetVertexCount() - 1);
-					}
-				} else {
-					char c;
-					index_stream >> c;
-					// スラッシュ2連続の場合、頂点番号のみ
-					if (c == '/') {
-						// 頂点データの追加
-						Mesh::VERTEX vertex{};
-						vertex.pos = positions[indexPosition - 1];
-						vertex.normal = { 0, 0, 1 };
-						vertex.uv = { 0, 0 };
-						mesh->AddVertex(vertex);
-					} else {
-						index_stream.seekg(-1, ios_base::cur); // 1文字戻る
-						index_stream >> indexTexcoord;
-						index_stream.seekg(1, ios_base::cur); // スラッシュを飛ばす
-						index_stream >> indexNormal;
-						// 頂点データの追加
-						Mesh::VERTEX vertex{};
-						vertex.pos = positions[indexPosition - 1];
-						vertex.normal = normals[indexNormal - 1];
-						vertex.uv = { 0, 0 };
-						mesh->AddVertex(vertex);
-						// エッジ平滑化用のデータを追加
-						if (_smoothing) {
-							mesh->AddSmoothData(indexPosition, (unsigned short)mesh->GetVertexCount() - 1);
-						}
-					}
-				}
-				// インデックスデータの追加
-				if (faceIndexCount >= 3) {
-					// 四角形ポリゴンの4点目なので、
-					// 四角形の0,1,2,3の内 2,3,0で三角形を構築する
-					mesh->AddIndex(indexCountTex - 1);
-					mesh->AddIndex(indexCountTex);
-					mesh->AddIndex(indexCountTex - 3);
-				} else
-				{
-					mesh->AddIndex(indexCountTex);
-				}
-				indexCountTex++;
-				faceIndexCount++;
-			}
-		}
+	// 元の.objと.mtlがあれば、調理済みのモデルがそれから作られたかを内容のハッシュで確かめる
+	// （元ファイルを同梱しない製品では.cmdlをそのまま信じる）
+	uint64_t sourceStamp = 0;
+	const bool isSource = ModelCooker::HashSource(directoryPath, filename, &sourceStamp);
+
+	// 同じ条件・同じ元ファイルで調理済みのモデルがあれば、.objを解析せずにメモリマップしたものをそのまま使う
+	CookedModel cooked;
+	CookedModel::CONTENT content;
+	if (!cooked.Open(cookedFilename, sizeof(ModelCooker::VERTEX)) || !ModelCooker::IsMatch(cooked.GetHeader(), _smoothing, _optimize, _lodNum) ||
+		(isSource && cooked.GetHeader().sourceStamp != sourceStamp)) {
+		// .objファイルをメモリマップして解析する（mtllibの.mtlも同じディレクトリから読む）
+		ObjParser parser;
+		if (!parser.Load(directoryPath, filename)) {
+			assert(0);
+		}
+		// 同じ(座標,UV,法線)を持つ面の頂点を1つの頂点にまとめる
+		parser.Weld();
+
+		// 平滑化・詳細度の生成・最適化をする
+		ModelCooker::CookObj(parser, _smoothing, _optimize, _lodNum, &content);
+		content.sourceStamp = sourceStamp;
+
+		// 開発中は次回のために書き出す（書き出せなくても今回はそのまま使う）
+		if (CookedModel::IsWriteOnLoad()) {
+			CookedModel::Write(cookedFilename, content);
+		}
+		cooked.Attach(content);
 	}
-	file.close();
 
-	// 頂点法線の平均によるエッジの平滑化
-	if (_smoothing) {
-		mesh->CalculateSmoothedVertexNormals();
-	}
+	CreateMeshes(cooked);
 }
 
-void Model::LoadMaterial(const std::string& _directoryPath, const std::string& _filename)
+void Model::CreateMeshes(const CookedModel& _cooked)
 {
-	// ファイルストリーム
-	std::ifstream file;
-	// マテリアルファイルを開く
-	file.open(_directoryPath + _filename);
-	// ファイルオープン失敗をチェック
-	if (file.fail()) {
-		assert(0);
-	}
-
-	Material* material = nullptr;
-
-	// 1行ずつ読み込む
-	string line;
-	while (getline(file, line)) {
-
-		// 1行分の文字列をストリームに変換して解析しやすくする
-		std::istringstream line_stream(line);
-
-		// 半角スペース区切りで行の先頭文字列を取得
-		string key;
-		getline(line_stream, key, ' ');
-
-		// 先頭のタブ文字は無視する
-		if (key[0] == '\t') {
-			key.erase(key.begin()); // 先頭の文字を削除
-		}
-
-		// 先頭文字列がnewmtlならマテリアル名
-		if (key == "newmtl") {
-
-			// 既にマテリアルがあれば
-			if (material) {
-				// マテリアルをコンテナに登録
-				AddMaterial(material);
-			}
-
-			// 新しいマテリアルを生成
-			material = Material::Create();
-			// マテリアル名読み込み
-			line_stream >> material->name;
-		}
-		// 先頭文字列がKaならアンビエント色
-		if (key == "Ka") {
-			line_stream >> material->ambient.x;
-			line_stream >> material->ambient.y;
-			line_stream >> material->ambient.z;
-		}
-		// 先頭文字列がKdならディフューズ色
-		if (key == "Kd") {
-			line_stream >> material->diffuse.x;
-			line_stream >> material->diffuse.y;
-			line_stream >> material->diffuse.z;
-		}
-		// 先頭文字列がKsならスペキュラー色
-		if (key == "Ks") {
-			line_stream >> material->specular.x;
-			line_stream >> material->specular.y;
-			line_stream >> material->specular.z;
-		}
-		// 先頭文字列がmap_Kdならテクスチャファイル名
-		if (key == "map_Kd") {
-			// テクスチャのファイル名読み込み
-			line_stream >> material->textureFilename;
-
-			// フルパスからファイル名を取り出す
-			size_t pos1;
-			pos1 = material->textureFilename.rfind('\\');
-			if (pos1 != string::npos) {
-				material->textureFilename = material->textureFilename.substr(pos1 + 1, material->textureFilename.size() - pos1 - 1);
-			}
-
-			pos1 = material->textureFilename.rfind('/');
-			if (pos1 != string::npos) {
-				material->textureFilename = material->textureFilename.substr(pos1 + 1, material->textureFilename.size() - pos1 - 1);
-			}
-		}
+	static_assert(sizeof(Mesh::VERTEX) == sizeof(ModelCooker::VERTEX), "Mesh::VERTEX and ModelCooker::VERTEX must match");
+
+	const CookedModel::HEADER& header = _cooked.GetHeader();
+
+	// マテリアル生成（メッシュからは番号で引く）
+	vector<Material*> materialTable(header.materialNum);
+	for (uint32_t i = 0; i < header.materialNum; i++) {
+		const CookedModel::MATERIAL& cookedMaterial = _cooked.GetMaterials()[i];
+		Material* material = Material::Create();
+		material->name = CookedModel::GetString(cookedMaterial.name);
+		material->ambient = cookedMaterial.ambient;
+		material->diffuse = cookedMaterial.diffuse;
+		material->specular = cookedMaterial.specular;
+		material->textureFilename = CookedModel::GetString(cookedMaterial.textureFilename);
+		AddMaterial(material);
+		materialTable[i] = material;
 	}
-	// ファイルを閉じる
-	file.close();
 
-	if (material) {
-		// マテリアルを登録
-		AddMaterial(material);
+	// メッシュごとに頂点・インデックス・詳細度をまとめて渡す
+	const Mesh::VERTEX* vertices = reinterpret_cast<const Mesh::VERTEX*>(_cooked.GetVertices());
+	for (uint32_t i = 0; i < header.meshNum; i++) {
+		const CookedModel::MESH& cookedMesh = _cooked.GetMeshes()[i];
+		meshes.emplace_back(new Mesh);
+		Mesh* mesh = meshes.back();
+		mesh->SetName(CookedModel::GetString(cookedMesh.name));
+		if (cookedMesh.materialIndex >= 0) {
+			mesh->SetMaterial(materialTable[cookedMesh.materialIndex]);
+		}
+		mesh->SetCookedData(vertices + cookedMesh.vertexStart, cookedMesh.vertexNum,
+			_cooked.GetIndices() + cookedMesh.indexStart, cookedMesh.indexNum,
+			_cooked.GetLods() + cookedMesh.lodStart, cookedMesh.lodNum, cookedMesh.boundsMin, cookedMesh.boundsMax);
 	}
 }
 
@@ -390,11 +183,11 @@ void Model::LoadTextures()
 	}
 }
 
-void Model::Draw(ID3D12GraphicsCommandList* _cmdList, const int _shaderResourceView, const int _instanceDrawNum)
+void Model::Draw(ID3D12GraphicsCommandList* _cmdList, const int _shaderResourceView, const int _instanceDrawNum, const int _lod)
 {
 	// 全メッシュを描画
 	for (auto& mesh : meshes) {
-		mesh->Draw(_cmdList, _shaderResourceView, _instanceDrawNum);
+		mesh->Draw(_cmdList, _shaderResourceView, _instanceDrawNum, _lod);
 	}
 }
 
@@ -404,4 +197,50 @@ void Model::VIDraw(ID3D12GraphicsCommandList* _cmdList)
 	for (auto& mesh : meshes) {
 		mesh->VIDraw(_cmdList);
 	}
+}
+
+bool Model::GetBounds(XMFLOAT3* _min, XMFLOAT3* _max)
+{
+	bool isBounds = false;
+	for (auto& mesh : meshes) {
+		if (mesh->GetVertexCount() == 0) {
+			continue;
+		}
+
+		const XMFLOAT3& meshMin = mesh->GetBoundsMin();
+		const XMFLOAT3& meshMax = mesh->GetBoundsMax();
+		if (!isBounds) {
+			*_min = meshMin;
+			*_max = meshMax;
+			isBounds = true;
+			continue;
+		}
+		*_min = { (std::min)(_min->x, meshMin.x), (std::min)(_min->y, meshMin.y), (std::min)(_min->z, meshMin.z) };
+		*_max = { (std::max)(_max->x, meshMax.x), (std::max)(_max->y, meshMax.y), (std::max)(_max->z, meshMax.z) };
+	}
+	return isBounds;
+}
+
+int Model::GetLodNum()
+{
+	int lodNum = 1;
+	for (auto& mesh : meshes) {
+		lodNum = (std::max)(lodNum, mesh->GetLodNum());
+	}
+	return lodNum;
+}
+
+int Model::SelectLod(float _pixelsPerUnit, float _maxPixelError)
+{
+	// 全メッシュのずれが許容範囲に収まる段まで粗くする
+	const int lodNum = GetLodNum();
+	for (int lod = 1; lod < lodNum; lod++) {
+		for (auto& mesh : meshes) {
+			const int meshLod = (std::min)(lod, mesh->GetLodNum() - 1);
+			if (mesh->GetLodError(meshLod) * _pixelsPerUnit > _maxPixelError) {
+				return lod - 1;
+			}
+		}
+	}
+	return lodNum - 1;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include "CookedModel.h"
 #include "Mesh.h"
 
 /// <summary>
@@ -38,8 +39,10 @@ public: // 静的メンバ関数
 	/// </summary>
 	/// <param name="_modelname">モデル名</param>
 	/// <param name="_smoothing">エッジ平滑化フラグ</param>
+	/// <param name="_optimize">頂点キャッシュ・オーバードロー・頂点フェッチに合わせて並べ替えるか</param>
+	/// <param name="_lodNum">メッシュごとに作る詳細度の段数（1なら元の形状のみ）</param>
 	/// <returns>生成されたモデル</returns>
-	static std::unique_ptr<Model> CreateFromOBJ(const std::string& _modelname, bool _smoothing = false);
+	static std::unique_ptr<Model> CreateFromOBJ(const std::string& _modelname, bool _smoothing = false, bool _optimize = true, int _lodNum = 1);
 
 public: // メンバ関数
 	/// <summary>
@@ -52,7 +55,9 @@ public: // メンバ関数
 	/// </summary>
 	/// <param name="_modelname">モデル名</param>
 	/// <param name="_smoothing">エッジ平滑化フラグ</param>
-	void Initialize(const std::string& _modelname, bool _smoothing);
+	/// <param name="_optimize">頂点キャッシュ・オーバードロー・頂点フェッチに合わせて並べ替えるか</param>
+	/// <param name="_lodNum">メッシュごとに作る詳細度の段数（1なら元の形状のみ）</param>
+	void Initialize(const std::string& _modelname, bool _smoothing, bool _optimize = true, int _lodNum = 1);
 
 	/// <summary>
 	/// 描画
@@ -60,7 +65,8 @@ public: // メンバ関数
 	/// <param name="_cmdList">命令発行先コマンドリスト</param>
 	/// <param name="_shaderResourceView">シェーダーリソースビュー番号</param>
 	/// <param name="_instanceDrawNum">インスタンシング描画個数</param>
-	void Draw(ID3D12GraphicsCommandList* _cmdList, const int _shaderResourceView = 3, const int _instanceDrawNum = 1);
+	/// <param name="_lod">詳細度の段（0が元の形状）</param>
+	void Draw(ID3D12GraphicsCommandList* _cmdList, const int _shaderResourceView = 3, const int _instanceDrawNum = 1, const int _lod = 0);
 
 	/// <summary>
 	/// メッシュコンテナを取得
@@ -80,6 +86,28 @@ public: // メンバ関数
 	/// <returns>メッシュコンテナ</returns>
 	inline void SetMeshes(Mesh* meshes) { this->meshes.push_back(meshes); }
 
+	/// <summary>
+	/// 全メッシュを囲むローカル座標のAABBを取得
+	/// </summary>
+	/// <param name="_min">AABB最小値（出力用）</param>
+	/// <param name="_max">AABB最大値（出力用）</param>
+	/// <returns>頂点を持つメッシュがあるか否か</returns>
+	bool GetBounds(XMFLOAT3* _min, XMFLOAT3* _max);
+
+	/// <summary>
+	/// 詳細度の段数を取得（メッシュの段数の最大）
+	/// </summary>
+	/// <returns>段数</returns>
+	int GetLodNum();
+
+	/// <summary>
+	/// 画面上でのずれが許容範囲に収まる最も粗い詳細度の段を選ぶ
+	/// </summary>
+	/// <param name="_pixelsPerUnit">モデルの座標系での長さ1が画面上で何ピクセルになるか</param>
+	/// <param name="_maxPixelError">許容する画面上でのずれ（ピクセル）</param>
+	/// <returns>詳細度の段</returns>
+	int SelectLod(float _pixelsPerUnit, float _maxPixelError = 1.0f);
+
 private: // メンバ変数
 	// 名前
 	std::string name;
@@ -93,18 +121,20 @@ private: // メンバ変数
 private: // メンバ関数
 
 	/// <summary>
-	/// モデル読み込み
+	/// モデル読み込み（同じ条件・同じ元ファイルの.cmdlがあればそれを使い、なければObjParserで解析して調理する。
+	/// 調理したものはCookedModel::IsWriteOnLoadのときだけ.cmdlに書き出す）
 	/// </summary>
 	/// <param name="_modelname">モデル名</param>
 	/// <param name="_smoothing">エッジ平滑化フラグ</param>
-	void LoadModel(const std::string& _modelname, bool _smoothing);
+	/// <param name="_optimize">頂点キャッシュ・オーバードロー・頂点フェッチに合わせて並べ替えるか</param>
+	/// <param name="_lodNum">メッシュごとに作る詳細度の段数</param>
+	void LoadModel(const std::string& _modelname, bool _smoothing, bool _optimize, int _lodNum);
 
 	/// <summary>
-	/// マテリアル読み込み
+	/// 調理済みモデルからマテリアルとメッシュを作る
 	/// </summary>
-	/// <param name="_directoryPath">ファイルパス</param>
-	/// <param name="_filename">ファイル名</param>
-	void LoadMaterial(const std::string& _directoryPath, const std::string& _filename);
+	/// <param name="_cooked">調理済みモデル</param>
+	void CreateMeshes(const CookedModel& _cooked);
 
 	/// <summary>
 	/// マテリアル登録
@@ -0,0 +1,177 @@
+﻿#include "ModelCooker.h"
+#include "CookedBinary.h"
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+using namespace DirectX;
+
+void ModelCooker::CookObj(const ObjParser& _parser, bool _smoothing, bool _optimize, int _lodNum, CookedModel::CONTENT* _content)
+{
+	CookedModel::CONTENT& content = *_content;
+	content = CookedModel::CONTENT();
+	content.flags = (_smoothing ? CookedModel::flag_smoothing : 0) | (_optimize ? CookedModel::flag_optimized : 0);
+	content.vertexStride = sizeof(VERTEX);
+	content.lodLevelNum = static_cast<uint32_t>((std::max)(_lodNum, 1));
+
+	// マテリアル
+	const std::vector<ObjParser::MATERIAL>& objMaterials = _parser.GetMaterials();
+	content.materials.resize(objMaterials.size());
+	for (size_t i = 0; i < objMaterials.size(); i++) {
+		CookedModel::MATERIAL& material = content.materials[i];
+		material = {};
+		CookedModel::SetString(material.name, objMaterials[i].name);
+		CookedModel::SetString(material.textureFilename, objMaterials[i].textureFilename);
+		material.ambient = objMaterials[i].ambient;
+		material.diffuse = objMaterials[i].diffuse;
+		material.specular = objMaterials[i].specular;
+		material.alpha = 1.0f;
+		material.baseColor = { 1.0f, 1.0f, 1.0f };
+	}
+
+	const std::vector<XMFLOAT3>& positions = _parser.GetPositions();
+	const std::vector<XMFLOAT3>& normals = _parser.GetNormals();
+	const std::vector<XMFLOAT2>& texcoords = _parser.GetTexcoords();
+	const std::vector<ObjParser::CORNER>& corners = _parser.GetCorners();
+	const std::vector<uint32_t>& objIndices = _parser.GetIndices();
+
+	std::vector<VERTEX> allVertices;
+	allVertices.reserve(corners.size());
+	bool isBounds = false;
+
+	// グループごとにメッシュを作る
+	for (const ObjParser::GROUP& group : _parser.GetGroups()) {
+		CookedModel::MESH mesh = {};
+		CookedModel::SetString(mesh.name, group.name);
+		mesh.vertexStart = static_cast<uint32_t>(allVertices.size());
+		mesh.indexStart = static_cast<uint32_t>(content.indices.size());
+		mesh.lodStart = static_cast<uint32_t>(content.lods.size());
+
+		// マテリアル名で検索する（同じ名前が複数あれば最初のもの）
+		mesh.materialIndex = -1;
+		for (size_t i = 0; i < objMaterials.size(); i++) {
+			if (objMaterials[i].name == group.materialName) {
+				mesh.materialIndex = static_cast<int32_t>(i);
+				break;
+			}
+		}
+		const bool isTexture = mesh.materialIndex >= 0 && objMaterials[mesh.materialIndex].textureFilename.size() > 0;
+
+		// まとめた頂点ごとに頂点データを作る
+		std::vector<VERTEX> vertices(group.cornerNum);
+		for (uint32_t i = 0; i < group.cornerNum; i++) {
+			const ObjParser::CORNER& corner = corners[group.cornerStart + i];
+			VERTEX& vertex = vertices[i];
+			vertex.pos = positions[corner.position];
+			vertex.normal = corner.normal != ObjParser::invalid_index ? normals[corner.normal] : XMFLOAT3{ 0, 0, 1 };
+			vertex.uv = isTexture && corner.texcoord != ObjParser::invalid_index ? texcoords[corner.texcoord] : XMFLOAT2{ 0, 0 };
+		}
+		std::vector<uint32_t> indices(objIndices.begin() + group.indexStart, objIndices.begin() + group.indexStart + group.indexNum);
+
+		// 同じ座標を持つ頂点の法線の平均によるエッジの平滑化
+		if (_smoothing) {
+			std::unordered_map<uint32_t, std::vector<uint32_t>> smoothData;
+			for (uint32_t i = 0; i < group.cornerNum; i++) {
+				smoothData[corners[group.cornerStart + i].position].push_back(i);
+			}
+			for (const auto& data : smoothData) {
+				XMFLOAT3 normal = {};
+				for (uint32_t index : data.second) {
+					normal.x += vertices[index].normal.x;
+					normal.y += vertices[index].normal.y;
+					normal.z += vertices[index].normal.z;
+				}
+				const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+				normal = length > 0.0f ? XMFLOAT3{ normal.x / length, normal.y / length, normal.z / length } : XMFLOAT3{};
+				for (uint32_t index : data.second) {
+					vertices[index].normal = normal;
+				}
+			}
+		}
+
+		std::vector<MeshSimplifier::LOD> lods;
+		if (!indices.empty()) {
+			// 詳細度を下げたインデックスを元のインデックスの後ろにつなげる
+			if (_lodNum > 1) {
+				std::vector<uint32_t> lodIndices;
+				MeshSimplifier::GenerateLods(indices.data(), indices.size(), &vertices[0].pos, vertices.size(), sizeof(VERTEX),
+					_lodNum, 0.5f, &lodIndices, &lods);
+				indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+			}
+
+			// 描画順と頂点の並び（元の形状で使われる順。粗い段は元の形状の頂点だけを使う）の最適化
+			if (_optimize) {
+				const size_t lodNum = lods.empty() ? 1 : lods.size();
+				for (size_t i = 0; i < lodNum; i++) {
+					const size_t indexStart = lods.empty() ? 0 : lods[i].indexStart;
+					const size_t indexNum = lods.empty() ? indices.size() : lods[i].indexNum;
+					MeshOptimizer::OptimizeVertexCache(&indices[indexStart], indexNum, vertices.size());
+					MeshOptimizer::OptimizeOverdraw(&indices[indexStart], indexNum, &vertices[0].pos, vertices.size(), sizeof(VERTEX));
+				}
+				std::vector<uint32_t> remap;
+				const size_t usedNum = MeshOptimizer::OptimizeVertexFetch(indices.data(), indices.size(), vertices.size(), &remap);
+				MeshOptimizer::RemapVertices(&vertices, remap, usedNum);
+			}
+		}
+
+		// メッシュとモデル全体のAABB
+		if (!vertices.empty()) {
+			mesh.boundsMin = vertices[0].pos;
+			mesh.boundsMax = vertices[0].pos;
+			for (const VERTEX& vertex : vertices) {
+				mesh.boundsMin = { (std::min)(mesh.boundsMin.x, vertex.pos.x), (std::min)(mesh.boundsMin.y, vertex.pos.y), (std::min)(mesh.boundsMin.z, vertex.pos.z) };
+				mesh.boundsMax = { (std::max)(mesh.boundsMax.x, vertex.pos.x), (std::max)(mesh.boundsMax.y, vertex.pos.y), (std::max)(mesh.boundsMax.z, vertex.pos.z) };
+			}
+			if (!isBounds) {
+				content.boundsMin = mesh.boundsMin;
+				content.boundsMax = mesh.boundsMax;
+				isBounds = true;
+			}
+			content.boundsMin = { (std::min)(content.boundsMin.x, mesh.boundsMin.x), (std::min)(content.boundsMin.y, mesh.boundsMin.y), (std::min)(content.boundsMin.z, mesh.boundsMin.z) };
+			content.boundsMax = { (std::max)(content.boundsMax.x, mesh.boundsMax.x), (std::max)(content.boundsMax.y, mesh.boundsMax.y), (std::max)(content.boundsMax.z, mesh.boundsMax.z) };
+		}
+
+		mesh.vertexNum = static_cast<uint32_t>(vertices.size());
+		mesh.indexNum = static_cast<uint32_t>(indices.size());
+		mesh.lodNum = static_cast<uint32_t>(lods.size());
+		allVertices.insert(allVertices.end(), vertices.begin(), vertices.end());
+		content.indices.insert(content.indices.end(), indices.begin(), indices.end());
+		content.lods.insert(content.lods.end(), lods.begin(), lods.end());
+		content.meshes.push_back(mesh);
+	}
+
+	const uint8_t* vertexBytes = reinterpret_cast<const uint8_t*>(allVertices.data());
+	content.vertices.assign(vertexBytes, vertexBytes + sizeof(VERTEX) * allVertices.size());
+}
+
+bool ModelCooker::HashSource(const std::string& _directoryPath, const std::string& _filename, uint64_t* _sourceStamp)
+{
+	MappedFile file;
+	if (!file.Open(_directoryPath + _filename)) {
+		return false;
+	}
+	uint64_t sourceStamp = CookedBinary::Hash(file.GetData(), file.GetSize(), 0);
+
+	// .mtlはObjParserと同じく.objと同じディレクトリから読む
+	std::vector<std::string> materialFilenames;
+	ObjParser::FindMaterialLibraries(file.GetData(), file.GetData() + file.GetSize(), &materialFilenames);
+	for (const std::string& materialFilename : materialFilenames) {
+		if (!CookedModel::HashFile(_directoryPath + materialFilename, &sourceStamp)) {
+			return false;
+		}
+	}
+
+	*_sourceStamp = sourceStamp;
+	return true;
+}
+
+bool ModelCooker::IsMatch(const CookedModel::HEADER& _header, bool _smoothing, bool _optimize, int _lodNum)
+{
+	const uint32_t flags = (_smoothing ? CookedModel::flag_smoothing : 0) | (_optimize ? CookedModel::flag_optimized : 0);
+	return _header.flags == flags &&
+		_header.lodLevelNum == static_cast<uint32_t>((std::max)(_lodNum, 1));
+}
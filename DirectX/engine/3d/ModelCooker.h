@@ -0,0 +1,55 @@
+﻿#pragma once
+#include "CookedModel.h"
+#include "ObjParser.h"
+
+/// <summary>
+/// OBJを調理済みモデルの内容にする（D3D12を使わないので、ツールでもエンジンの読み込み時でも同じ結果になる）
+/// </summary>
+class ModelCooker
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMFLOAT2 = DirectX::XMFLOAT2;
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+
+public: // サブクラス
+
+	// 頂点（Mesh::VERTEXと同じ並び）
+	struct VERTEX
+	{
+		XMFLOAT3 pos; // xyz座標
+		XMFLOAT3 normal; // 法線ベクトル
+		XMFLOAT2 uv;  // uv座標
+	};
+
+public: // 静的メンバ関数
+
+	/// <summary>
+	/// OBJを調理する（Weld済みの解析結果から、グループごとに平滑化・詳細度の生成・最適化を行う）
+	/// </summary>
+	/// <param name="_parser">Weld済みのOBJの解析結果</param>
+	/// <param name="_smoothing">エッジ平滑化フラグ</param>
+	/// <param name="_optimize">頂点キャッシュ・オーバードロー・頂点フェッチに合わせて並べ替えるか</param>
+	/// <param name="_lodNum">メッシュごとに作る詳細度の段数（1なら元の形状のみ）</param>
+	/// <param name="_content">調理済みモデルの内容（出力用）</param>
+	static void CookObj(const ObjParser& _parser, bool _smoothing, bool _optimize, int _lodNum, CookedModel::CONTENT* _content);
+
+	/// <summary>
+	/// .objとmtllibの.mtlの内容からハッシュを作る（調理済みモデルの元ファイルが変わっていないかの確認用）
+	/// </summary>
+	/// <param name="_directoryPath">ディレクトリ（末尾に/を付ける）</param>
+	/// <param name="_filename">.objのファイル名</param>
+	/// <param name="_sourceStamp">ハッシュ（出力用）</param>
+	/// <returns>全ての元ファイルを読めたか</returns>
+	static bool HashSource(const std::string& _directoryPath, const std::string& _filename, uint64_t* _sourceStamp);
+
+	/// <summary>
+	/// 調理済みモデルの内容が指定と同じ条件で作られたか（頂点の形はCookedModel::Openで確かめる）
+	/// </summary>
+	/// <param name="_header">調理済みモデルのヘッダー</param>
+	/// <param name="_smoothing">エッジ平滑化フラグ</param>
+	/// <param name="_optimize">頂点キャッシュ・オーバードロー・頂点フェッチに合わせて並べ替えるか</param>
+	/// <param name="_lodNum">メッシュごとに作る詳細度の段数</param>
+	/// <returns>同じ条件か</returns>
+	static bool IsMatch(const CookedModel::HEADER& _header, bool _smoothing, bool _optimize, int _lodNum);
+};
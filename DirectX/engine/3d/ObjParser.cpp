@@ -0,0 +1,586 @@
+﻿#include "ObjParser.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace
+{
+	/// <summary>
+	/// 空白（スペース・タブ・改行コードの\r）か
+	/// </summary>
+	bool IsSpace(char _c)
+	{
+		return _c == ' ' || _c == '\t' || _c == '\r';
+	}
+
+	/// <summary>
+	/// 数字か
+	/// </summary>
+	bool IsDigit(char _c)
+	{
+		return static_cast<unsigned char>(_c - '0') < 10;
+	}
+
+	/// <summary>
+	/// 空白を飛ばす
+	/// </summary>
+	void SkipSpace(const char*& _cursor, const char* _end)
+	{
+		while (_cursor < _end && IsSpace(*_cursor)) { _cursor++; }
+	}
+
+	/// <summary>
+	/// 空白で区切られた単語を1つ読む
+	/// </summary>
+	/// <param name="_cursor">読み込み位置（読んだ分進める）</param>
+	/// <param name="_end">終端</param>
+	/// <param name="_tokenEnd">単語の終端（出力用）</param>
+	/// <returns>単語の先頭</returns>
+	const char* ReadToken(const char*& _cursor, const char* _end, const char** _tokenEnd)
+	{
+		SkipSpace(_cursor, _end);
+		const char* begin = _cursor;
+		while (_cursor < _end && !IsSpace(*_cursor)) { _cursor++; }
+		*_tokenEnd = _cursor;
+		return begin;
+	}
+
+	/// <summary>
+	/// 単語がキーワードと一致するか
+	/// </summary>
+	template <size_t N>
+	bool IsKeyword(const char* _begin, const char* _end, const char(&_keyword)[N])
+	{
+		return static_cast<size_t>(_end - _begin) == N - 1 && memcmp(_begin, _keyword, N - 1) == 0;
+	}
+
+	/// <summary>
+	/// 行の終端を探す
+	/// </summary>
+	const char* FindLineEnd(const char* _cursor, const char* _end)
+	{
+		const void* lineEnd = memchr(_cursor, '\n', _end - _cursor);
+		return lineEnd ? static_cast<const char*>(lineEnd) : _end;
+	}
+
+	/// <summary>
+	/// 面の頂点番号の読み込み（負の値は末尾からの番号）
+	/// </summary>
+	/// <param name="_cursor">読み込み位置（読んだ分進める）</param>
+	/// <param name="_end">終端</param>
+	/// <param name="_count">読み込み済みの要素数</param>
+	/// <param name="_index">0始まりの番号（出力用）</param>
+	/// <returns>範囲内の番号を読めたか</returns>
+	bool ParseIndex(const char*& _cursor, const char* _end, size_t _count, uint32_t* _index)
+	{
+		bool isNegative = false;
+		if (_cursor < _end && *_cursor == '-')
+		{
+			isNegative = true;
+			_cursor++;
+		}
+		if (_cursor >= _end || !IsDigit(*_cursor)) { return false; }
+
+		int64_t value = 0;
+		while (_cursor < _end && IsDigit(*_cursor))
+		{
+			value = value * 10 + (*_cursor - '0');
+			if (value > 0xffffffffLL) { return false; }
+			_cursor++;
+		}
+
+		const int64_t index = isNegative ? static_cast<int64_t>(_count) - value : value - 1;
+		if (index < 0 || index >= static_cast<int64_t>(_count)) { return false; }
+		*_index = static_cast<uint32_t>(index);
+		return true;
+	}
+
+	/// <summary>
+	/// 小数を3つ読む
+	/// </summary>
+	bool ParseFloat3(const char* _cursor, const char* _end, XMFLOAT3* _value)
+	{
+		return ObjParser::ParseFloat(_cursor, _end, &_value->x) &&
+			ObjParser::ParseFloat(_cursor, _end, &_value->y) &&
+			ObjParser::ParseFloat(_cursor, _end, &_value->z);
+	}
+
+	/// <summary>
+	/// 面の頂点の番号の組のハッシュ値
+	/// </summary>
+	uint32_t HashCorner(const ObjParser::CORNER& _corner)
+	{
+		uint32_t hash = _corner.position * 73856093u ^ _corner.texcoord * 19349663u ^ _corner.normal * 83492791u;
+		hash ^= hash >> 16;
+		hash *= 0x7feb352du;
+		hash ^= hash >> 15;
+		return hash;
+	}
+
+	/// <summary>
+	/// 面の頂点の番号の組が等しいか
+	/// </summary>
+	bool IsEqualCorner(const ObjParser::CORNER& _a, const ObjParser::CORNER& _b)
+	{
+		return _a.position == _b.position && _a.texcoord == _b.texcoord && _a.normal == _b.normal;
+	}
+
+	/// <summary>
+	/// パスからファイル名を取り出す
+	/// </summary>
+	std::string GetFilename(const char* _begin, const char* _end)
+	{
+		for (const char* c = _end; c > _begin; c--)
+		{
+			if (c[-1] == '\\' || c[-1] == '/') {
+				return std::string(c, _end);
+			}
+		}
+		return std::string(_begin, _end);
+	}
+}
+
+bool ObjParser::Load(const std::string& _directoryPath, const std::string& _filename)
+{
+	MappedFile file;
+	if (!file.Open(_directoryPath + _filename)) {
+		return false;
+	}
+	return Parse(file.GetData(), file.GetData() + file.GetSize(), _directoryPath);
+}
+
+bool ObjParser::Parse(const char* _begin, const char* _end, const std::string& _directoryPath)
+{
+	Clear();
+	Reserve(_begin, _end);
+	groups.emplace_back();
+
+	for (const char* line = _begin; line < _end;)
+	{
+		const char* lineEnd = FindLineEnd(line, _end);
+		const char* cursor = line;
+		line = lineEnd + 1;
+
+		// 先頭の単語で行の種類を判別する
+		const char* keyEnd;
+		const char* key = ReadToken(cursor, lineEnd, &keyEnd);
+		if (key == keyEnd || *key == '#') { continue; }
+
+		if (IsKeyword(key, keyEnd, "v"))
+		{
+			XMFLOAT3 position = {};
+			ParseFloat3(cursor, lineEnd, &position);
+			positions.emplace_back(position);
+		}
+		else if (IsKeyword(key, keyEnd, "vt"))
+		{
+			// V方向反転
+			XMFLOAT2 texcoord = {};
+			ParseFloat(cursor, lineEnd, &texcoord.x);
+			ParseFloat(cursor, lineEnd, &texcoord.y);
+			texcoord.y = 1.0f - texcoord.y;
+			texcoords.emplace_back(texcoord);
+		}
+		else if (IsKeyword(key, keyEnd, "vn"))
+		{
+			XMFLOAT3 normal = {};
+			ParseFloat3(cursor, lineEnd, &normal);
+			normals.emplace_back(normal);
+		}
+		else if (IsKeyword(key, keyEnd, "f"))
+		{
+			if (!ParseFace(cursor, lineEnd)) {
+				return false;
+			}
+		}
+		else if (IsKeyword(key, keyEnd, "g"))
+		{
+			// 名前と面を持つグループがあれば次のグループを始める（なければ名前だけ付け直す）
+			GROUP* group = &groups.back();
+			if (group->name.size() > 0 && group->cornerNum > 0)
+			{
+				groups.emplace_back();
+				group = &groups.back();
+				group->cornerStart = static_cast<uint32_t>(corners.size());
+				group->indexStart = static_cast<uint32_t>(indices.size());
+			}
+			const char* nameEnd;
+			const char* name = ReadToken(cursor, lineEnd, &nameEnd);
+			group->name.assign(name, nameEnd);
+		}
+		else if (IsKeyword(key, keyEnd, "usemtl"))
+		{
+			// 最初に割り当てられたマテリアルだけを使う
+			if (groups.back().materialName.empty())
+			{
+				const char* nameEnd;
+				const char* name = ReadToken(cursor, lineEnd, &nameEnd);
+				groups.back().materialName.assign(name, nameEnd);
+			}
+		}
+		else if (IsKeyword(key, keyEnd, "mtllib"))
+		{
+			const char* nameEnd;
+			const char* name = ReadToken(cursor, lineEnd, &nameEnd);
+			if (!LoadMaterial(_directoryPath + std::string(name, nameEnd))) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void ObjParser::FindMaterialLibraries(const char* _begin, const char* _end, std::vector<std::string>* _filenames)
+{
+	// 行ごとに区切らず'm'だけを探し、行頭の単語がmtllibのものを拾う（頂点や面の行には'm'が出てこない）
+	_filenames->clear();
+	for (const char* m = _begin; m < _end; m++)
+	{
+		m = static_cast<const char*>(memchr(m, 'm', _end - m));
+		if (!m) { break; }
+
+		const char* lineBegin = m;
+		while (lineBegin > _begin && IsSpace(lineBegin[-1])) { lineBegin--; }
+		if (lineBegin > _begin && lineBegin[-1] != '\n') { continue; }
+
+		const char* lineEnd = FindLineEnd(m, _end);
+		const char* cursor = m;
+		const char* keyEnd;
+		const char* key = ReadToken(cursor, lineEnd, &keyEnd);
+		if (IsKeyword(key, keyEnd, "mtllib"))
+		{
+			const char* nameEnd;
+			const char* name = ReadToken(cursor, lineEnd, &nameEnd);
+			if (name != nameEnd) {
+				_filenames->emplace_back(name, nameEnd);
+			}
+		}
+	}
+}
+
+bool ObjParser::LoadMaterial(const std::string& _filename)
+{
+	MappedFile file;
+	if (!file.Open(_filename)) {
+		return false;
+	}
+	ParseMaterial(file.GetData(), file.GetData() + file.GetSize());
+	return true;
+}
+
+void ObjParser::ParseMaterial(const char* _begin, const char* _end)
+{
+	MATERIAL* material = nullptr;
+
+	for (const char* line = _begin; line < _end;)
+	{
+		const char* lineEnd = FindLineEnd(line, _end);
+		const char* cursor = line;
+		line = lineEnd + 1;
+
+		// 先頭のタブ文字は無視する
+		const char* keyEnd;
+		const char* key = ReadToken(cursor, lineEnd, &keyEnd);
+		if (key == keyEnd || *key == '#') { continue; }
+
+		if (IsKeyword(key, keyEnd, "newmtl"))
+		{
+			materials.emplace_back();
+			material = &materials.back();
+			const char* nameEnd;
+			const char* name = ReadToken(cursor, lineEnd, &nameEnd);
+			material->name.assign(name, nameEnd);
+			continue;
+		}
+		if (!material) { continue; }
+
+		if (IsKeyword(key, keyEnd, "Ka")) {
+			ParseFloat3(cursor, lineEnd, &material->ambient);
+		}
+		else if (IsKeyword(key, keyEnd, "Kd")) {
+			ParseFloat3(cursor, lineEnd, &material->diffuse);
+		}
+		else if (IsKeyword(key, keyEnd, "Ks")) {
+			ParseFloat3(cursor, lineEnd, &material->specular);
+		}
+		else if (IsKeyword(key, keyEnd, "map_Kd"))
+		{
+			// フルパスからファイル名を取り出す
+			const char* nameEnd;
+			const char* name = ReadToken(cursor, lineEnd, &nameEnd);
+			material->textureFilename = GetFilename(name, nameEnd);
+		}
+	}
+}
+
+void ObjParser::Weld()
+{
+	std::vector<CORNER> welded;
+	welded.reserve(corners.size());
+	// 番号の組から、まとめた頂点のグループ内での番号を引くハッシュ表（開番地法）
+	std::vector<uint32_t> table;
+	// 元の面の頂点から、まとめた頂点への番号
+	std::vector<uint32_t> remap;
+
+	for (GROUP& group : groups)
+	{
+		const uint32_t weldedStart = static_cast<uint32_t>(welded.size());
+		size_t tableSize = 16;
+		while (tableSize < static_cast<size_t>(group.cornerNum) * 2) { tableSize <<= 1; }
+		const size_t tableMask = tableSize - 1;
+		table.assign(tableSize, static_cast<uint32_t>(invalid_index));
+		remap.resize(group.cornerNum);
+
+		for (uint32_t i = 0; i < group.cornerNum; i++)
+		{
+			const CORNER& corner = corners[group.cornerStart + i];
+			for (size_t slot = HashCorner(corner) & tableMask;; slot = (slot + 1) & tableMask)
+			{
+				const uint32_t found = table[slot];
+				if (found == invalid_index)
+				{
+					// 初めて出てきた組
+					table[slot] = static_cast<uint32_t>(welded.size()) - weldedStart;
+					remap[i] = table[slot];
+					welded.push_back(corner);
+					break;
+				}
+				if (IsEqualCorner(welded[weldedStart + found], corner))
+				{
+					remap[i] = found;
+					break;
+				}
+			}
+		}
+
+		for (uint32_t i = 0; i < group.indexNum; i++)
+		{
+			uint32_t& index = indices[group.indexStart + i];
+			index = remap[index];
+		}
+		group.cornerStart = weldedStart;
+		group.cornerNum = static_cast<uint32_t>(welded.size()) - weldedStart;
+	}
+
+	corners.swap(welded);
+}
+
+void ObjParser::Clear()
+{
+	positions.clear();
+	normals.clear();
+	texcoords.clear();
+	corners.clear();
+	indices.clear();
+	groups.clear();
+	materials.clear();
+}
+
+bool ObjParser::ParseFloat(const char*& _cursor, const char* _end, float* _value)
+{
+	// 誤差なく倍精度に変換できる10の累乗
+	static const double powers[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	SkipSpace(_cursor, _end);
+	const char* begin = _cursor;
+	const char* c = _cursor;
+
+	bool isNegative = false;
+	if (c < _end && (*c == '-' || *c == '+'))
+	{
+		isNegative = *c == '-';
+		c++;
+	}
+
+	// 有効数字を19桁まで整数として読み、小数点の位置は指数に回す
+	uint64_t mantissa = 0;
+	int digitNum = 0;
+	int exponent = 0;
+	bool isDigit = false;
+	for (; c < _end && IsDigit(*c); c++)
+	{
+		isDigit = true;
+		if (digitNum < 19)
+		{
+			mantissa = mantissa * 10 + (*c - '0');
+			if (mantissa > 0) { digitNum++; }
+		}
+		else
+		{
+			exponent++;
+		}
+	}
+	if (c < _end && *c == '.')
+	{
+		for (c++; c < _end && IsDigit(*c); c++)
+		{
+			isDigit = true;
+			if (digitNum < 19)
+			{
+				mantissa = mantissa * 10 + (*c - '0');
+				if (mantissa > 0) { digitNum++; }
+				exponent--;
+			}
+		}
+	}
+
+	bool isFast = isDigit;
+	if (isDigit && c < _end && (*c == 'e' || *c == 'E'))
+	{
+		const char* exponentBegin = c;
+		c++;
+		bool isExponentNegative = false;
+		if (c < _end && (*c == '-' || *c == '+'))
+		{
+			isExponentNegative = *c == '-';
+			c++;
+		}
+		if (c < _end && IsDigit(*c))
+		{
+			int exponentValue = 0;
+			for (; c < _end && IsDigit(*c); c++)
+			{
+				if (exponentValue < 10000) { exponentValue = exponentValue * 10 + (*c - '0'); }
+			}
+			exponent += isExponentNegative ? -exponentValue : exponentValue;
+		}
+		else
+		{
+			// 指数のないeは数値に含めない
+			c = exponentBegin;
+		}
+	}
+
+	if (isFast && mantissa == 0)
+	{
+		*_value = isNegative ? -0.0f : 0.0f;
+		_cursor = c;
+		return true;
+	}
+
+	// 仮数が2^53以下で指数が±22以内なら、1回の乗除算で正しく丸めた倍精度になる
+	if (isFast && digitNum <= 15 && exponent >= -22 && exponent <= 22)
+	{
+		double value = static_cast<double>(mantissa);
+		value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+		*_value = static_cast<float>(isNegative ? -value : value);
+		_cursor = c;
+		return true;
+	}
+
+	// それ以外（桁が多い・inf・nanなど）は終端付きの文字列にしてstrtodに任せる
+	const char* tokenEnd = begin;
+	while (tokenEnd < _end && !IsSpace(*tokenEnd) && *tokenEnd != '\n' && *tokenEnd != '/') { tokenEnd++; }
+	char buffer[64];
+	const size_t length = (std::min)(static_cast<size_t>(tokenEnd - begin), sizeof(buffer) - 1);
+	if (length == 0) { return false; }
+	memcpy(buffer, begin, length);
+	buffer[length] = '\0';
+	char* parsedEnd = nullptr;
+	const double value = strtod(buffer, &parsedEnd);
+	if (parsedEnd == buffer) { return false; }
+	*_value = static_cast<float>(value);
+	_cursor = begin + (parsedEnd - buffer);
+	return true;
+}
+
+void ObjParser::Reserve(const char* _begin, const char* _end)
+{
+	size_t positionNum = 0;
+	size_t texcoordNum = 0;
+	size_t normalNum = 0;
+	size_t faceNum = 0;
+	for (const char* line = _begin; line < _end; line = FindLineEnd(line, _end) + 1)
+	{
+		if (_end - line < 2) { break; }
+		if (line[0] == 'v')
+		{
+			if (IsSpace(line[1])) { positionNum++; }
+			else if (line[1] == 't') { texcoordNum++; }
+			else if (line[1] == 'n') { normalNum++; }
+		}
+		else if (line[0] == 'f' && IsSpace(line[1]))
+		{
+			faceNum++;
+		}
+	}
+
+	// 面は三角形として確保し、多角形の分は足りなければ伸ばす
+	positions.reserve(positionNum);
+	texcoords.reserve(texcoordNum);
+	normals.reserve(normalNum);
+	corners.reserve(faceNum * 3);
+	indices.reserve(faceNum * 3);
+}
+
+bool ObjParser::ParseFace(const char* _cursor, const char* _end)
+{
+	GROUP& group = groups.back();
+	const uint32_t firstCorner = static_cast<uint32_t>(corners.size()) - group.cornerStart;
+	uint32_t faceCornerNum = 0;
+
+	while (true)
+	{
+		SkipSpace(_cursor, _end);
+		if (_cursor >= _end) { break; }
+
+		// v、v/vt、v//vn、v/vt/vnのいずれか
+		CORNER corner = { invalid_index, invalid_index, invalid_index };
+		if (!ParseIndex(_cursor, _end, positions.size(), &corner.position)) {
+			return false;
+		}
+		if (_cursor < _end && *_cursor == '/')
+		{
+			_cursor++;
+			if (_cursor < _end && *_cursor != '/')
+			{
+				if (!ParseIndex(_cursor, _end, texcoords.size(), &corner.texcoord)) {
+					return false;
+				}
+			}
+			if (_cursor < _end && *_cursor == '/')
+			{
+				_cursor++;
+				if (!ParseIndex(_cursor, _end, normals.size(), &corner.normal)) {
+					return false;
+				}
+			}
+		}
+		corners.push_back(corner);
+
+		// 多角形の4点目以降は、直前の点と最初の点で三角形を作る
+		const uint32_t cornerIndex = firstCorner + faceCornerNum;
+		if (faceCornerNum >= 3)
+		{
+			indices.push_back(cornerIndex - 1);
+			indices.push_back(cornerIndex);
+			indices.push_back(firstCorner);
+			group.indexNum += 3;
+		}
+		else
+		{
+			indices.push_back(cornerIndex);
+			group.indexNum++;
+		}
+		faceCornerNum++;
+	}
+
+	// 三角形にならない面は捨てる
+	if (faceCornerNum < 3)
+	{
+		corners.resize(corners.size() - faceCornerNum);
+		indices.resize(indices.size() - faceCornerNum);
+		group.indexNum -= faceCornerNum;
+		return true;
+	}
+
+	group.cornerNum += faceCornerNum;
+	return true;
+}
@@ -0,0 +1,188 @@
+﻿#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// OBJ・MTLファイルの解析
+/// （ファイルをメモリマップし、行を複製せずにその場で数値へ変換する。頂点番号は32bitで扱う）
+/// </summary>
+class ObjParser
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMFLOAT2 = DirectX::XMFLOAT2;
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+
+public: // サブクラス
+
+	// 面の頂点1つ分の番号（0始まり、ないものはinvalid_index）
+	struct CORNER
+	{
+		uint32_t position; // 座標の番号
+		uint32_t texcoord; // UVの番号
+		uint32_t normal; // 法線の番号
+	};
+
+	// グループ（Modelのメッシュ1つ分）
+	struct GROUP
+	{
+		std::string name; // グループ名
+		std::string materialName; // 最初に割り当てられたマテリアル名
+		uint32_t cornerStart = 0; // cornersでの先頭
+		uint32_t cornerNum = 0; // 面の頂点の数
+		uint32_t indexStart = 0; // indicesでの先頭
+		uint32_t indexNum = 0; // 三角形に分割したインデックスの数
+	};
+
+	// マテリアル（値はMaterialの初期値と同じ）
+	struct MATERIAL
+	{
+		std::string name; // マテリアル名
+		XMFLOAT3 ambient = { 0.3f, 0.3f, 0.3f }; // アンビエント色
+		XMFLOAT3 diffuse = { 0.0f, 0.0f, 0.0f }; // ディフューズ色
+		XMFLOAT3 specular = { 0.0f, 0.0f, 0.0f }; // スペキュラー色
+		std::string textureFilename; // テクスチャファイル名（ディレクトリは除く）
+	};
+
+public: // 定数
+	// 番号がないことを表す値
+	static const uint32_t invalid_index = 0xffffffff;
+
+public: // メンバ関数
+
+	/// <summary>
+	/// .objファイルの読み込み（mtllibの.mtlも同じディレクトリから読み込む）
+	/// </summary>
+	/// <param name="_directoryPath">ディレクトリ（末尾に/を付ける）</param>
+	/// <param name="_filename">ファイル名</param>
+	/// <returns>成功か</returns>
+	bool Load(const std::string& _directoryPath, const std::string& _filename);
+
+	/// <summary>
+	/// OBJ形式の文字列の解析
+	/// </summary>
+	/// <param name="_begin">先頭</param>
+	/// <param name="_end">終端</param>
+	/// <param name="_directoryPath">mtllibを探すディレクトリ</param>
+	/// <returns>成功か</returns>
+	bool Parse(const char* _begin, const char* _end, const std::string& _directoryPath);
+
+	/// <summary>
+	/// OBJ形式の文字列からmtllibのファイル名だけを集める（解析せずに元ファイルの一覧を知るため）
+	/// </summary>
+	/// <param name="_begin">先頭</param>
+	/// <param name="_end">終端</param>
+	/// <param name="_filenames">mtllibのファイル名（出力用）</param>
+	static void FindMaterialLibraries(const char* _begin, const char* _end, std::vector<std::string>* _filenames);
+
+	/// <summary>
+	/// .mtlファイルの読み込み
+	/// </summary>
+	/// <param name="_filename">ファイルパス</param>
+	/// <returns>成功か</returns>
+	bool LoadMaterial(const std::string& _filename);
+
+	/// <summary>
+	/// MTL形式の文字列の解析
+	/// </summary>
+	/// <param name="_begin">先頭</param>
+	/// <param name="_end">終端</param>
+	void ParseMaterial(const char* _begin, const char* _end);
+
+	/// <summary>
+	/// グループ内で(座標,UV,法線)の番号が同じ面の頂点を1つにまとめ、インデックスを付け直す
+	/// </summary>
+	void Weld();
+
+	/// <summary>
+	/// 読み込んだ内容を全て破棄
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 小数の読み込み（C++14ではstd::from_charsが使えないため自前で変換し、
+	/// 有効桁が15桁を超える・指数が大きいなど誤差の出る場合だけstrtodに任せる）
+	/// </summary>
+	/// <param name="_cursor">読み込み位置（前の空白は飛ばし、読んだ分進める）</param>
+	/// <param name="_end">終端</param>
+	/// <param name="_value">値（出力用）</param>
+	/// <returns>数値を読めたか</returns>
+	static bool ParseFloat(const char*& _cursor, const char* _end, float* _value);
+
+	/// <summary>
+	/// 座標配列を取得
+	/// </summary>
+	/// <returns>座標配列</returns>
+	const std::vector<XMFLOAT3>& GetPositions() const { return positions; }
+
+	/// <summary>
+	/// 法線配列を取得
+	/// </summary>
+	/// <returns>法線配列</returns>
+	const std::vector<XMFLOAT3>& GetNormals() const { return normals; }
+
+	/// <summary>
+	/// UV配列を取得（Vは反転済み）
+	/// </summary>
+	/// <returns>UV配列</returns>
+	const std::vector<XMFLOAT2>& GetTexcoords() const { return texcoords; }
+
+	/// <summary>
+	/// 面の頂点配列を取得（全グループ分が順に並ぶ。Weld後は重複のない頂点）
+	/// </summary>
+	/// <returns>面の頂点配列</returns>
+	const std::vector<CORNER>& GetCorners() const { return corners; }
+
+	/// <summary>
+	/// 三角形のインデックス配列を取得（グループのcornerStartからの番号）
+	/// </summary>
+	/// <returns>インデックス配列</returns>
+	const std::vector<uint32_t>& GetIndices() const { return indices; }
+
+	/// <summary>
+	/// グループ配列を取得（最低1つある）
+	/// </summary>
+	/// <returns>グループ配列</returns>
+	const std::vector<GROUP>& GetGroups() const { return groups; }
+
+	/// <summary>
+	/// マテリアル配列を取得
+	/// </summary>
+	/// <returns>マテリアル配列</returns>
+	const std::vector<MATERIAL>& GetMaterials() const { return materials; }
+
+private: // メンバ関数
+
+	/// <summary>
+	/// 行の先頭を数え、配列の容量を確保する
+	/// </summary>
+	/// <param name="_begin">先頭</param>
+	/// <param name="_end">終端</param>
+	void Reserve(const char* _begin, const char* _end);
+
+	/// <summary>
+	/// 面の読み込み（多角形は最初の頂点を中心に三角形へ分割する）
+	/// </summary>
+	/// <param name="_cursor">キーワードの後ろ</param>
+	/// <param name="_end">行の終端</param>
+	/// <returns>成功か</returns>
+	bool ParseFace(const char* _cursor, const char* _end);
+
+private: // メンバ変数
+	// 座標
+	std::vector<XMFLOAT3> positions;
+	// 法線
+	std::vector<XMFLOAT3> normals;
+	// UV
+	std::vector<XMFLOAT2> texcoords;
+	// 面の頂点
+	std::vector<CORNER> corners;
+	// 三角形のインデックス
+	std::vector<uint32_t> indices;
+	// グループ
+	std::vector<GROUP> groups;
+	// マテリアル
+	std::vector<MATERIAL> materials;
+};
@@ -7,6 +7,8 @@
 #include "Model.h"
 #include "Texture.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -45,6 +47,19 @@ void Object3d::Initialize()
 	InterfaceObject3d::Initialize();
 }
 
+void Object3d::SetModel(Model* _model)
+{
+	this->model = _model;
+
+	// モデルの頂点を囲むAABBを視錐台カリングに使う
+	XMFLOAT3 modelMin, modelMax;
+	if (_model && _model->GetBounds(&modelMin, &modelMax)) {
+		SetLocalBounds(modelMin, modelMax);
+	} else {
+		isBounds = false;
+	}
+}
+
 void Object3d::PreDraw()
 {
 	// パイプラインステートの設定
@@ -68,8 +83,37 @@ void Object3d::Draw()
 		return;
 	}
 
+	// 視錐台の外にあれば定数バッファの更新ごと省く
+	if (!UpdateCulling()) {
+		return;
+	}
+
 	InterfaceObject3d::Draw();
 
-	// モデル描画
-	model->Draw(cmdList);
+	// モデル描画（遠くて小さく見えるほど粗い詳細度で描く）
+	model->Draw(cmdList, 3, 1, SelectLod());
+}
+
+int Object3d::SelectLod()
+{
+	// 詳細度がない・カメラがない場合は元の形状
+	if (!model || !camera || model->GetLodNum() <= 1) {
+		return 0;
+	}
+
+	// モデルのAABBの中心のワールド座標（AABBがなければ原点）
+	XMFLOAT3 center = { 0, 0, 0 };
+	if (isBounds) {
+		center = { (boundsMin.x + boundsMax.x) * 0.5f, (boundsMin.y + boundsMax.y) * 0.5f, (boundsMin.z + boundsMax.z) * 0.5f };
+	}
+	XMFLOAT3 worldCenter;
+	XMStoreFloat3(&worldCenter, XMVector3Transform(XMLoadFloat3(&center), matWorld));
+
+	// ワールド行列の最大の拡大率で、モデルの座標系での長さ1をワールド座標での長さにする
+	const float worldScale = std::sqrt((std::max)((std::max)(
+		XMVectorGetX(XMVector3LengthSq(matWorld.r[0])),
+		XMVectorGetX(XMVector3LengthSq(matWorld.r[1]))),
+		XMVectorGetX(XMVector3LengthSq(matWorld.r[2]))));
+
+	return model->SelectLod(camera->GetPixelsPerUnit(worldCenter) * worldScale);
 }
\ No newline at end of file
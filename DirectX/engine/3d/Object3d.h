@@ -44,6 +44,12 @@ public: // メンバ関数
 	/// </summary>
 	void Draw() override;
 
+	/// <summary>
+	/// カメラから見た画面上の大きさで、モデルの詳細度の段を選ぶ
+	/// </summary>
+	/// <returns>詳細度の段（0が元の形状）</returns>
+	int SelectLod();
+
 protected: // メンバ変数
 
 	// 名前
@@ -57,7 +63,7 @@ public:
 	/// モデルのセット
 	/// </summary>
 	/// <param name="model">モデル</param>
-	void SetModel(Model* _model) { this->model = _model; }
+	void SetModel(Model* _model);
 
 	/// <summary>
 	/// モデルを取得
@@ -3,6 +3,7 @@
 #include "SafeDelete.h"
 
 #include <vector>
+#include <algorithm>
 
 using namespace DirectX;
 
@@ -22,6 +23,17 @@ void PrimitiveObject3D::Initialize()
 	//_z̑傫
 	size_t vertSize = vertices.size();
 
+	// ͂AABBJOɎgi[hs͕`OɊOZbgj
+	if (vertSize > 0) {
+		XMFLOAT3 vertMin = vertices[0];
+		XMFLOAT3 vertMax = vertices[0];
+		for (const XMFLOAT3& vertex : vertices) {
+			vertMin = { (std::min)(vertMin.x, vertex.x), (std::min)(vertMin.y, vertex.y), (std::min)(vertMin.z, vertex.z) };
+			vertMax = { (std::max)(vertMax.x, vertex.x), (std::max)(vertMax.y, vertex.y), (std::max)(vertMax.z, vertex.z) };
+		}
+		SetLocalBounds(vertMin, vertMax);
+	}
+
 	//_f[^Ŝ̃TCY = _f[^̃TCY * _f[^̗vf
 	const UINT sizeVB = static_cast<UINT>(sizeof(XMFLOAT3) * vertSize);
 
@@ -128,6 +140,11 @@ void PrimitiveObject3D::PreDraw()
 
 void PrimitiveObject3D::Draw()
 {
+	// ̊OɂΒ萔obt@̍XVƏȂ
+	if (!IsVisible()) {
+		return;
+	}
+
 	Update();
 
 	//CfbNXobt@̐ݒ
@@ -0,0 +1,22 @@
+﻿#include "AABBCollider.h"
+
+using namespace DirectX;
+
+void AABBCollider::Update()
+{
+	// ワールド行列から座標を抽出
+	const XMMATRIX& matWorld = object3d->GetMatWorld();
+
+	// ボックスのメンバ変数を更新
+	AABB::center = matWorld.r[3] + offset;
+	AABB::halfSize = halfSize;
+
+	// ブロードフェーズ用のAABBを更新
+	aabbMin = { center.m128_f32[0] - halfSize.x, center.m128_f32[1] - halfSize.y, center.m128_f32[2] - halfSize.z };
+	aabbMax = { center.m128_f32[0] + halfSize.x, center.m128_f32[1] + halfSize.y, center.m128_f32[2] + halfSize.z };
+	UpdateProxy();
+}
+
+void AABBCollider::Draw()
+{
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "BaseCollider.h"
+#include "CollisionPrimitive.h"
+
+#include <DirectXMath.h>
+
+/// <summary>
+/// 軸平行ボックス衝突判定オブジェクト
+/// （オブジェクトの回転・拡大は反映せず、座標のみ追従する）
+/// </summary>
+class AABBCollider : public BaseCollider, public AABB
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMVECTOR = DirectX::XMVECTOR;
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+public:
+	AABBCollider(XMVECTOR _offset = { 0,0,0,0 }, const XMFLOAT3& _halfSize = { 0.5f,0.5f,0.5f }) :
+		offset(_offset),
+		halfSize(_halfSize)
+	{
+		// 軸平行ボックス形状をセット
+		shapeType = COLLISIONSHAPE_AABB;
+	}
+
+	/// <summary>
+	/// 更新
+	/// </summary>
+	void Update() override;
+
+	/// <summary>
+	/// 判定描画
+	/// </summary>
+	void Draw() override;
+
+	inline const XMVECTOR& GetOffset() { return offset; }
+
+	inline void SetOffset(const XMVECTOR& _offset) { this->offset = _offset; }
+
+	inline const XMFLOAT3& GetHalfSize() { return halfSize; }
+
+	inline void SetHalfSize(const XMFLOAT3& _halfSize) { this->halfSize = _halfSize; }
+
+private:
+	// オブジェクト中心からのオフセット
+	XMVECTOR offset;
+	// 各軸方向の大きさの半分
+	XMFLOAT3 halfSize;
+};
@@ -0,0 +1,44 @@
+﻿#include "BaseCollider.h"
+#include "CollisionManager.h"
+#include <cstring>
+
+void BaseCollider::SetAttribute(const unsigned short& _attribute)
+{
+	if (isRegistered) {
+		CollisionManager::GetInstance()->ChangeAttribute(this, _attribute);
+	}
+	else {
+		attribute = _attribute;
+	}
+}
+
+void BaseCollider::AddAttribute(const unsigned short& _attribute)
+{
+	SetAttribute(static_cast<unsigned short>(attribute | _attribute));
+}
+
+void BaseCollider::RemoveAttribute(const unsigned short& _attribute)
+{
+	SetAttribute(static_cast<unsigned short>(attribute & ~_attribute));
+}
+
+void BaseCollider::UpdateProxy()
+{
+	// ワールド行列もAABBも変わっていなければ、接触キャッシュをそのまま使えるよう何もしない
+	const DirectX::XMMATRIX& matWorld = object3d->GetMatWorld();
+	if (memcmp(&matWorld, &lastMatWorld, sizeof(DirectX::XMMATRIX)) == 0 &&
+		memcmp(&aabbMin, &lastAABBMin, sizeof(DirectX::XMFLOAT3)) == 0 &&
+		memcmp(&aabbMax, &lastAABBMax, sizeof(DirectX::XMFLOAT3)) == 0)
+	{
+		return;
+	}
+
+	isMoved = true;
+	lastMatWorld = matWorld;
+	lastAABBMin = aabbMin;
+	lastAABBMax = aabbMax;
+
+	if (isRegistered) {
+		CollisionManager::GetInstance()->MoveCollider(this);
+	}
+}
@@ -34,6 +34,18 @@ public:
 
 	inline COLILSION_SHAPE_TYPE GetShapeType() { return shapeType; }
 
+	/// <summary>
+	/// ワールド座標でのAABB最小値を取得
+	/// </summary>
+	/// <returns>AABB最小値</returns>
+	inline const DirectX::XMFLOAT3& GetAABBMin() { return aabbMin; }
+
+	/// <summary>
+	/// ワールド座標でのAABB最大値を取得
+	/// </summary>
+	/// <returns>AABB最大値</returns>
+	inline const DirectX::XMFLOAT3& GetAABBMax() { return aabbMax; }
+
 	/// <summary>
 	/// 衝突時コールバック関数
 	/// </summary>
@@ -43,28 +55,58 @@ public:
 	}
 
 	/// <summary>
-	/// 当たり判定属性をセット
+	/// 接触開始時コールバック関数
 	/// </summary>
-	/// <param name="attribute">当たり判定属性</param>
-	inline void SetAttribute(const unsigned short& _attribute) {
-		this->attribute = _attribute;
+	/// <param name="info">衝突情報</param>
+	inline void OnCollisionEnter(const CollisionInfo& _info) {
+		object3d->OnCollisionEnter(_info);
 	}
 
+	/// <summary>
+	/// 接触継続時コールバック関数
+	/// </summary>
+	/// <param name="info">衝突情報</param>
+	inline void OnCollisionStay(const CollisionInfo& _info) {
+		object3d->OnCollisionStay(_info);
+	}
+
+	/// <summary>
+	/// 接触終了時コールバック関数
+	/// </summary>
+	/// <param name="info">衝突情報</param>
+	inline void OnCollisionExit(const CollisionInfo& _info) {
+		object3d->OnCollisionExit(_info);
+	}
+
+	/// <summary>
+	/// 当たり判定属性をセット（登録済みならCollisionManagerのレイヤー分けも更新する）
+	/// </summary>
+	/// <param name="attribute">当たり判定属性</param>
+	void SetAttribute(const unsigned short& _attribute);
+
 	/// <summary>
 	/// 当たり判定属性を追加
 	/// </summary>
 	/// <param name="attribute">当たり判定属性</param>
-	inline void AddAttribute(const unsigned short& _attribute) {
-		this->attribute |= _attribute;
-	}
+	void AddAttribute(const unsigned short& _attribute);
 
 	/// <summary>
 	/// 当たり判定属性を削除
 	/// </summary>
 	/// <param name="attribute">当たり判定属性</param>
-	inline void RemoveAttribute(const unsigned short& _attribute) {
-		this->attribute &= !_attribute;
-	}
+	void RemoveAttribute(const unsigned short& _attribute);
+
+	/// <summary>
+	/// 当たり判定属性を取得
+	/// </summary>
+	/// <returns>当たり判定属性</returns>
+	inline unsigned short GetAttribute() { return attribute; }
+
+protected:
+	/// <summary>
+	/// ワールドAABBの変更をCollisionManagerへ反映し、動いたかを記録する（派生クラスのUpdateでAABBを更新した後に呼ぶ）
+	/// </summary>
+	void UpdateProxy();
 
 protected:
 	InterfaceObject3d* object3d = nullptr;
@@ -72,4 +114,23 @@ protected:
 	COLILSION_SHAPE_TYPE shapeType = SHAPE_UNKNOWN;
 	// 当たり判定属性
 	unsigned short attribute = 0b1111111111111111;
+	// CollisionManagerに登録されているか
+	bool isRegistered = false;
+	// 動的AABB木の葉の番号
+	int proxyId = -1;
+	// 属性ごとのまとまりの中での位置
+	int bucketPosition = -1;
+	// CollisionManagerが割り当てる通し番号（接触キャッシュのキーに使う）
+	unsigned int colliderId = 0;
+	// 前回の全衝突チェックから動いたか
+	bool isMoved = true;
+	// 動いたかを調べる為の、前回のワールド行列
+	DirectX::XMMATRIX lastMatWorld = {};
+	// 動いたかを調べる為の、前回のAABB
+	DirectX::XMFLOAT3 lastAABBMin = {};
+	DirectX::XMFLOAT3 lastAABBMax = {};
+	// ワールド座標でのAABB最小値（Update時に更新）
+	DirectX::XMFLOAT3 aabbMin = {};
+	// ワールド座標でのAABB最大値（Update時に更新）
+	DirectX::XMFLOAT3 aabbMax = {};
 };
\ No newline at end of file
@@ -0,0 +1,32 @@
+﻿#include "CapsuleCollider.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+void CapsuleCollider::Update()
+{
+	// 線分の端点をワールド座標へ
+	const XMMATRIX& matWorld = object3d->GetMatWorld();
+	const XMVECTOR start = XMVector3Transform(startOffset, matWorld);
+	const XMVECTOR end = XMVector3Transform(endOffset, matWorld);
+
+	// カプセルのメンバ変数を更新
+	Capsule::startPosition = { start.m128_f32[0], start.m128_f32[1], start.m128_f32[2] };
+	Capsule::endPosition = { end.m128_f32[0], end.m128_f32[1], end.m128_f32[2] };
+	Capsule::radius = radius;
+
+	// ブロードフェーズ用のAABBを更新
+	aabbMin = {
+		(std::min)(startPosition.x, endPosition.x) - radius,
+		(std::min)(startPosition.y, endPosition.y) - radius,
+		(std::min)(startPosition.z, endPosition.z) - radius };
+	aabbMax = {
+		(std::max)(startPosition.x, endPosition.x) + radius,
+		(std::max)(startPosition.y, endPosition.y) + radius,
+		(std::max)(startPosition.z, endPosition.z) + radius };
+	UpdateProxy();
+}
+
+void CapsuleCollider::Draw()
+{
+}
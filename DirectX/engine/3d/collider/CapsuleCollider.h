@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "BaseCollider.h"
+#include "CollisionPrimitive.h"
+
+#include <DirectXMath.h>
+
+/// <summary>
+/// カプセル衝突判定オブジェクト
+/// （線分の端点はオブジェクトのローカル座標で持ち、ワールド行列で回転・拡大する。半径は拡大しない）
+/// </summary>
+class CapsuleCollider : public BaseCollider, public Capsule
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMVECTOR = DirectX::XMVECTOR;
+public:
+	CapsuleCollider(XMVECTOR _startOffset = { 0,0,0,0 }, XMVECTOR _endOffset = { 0,1,0,0 }, float _radius = 0.5f) :
+		startOffset(_startOffset),
+		endOffset(_endOffset),
+		radius(_radius)
+	{
+		// カプセル形状をセット
+		shapeType = COLLISIONSHAPE_CAPSULE;
+	}
+
+	/// <summary>
+	/// 更新
+	/// </summary>
+	void Update() override;
+
+	/// <summary>
+	/// 判定描画
+	/// </summary>
+	void Draw() override;
+
+	inline const XMVECTOR& GetStartOffset() { return startOffset; }
+
+	inline void SetStartOffset(const XMVECTOR& _startOffset) { this->startOffset = _startOffset; }
+
+	inline const XMVECTOR& GetEndOffset() { return endOffset; }
+
+	inline void SetEndOffset(const XMVECTOR& _endOffset) { this->endOffset = _endOffset; }
+
+	inline float GetRadius() { return radius; }
+
+	inline void SetRadius(float _radius) { this->radius = _radius; }
+
+private:
+	// オブジェクトのローカル座標での線分の始点
+	XMVECTOR startOffset;
+	// オブジェクトのローカル座標での線分の終点
+	XMVECTOR endOffset;
+	// 半径
+	float radius;
+};
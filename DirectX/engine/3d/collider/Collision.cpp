@@ -1,7 +1,62 @@
 ﻿#include "Collision.h"
+#include <algorithm>
+#include <cfloat>
 
 using namespace DirectX;
 
+/// <summary>
+/// レイと三角形の交差距離を4レーン同時に求める（Moller-Trumbore法、裏面には当たらない）
+/// </summary>
+/// <returns>レーンごとの交差距離（当たらないレーンは_maxDistance以上）</returns>
+static XMVECTOR IntersectRayTriangleSoA(
+	FXMVECTOR _startX, FXMVECTOR _startY, FXMVECTOR _startZ,
+	GXMVECTOR _dirX, HXMVECTOR _dirY, HXMVECTOR _dirZ,
+	const XMVECTOR& _p0x, const XMVECTOR& _p0y, const XMVECTOR& _p0z,
+	const XMVECTOR& _e1x, const XMVECTOR& _e1y, const XMVECTOR& _e1z,
+	const XMVECTOR& _e2x, const XMVECTOR& _e2y, const XMVECTOR& _e2z,
+	const XMVECTOR& _maxDistance)
+{
+	const XMVECTOR epsilon = XMVectorReplicate(1.0e-5f);	// 誤差吸収用の微小な値
+	const XMVECTOR zero = XMVectorZero();
+	const XMVECTOR one = XMVectorSplatOne();
+
+	// pvec = dir × e2
+	XMVECTOR pvx = XMVectorNegativeMultiplySubtract(_dirZ, _e2y, XMVectorMultiply(_dirY, _e2z));
+	XMVECTOR pvy = XMVectorNegativeMultiplySubtract(_dirX, _e2z, XMVectorMultiply(_dirZ, _e2x));
+	XMVECTOR pvz = XMVectorNegativeMultiplySubtract(_dirY, _e2x, XMVectorMultiply(_dirX, _e2y));
+
+	// 行列式が正なら表面（縮退三角形・方向0のレイは0になり弾かれる）
+	XMVECTOR det = XMVectorMultiplyAdd(_e1x, pvx, XMVectorMultiplyAdd(_e1y, pvy, XMVectorMultiply(_e1z, pvz)));
+	XMVECTOR valid = XMVectorGreater(det, zero);
+	XMVECTOR invDet = XMVectorReciprocal(XMVectorSelect(one, det, valid));
+
+	// 重心座標u
+	XMVECTOR tx = XMVectorSubtract(_startX, _p0x);
+	XMVECTOR ty = XMVectorSubtract(_startY, _p0y);
+	XMVECTOR tz = XMVectorSubtract(_startZ, _p0z);
+	XMVECTOR u = XMVectorMultiply(XMVectorMultiplyAdd(tx, pvx, XMVectorMultiplyAdd(ty, pvy, XMVectorMultiply(tz, pvz))), invDet);
+
+	// qvec = tvec × e1
+	XMVECTOR qvx = XMVectorNegativeMultiplySubtract(tz, _e1y, XMVectorMultiply(ty, _e1z));
+	XMVECTOR qvy = XMVectorNegativeMultiplySubtract(tx, _e1z, XMVectorMultiply(tz, _e1x));
+	XMVECTOR qvz = XMVectorNegativeMultiplySubtract(ty, _e1x, XMVectorMultiply(tx, _e1y));
+
+	// 重心座標v
+	XMVECTOR v = XMVectorMultiply(XMVectorMultiplyAdd(_dirX, qvx, XMVectorMultiplyAdd(_dirY, qvy, XMVectorMultiply(_dirZ, qvz))), invDet);
+
+	// レイ上の距離
+	XMVECTOR t = XMVectorMultiply(XMVectorMultiplyAdd(_e2x, qvx, XMVectorMultiplyAdd(_e2y, qvy, XMVectorMultiply(_e2z, qvz))), invDet);
+
+	// 三角形の内側かつレイの前方で、既知の交点より近いもののみ有効
+	valid = XMVectorAndInt(valid, XMVectorGreaterOrEqual(u, XMVectorNegate(epsilon)));
+	valid = XMVectorAndInt(valid, XMVectorGreaterOrEqual(v, XMVectorNegate(epsilon)));
+	valid = XMVectorAndInt(valid, XMVectorLessOrEqual(XMVectorAdd(u, v), XMVectorAdd(one, epsilon)));
+	valid = XMVectorAndInt(valid, XMVectorGreaterOrEqual(t, zero));
+	valid = XMVectorAndInt(valid, XMVectorLess(t, _maxDistance));
+
+	return XMVectorSelect(_maxDistance, t, valid);
+}
+
 bool Collision::CheckCircle2Circle(const DirectX::XMFLOAT3& pos1, float radius1, const DirectX::XMFLOAT3& pos2, float radius2)
 {
 	float disX = pos2.x - pos1.x;
@@ -160,6 +215,34 @@ bool Collision::CheckSphere2Triangle(const Sphere& _sphere, const Triangle& _tri
 	return true;
 }
 
+bool Collision::CheckSphere2Triangle(const Sphere& _sphere, const Triangle& _triangle, CONTACT_POINT* _contact)
+{
+	XMVECTOR p;
+	ClosestPtPoint2Triangle(_sphere.center, _triangle, &p);
+	XMVECTOR v = _sphere.center - p;
+	float distanceSquare = XMVector3Dot(v, v).m128_f32[0];
+	if (distanceSquare > _sphere.radius * _sphere.radius) {
+		return false;
+	}
+
+	_contact->point = p;
+
+	// 中心が表側にあり最近接点から離れていれば、その向きに押し出す
+	const float epsilon = 1.0e-6f;
+	const float planeDistance = XMVector3Dot(_sphere.center - _triangle.p0, _triangle.normal).m128_f32[0];
+	if (planeDistance > 0.0f && distanceSquare > epsilon) {
+		const float distance = sqrtf(distanceSquare);
+		_contact->normal = v / distance;
+		_contact->depth = _sphere.radius - distance;
+	}
+	// 面上や裏側まで埋まっている場合は面法線で押し出す
+	else {
+		_contact->normal = _triangle.normal;
+		_contact->depth = _sphere.radius - planeDistance;
+	}
+	return true;
+}
+
 bool Collision::CheckRay2Plane(const Ray& _lay, const Plane& _plane, float* _distance, DirectX::XMVECTOR* _inter)
 {
 	const float epsilon = 1.0e-5f;	// 誤差吸収用の微小な値
@@ -239,6 +322,127 @@ bool Collision::CheckRay2Triangle(const Ray& _lay, const Triangle& _triangle, fl
 	return true;
 }
 
+bool Collision::CheckRay2Triangle4(const Ray& _lay, const Triangle4& _triangle4, float _maxDistance, float* _distance, int* _index)
+{
+	XMVECTOR maxDistance = XMVectorReplicate(_maxDistance);
+	XMVECTOR t = IntersectRayTriangleSoA(
+		XMVectorSplatX(_lay.start), XMVectorSplatY(_lay.start), XMVectorSplatZ(_lay.start),
+		XMVectorSplatX(_lay.dir), XMVectorSplatY(_lay.dir), XMVectorSplatZ(_lay.dir),
+		_triangle4.p0x, _triangle4.p0y, _triangle4.p0z,
+		_triangle4.e1x, _triangle4.e1y, _triangle4.e1z,
+		_triangle4.e2x, _triangle4.e2y, _triangle4.e2z,
+		maxDistance);
+
+	XMFLOAT4A distance;
+	XMStoreFloat4A(&distance, t);
+
+	// 最も近いレーンを探す
+	int closestIndex = -1;
+	float closestDistance = _maxDistance;
+	for (int i = 0; i < 4; i++)
+	{
+		const float laneDistance = (&distance.x)[i];
+		if (laneDistance < closestDistance)
+		{
+			closestDistance = laneDistance;
+			closestIndex = i;
+		}
+	}
+
+	if (closestIndex < 0) {
+		return false;
+	}
+
+	if (_distance) {
+		*_distance = closestDistance;
+	}
+	if (_index) {
+		*_index = closestIndex;
+	}
+
+	return true;
+}
+
+int Collision::CheckRay4Triangle(const Ray4& _ray4, const Triangle& _triangle, DirectX::XMVECTOR* _distance)
+{
+	XMVECTOR edge1 = _triangle.p1 - _triangle.p0;
+	XMVECTOR edge2 = _triangle.p2 - _triangle.p0;
+
+	XMVECTOR t = IntersectRayTriangleSoA(
+		_ray4.startX, _ray4.startY, _ray4.startZ,
+		_ray4.dirX, _ray4.dirY, _ray4.dirZ,
+		XMVectorSplatX(_triangle.p0), XMVectorSplatY(_triangle.p0), XMVectorSplatZ(_triangle.p0),
+		XMVectorSplatX(edge1), XMVectorSplatY(edge1), XMVectorSplatZ(edge1),
+		XMVectorSplatX(edge2), XMVectorSplatY(edge2), XMVectorSplatZ(edge2),
+		*_distance);
+
+	XMVECTOR hitMask = XMVectorLess(t, *_distance);
+	*_distance = t;
+
+	XMUINT4 mask;
+	XMStoreUInt4(&mask, hitMask);
+	return (mask.x & 1) | (mask.y & 2) | (mask.z & 4) | (mask.w & 8);
+}
+
+bool Collision::CheckRay2AABB(const DirectX::XMFLOAT3& _start, const DirectX::XMFLOAT3& _invDir,
+	const DirectX::XMFLOAT3& _min, const DirectX::XMFLOAT3& _max, float _maxDistance)
+{
+	float tx1 = (_min.x - _start.x) * _invDir.x;
+	float tx2 = (_max.x - _start.x) * _invDir.x;
+	float tMin = (std::min)(tx1, tx2);
+	float tMax = (std::max)(tx1, tx2);
+
+	float ty1 = (_min.y - _start.y) * _invDir.y;
+	float ty2 = (_max.y - _start.y) * _invDir.y;
+	tMin = (std::max)(tMin, (std::min)(ty1, ty2));
+	tMax = (std::min)(tMax, (std::max)(ty1, ty2));
+
+	float tz1 = (_min.z - _start.z) * _invDir.z;
+	float tz2 = (_max.z - _start.z) * _invDir.z;
+	tMin = (std::max)(tMin, (std::min)(tz1, tz2));
+	tMax = (std::min)(tMax, (std::max)(tz1, tz2));
+
+	return tMax >= tMin && tMax >= 0.0f && tMin < _maxDistance;
+}
+
+int Collision::CheckRay4AABB(const Ray4& _ray4, const XMVECTOR& _invDirX, const XMVECTOR& _invDirY, const XMVECTOR& _invDirZ,
+	const XMFLOAT3& _min, const XMFLOAT3& _max, const XMVECTOR& _maxDistance)
+{
+	XMVECTOR tx1 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(_min.x), _ray4.startX), _invDirX);
+	XMVECTOR tx2 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(_max.x), _ray4.startX), _invDirX);
+	XMVECTOR tMin = XMVectorMin(tx1, tx2);
+	XMVECTOR tMax = XMVectorMax(tx1, tx2);
+
+	XMVECTOR ty1 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(_min.y), _ray4.startY), _invDirY);
+	XMVECTOR ty2 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(_max.y), _ray4.startY), _invDirY);
+	tMin = XMVectorMax(tMin, XMVectorMin(ty1, ty2));
+	tMax = XMVectorMin(tMax, XMVectorMax(ty1, ty2));
+
+	XMVECTOR tz1 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(_min.z), _ray4.startZ), _invDirZ);
+	XMVECTOR tz2 = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(_max.z), _ray4.startZ), _invDirZ);
+	tMin = XMVectorMax(tMin, XMVectorMin(tz1, tz2));
+	tMax = XMVectorMin(tMax, XMVectorMax(tz1, tz2));
+
+	XMVECTOR hitMask = XMVectorAndInt(XMVectorGreaterOrEqual(tMax, tMin), XMVectorGreaterOrEqual(tMax, XMVectorZero()));
+	hitMask = XMVectorAndInt(hitMask, XMVectorLess(tMin, _maxDistance));
+
+	XMUINT4 mask;
+	XMStoreUInt4(&mask, hitMask);
+	return (mask.x & 1) | (mask.y & 2) | (mask.z & 4) | (mask.w & 8);
+}
+
+DirectX::XMFLOAT3 Collision::ComputeInvDir(const DirectX::XMVECTOR& _dir)
+{
+	XMFLOAT3 invDir;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		//軸に平行な場合はスラブの判定が破綻しないよう十分大きな値にする
+		const float dir = _dir.m128_f32[axis];
+		(&invDir.x)[axis] = fabsf(dir) > 1.0e-8f ? 1.0f / dir : (dir < 0.0f ? -1.0e+8f : 1.0e+8f);
+	}
+	return invDir;
+}
+
 bool Collision::CheckRay2Sphere(const Ray & lay, const Sphere & sphere, float*distance, DirectX::XMVECTOR * inter)
 {
 	XMVECTOR m = lay.start - sphere.center;
@@ -273,6 +477,200 @@ bool Collision::CheckRay2Sphere(const Ray & lay, const Sphere & sphere, float*di
 	return true;
 }
 
+/// <summary>
+/// 移動する点と球（または頂点を中心とした球）の最初の接触時刻を求める
+/// </summary>
+/// <param name="_start">点の開始位置</param>
+/// <param name="_displacement">移動量</param>
+/// <param name="_center">球の中心</param>
+/// <param name="_radius">球の半径</param>
+/// <param name="_time">接触時刻（出力用）</param>
+/// <returns>時刻0～1の間に接触するか否か</returns>
+static bool SweepPoint2Sphere(const XMVECTOR& _start, const XMVECTOR& _displacement,
+	const XMVECTOR& _center, float _radius, float* _time)
+{
+	XMVECTOR m = _start - _center;
+	float a = XMVector3Dot(_displacement, _displacement).m128_f32[0];
+	float b = XMVector3Dot(m, _displacement).m128_f32[0];
+	float c = XMVector3Dot(m, m).m128_f32[0] - _radius * _radius;
+	// 離れていく、または動いていない
+	if (b >= 0.0f || a <= 0.0f) {
+		return false;
+	}
+	float discr = b * b - a * c;
+	if (discr < 0.0f) {
+		return false;
+	}
+	float t = (-b - sqrtf(discr)) / a;
+	if (t < 0.0f || t > 1.0f) {
+		return false;
+	}
+	*_time = t;
+	return true;
+}
+
+/// <summary>
+/// 移動する点と線分を軸とした円柱の最初の接触時刻を求める
+/// </summary>
+/// <param name="_start">点の開始位置</param>
+/// <param name="_displacement">移動量</param>
+/// <param name="_edgeStart">線分の始点</param>
+/// <param name="_edgeEnd">線分の終点</param>
+/// <param name="_radius">円柱の半径</param>
+/// <param name="_time">接触時刻（出力用）</param>
+/// <returns>時刻0～1の間に円柱の側面（線分の範囲内）に接触するか否か</returns>
+static bool SweepPoint2Cylinder(const XMVECTOR& _start, const XMVECTOR& _displacement,
+	const XMVECTOR& _edgeStart, const XMVECTOR& _edgeEnd, float _radius, float* _time)
+{
+	XMVECTOR e = _edgeEnd - _edgeStart;
+	XMVECTOR m = _start - _edgeStart;
+	float ee = XMVector3Dot(e, e).m128_f32[0];
+	float ed = XMVector3Dot(e, _displacement).m128_f32[0];
+	float em = XMVector3Dot(e, m).m128_f32[0];
+	if (ee <= 0.0f) {
+		return false;
+	}
+	// 軸に垂直な成分のみで2次方程式を立てる
+	float a = ee * XMVector3Dot(_displacement, _displacement).m128_f32[0] - ed * ed;
+	float b = ee * XMVector3Dot(m, _displacement).m128_f32[0] - em * ed;
+	float c = ee * (XMVector3Dot(m, m).m128_f32[0] - _radius * _radius) - em * em;
+	// 軸と平行に動く、または離れていく
+	if (a <= 0.0f || b >= 0.0f) {
+		return false;
+	}
+	float discr = b * b - a * c;
+	if (discr < 0.0f) {
+		return false;
+	}
+	float t = (-b - sqrtf(discr)) / a;
+	if (t < 0.0f || t > 1.0f) {
+		return false;
+	}
+	// 接触位置が線分の範囲内か
+	float f = (em + t * ed) / ee;
+	if (f < 0.0f || f > 1.0f) {
+		return false;
+	}
+	*_time = t;
+	return true;
+}
+
+bool Collision::CheckSweptSphere2Sphere(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement,
+	const Sphere& _target, float* _time, DirectX::XMVECTOR* _inter, DirectX::XMVECTOR* _normal)
+{
+	const float radius = _sphere.radius + _target.radius;
+
+	// 開始時点で重なっている
+	float t = 0.0f;
+	XMVECTOR m = _sphere.center - _target.center;
+	if (XMVector3LengthSq(m).m128_f32[0] > radius * radius) {
+		// 半径の和の球に対して中心点を動かす
+		if (!SweepPoint2Sphere(_sphere.center, _displacement, _target.center, radius, &t)) {
+			return false;
+		}
+	}
+
+	XMVECTOR center = _sphere.center + _displacement * t;
+	XMVECTOR normal = XMVector3Normalize(center - _target.center);
+
+	if (_time) {
+		*_time = t;
+	}
+	if (_inter) {
+		*_inter = _target.center + normal * _target.radius;
+	}
+	if (_normal) {
+		*_normal = normal;
+	}
+	return true;
+}
+
+bool Collision::CheckSweptSphere2Triangle(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement,
+	const Triangle& _triangle, float* _time, DirectX::XMVECTOR* _inter, DirectX::XMVECTOR* _normal)
+{
+	// 開始時点で重なっている
+	XMVECTOR closest;
+	if (CheckSphere2Triangle(_sphere, _triangle, &closest)) {
+		XMVECTOR normal = _sphere.center - closest;
+		normal = XMVector3LengthSq(normal).m128_f32[0] > 0.0f ? XMVector3Normalize(normal) : _triangle.normal;
+		if (_time) {
+			*_time = 0.0f;
+		}
+		if (_inter) {
+			*_inter = closest;
+		}
+		if (_normal) {
+			*_normal = normal;
+		}
+		return true;
+	}
+
+	// 球の中心がある側を表とする
+	XMVECTOR normal = _triangle.normal;
+	float distance = XMVector3Dot(_sphere.center - _triangle.p0, normal).m128_f32[0];
+	if (distance < 0.0f) {
+		normal = -normal;
+		distance = -distance;
+	}
+
+	// 面の内側に接触する場合
+	float approach = -XMVector3Dot(_displacement, normal).m128_f32[0];
+	if (approach > 0.0f && distance >= _sphere.radius) {
+		float t = (distance - _sphere.radius) / approach;
+		if (t > 1.0f) {
+			// 面に届かないなら辺・頂点にも届かない
+			return false;
+		}
+		XMVECTOR contact = _sphere.center + _displacement * t - normal * _sphere.radius;
+		XMVECTOR closestContact;
+		ClosestPtPoint2Triangle(contact, _triangle, &closestContact);
+		if (XMVector3LengthSq(closestContact - contact).m128_f32[0] <= 1.0e-8f) {
+			if (_time) {
+				*_time = t;
+			}
+			if (_inter) {
+				*_inter = contact;
+			}
+			if (_normal) {
+				*_normal = normal;
+			}
+			return true;
+		}
+	}
+
+	// 辺・頂点に接触する場合は、最も早いものを探す
+	const XMVECTOR vertices[3] = { _triangle.p0, _triangle.p1, _triangle.p2 };
+	float hitTime = 2.0f;
+	for (int i = 0; i < 3; i++)
+	{
+		float t;
+		if (SweepPoint2Sphere(_sphere.center, _displacement, vertices[i], _sphere.radius, &t) && t < hitTime) {
+			hitTime = t;
+		}
+		if (SweepPoint2Cylinder(_sphere.center, _displacement, vertices[i], vertices[(i + 1) % 3], _sphere.radius, &t) && t < hitTime) {
+			hitTime = t;
+		}
+	}
+	if (hitTime > 1.0f) {
+		return false;
+	}
+
+	XMVECTOR center = _sphere.center + _displacement * hitTime;
+	XMVECTOR contact;
+	ClosestPtPoint2Triangle(center, _triangle, &contact);
+
+	if (_time) {
+		*_time = hitTime;
+	}
+	if (_inter) {
+		*_inter = contact;
+	}
+	if (_normal) {
+		*_normal = XMVector3Normalize(center - contact);
+	}
+	return true;
+}
+
 bool Collision::CheckSphereCapsule(const Sphere& sphere, const Capsule& capsule, float* distance)
 {
 	//1.カプセル内の線分のスタート位置からエンド位置へのベクトルを作る
@@ -352,6 +750,607 @@ bool Collision::CheckTriangleCapsule(const Triangle& _triangle, const Capsule& _
 	}
 }
 
+/// <summary>
+/// カプセルの線分の端点を取得
+/// </summary>
+/// <param name="_capsule">カプセル</param>
+/// <param name="_start">始点（出力用）</param>
+/// <param name="_end">終点（出力用）</param>
+static void GetCapsuleSegment(const Capsule& _capsule, XMVECTOR* _start, XMVECTOR* _end)
+{
+	*_start = XMVectorSet(_capsule.startPosition.x, _capsule.startPosition.y, _capsule.startPosition.z, 1.0f);
+	*_end = XMVectorSet(_capsule.endPosition.x, _capsule.endPosition.y, _capsule.endPosition.z, 1.0f);
+}
+
+/// <summary>
+/// 原点を中心とするボックスと線分の最近接点を求める
+/// （距離の二乗は線分上で区分的な2次関数になるので、ボックスの面をまたぐ位置で区切って区間ごとに最小値を求める）
+/// </summary>
+/// <param name="_start">線分の始点</param>
+/// <param name="_end">線分の終点</param>
+/// <param name="_halfSize">ボックスの各軸方向の大きさの半分</param>
+/// <param name="_closestSegment">線分上の最近接点（出力用）</param>
+/// <param name="_closestBox">ボックス上の最近接点（出力用）</param>
+/// <returns>最近接点間の距離の二乗</returns>
+static float ClosestPtSegment2Box(const XMFLOAT3& _start, const XMFLOAT3& _end, const XMFLOAT3& _halfSize,
+	XMFLOAT3* _closestSegment, XMFLOAT3* _closestBox)
+{
+	const float* start = &_start.x;
+	const float* halfSize = &_halfSize.x;
+	const float dir[3] = { _end.x - _start.x, _end.y - _start.y, _end.z - _start.z };
+
+	// 区間の境目（線分の両端と、各面をまたぐ位置）
+	float bounds[8];
+	int boundNum = 0;
+	bounds[boundNum++] = 0.0f;
+	bounds[boundNum++] = 1.0f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (dir[axis] == 0.0f) { continue; }
+		for (const float face : { -halfSize[axis], halfSize[axis] })
+		{
+			const float t = (face - start[axis]) / dir[axis];
+			if (0.0f < t && t < 1.0f) {
+				bounds[boundNum++] = t;
+			}
+		}
+	}
+	// 最大8個なので挿入ソートで並べる（std::sortだとGCCの-O2で誤った配列範囲外の警告が出る）
+	for (int i = 1; i < boundNum; i++)
+	{
+		const float value = bounds[i];
+		int j = i;
+		for (; j > 0 && bounds[j - 1] > value; j--) {
+			bounds[j] = bounds[j - 1];
+		}
+		bounds[j] = value;
+	}
+
+	// 線分上の位置tでの点とボックス上の最近接点、距離の二乗
+	auto evaluate = [&](float _t, float* _point, float* _boxPoint)
+	{
+		float distanceSquare = 0.0f;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			_point[axis] = start[axis] + dir[axis] * _t;
+			_boxPoint[axis] = Collision::clamp(_point[axis], -halfSize[axis], halfSize[axis]);
+			const float diff = _point[axis] - _boxPoint[axis];
+			distanceSquare += diff * diff;
+		}
+		return distanceSquare;
+	};
+
+	float bestDistance = evaluate(0.0f, &_closestSegment->x, &_closestBox->x);
+	for (int i = 0; i + 1 < boundNum && bestDistance > 0.0f; i++)
+	{
+		const float t0 = bounds[i];
+		const float t1 = bounds[i + 1];
+		if (t1 <= t0) { continue; }
+
+		// 区間内では面の外側にはみ出す軸が変わらないので、はみ出す軸の2乗和を最小にするtを解く
+		const float middle = (t0 + t1) * 0.5f;
+		float numerator = 0.0f;
+		float denominator = 0.0f;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const float position = start[axis] + dir[axis] * middle;
+			if (-halfSize[axis] <= position && position <= halfSize[axis]) { continue; }
+
+			const float face = position < 0.0f ? -halfSize[axis] : halfSize[axis];
+			numerator -= (start[axis] - face) * dir[axis];
+			denominator += dir[axis] * dir[axis];
+		}
+		const float t = denominator > 0.0f ? Collision::clamp(numerator / denominator, t0, t1) : middle;
+
+		float point[3], boxPoint[3];
+		const float distance = evaluate(t, point, boxPoint);
+		if (distance < bestDistance)
+		{
+			bestDistance = distance;
+			*_closestSegment = { point[0], point[1], point[2] };
+			*_closestBox = { boxPoint[0], boxPoint[1], boxPoint[2] };
+		}
+	}
+
+	// 終点は区間の端として上で評価済みだが、区間が無い（長さ0の線分）場合に備える
+	float point[3], boxPoint[3];
+	const float distance = evaluate(1.0f, point, boxPoint);
+	if (distance < bestDistance)
+	{
+		bestDistance = distance;
+		*_closestSegment = { point[0], point[1], point[2] };
+		*_closestBox = { boxPoint[0], boxPoint[1], boxPoint[2] };
+	}
+
+	return bestDistance;
+}
+
+/// <summary>
+/// 分離軸上でOBBのローカル座標系の点群がボックスから離れているか
+/// </summary>
+/// <param name="_points">OBBのローカル座標系での点</param>
+/// <param name="_pointNum">点の数</param>
+/// <param name="_axis">分離軸（OBBのローカル座標系）</param>
+/// <param name="_halfSize">ボックスの各軸方向の大きさの半分</param>
+/// <returns>離れているか（軸が縮退している場合はfalse）</returns>
+static bool IsSeparatedOnAxis(const XMVECTOR* _points, int _pointNum, const XMVECTOR& _axis, const XMFLOAT3& _halfSize)
+{
+	if (XMVector3LengthSq(_axis).m128_f32[0] < 1.0e-12f) { return false; }
+
+	float pointMin = XMVector3Dot(_points[0], _axis).m128_f32[0];
+	float pointMax = pointMin;
+	for (int i = 1; i < _pointNum; i++)
+	{
+		const float projection = XMVector3Dot(_points[i], _axis).m128_f32[0];
+		pointMin = (std::min)(pointMin, projection);
+		pointMax = (std::max)(pointMax, projection);
+	}
+
+	const float radius = _halfSize.x * fabsf(_axis.m128_f32[0]) +
+		_halfSize.y * fabsf(_axis.m128_f32[1]) +
+		_halfSize.z * fabsf(_axis.m128_f32[2]);
+	return pointMin > radius || pointMax < -radius;
+}
+
+void Collision::ClosestPtPoint2Segment(const XMVECTOR& _point, const XMVECTOR& _start, const XMVECTOR& _end, XMVECTOR* _closest)
+{
+	XMVECTOR start_end = _end - _start;
+	float lengthSquare = XMVector3Dot(start_end, start_end).m128_f32[0];
+	if (lengthSquare <= 0.0f) {
+		*_closest = _start;
+		return;
+	}
+
+	// 線分上への射影を端で止める
+	float t = XMVector3Dot(_point - _start, start_end).m128_f32[0] / lengthSquare;
+	*_closest = _start + start_end * clamp(t, 0.0f, 1.0f);
+}
+
+float Collision::ClosestPtSegment2Segment(const XMVECTOR& _startA, const XMVECTOR& _endA,
+	const XMVECTOR& _startB, const XMVECTOR& _endB, XMVECTOR* _closestA, XMVECTOR* _closestB)
+{
+	const float epsilon = 1.0e-8f;
+	XMVECTOR dirA = _endA - _startA;
+	XMVECTOR dirB = _endB - _startB;
+	XMVECTOR r = _startA - _startB;
+	float a = XMVector3Dot(dirA, dirA).m128_f32[0];
+	float e = XMVector3Dot(dirB, dirB).m128_f32[0];
+	float f = XMVector3Dot(dirB, r).m128_f32[0];
+
+	float s = 0.0f;
+	float t = 0.0f;
+	if (a <= epsilon && e <= epsilon) {
+		// どちらも点
+	}
+	else if (a <= epsilon) {
+		// Aが点
+		t = clamp(f / e, 0.0f, 1.0f);
+	}
+	else
+	{
+		float c = XMVector3Dot(dirA, r).m128_f32[0];
+		if (e <= epsilon) {
+			// Bが点
+			s = clamp(-c / a, 0.0f, 1.0f);
+		}
+		else
+		{
+			// 平行でなければ無限直線同士の最近接点から始め、線分の範囲に収める
+			float b = XMVector3Dot(dirA, dirB).m128_f32[0];
+			float denominator = a * e - b * b;
+			if (denominator != 0.0f) {
+				s = clamp((b * f - c * e) / denominator, 0.0f, 1.0f);
+			}
+			t = (b * s + f) / e;
+			if (t < 0.0f) {
+				t = 0.0f;
+				s = clamp(-c / a, 0.0f, 1.0f);
+			}
+			else if (t > 1.0f) {
+				t = 1.0f;
+				s = clamp((b - c) / a, 0.0f, 1.0f);
+			}
+		}
+	}
+
+	*_closestA = _startA + dirA * s;
+	*_closestB = _startB + dirB * t;
+	return XMVector3LengthSq(*_closestA - *_closestB).m128_f32[0];
+}
+
+void Collision::ClosestPtPoint2OBB(const XMVECTOR& _point, const OBB& _obb, XMVECTOR* _closest)
+{
+	// 各軸への射影をボックスの範囲に収める
+	XMVECTOR center_point = _point - _obb.center;
+	XMVECTOR closest = _obb.center;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		const float halfSize = (&_obb.halfSize.x)[axis];
+		const float distance = XMVector3Dot(center_point, _obb.axis[axis]).m128_f32[0];
+		closest += _obb.axis[axis] * clamp(distance, -halfSize, halfSize);
+	}
+	*_closest = closest;
+}
+
+bool Collision::CheckSphere2Capsule(const Sphere& _sphere, const Capsule& _capsule, XMVECTOR* _inter, XMVECTOR* _reject)
+{
+	// 線分上で球の中心に最も近い点を中心とする球として判定する
+	XMVECTOR start, end;
+	GetCapsuleSegment(_capsule, &start, &end);
+
+	Sphere closestSphere;
+	ClosestPtPoint2Segment(_sphere.center, start, end, &closestSphere.center);
+	closestSphere.radius = _capsule.radius;
+	return CheckSphere2Sphere(_sphere, closestSphere, _inter, _reject);
+}
+
+bool Collision::CheckCapsule2Capsule(const Capsule& _capsuleA, const Capsule& _capsuleB, XMVECTOR* _inter)
+{
+	// 線分同士の最近接点を中心とする球同士として判定する
+	XMVECTOR startA, endA, startB, endB;
+	GetCapsuleSegment(_capsuleA, &startA, &endA);
+	GetCapsuleSegment(_capsuleB, &startB, &endB);
+
+	Sphere closestA, closestB;
+	ClosestPtSegment2Segment(startA, endA, startB, endB, &closestA.center, &closestB.center);
+	closestA.radius = _capsuleA.radius;
+	closestB.radius = _capsuleB.radius;
+	return CheckSphere2Sphere(closestA, closestB, _inter);
+}
+
+bool Collision::CheckSphere2OBB(const Sphere& _sphere, const OBB& _obb, XMVECTOR* _inter, XMVECTOR* _reject)
+{
+	// 各軸への射影をボックスの範囲に収めて最近接点を求める
+	XMVECTOR center_point = _sphere.center - _obb.center;
+	XMVECTOR closest = _obb.center;
+	float distances[3];
+	bool isInside = true;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		const float halfSize = (&_obb.halfSize.x)[axis];
+		distances[axis] = XMVector3Dot(center_point, _obb.axis[axis]).m128_f32[0];
+		isInside &= fabsf(distances[axis]) <= halfSize;
+		closest += _obb.axis[axis] * clamp(distances[axis], -halfSize, halfSize);
+	}
+
+	XMVECTOR closest_center = _sphere.center - closest;
+	float distanceSquare = isInside ? 0.0f : XMVector3LengthSq(closest_center).m128_f32[0];
+	if (distanceSquare > _sphere.radius * _sphere.radius) {
+		return false;
+	}
+
+	if (_inter) {
+		*_inter = closest;
+	}
+	// 押し出すベクトルを計算
+	if (_reject)
+	{
+		if (!isInside) {
+			*_reject = XMVector3Normalize(closest_center) * (_sphere.radius - sqrtf(distanceSquare));
+		}
+		else
+		{
+			// 中心がボックスの内側にあるので、最も浅い面から押し出す
+			int minAxis = 0;
+			for (int axis = 1; axis < 3; axis++)
+			{
+				if ((&_obb.halfSize.x)[axis] - fabsf(distances[axis]) < (&_obb.halfSize.x)[minAxis] - fabsf(distances[minAxis])) {
+					minAxis = axis;
+				}
+			}
+			const float depth = (&_obb.halfSize.x)[minAxis] - fabsf(distances[minAxis]);
+			*_reject = _obb.axis[minAxis] * ((distances[minAxis] < 0.0f ? -1.0f : 1.0f) * (depth + _sphere.radius));
+		}
+	}
+	return true;
+}
+
+bool Collision::CheckCapsule2OBB(const Capsule& _capsule, const OBB& _obb, XMVECTOR* _inter)
+{
+	// 線分をOBBのローカル座標系へ移し、原点中心のボックスとの最近接点を求める
+	XMVECTOR start, end;
+	GetCapsuleSegment(_capsule, &start, &end);
+	XMFLOAT3 localStart, localEnd;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		(&localStart.x)[axis] = XMVector3Dot(start - _obb.center, _obb.axis[axis]).m128_f32[0];
+		(&localEnd.x)[axis] = XMVector3Dot(end - _obb.center, _obb.axis[axis]).m128_f32[0];
+	}
+
+	XMFLOAT3 closestSegment, closestBox;
+	float distanceSquare = ClosestPtSegment2Box(localStart, localEnd, _obb.halfSize, &closestSegment, &closestBox);
+	if (distanceSquare > _capsule.radius * _capsule.radius) {
+		return false;
+	}
+
+	if (_inter) {
+		*_inter = _obb.center + _obb.axis[0] * closestBox.x + _obb.axis[1] * closestBox.y + _obb.axis[2] * closestBox.z;
+	}
+	return true;
+}
+
+bool Collision::CheckAABB2AABB(const AABB& _aabbA, const AABB& _aabbB, XMVECTOR* _inter)
+{
+	XMFLOAT3 inter;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		const float centerA = _aabbA.center.m128_f32[axis];
+		const float centerB = _aabbB.center.m128_f32[axis];
+		const float halfSizeA = (&_aabbA.halfSize.x)[axis];
+		const float halfSizeB = (&_aabbB.halfSize.x)[axis];
+		if (fabsf(centerA - centerB) > halfSizeA + halfSizeB) {
+			return false;
+		}
+
+		// 重なっている範囲の中心
+		const float overlapMin = (std::max)(centerA - halfSizeA, centerB - halfSizeB);
+		const float overlapMax = (std::min)(centerA + halfSizeA, centerB + halfSizeB);
+		(&inter.x)[axis] = (overlapMin + overlapMax) * 0.5f;
+	}
+
+	if (_inter) {
+		*_inter = XMVectorSet(inter.x, inter.y, inter.z, 1.0f);
+	}
+	return true;
+}
+
+bool Collision::CheckOBB2OBB(const OBB& _obbA, const OBB& _obbB, XMVECTOR* _inter)
+{
+	// 平行な辺の外積が0になっても誤判定しないよう、回転行列の絶対値に微小な値を足す
+	const float epsilon = 1.0e-6f;
+	const float* halfSizeA = &_obbA.halfSize.x;
+	const float* halfSizeB = &_obbB.halfSize.x;
+
+	// Bの軸をAの座標系で表した回転行列と、Aの座標系でのBの中心
+	float rotation[3][3];
+	float absRotation[3][3];
+	float translation[3];
+	XMVECTOR centerA_centerB = _obbB.center - _obbA.center;
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			rotation[i][j] = XMVector3Dot(_obbA.axis[i], _obbB.axis[j]).m128_f32[0];
+			absRotation[i][j] = fabsf(rotation[i][j]) + epsilon;
+		}
+		translation[i] = XMVector3Dot(centerA_centerB, _obbA.axis[i]).m128_f32[0];
+	}
+
+	// Aの軸
+	for (int i = 0; i < 3; i++)
+	{
+		const float radiusA = halfSizeA[i];
+		const float radiusB = halfSizeB[0] * absRotation[i][0] + halfSizeB[1] * absRotation[i][1] + halfSizeB[2] * absRotation[i][2];
+		if (fabsf(translation[i]) > radiusA + radiusB) { return false; }
+	}
+
+	// Bの軸
+	for (int j = 0; j < 3; j++)
+	{
+		const float radiusA = halfSizeA[0] * absRotation[0][j] + halfSizeA[1] * absRotation[1][j] + halfSizeA[2] * absRotation[2][j];
+		const float radiusB = halfSizeB[j];
+		const float distance = translation[0] * rotation[0][j] + translation[1] * rotation[1][j] + translation[2] * rotation[2][j];
+		if (fabsf(distance) > radiusA + radiusB) { return false; }
+	}
+
+	// Aの軸iとBの軸jの外積
+	for (int i = 0; i < 3; i++)
+	{
+		const int i1 = (i + 1) % 3;
+		const int i2 = (i + 2) % 3;
+		for (int j = 0; j < 3; j++)
+		{
+			const int j1 = (j + 1) % 3;
+			const int j2 = (j + 2) % 3;
+			const float radiusA = halfSizeA[i1] * absRotation[i2][j] + halfSizeA[i2] * absRotation[i1][j];
+			const float radiusB = halfSizeB[j1] * absRotation[i][j2] + halfSizeB[j2] * absRotation[i][j1];
+			const float distance = translation[i2] * rotation[i1][j] - translation[i1] * rotation[i2][j];
+			if (fabsf(distance) > radiusA + radiusB) { return false; }
+		}
+	}
+
+	if (_inter)
+	{
+		XMVECTOR closestA, closestB;
+		ClosestPtPoint2OBB(_obbB.center, _obbA, &closestA);
+		ClosestPtPoint2OBB(_obbA.center, _obbB, &closestB);
+		*_inter = XMVectorLerp(closestA, closestB, 0.5f);
+	}
+	return true;
+}
+
+bool Collision::CheckCapsule2Triangle(const Capsule& _capsule, const Triangle& _triangle, XMVECTOR* _inter)
+{
+	XMVECTOR start, end;
+	GetCapsuleSegment(_capsule, &start, &end);
+
+	// 線分が三角形を貫いていれば距離0
+	float startDistance = XMVector3Dot(start - _triangle.p0, _triangle.normal).m128_f32[0];
+	float endDistance = XMVector3Dot(end - _triangle.p0, _triangle.normal).m128_f32[0];
+	if (startDistance * endDistance <= 0.0f && startDistance != endDistance)
+	{
+		XMVECTOR crossPoint = XMVectorLerp(start, end, startDistance / (startDistance - endDistance));
+		XMVECTOR closest;
+		ClosestPtPoint2Triangle(crossPoint, _triangle, &closest);
+		if (XMVector3LengthSq(closest - crossPoint).m128_f32[0] <= 1.0e-10f)
+		{
+			if (_inter) {
+				*_inter = closest;
+			}
+			return true;
+		}
+	}
+
+	// 貫いていなければ、最近接点は線分の端点か三角形の辺のどちらかに現れる
+	XMVECTOR closest;
+	ClosestPtPoint2Triangle(start, _triangle, &closest);
+	float minDistance = XMVector3LengthSq(start - closest).m128_f32[0];
+
+	XMVECTOR tempClosest;
+	ClosestPtPoint2Triangle(end, _triangle, &tempClosest);
+	float distance = XMVector3LengthSq(end - tempClosest).m128_f32[0];
+	if (distance < minDistance) {
+		minDistance = distance;
+		closest = tempClosest;
+	}
+
+	const XMVECTOR* vertices[3] = { &_triangle.p0, &_triangle.p1, &_triangle.p2 };
+	for (int i = 0; i < 3; i++)
+	{
+		XMVECTOR closestSegment;
+		distance = ClosestPtSegment2Segment(start, end, *vertices[i], *vertices[(i + 1) % 3], &closestSegment, &tempClosest);
+		if (distance < minDistance) {
+			minDistance = distance;
+			closest = tempClosest;
+		}
+	}
+
+	if (minDistance > _capsule.radius * _capsule.radius) {
+		return false;
+	}
+
+	if (_inter) {
+		*_inter = closest;
+	}
+	return true;
+}
+
+bool Collision::CheckOBB2Triangle(const OBB& _obb, const Triangle& _triangle, XMVECTOR* _inter)
+{
+	// 三角形をOBBのローカル座標系へ移す
+	const XMVECTOR* vertices[3] = { &_triangle.p0, &_triangle.p1, &_triangle.p2 };
+	XMVECTOR localVertices[3];
+	for (int i = 0; i < 3; i++)
+	{
+		XMVECTOR center_vertex = *vertices[i] - _obb.center;
+		localVertices[i] = XMVectorSet(
+			XMVector3Dot(center_vertex, _obb.axis[0]).m128_f32[0],
+			XMVector3Dot(center_vertex, _obb.axis[1]).m128_f32[0],
+			XMVector3Dot(center_vertex, _obb.axis[2]).m128_f32[0], 0.0f);
+	}
+
+	const XMVECTOR edges[3] = {
+		localVertices[1] - localVertices[0],
+		localVertices[2] - localVertices[1],
+		localVertices[0] - localVertices[2] };
+	const XMVECTOR boxAxes[3] = { { 1,0,0,0 }, { 0,1,0,0 }, { 0,0,1,0 } };
+
+	// ボックスの面の法線、三角形の法線、ボックスの軸と三角形の辺の外積の13軸
+	for (const XMVECTOR& boxAxis : boxAxes)
+	{
+		if (IsSeparatedOnAxis(localVertices, 3, boxAxis, _obb.halfSize)) { return false; }
+	}
+	if (IsSeparatedOnAxis(localVertices, 3, XMVector3Cross(edges[0], edges[1]), _obb.halfSize)) { return false; }
+	for (const XMVECTOR& boxAxis : boxAxes)
+	{
+		for (const XMVECTOR& edge : edges)
+		{
+			if (IsSeparatedOnAxis(localVertices, 3, XMVector3Cross(boxAxis, edge), _obb.halfSize)) { return false; }
+		}
+	}
+
+	if (_inter) {
+		ClosestPtPoint2Triangle(_obb.center, _triangle, _inter);
+	}
+	return true;
+}
+
+bool Collision::CheckRay2Capsule(const Ray& _lay, const Capsule& _capsule, float* _distance, XMVECTOR* _inter)
+{
+	XMVECTOR start, end;
+	GetCapsuleSegment(_capsule, &start, &end);
+	const float radiusSquare = _capsule.radius * _capsule.radius;
+
+	float t = 0.0f;
+	XMVECTOR closest;
+	ClosestPtPoint2Segment(_lay.start, start, end, &closest);
+	// 始点がカプセルの内側でなければ、側面の円柱と両端の球のうち最も近い交点を求める
+	if (XMVector3LengthSq(_lay.start - closest).m128_f32[0] > radiusSquare)
+	{
+		bool isHit = false;
+		t = FLT_MAX;
+
+		// 側面（軸に垂直な成分のみで2次方程式を立てる）
+		XMVECTOR e = end - start;
+		XMVECTOR m = _lay.start - start;
+		float ee = XMVector3Dot(e, e).m128_f32[0];
+		float ed = XMVector3Dot(e, _lay.dir).m128_f32[0];
+		float em = XMVector3Dot(e, m).m128_f32[0];
+		float a = ee * XMVector3Dot(_lay.dir, _lay.dir).m128_f32[0] - ed * ed;
+		float b = ee * XMVector3Dot(m, _lay.dir).m128_f32[0] - em * ed;
+		float c = ee * (XMVector3Dot(m, m).m128_f32[0] - radiusSquare) - em * em;
+		float discr = b * b - a * c;
+		if (ee > 0.0f && a > 0.0f && discr >= 0.0f)
+		{
+			float cylinderT = (-b - sqrtf(discr)) / a;
+			float f = (em + cylinderT * ed) / ee;
+			if (cylinderT >= 0.0f && 0.0f <= f && f <= 1.0f) {
+				isHit = true;
+				t = cylinderT;
+			}
+		}
+
+		// 両端の球
+		Sphere cap;
+		cap.radius = _capsule.radius;
+		for (const XMVECTOR& capCenter : { start, end })
+		{
+			cap.center = capCenter;
+			float capT;
+			if (CheckRay2Sphere(_lay, cap, &capT) && capT < t) {
+				isHit = true;
+				t = capT;
+			}
+		}
+
+		if (!isHit) {
+			return false;
+		}
+	}
+
+	if (_distance) {
+		*_distance = t;
+	}
+	if (_inter) {
+		*_inter = _lay.start + t * _lay.dir;
+	}
+	return true;
+}
+
+bool Collision::CheckRay2OBB(const Ray& _lay, const OBB& _obb, float* _distance, XMVECTOR* _inter)
+{
+	// OBBのローカル座標系でのスラブ法（始点が内側なら距離0）
+	XMVECTOR center_start = _lay.start - _obb.center;
+	float tMin = 0.0f;
+	float tMax = FLT_MAX;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		const float halfSize = (&_obb.halfSize.x)[axis];
+		const float start = XMVector3Dot(center_start, _obb.axis[axis]).m128_f32[0];
+		const float dir = XMVector3Dot(_lay.dir, _obb.axis[axis]).m128_f32[0];
+		if (fabsf(dir) < 1.0e-8f)
+		{
+			// 軸に平行なら、スラブの外にある時点で当たらない
+			if (fabsf(start) > halfSize) { return false; }
+			continue;
+		}
+
+		float t1 = (-halfSize - start) / dir;
+		float t2 = (halfSize - start) / dir;
+		tMin = (std::max)(tMin, (std::min)(t1, t2));
+		tMax = (std::min)(tMax, (std::max)(t1, t2));
+		if (tMin > tMax) { return false; }
+	}
+
+	if (_distance) {
+		*_distance = tMin;
+	}
+	if (_inter) {
+		*_inter = _lay.start + tMin * _lay.dir;
+	}
+	return true;
+}
+
 float Collision::sqDistanceSegmentSegment(const Vector3& p1, const Vector3& q1, const Vector3& p2, const Vector3& q2)
 {
 	Vector3 d1 = q1 - p1;//p1->q1のベクトル
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "CollisionPrimitive.h"
+#include "ContactManifold.h"
 #include "Vector3.h"
 
 /// <summary>
@@ -62,6 +63,17 @@ public:
 	static bool CheckSphere2Triangle(const Sphere& _sphere,
 		const Triangle& _triangle, DirectX::XMVECTOR* _inter = nullptr, DirectX::XMVECTOR* _reject = nullptr);
 
+	/// <summary>
+	/// 球と法線付き三角形の当たり判定（接触点を求める）
+	/// 球の中心が表側にあれば最近接点から中心への向きを法線とし、辺や頂点に触れた場合も面法線で押し出さない
+	/// </summary>
+	/// <param name="_sphere">球</param>
+	/// <param name="_triangle">三角形</param>
+	/// <param name="_contact">接触点（出力用、colliderは書き換えない）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckSphere2Triangle(const Sphere& _sphere,
+		const Triangle& _triangle, CONTACT_POINT* _contact);
+
 	/// <summary>
 	/// レイと平面の当たり判定
 	/// </summary>
@@ -84,6 +96,60 @@ public:
 	static bool CheckRay2Triangle(const Ray& _lay,
 		const Triangle& _triangle, float* _distance = nullptr, DirectX::XMVECTOR* _inter = nullptr);
 
+	/// <summary>
+	/// レイと三角形4つの当たり判定（SIMDで4つ同時に判定し、最も近いものを返す）
+	/// </summary>
+	/// <param name="_lay">レイ</param>
+	/// <param name="_triangle4">SoA形式の三角形4つ</param>
+	/// <param name="_maxDistance">これ以上遠い交点は無視する</param>
+	/// <param name="_distance">距離（出力用）</param>
+	/// <param name="_index">当たった三角形のレーン番号0～3（出力用）</param>
+	/// <returns>いずれかと交差しているか否か</returns>
+	static bool CheckRay2Triangle4(const Ray& _lay, const Triangle4& _triangle4,
+		float _maxDistance, float* _distance = nullptr, int* _index = nullptr);
+
+	/// <summary>
+	/// レイ4本と三角形の当たり判定（SIMDで4本同時に判定する）
+	/// </summary>
+	/// <param name="_ray4">SoA形式のレイ4本</param>
+	/// <param name="_triangle">三角形</param>
+	/// <param name="_distance">レイごとの最大距離。より近い交点が見つかったレーンは距離で上書きする（入出力用）</param>
+	/// <returns>より近い交点が見つかったレイのビットマスク</returns>
+	static int CheckRay4Triangle(const Ray4& _ray4, const Triangle& _triangle, DirectX::XMVECTOR* _distance);
+
+	/// <summary>
+	/// レイとAABBの当たり判定（スラブ法）
+	/// </summary>
+	/// <param name="_start">レイの始点</param>
+	/// <param name="_invDir">レイの方向の逆数（ComputeInvDirで求める）</param>
+	/// <param name="_min">AABB最小値</param>
+	/// <param name="_max">AABB最大値</param>
+	/// <param name="_maxDistance">これ以上遠いAABBは無視する</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckRay2AABB(const DirectX::XMFLOAT3& _start, const DirectX::XMFLOAT3& _invDir,
+		const DirectX::XMFLOAT3& _min, const DirectX::XMFLOAT3& _max, float _maxDistance);
+
+	/// <summary>
+	/// レイ4本とAABBの当たり判定（スラブ法をSIMDで4本同時に行う）
+	/// </summary>
+	/// <param name="_ray4">SoA形式のレイ4本（始点のみ使う）</param>
+	/// <param name="_invDirX">レイの方向の逆数のx成分（ComputeInvDirで求める）</param>
+	/// <param name="_invDirY">レイの方向の逆数のy成分</param>
+	/// <param name="_invDirZ">レイの方向の逆数のz成分</param>
+	/// <param name="_min">AABB最小値</param>
+	/// <param name="_max">AABB最大値</param>
+	/// <param name="_maxDistance">レイごとの、これ以上遠いAABBは無視する距離</param>
+	/// <returns>交差しているレイのビットマスク</returns>
+	static int CheckRay4AABB(const Ray4& _ray4, const DirectX::XMVECTOR& _invDirX, const DirectX::XMVECTOR& _invDirY, const DirectX::XMVECTOR& _invDirZ,
+		const DirectX::XMFLOAT3& _min, const DirectX::XMFLOAT3& _max, const DirectX::XMVECTOR& _maxDistance);
+
+	/// <summary>
+	/// スラブ法用にレイの方向の逆数を求める
+	/// </summary>
+	/// <param name="_dir">レイの方向</param>
+	/// <returns>方向の逆数（軸に平行な成分は十分大きな値）</returns>
+	static DirectX::XMFLOAT3 ComputeInvDir(const DirectX::XMVECTOR& _dir);
+
 	/// <summary>
 	/// レイと球の当たり判定
 	/// </summary>
@@ -95,6 +161,32 @@ public:
 	static bool CheckRay2Sphere(const Ray& _lay,
 		const Sphere& _sphere, float* _distance = nullptr, DirectX::XMVECTOR* _inter = nullptr);
 
+	/// <summary>
+	/// 移動する球と球の当たり判定（連続判定）
+	/// </summary>
+	/// <param name="_sphere">移動する球（移動開始時）</param>
+	/// <param name="_displacement">移動量</param>
+	/// <param name="_target">静止している球</param>
+	/// <param name="_time">最初に接触する時刻0～1（出力用）</param>
+	/// <param name="_inter">接触点（出力用）</param>
+	/// <param name="_normal">接触面の法線（出力用）</param>
+	/// <returns>移動中に接触するか否か</returns>
+	static bool CheckSweptSphere2Sphere(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement,
+		const Sphere& _target, float* _time = nullptr, DirectX::XMVECTOR* _inter = nullptr, DirectX::XMVECTOR* _normal = nullptr);
+
+	/// <summary>
+	/// 移動する球と法線付き三角形の当たり判定（連続判定、両面）
+	/// </summary>
+	/// <param name="_sphere">移動する球（移動開始時）</param>
+	/// <param name="_displacement">移動量</param>
+	/// <param name="_triangle">三角形</param>
+	/// <param name="_time">最初に接触する時刻0～1（出力用）</param>
+	/// <param name="_inter">接触点（出力用）</param>
+	/// <param name="_normal">接触面の法線（出力用）</param>
+	/// <returns>移動中に接触するか否か</returns>
+	static bool CheckSweptSphere2Triangle(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement,
+		const Triangle& _triangle, float* _time = nullptr, DirectX::XMVECTOR* _inter = nullptr, DirectX::XMVECTOR* _normal = nullptr);
+
 	/// <summary>
 	/// 球とカプセル
 	/// </summary>
@@ -120,6 +212,136 @@ public:
 	/// <returns>交差しているか否か</returns>
 	static bool CheckTriangleCapsule(const Triangle& _triangle, const Capsule& _capsule);
 
+	/// <summary>
+	/// 点と線分の最近接点を求める
+	/// </summary>
+	/// <param name="_point">点</param>
+	/// <param name="_start">線分の始点</param>
+	/// <param name="_end">線分の終点</param>
+	/// <param name="_closest">最近接点（出力用）</param>
+	static void ClosestPtPoint2Segment(const DirectX::XMVECTOR& _point,
+		const DirectX::XMVECTOR& _start, const DirectX::XMVECTOR& _end, DirectX::XMVECTOR* _closest);
+
+	/// <summary>
+	/// 線分と線分の最近接点を求める
+	/// </summary>
+	/// <param name="_startA">線分Aの始点</param>
+	/// <param name="_endA">線分Aの終点</param>
+	/// <param name="_startB">線分Bの始点</param>
+	/// <param name="_endB">線分Bの終点</param>
+	/// <param name="_closestA">線分A上の最近接点（出力用）</param>
+	/// <param name="_closestB">線分B上の最近接点（出力用）</param>
+	/// <returns>最近接点間の距離の二乗</returns>
+	static float ClosestPtSegment2Segment(const DirectX::XMVECTOR& _startA, const DirectX::XMVECTOR& _endA,
+		const DirectX::XMVECTOR& _startB, const DirectX::XMVECTOR& _endB,
+		DirectX::XMVECTOR* _closestA, DirectX::XMVECTOR* _closestB);
+
+	/// <summary>
+	/// 点とOBBの最近接点を求める（点がOBBの内側なら点そのもの）
+	/// </summary>
+	/// <param name="_point">点</param>
+	/// <param name="_obb">OBB</param>
+	/// <param name="_closest">最近接点（出力用）</param>
+	static void ClosestPtPoint2OBB(const DirectX::XMVECTOR& _point, const OBB& _obb, DirectX::XMVECTOR* _closest);
+
+	/// <summary>
+	/// 球とカプセルの当たり判定
+	/// </summary>
+	/// <param name="_sphere">球</param>
+	/// <param name="_capsule">カプセル</param>
+	/// <param name="_inter">交点（出力用）</param>
+	/// <param name="_reject">球の排斥ベクトル（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckSphere2Capsule(const Sphere& _sphere, const Capsule& _capsule,
+		DirectX::XMVECTOR* _inter = nullptr, DirectX::XMVECTOR* _reject = nullptr);
+
+	/// <summary>
+	/// カプセルとカプセルの当たり判定
+	/// </summary>
+	/// <param name="_capsuleA">カプセルA</param>
+	/// <param name="_capsuleB">カプセルB</param>
+	/// <param name="_inter">交点（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckCapsule2Capsule(const Capsule& _capsuleA, const Capsule& _capsuleB, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// 球とOBBの当たり判定
+	/// </summary>
+	/// <param name="_sphere">球</param>
+	/// <param name="_obb">OBB</param>
+	/// <param name="_inter">交点（OBB上の最近接点）</param>
+	/// <param name="_reject">球の排斥ベクトル（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckSphere2OBB(const Sphere& _sphere, const OBB& _obb,
+		DirectX::XMVECTOR* _inter = nullptr, DirectX::XMVECTOR* _reject = nullptr);
+
+	/// <summary>
+	/// カプセルとOBBの当たり判定
+	/// </summary>
+	/// <param name="_capsule">カプセル</param>
+	/// <param name="_obb">OBB</param>
+	/// <param name="_inter">交点（OBB上の最近接点）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckCapsule2OBB(const Capsule& _capsule, const OBB& _obb, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// AABBとAABBの当たり判定
+	/// </summary>
+	/// <param name="_aabbA">AABB A</param>
+	/// <param name="_aabbB">AABB B</param>
+	/// <param name="_inter">交点（重なり領域の中心）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckAABB2AABB(const AABB& _aabbA, const AABB& _aabbB, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// OBBとOBBの当たり判定（分離軸判定）
+	/// </summary>
+	/// <param name="_obbA">OBB A</param>
+	/// <param name="_obbB">OBB B</param>
+	/// <param name="_inter">交点（互いの中心に最も近い点の中点で近似）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckOBB2OBB(const OBB& _obbA, const OBB& _obbB, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// カプセルと三角形の当たり判定（両面）
+	/// </summary>
+	/// <param name="_capsule">カプセル</param>
+	/// <param name="_triangle">三角形</param>
+	/// <param name="_inter">交点（三角形上の最近接点）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckCapsule2Triangle(const Capsule& _capsule, const Triangle& _triangle, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// OBBと三角形の当たり判定（分離軸判定、両面）
+	/// </summary>
+	/// <param name="_obb">OBB</param>
+	/// <param name="_triangle">三角形</param>
+	/// <param name="_inter">交点（OBBの中心に最も近い三角形上の点で近似）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckOBB2Triangle(const OBB& _obb, const Triangle& _triangle, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// レイとカプセルの当たり判定
+	/// </summary>
+	/// <param name="_lay">レイ</param>
+	/// <param name="_capsule">カプセル</param>
+	/// <param name="_distance">距離（出力用）</param>
+	/// <param name="_inter">交点（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckRay2Capsule(const Ray& _lay, const Capsule& _capsule,
+		float* _distance = nullptr, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// レイとOBBの当たり判定
+	/// </summary>
+	/// <param name="_lay">レイ</param>
+	/// <param name="_obb">OBB</param>
+	/// <param name="_distance">距離（出力用）</param>
+	/// <param name="_inter">交点（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	static bool CheckRay2OBB(const Ray& _lay, const OBB& _obb,
+		float* _distance = nullptr, DirectX::XMVECTOR* _inter = nullptr);
+
 	/// <summary>
 	/// 線分と線分の距離の二乗を求める
 	/// </summary>
@@ -146,7 +368,7 @@ public:
 	static float clamp(float x, float low, float high)
 	{
 		x = (x < low) ? low : x;
-		x = (x < high) ? high : x;
+		x = (x > high) ? high : x;
 		return x;
 	}
 };
\ No newline at end of file
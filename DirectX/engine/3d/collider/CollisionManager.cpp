@@ -1,65 +1,590 @@
 ﻿#include "CollisionManager.h"
 #include "BaseCollider.h"
+#include <algorithm>
+#include <memory>
 #include "Collision.h"
 #include "MeshCollider.h"
+#include "HeightfieldCollider.h"
+#include "SphereCollider.h"
+#include "CapsuleCollider.h"
+#include "AABBCollider.h"
+#include "OBBCollider.h"
+#include "ThreadPool.h"
 
 using namespace DirectX;
 
+/// <summary>
+/// 引数の順を入れ替えて判定関数を呼ぶ（表の逆順の組に登録する）
+/// </summary>
+template <bool(*Check)(BaseCollider*, BaseCollider*, XMVECTOR*)>
+static bool CheckSwapped(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Check(_colB, _colA, _inter);
+}
+
+/// <summary>
+/// 判定関数を形状の組とその逆順の組へ登録する
+/// </summary>
+template <bool(*Check)(BaseCollider*, BaseCollider*, XMVECTOR*), typename Table>
+static void SetCheckFunction(Table& _table, COLILSION_SHAPE_TYPE _typeA, COLILSION_SHAPE_TYPE _typeB)
+{
+	_table[_typeB][_typeA] = CheckSwapped<Check>;
+	_table[_typeA][_typeB] = Check;
+}
+
+/// <summary>
+/// 一括レイキャストでレイを並べ替えるキー（方向の象限と、AABB内の始点位置のモートン順）
+/// </summary>
+static uint32_t GetRaySortKey(const Ray& _ray, const XMFLOAT3& _min, const XMFLOAT3& _max)
+{
+	uint32_t key = 0;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		// 方向の符号が同じレイをまとめる
+		key |= (_ray.dir.m128_f32[axis] < 0.0f ? 1u : 0u) << (30 - axis);
+
+		// 始点をAABB内で9bitに量子化し、3軸のビットを交互に並べる
+		const float extent = (&_max.x)[axis] - (&_min.x)[axis];
+		const float ratio = extent > 0.0f ? (_ray.start.m128_f32[axis] - (&_min.x)[axis]) / extent : 0.0f;
+		const uint32_t cell = static_cast<uint32_t>((std::min)((std::max)(ratio, 0.0f), 1.0f) * 511.0f);
+		for (int bit = 0; bit < 9; bit++)
+		{
+			key |= ((cell >> (8 - bit)) & 1u) << (26 - bit * 3 - axis);
+		}
+	}
+	return key;
+}
+
+static bool CheckPairSphere2Sphere(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckSphere2Sphere(*static_cast<SphereCollider*>(_colA), *static_cast<SphereCollider*>(_colB), _inter);
+}
+
+static bool CheckPairSphere2Mesh(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return static_cast<MeshCollider*>(_colB)->CheckCollisionSphere(*static_cast<SphereCollider*>(_colA), _inter);
+}
+
+static bool CheckPairSphere2Heightfield(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return static_cast<HeightfieldCollider*>(_colB)->CheckCollisionSphere(*static_cast<SphereCollider*>(_colA), _inter);
+}
+
+static bool CheckPairSphere2Capsule(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckSphere2Capsule(*static_cast<SphereCollider*>(_colA), *static_cast<CapsuleCollider*>(_colB), _inter);
+}
+
+static bool CheckPairSphere2AABB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckSphere2OBB(*static_cast<SphereCollider*>(_colA), static_cast<AABBCollider*>(_colB)->ToOBB(), _inter);
+}
+
+static bool CheckPairSphere2OBB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckSphere2OBB(*static_cast<SphereCollider*>(_colA), *static_cast<OBBCollider*>(_colB), _inter);
+}
+
+static bool CheckPairMesh2Capsule(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return static_cast<MeshCollider*>(_colA)->CheckCollisionCapsule(*static_cast<CapsuleCollider*>(_colB), _inter);
+}
+
+static bool CheckPairMesh2AABB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return static_cast<MeshCollider*>(_colA)->CheckCollisionOBB(static_cast<AABBCollider*>(_colB)->ToOBB(), _inter);
+}
+
+static bool CheckPairMesh2OBB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return static_cast<MeshCollider*>(_colA)->CheckCollisionOBB(*static_cast<OBBCollider*>(_colB), _inter);
+}
+
+static bool CheckPairHeightfield2Capsule(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return static_cast<HeightfieldCollider*>(_colA)->CheckCollisionCapsule(*static_cast<CapsuleCollider*>(_colB), _inter);
+}
+
+static bool CheckPairHeightfield2AABB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return static_cast<HeightfieldCollider*>(_colA)->CheckCollisionOBB(static_cast<AABBCollider*>(_colB)->ToOBB(), _inter);
+}
+
+static bool CheckPairHeightfield2OBB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return static_cast<HeightfieldCollider*>(_colA)->CheckCollisionOBB(*static_cast<OBBCollider*>(_colB), _inter);
+}
+
+static bool CheckPairCapsule2Capsule(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckCapsule2Capsule(*static_cast<CapsuleCollider*>(_colA), *static_cast<CapsuleCollider*>(_colB), _inter);
+}
+
+static bool CheckPairCapsule2AABB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckCapsule2OBB(*static_cast<CapsuleCollider*>(_colA), static_cast<AABBCollider*>(_colB)->ToOBB(), _inter);
+}
+
+static bool CheckPairCapsule2OBB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckCapsule2OBB(*static_cast<CapsuleCollider*>(_colA), *static_cast<OBBCollider*>(_colB), _inter);
+}
+
+static bool CheckPairAABB2AABB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckAABB2AABB(*static_cast<AABBCollider*>(_colA), *static_cast<AABBCollider*>(_colB), _inter);
+}
+
+static bool CheckPairAABB2OBB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckOBB2OBB(static_cast<AABBCollider*>(_colA)->ToOBB(), *static_cast<OBBCollider*>(_colB), _inter);
+}
+
+static bool CheckPairOBB2OBB(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	return Collision::CheckOBB2OBB(*static_cast<OBBCollider*>(_colA), *static_cast<OBBCollider*>(_colB), _inter);
+}
+
+/// <summary>
+/// レイとコライダーの詳細判定
+/// </summary>
+/// <param name="_ray">レイ</param>
+/// <param name="_collider">コライダー</param>
+/// <param name="_distance">距離（出力用）</param>
+/// <param name="_inter">交点（出力用）</param>
+/// <returns>交差しているか否か</returns>
+static bool CheckRay2Collider(const Ray& _ray, BaseCollider* _collider, float* _distance, XMVECTOR* _inter)
+{
+	switch (_collider->GetShapeType())
+	{
+	case COLLISIONSHAPE_SPHERE:
+		return Collision::CheckRay2Sphere(_ray, *static_cast<SphereCollider*>(_collider), _distance, _inter);
+	case COLLISIONSHAPE_MESH:
+		return static_cast<MeshCollider*>(_collider)->CheckCollisionRay(_ray, _distance, _inter);
+	case COLLISIONSHAPE_HEIGHTFIELD:
+		return static_cast<HeightfieldCollider*>(_collider)->CheckCollisionRay(_ray, _distance, _inter);
+	case COLLISIONSHAPE_CAPSULE:
+		return Collision::CheckRay2Capsule(_ray, *static_cast<CapsuleCollider*>(_collider), _distance, _inter);
+	case COLLISIONSHAPE_AABB:
+		return Collision::CheckRay2OBB(_ray, static_cast<AABBCollider*>(_collider)->ToOBB(), _distance, _inter);
+	case COLLISIONSHAPE_OBB:
+		return Collision::CheckRay2OBB(_ray, *static_cast<OBBCollider*>(_collider), _distance, _inter);
+	default:
+		return false;
+	}
+}
+
+const CollisionManager::CheckFunctionTable CollisionManager::checkFunctions = CollisionManager::CreateCheckFunctionTable();
+
 CollisionManager * CollisionManager::GetInstance()
 {
 	static CollisionManager instance;
 	return &instance;
 }
 
+CollisionManager::CheckFunctionTable CollisionManager::CreateCheckFunctionTable()
+{
+	// メッシュ・ハイトフィールド同士は静的な地形同士なので判定しない
+	CheckFunctionTable table = {};
+	SetCheckFunction<CheckPairSphere2Sphere>(table, COLLISIONSHAPE_SPHERE, COLLISIONSHAPE_SPHERE);
+	SetCheckFunction<CheckPairSphere2Mesh>(table, COLLISIONSHAPE_SPHERE, COLLISIONSHAPE_MESH);
+	SetCheckFunction<CheckPairSphere2Heightfield>(table, COLLISIONSHAPE_SPHERE, COLLISIONSHAPE_HEIGHTFIELD);
+	SetCheckFunction<CheckPairSphere2Capsule>(table, COLLISIONSHAPE_SPHERE, COLLISIONSHAPE_CAPSULE);
+	SetCheckFunction<CheckPairSphere2AABB>(table, COLLISIONSHAPE_SPHERE, COLLISIONSHAPE_AABB);
+	SetCheckFunction<CheckPairSphere2OBB>(table, COLLISIONSHAPE_SPHERE, COLLISIONSHAPE_OBB);
+	SetCheckFunction<CheckPairMesh2Capsule>(table, COLLISIONSHAPE_MESH, COLLISIONSHAPE_CAPSULE);
+	SetCheckFunction<CheckPairMesh2AABB>(table, COLLISIONSHAPE_MESH, COLLISIONSHAPE_AABB);
+	SetCheckFunction<CheckPairMesh2OBB>(table, COLLISIONSHAPE_MESH, COLLISIONSHAPE_OBB);
+	SetCheckFunction<CheckPairHeightfield2Capsule>(table, COLLISIONSHAPE_HEIGHTFIELD, COLLISIONSHAPE_CAPSULE);
+	SetCheckFunction<CheckPairHeightfield2AABB>(table, COLLISIONSHAPE_HEIGHTFIELD, COLLISIONSHAPE_AABB);
+	SetCheckFunction<CheckPairHeightfield2OBB>(table, COLLISIONSHAPE_HEIGHTFIELD, COLLISIONSHAPE_OBB);
+	SetCheckFunction<CheckPairCapsule2Capsule>(table, COLLISIONSHAPE_CAPSULE, COLLISIONSHAPE_CAPSULE);
+	SetCheckFunction<CheckPairCapsule2AABB>(table, COLLISIONSHAPE_CAPSULE, COLLISIONSHAPE_AABB);
+	SetCheckFunction<CheckPairCapsule2OBB>(table, COLLISIONSHAPE_CAPSULE, COLLISIONSHAPE_OBB);
+	SetCheckFunction<CheckPairAABB2AABB>(table, COLLISIONSHAPE_AABB, COLLISIONSHAPE_AABB);
+	SetCheckFunction<CheckPairAABB2OBB>(table, COLLISIONSHAPE_AABB, COLLISIONSHAPE_OBB);
+	SetCheckFunction<CheckPairOBB2OBB>(table, COLLISIONSHAPE_OBB, COLLISIONSHAPE_OBB);
+	return table;
+}
+
+CollisionManager::CollisionManager()
+{
+	// 初期状態では全てのレイヤー同士が衝突する
+	layerMasks.fill(0xffff);
+}
+
+void CollisionManager::AddCollider(BaseCollider* _collider)
+{
+	_collider->isRegistered = true;
+	// 通し番号は登録し直すたびに振り直し、以前のペアの接触キャッシュと混ざらないようにする
+	_collider->colliderId = ++nextColliderId;
+	_collider->isMoved = true;
+	AddToBucket(_collider);
+}
+
+void CollisionManager::RemoveCollider(BaseCollider* _collider)
+{
+	if (!_collider->isRegistered) { return; }
+
+	RemoveFromBucket(_collider);
+	_collider->isRegistered = false;
+
+	// 接触中だった相手へ接触終了を通知するため、次の全衝突チェックまで覚えておく
+	removedColliderIds.insert(_collider->colliderId);
+}
+
+void CollisionManager::ChangeAttribute(BaseCollider* _collider, unsigned short _attribute)
+{
+	if (_collider->attribute == _attribute) { return; }
+
+	RemoveFromBucket(_collider);
+	_collider->attribute = _attribute;
+	AddToBucket(_collider);
+}
+
+void CollisionManager::MoveCollider(BaseCollider* _collider)
+{
+	LAYER_BUCKET* bucket = FindBucket(_collider->attribute);
+	assert(bucket);
+
+	bucket->tree.MoveProxy(_collider->proxyId, _collider->aabbMin, _collider->aabbMax);
+}
+
+void CollisionManager::SetLayerCollision(int _layerA, int _layerB, bool _isCollide)
+{
+	assert(0 <= _layerA && _layerA < layerNum);
+	assert(0 <= _layerB && _layerB < layerNum);
+
+	const unsigned short bitA = static_cast<unsigned short>(1 << _layerA);
+	const unsigned short bitB = static_cast<unsigned short>(1 << _layerB);
+	if (_isCollide) {
+		layerMasks[_layerA] |= bitB;
+		layerMasks[_layerB] |= bitA;
+	}
+	else {
+		layerMasks[_layerA] &= ~bitB;
+		layerMasks[_layerB] &= ~bitA;
+	}
+}
+
+bool CollisionManager::IsLayerCollision(int _layerA, int _layerB) const
+{
+	assert(0 <= _layerA && _layerA < layerNum);
+	assert(0 <= _layerB && _layerB < layerNum);
+
+	return (layerMasks[_layerA] & (1 << _layerB)) != 0;
+}
+
+unsigned short CollisionManager::ComputeCollideMask(unsigned short _attribute) const
+{
+	// 属性に含まれる全レイヤーの衝突相手を合わせる
+	unsigned short mask = 0;
+	for (int layer = 0; layer < layerNum; layer++)
+	{
+		if (_attribute & (1 << layer)) {
+			mask |= layerMasks[layer];
+		}
+	}
+	return mask;
+}
+
+CollisionManager::LAYER_BUCKET* CollisionManager::FindBucket(unsigned short _attribute)
+{
+	// 属性の組み合わせは少ないので線形に探す
+	for (LAYER_BUCKET& bucket : layerBuckets)
+	{
+		if (bucket.attribute == _attribute) {
+			return &bucket;
+		}
+	}
+	return nullptr;
+}
+
+void CollisionManager::AddToBucket(BaseCollider* _collider)
+{
+	LAYER_BUCKET* bucket = FindBucket(_collider->attribute);
+	if (!bucket)
+	{
+		// 初めての属性なら末尾にまとまりを作る
+		layerBuckets.emplace_back();
+		bucket = &layerBuckets.back();
+		bucket->attribute = _collider->attribute;
+	}
+
+	_collider->bucketPosition = static_cast<int>(bucket->colliders.size());
+	bucket->colliders.push_back(_collider);
+	_collider->proxyId = bucket->tree.CreateProxy(_collider->aabbMin, _collider->aabbMax, _collider);
+}
+
+void CollisionManager::RemoveFromBucket(BaseCollider* _collider)
+{
+	LAYER_BUCKET* bucket = FindBucket(_collider->attribute);
+	assert(bucket);
+
+	bucket->tree.DestroyProxy(_collider->proxyId);
+
+	// 末尾のコライダーを空いた位置へ移して詰める
+	std::vector<BaseCollider*>& bucketColliders = bucket->colliders;
+	BaseCollider* last = bucketColliders.back();
+	bucketColliders[_collider->bucketPosition] = last;
+	last->bucketPosition = _collider->bucketPosition;
+	bucketColliders.pop_back();
+
+	_collider->proxyId = -1;
+	_collider->bucketPosition = -1;
+}
+
 void CollisionManager::CheckAllCollisions()
 {
-	std::forward_list<BaseCollider*>::iterator itA;
-	std::forward_list<BaseCollider*>::iterator itB;
-
-	// 全ての組み合わせについて総当りチェック
-	itA = colliders.begin();
-	for (; itA != colliders.end(); ++itA) {
-		itB = itA;
-		++itB;
-		for (; itB != colliders.end(); ++itB) {
-			BaseCollider* colA = *itA;
-			BaseCollider* colB = *itB;
-
-			// ともに球
-			if (colA->GetShapeType() == COLLISIONSHAPE_SPHERE &&
-				colB->GetShapeType() == COLLISIONSHAPE_SPHERE) {
-				Sphere* SphereA = dynamic_cast<Sphere*>(colA);
-				Sphere* SphereB = dynamic_cast<Sphere*>(colB);
-				DirectX::XMVECTOR inter;
-				if (Collision::CheckSphere2Sphere(*SphereA, *SphereB, &inter)) {
-					colA->OnCollision(CollisionInfo(colB->GetObject3d(), colB, inter));
-					colB->OnCollision(CollisionInfo(colA->GetObject3d(), colA, inter));
+	// 衝突し得る属性のまとまりの組ごとに木を同時に辿り、AABBが重なるペアを候補にする
+	contactPairs.clear();
+	auto addContactPair = [this](BaseCollider* _colA, BaseCollider* _colB)
+		{
+			// 通し番号の小さい方をAにそろえ、どちらの木から見つけても同じキーになるようにする
+			if (_colB->colliderId < _colA->colliderId) { std::swap(_colA, _colB); }
+			const uint64_t key = (static_cast<uint64_t>(_colA->colliderId) << 32) | _colB->colliderId;
+			contactPairs.push_back({ key, _colA, _colB, XMVectorZero(), false, -1 });
+		};
+
+	const int bucketNum = static_cast<int>(layerBuckets.size());
+	for (int i = 0; i < bucketNum; i++)
+	{
+		const LAYER_BUCKET& bucketA = layerBuckets[i];
+		const unsigned short collideMask = ComputeCollideMask(GetCollisionLayers(bucketA.attribute));
+
+		for (int j = i; j < bucketNum; j++)
+		{
+			const LAYER_BUCKET& bucketB = layerBuckets[j];
+
+			// レイヤー行列で衝突しないまとまりは丸ごと飛ばす
+			if (!(collideMask & GetCollisionLayers(bucketB.attribute))) { continue; }
+
+			// コライダーが少なければ実際のAABBを総当たりで比べる
+			const size_t colliderNumA = bucketA.colliders.size();
+			const size_t colliderNumB = bucketB.colliders.size();
+			if (colliderNumA == 0 || colliderNumB == 0) { continue; }
+			const size_t pairNum = i == j ? colliderNumA * (colliderNumA - 1) / 2 : colliderNumA * colliderNumB;
+			if (pairNum <= bruteForcePairMax)
+			{
+				// Bの範囲を4つずつSoA形式（最小値xyz・最大値xyzの順）へ写す（余ったレーンはどれとも重ならない範囲）
+				const size_t groupNum = (colliderNumB + 3) / 4;
+				bruteForceBounds.resize(groupNum * 6);
+				for (size_t b = 0; b < groupNum * 4; b++)
+				{
+					XMFLOAT4A* group = &bruteForceBounds[b / 4 * 6];
+					const bool isValid = b < colliderNumB;
+					const XMFLOAT3 minB = isValid ? bucketB.colliders[b]->aabbMin : XMFLOAT3{ D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX };
+					const XMFLOAT3 maxB = isValid ? bucketB.colliders[b]->aabbMax : XMFLOAT3{ -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX };
+					for (int axis = 0; axis < 3; axis++)
+					{
+						(&group[axis].x)[b % 4] = (&minB.x)[axis];
+						(&group[axis + 3].x)[b % 4] = (&maxB.x)[axis];
+					}
 				}
-			}
-			else if (colA->GetShapeType() == COLLISIONSHAPE_MESH &&
-				colB->GetShapeType() == COLLISIONSHAPE_SPHERE) {
-				MeshCollider* meshCollider = dynamic_cast<MeshCollider*>(colA);
-				Sphere* sphere = dynamic_cast<Sphere*>(colB);
-				DirectX::XMVECTOR inter;
-				if (meshCollider->CheckCollisionSphere(*sphere, &inter)) {
-					colA->OnCollision(CollisionInfo(colB->GetObject3d(), colB, inter));
-					colB->OnCollision(CollisionInfo(colA->GetObject3d(), colA, inter));
+
+				// Aの1つとBの4つをSIMDでまとめて比べる
+				for (size_t a = 0; a < colliderNumA; a++)
+				{
+					BaseCollider* colA = bucketA.colliders[a];
+					const XMVECTOR minA[3] = { XMVectorReplicate(colA->aabbMin.x), XMVectorReplicate(colA->aabbMin.y), XMVectorReplicate(colA->aabbMin.z) };
+					const XMVECTOR maxA[3] = { XMVectorReplicate(colA->aabbMax.x), XMVectorReplicate(colA->aabbMax.y), XMVectorReplicate(colA->aabbMax.z) };
+
+					// 同じまとまり同士は後ろの相手とだけ比べる
+					const size_t first = i == j ? a + 1 : 0;
+					for (size_t g = first / 4; g < groupNum; g++)
+					{
+						const XMFLOAT4A* group = &bruteForceBounds[g * 6];
+						XMVECTOR overlap = XMVectorAndInt(
+							XMVectorLessOrEqual(minA[0], XMLoadFloat4A(&group[3])), XMVectorLessOrEqual(XMLoadFloat4A(&group[0]), maxA[0]));
+						for (int axis = 1; axis < 3; axis++)
+						{
+							overlap = XMVectorAndInt(overlap, XMVectorLessOrEqual(minA[axis], XMLoadFloat4A(&group[axis + 3])));
+							overlap = XMVectorAndInt(overlap, XMVectorLessOrEqual(XMLoadFloat4A(&group[axis]), maxA[axis]));
+						}
+
+						XMUINT4 mask;
+						XMStoreUInt4(&mask, overlap);
+						int overlapMask = (mask.x & 1) | (mask.y & 2) | (mask.z & 4) | (mask.w & 8);
+						if (g == first / 4) {
+							overlapMask &= ~((1 << (first % 4)) - 1);
+						}
+						for (int lane = 0; overlapMask != 0; lane++, overlapMask >>= 1)
+						{
+							if (overlapMask & 1) {
+								addContactPair(colA, bucketB.colliders[g * 4 + lane]);
+							}
+						}
+					}
 				}
+				continue;
+			}
+
+			bucketA.tree.QueryOverlaps(bucketB.tree, [&](int _proxyA, int _proxyB)
+				{
+					// 木は太いAABBで辿るので、実際のAABBで確かめ直す
+					BaseCollider* colA = bucketA.tree.GetCollider(_proxyA);
+					BaseCollider* colB = bucketB.tree.GetCollider(_proxyB);
+					if (CheckAABB2AABB(colA->aabbMin, colA->aabbMax, colB->aabbMin, colB->aabbMax)) {
+						addContactPair(colA, colB);
+					}
+				});
+		}
+	}
+
+	// 候補をキー順に並べ、同じくキー順の前フレームの候補と先頭から突き合わせる
+	// （通知順が木の形に左右されなくなり、ハッシュ表を作り直す手間も要らない）
+	std::sort(contactPairs.begin(), contactPairs.end(),
+		[](const CONTACT_PAIR& _a, const CONTACT_PAIR& _b) { return _a.key < _b.key; });
+
+	// どちらも動いていなければ前フレームの判定結果を使い回す
+	isPrevContactFound.assign(prevContactPairs.size(), false);
+	narrowphaseIndices.clear();
+	const int pairNum = static_cast<int>(contactPairs.size());
+	const int prevPairNum = static_cast<int>(prevContactPairs.size());
+	int prev = 0;
+	for (int i = 0; i < pairNum; i++)
+	{
+		CONTACT_PAIR& pair = contactPairs[i];
+		while (prev < prevPairNum && prevContactPairs[prev].key < pair.key) {
+			prev++;
+		}
+		if (prev < prevPairNum && prevContactPairs[prev].key == pair.key)
+		{
+			pair.prevIndex = prev;
+			isPrevContactFound[prev] = true;
+			if (!pair.colA->isMoved && !pair.colB->isMoved)
+			{
+				pair.inter = prevContactPairs[prev].inter;
+				pair.isTouching = prevContactPairs[prev].isTouching;
+				continue;
+			}
+		}
+		narrowphaseIndices.push_back(i);
+	}
+
+	// 詳細判定はコライダーを読むだけなので、候補ペアをスレッドで分担する
+	// （結果はペアごとの枠へ書き込むので、スレッド数に関わらず通知順は候補ペア順になる）
+	ThreadPool::GetInstance()->ParallelFor(static_cast<int>(narrowphaseIndices.size()), narrowphaseGrainSize,
+		[this](int _start, int _end, int)
+		{
+			for (int i = _start; i < _end; i++)
+			{
+				CONTACT_PAIR& pair = contactPairs[narrowphaseIndices[i]];
+				pair.isTouching = CheckPair(pair.colA, pair.colB, &pair.inter);
+			}
+		});
+
+	// 判定後に呼び出し元のスレッドでまとめて通知する
+	//（コールバックの中でコライダーが削除・解放されることがあるので、呼ぶ前に毎回通し番号で確かめる）
+	for (int i = 0; i < pairNum; i++)
+	{
+		CONTACT_PAIR& pair = contactPairs[i];
+		const bool isPrevTouching = pair.prevIndex >= 0 && prevContactPairs[pair.prevIndex].isTouching;
+		auto isAlive = [this, &pair]() { return !IsRemoved(pair.GetIdA()) && !IsRemoved(pair.GetIdB()); };
+
+		if (pair.isTouching)
+		{
+			// 先の通知で削除されていれば、接触していた場合だけ後でまとめて接触終了を通知する
+			if (!isAlive())
+			{
+				pair.isTouching = isPrevTouching;
+				continue;
+			}
+
+			const CollisionInfo infoA(pair.colB->GetObject3d(), pair.colB, pair.inter);
+			const CollisionInfo infoB(pair.colA->GetObject3d(), pair.colA, pair.inter);
+			if (isPrevTouching) {
+				pair.colA->OnCollisionStay(infoA);
+			}
+			else {
+				pair.colA->OnCollisionEnter(infoA);
+			}
+			if (isAlive()) {
+				pair.colA->OnCollision(infoA);
 			}
-			else if (colA->GetShapeType() == COLLISIONSHAPE_SPHERE &&
-				colB->GetShapeType() == COLLISIONSHAPE_MESH) {
-				MeshCollider* meshCollider = dynamic_cast<MeshCollider*>(colB);
-				Sphere* sphere = dynamic_cast<Sphere*>(colA);
-				DirectX::XMVECTOR inter;
-				if (meshCollider->CheckCollisionSphere(*sphere, &inter)) {
-					colA->OnCollision(CollisionInfo(colB->GetObject3d(), colB, inter));
-					colB->OnCollision(CollisionInfo(colA->GetObject3d(), colA, inter));
+			if (isAlive()) {
+				if (isPrevTouching) {
+					pair.colB->OnCollisionStay(infoB);
 				}
+				else {
+					pair.colB->OnCollisionEnter(infoB);
+				}
+			}
+			if (isAlive()) {
+				pair.colB->OnCollision(infoB);
 			}
 		}
+		else if (isPrevTouching)
+		{
+			// 候補には残ったが離れた
+			NotifyContactExit(prevContactPairs[pair.prevIndex]);
+		}
+	}
+
+	// 候補から外れたペア（離れた、属性が変わった、削除された）のうち、接触していたものへ接触終了を通知する
+	for (size_t i = 0; i < prevContactPairs.size(); i++)
+	{
+		if (!isPrevContactFound[i] && prevContactPairs[i].isTouching) {
+			NotifyContactExit(prevContactPairs[i]);
+		}
+	}
+
+	// 通知中に削除されたコライダーのペアは、ここで接触終了を通知して接触キャッシュから外す
+	//（通し番号は下で忘れるので、次のフレームに持ち越すと解放済みのコライダーに触ってしまう。
+	//  接触終了の通知でさらに削除されることもあるので、削除が増えなくなるまで繰り返す）
+	for (size_t removedNum = 0; removedNum != removedColliderIds.size();)
+	{
+		removedNum = removedColliderIds.size();
+		for (CONTACT_PAIR& pair : contactPairs)
+		{
+			if (pair.isTouching && (IsRemoved(pair.GetIdA()) || IsRemoved(pair.GetIdB())))
+			{
+				pair.isTouching = false;
+				NotifyContactExit(pair);
+			}
+		}
+	}
+
+	// 今フレームの候補を次のフレームの接触キャッシュにする
+	prevContactPairs.swap(contactPairs);
+
+	for (LAYER_BUCKET& bucket : layerBuckets)
+	{
+		for (BaseCollider* collider : bucket.colliders)
+		{
+			collider->isMoved = false;
+		}
+	}
+	removedColliderIds.clear();
+}
+
+void CollisionManager::NotifyContactExit(const CONTACT_PAIR& _pair)
+{
+	// 削除されたコライダーは既に解放されている場合があるので、通し番号だけで判断して触らない
+	//（Aへの通知の中でBが削除されることもあるので、Bへ通知する前に確かめ直す）
+	if (!IsRemoved(_pair.GetIdA())) {
+		_pair.colA->OnCollisionExit(IsRemoved(_pair.GetIdB()) ?
+			CollisionInfo(nullptr, nullptr, _pair.inter) :
+			CollisionInfo(_pair.colB->GetObject3d(), _pair.colB, _pair.inter));
+	}
+	if (!IsRemoved(_pair.GetIdB())) {
+		_pair.colB->OnCollisionExit(IsRemoved(_pair.GetIdA()) ?
+			CollisionInfo(nullptr, nullptr, _pair.inter) :
+			CollisionInfo(_pair.colA->GetObject3d(), _pair.colA, _pair.inter));
 	}
 }
 
+bool CollisionManager::CheckPair(BaseCollider* _colA, BaseCollider* _colB, XMVECTOR* _inter)
+{
+	const COLILSION_SHAPE_TYPE typeA = _colA->GetShapeType();
+	const COLILSION_SHAPE_TYPE typeB = _colB->GetShapeType();
+	assert(0 <= typeA && typeA < COLLISIONSHAPE_NUM);
+	assert(0 <= typeB && typeB < COLLISIONSHAPE_NUM);
+
+	const CheckFunction checkFunction = checkFunctions[typeA][typeB];
+	return checkFunction && checkFunction(_colA, _colB, _inter);
+}
+
 bool CollisionManager::Raycast(const Ray& _ray, RAYCAST_HIT* _hitInfo, float _maxDistance)
 {
 	return Raycast(_ray, 0xffff, _hitInfo, _maxDistance);
@@ -68,157 +593,416 @@ bool CollisionManager::Raycast(const Ray& _ray, RAYCAST_HIT* _hitInfo, float _ma
 bool CollisionManager::Raycast(const Ray& _ray, const unsigned short& _attribute, RAYCAST_HIT* _hitInfo, float _maxDistance)
 {
 	bool result = false;
-	std::forward_list<BaseCollider*>::iterator it;
-	std::forward_list<BaseCollider*>::iterator it_hit;
+	BaseCollider* hitCollider = nullptr;
 	float distance = _maxDistance;
 	XMVECTOR inter;
 
-	// 全てのコライダーと総当りチェック
-	it = colliders.begin();
-	for (; it != colliders.end(); ++it) {
-		BaseCollider* colA = *it;
+	XMFLOAT3 start;
+	XMStoreFloat3(&start, _ray.start);
+	const XMFLOAT3 invDir = Collision::ComputeInvDir(_ray.dir);
 
-		// 属性が合わなければスキップ
-		if (!(colA->attribute & _attribute)) {
-			continue;
+	// 属性が合うレイヤーの木から、レイが届くコライダーだけをチェック
+	RaycastColliders(_attribute, start, invDir, 0.0f, distance, [&](BaseCollider* colA) {
+		// ワールドAABBに当たらない、または既知の交点より遠ければスキップ
+		if (!Collision::CheckRay2AABB(start, invDir, colA->aabbMin, colA->aabbMax, distance)) {
+			return true;
 		}
 
-		if (colA->GetShapeType() == COLLISIONSHAPE_SPHERE) {
-			Sphere* sphere = dynamic_cast<Sphere*>(colA);
-
-			float tempDistance;
-			XMVECTOR tempInter;
-
-			if (!Collision::CheckRay2Sphere(_ray, *sphere, &tempDistance, &tempInter)) continue;
-			if (tempDistance >= distance) continue;
-
-			result = true;
-			distance = tempDistance;
-			inter = tempInter;
-			it_hit = it;
-		}
-		else if (colA->GetShapeType() == COLLISIONSHAPE_MESH) {
-			MeshCollider* meshCollider = dynamic_cast<MeshCollider*>(colA);
+		float tempDistance;
+		XMVECTOR tempInter;
+		if (!CheckRay2Collider(_ray, colA, &tempDistance, &tempInter)) return true;
+		if (tempDistance >= distance) return true;
 
-			float tempDistance;
-			DirectX::XMVECTOR tempInter;
-			if (!meshCollider->CheckCollisionRay(_ray, &tempDistance, &tempInter)) continue;
-			if (tempDistance >= distance) continue;
-
-			result = true;
-			distance = tempDistance;
-			inter = tempInter;
-			it_hit = it;
-		}
-	}
+		result = true;
+		distance = tempDistance;
+		inter = tempInter;
+		hitCollider = colA;
+		return true;
+	});
 
 	if (result && _hitInfo) {
 		_hitInfo->distance = distance;
 		_hitInfo->inter = inter;
-		_hitInfo->collider = *it_hit;
+		_hitInfo->collider = hitCollider;
 		_hitInfo->object = _hitInfo->collider->GetObject3d();
 	}
 
 	return result;
 }
 
-void CollisionManager::QuerySphere(const Sphere& _sphere, QueryCallback* _callback, const unsigned short& _attribute)
+int CollisionManager::RaycastBatch(const Ray* _rays, int _rayNum, const unsigned short& _attribute, RAYCAST_HIT* _hitInfos, float _maxDistance, int _threadNum)
 {
-	assert(_callback);
+	assert(_rays || _rayNum == 0);
+	assert(_hitInfos || _rayNum == 0);
+
+	// 属性の判定はバッチ全体で一度だけ行う
+	batchColliders.clear();
+	ForEachCollider(_attribute, [this](BaseCollider* _col)
+		{
+			batchColliders.push_back(_col);
+			return true;
+		});
+
+	// レイが少ない場合はスレッドを減らす
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	const int threadNum = (std::max)(1, (std::min)((std::min)(_threadNum, threadPool->GetThreadNum()), _rayNum / raycastBatchThreadMin));
+	if (threadNum == 1) {
+		RaycastBatchRange(_rays, _rayNum, _hitInfos, _maxDistance);
+	}
+	else {
+		// レイをスレッド数で均等に分け、常駐スレッドで分担する（範囲は重ならないので結果の枠へ直接書き込む）
+		const int rangeSize = (_rayNum + threadNum - 1) / threadNum;
+		threadPool->ParallelFor(_rayNum, rangeSize,
+			[this, _rays, _hitInfos, _maxDistance](int _start, int _end, int)
+			{
+				RaycastBatchRange(_rays + _start, _end - _start, _hitInfos + _start, _maxDistance);
+			});
+	}
 
-	std::forward_list<BaseCollider*>::iterator it;
+	int hitNum = 0;
+	for (int i = 0; i < _rayNum; i++) {
+		if (_hitInfos[i].collider) {
+			hitNum++;
+		}
+	}
 
-	// 全てのコライダーと総当りチェック
-	it = colliders.begin();
-	for (; it != colliders.end(); ++it) {
-		BaseCollider* col = *it;
+	return hitNum;
+}
 
-		// 属性が合わなければスキップ
-		if (!(col->attribute & _attribute)) {
-			continue;
+int CollisionManager::RaycastBatch(const std::vector<Ray>& _rays, const unsigned short& _attribute, std::vector<RAYCAST_HIT>& _hitInfos, float _maxDistance, int _threadNum)
+{
+	_hitInfos.resize(_rays.size());
+	return RaycastBatch(_rays.data(), static_cast<int>(_rays.size()), _attribute, _hitInfos.data(), _maxDistance, _threadNum);
+}
+
+void CollisionManager::RaycastBatchRange(const Ray* _rays, int _rayNum, RAYCAST_HIT* _hitInfos, float _maxDistance)
+{
+	// スラブ判定用の値はレイごとに一度だけ求める
+	std::vector<XMFLOAT3> starts(_rayNum);
+	std::vector<XMFLOAT3> invDirs(_rayNum);
+	for (int i = 0; i < _rayNum; i++)
+	{
+		XMStoreFloat3(&starts[i], _rays[i].start);
+		invDirs[i] = Collision::ComputeInvDir(_rays[i].dir);
+
+		_hitInfos[i].object = nullptr;
+		_hitInfos[i].collider = nullptr;
+		_hitInfos[i].distance = _maxDistance;
+	}
+
+	// メッシュへまとめて渡すレイ
+	std::vector<int> rayIndices;
+	std::vector<std::pair<uint32_t, int>> sortKeys;
+	std::vector<Ray> meshRays;
+	std::vector<float> meshDistances;
+	std::vector<XMVECTOR> meshInters;
+	std::unique_ptr<bool[]> meshHits(new bool[_rayNum]);
+	rayIndices.reserve(_rayNum);
+	meshRays.reserve(_rayNum);
+
+	// コライダーごとに、ワールドAABBに当たるレイだけをまとめて詳細判定する
+	for (BaseCollider* col : batchColliders)
+	{
+		rayIndices.clear();
+		for (int i = 0; i < _rayNum; i++)
+		{
+			if (Collision::CheckRay2AABB(starts[i], invDirs[i], col->aabbMin, col->aabbMax, _hitInfos[i].distance)) {
+				rayIndices.push_back(i);
+			}
 		}
+		if (rayIndices.empty()) { continue; }
 
-		// 球
-		if (col->GetShapeType() == COLLISIONSHAPE_SPHERE) {
-			Sphere* sphereB = dynamic_cast<Sphere*>(col);
+		if (col->GetShapeType() == COLLISIONSHAPE_MESH) {
+			MeshCollider* meshCollider = static_cast<MeshCollider*>(col);
+			const int meshRayNum = static_cast<int>(rayIndices.size());
+
+			// 近い始点・同じ向きのレイが4本ずつまとまるよう並べ替え、BVHを共有して辿れるようにする
+			sortKeys.resize(meshRayNum);
+			for (int i = 0; i < meshRayNum; i++) {
+				sortKeys[i] = { GetRaySortKey(_rays[rayIndices[i]], col->aabbMin, col->aabbMax), rayIndices[i] };
+			}
+			std::sort(sortKeys.begin(), sortKeys.end());
+			for (int i = 0; i < meshRayNum; i++) {
+				rayIndices[i] = sortKeys[i].second;
+			}
+
+			meshRays.resize(meshRayNum);
+			meshDistances.resize(meshRayNum);
+			meshInters.resize(meshRayNum);
+			for (int i = 0; i < meshRayNum; i++) {
+				meshRays[i] = _rays[rayIndices[i]];
+			}
 
-			XMVECTOR tempInter;
-			XMVECTOR tempReject;
-			if (!Collision::CheckSphere2Sphere(_sphere, *sphereB, &tempInter, &tempReject)) continue;
+			if (meshCollider->CheckCollisionRays(meshRays.data(), meshRayNum, meshHits.get(), meshDistances.data(), meshInters.data()) == 0) continue;
 
-			// 交差情報をセット
-			QUERY_HIT info;
-			info.collider = col;
-			info.object = col->GetObject3d();
-			info.inter = tempInter;
-			info.reject = tempReject;
+			for (int i = 0; i < meshRayNum; i++)
+			{
+				const int rayIndex = rayIndices[i];
+				if (!meshHits[i]) continue;
+				if (meshDistances[i] >= _hitInfos[rayIndex].distance) continue;
 
-			// クエリーコールバック呼び出し
-			if (!_callback->OnQueryHit(info)) {
-				// 戻り値がfalseの場合、継続せず終了
-				return;
+				_hitInfos[rayIndex].distance = meshDistances[i];
+				_hitInfos[rayIndex].inter = meshInters[i];
+				_hitInfos[rayIndex].collider = col;
+			}
+		}
+		else {
+			// メッシュ以外は1本ずつ判定する
+			for (int rayIndex : rayIndices)
+			{
+				float tempDistance;
+				XMVECTOR tempInter;
+				if (!CheckRay2Collider(_rays[rayIndex], col, &tempDistance, &tempInter)) continue;
+				if (tempDistance >= _hitInfos[rayIndex].distance) continue;
+
+				_hitInfos[rayIndex].distance = tempDistance;
+				_hitInfos[rayIndex].inter = tempInter;
+				_hitInfos[rayIndex].collider = col;
 			}
 		}
+	}
+
+	for (int i = 0; i < _rayNum; i++)
+	{
+		if (_hitInfos[i].collider) {
+			_hitInfos[i].object = _hitInfos[i].collider->GetObject3d();
+		}
+	}
+}
+
+void CollisionManager::QuerySphere(const Sphere& _sphere, QueryCallback* _callback, const unsigned short& _attribute)
+{
+	assert(_callback);
+
+	const XMFLOAT3 sphereMin = {
+		_sphere.center.m128_f32[0] - _sphere.radius,
+		_sphere.center.m128_f32[1] - _sphere.radius,
+		_sphere.center.m128_f32[2] - _sphere.radius };
+	const XMFLOAT3 sphereMax = {
+		_sphere.center.m128_f32[0] + _sphere.radius,
+		_sphere.center.m128_f32[1] + _sphere.radius,
+		_sphere.center.m128_f32[2] + _sphere.radius };
+
+	// 属性が合うレイヤーの木から、AABBが重なるコライダーだけをチェック
+	QueryColliders(_attribute, sphereMin, sphereMax, [&](BaseCollider* col) {
+		XMVECTOR tempInter;
+		XMVECTOR tempReject;
+		bool isHit = false;
+
+		// 球
+		if (col->GetShapeType() == COLLISIONSHAPE_SPHERE) {
+			SphereCollider* sphereB = static_cast<SphereCollider*>(col);
+			isHit = Collision::CheckSphere2Sphere(_sphere, *sphereB, &tempInter, &tempReject);
+		}
+		// カプセル
+		else if (col->GetShapeType() == COLLISIONSHAPE_CAPSULE) {
+			CapsuleCollider* capsule = static_cast<CapsuleCollider*>(col);
+			isHit = Collision::CheckSphere2Capsule(_sphere, *capsule, &tempInter, &tempReject);
+		}
+		// 軸平行ボックス
+		else if (col->GetShapeType() == COLLISIONSHAPE_AABB) {
+			AABBCollider* aabb = static_cast<AABBCollider*>(col);
+			isHit = Collision::CheckSphere2OBB(_sphere, aabb->ToOBB(), &tempInter, &tempReject);
+		}
+		// 有向ボックス
+		else if (col->GetShapeType() == COLLISIONSHAPE_OBB) {
+			OBBCollider* obb = static_cast<OBBCollider*>(col);
+			isHit = Collision::CheckSphere2OBB(_sphere, *obb, &tempInter, &tempReject);
+		}
 		// メッシュ
 		else if (col->GetShapeType() == COLLISIONSHAPE_MESH) {
-			MeshCollider* meshCollider = dynamic_cast<MeshCollider*>(col);
+			MeshCollider* meshCollider = static_cast<MeshCollider*>(col);
+			isHit = meshCollider->CheckCollisionSphere(_sphere, &tempInter, &tempReject);
+		}
+		// ハイトフィールド
+		else if (col->GetShapeType() == COLLISIONSHAPE_HEIGHTFIELD) {
+			HeightfieldCollider* heightfield = static_cast<HeightfieldCollider*>(col);
+			isHit = heightfield->CheckCollisionSphere(_sphere, &tempInter, &tempReject);
+		}
 
-			XMVECTOR tempInter;
-			XMVECTOR tempReject;
-			if (!meshCollider->CheckCollisionSphere(_sphere, &tempInter, &tempReject)) continue;
+		if (!isHit) return true;
 
-			// 交差情報をセット
-			QUERY_HIT info;
-			info.collider = col;
-			info.object = col->GetObject3d();
-			info.inter = tempInter;
-			info.reject = tempReject;
+		// 交差情報をセット
+		QUERY_HIT info;
+		info.collider = col;
+		info.object = col->GetObject3d();
+		info.inter = tempInter;
+		info.reject = tempReject;
 
-			// クエリーコールバック呼び出し
-			if (!_callback->OnQueryHit(info)) {
-				// 戻り値がfalseの場合、継続せず終了
-				return;
-			}
+		// クエリーコールバック呼び出し（戻り値がfalseの場合、継続せず終了）
+		return _callback->OnQueryHit(info);
+	});
+}
+
+bool CollisionManager::QuerySphereContacts(const Sphere& _sphere, ContactManifold* _manifold, const unsigned short& _attribute)
+{
+	assert(_manifold);
+	_manifold->Clear();
+
+	const XMFLOAT3 sphereMin = {
+		_sphere.center.m128_f32[0] - _sphere.radius,
+		_sphere.center.m128_f32[1] - _sphere.radius,
+		_sphere.center.m128_f32[2] - _sphere.radius };
+	const XMFLOAT3 sphereMax = {
+		_sphere.center.m128_f32[0] + _sphere.radius,
+		_sphere.center.m128_f32[1] + _sphere.radius,
+		_sphere.center.m128_f32[2] + _sphere.radius };
+
+	// 属性が合うレイヤーの木から、AABBが重なるコライダーの接触点を全て集める
+	QueryColliders(_attribute, sphereMin, sphereMax, [&](BaseCollider* col) {
+		XMVECTOR tempInter;
+		XMVECTOR tempReject;
+		bool isHit = false;
+
+		// メッシュ・ハイトフィールドは三角形ごとの接触点を直接追加する
+		if (col->GetShapeType() == COLLISIONSHAPE_MESH) {
+			static_cast<MeshCollider*>(col)->CheckCollisionSphereContacts(_sphere, _manifold);
+			return true;
 		}
-	}
+		else if (col->GetShapeType() == COLLISIONSHAPE_HEIGHTFIELD) {
+			static_cast<HeightfieldCollider*>(col)->CheckCollisionSphereContacts(_sphere, _manifold);
+			return true;
+		}
+		// 球
+		else if (col->GetShapeType() == COLLISIONSHAPE_SPHERE) {
+			SphereCollider* sphereB = static_cast<SphereCollider*>(col);
+			isHit = Collision::CheckSphere2Sphere(_sphere, *sphereB, &tempInter, &tempReject);
+		}
+		// カプセル
+		else if (col->GetShapeType() == COLLISIONSHAPE_CAPSULE) {
+			CapsuleCollider* capsule = static_cast<CapsuleCollider*>(col);
+			isHit = Collision::CheckSphere2Capsule(_sphere, *capsule, &tempInter, &tempReject);
+		}
+		// 軸平行ボックス
+		else if (col->GetShapeType() == COLLISIONSHAPE_AABB) {
+			AABBCollider* aabb = static_cast<AABBCollider*>(col);
+			isHit = Collision::CheckSphere2OBB(_sphere, aabb->ToOBB(), &tempInter, &tempReject);
+		}
+		// 有向ボックス
+		else if (col->GetShapeType() == COLLISIONSHAPE_OBB) {
+			OBBCollider* obb = static_cast<OBBCollider*>(col);
+			isHit = Collision::CheckSphere2OBB(_sphere, *obb, &tempInter, &tempReject);
+		}
+
+		if (!isHit) return true;
+
+		// 排斥ベクトルを法線とめり込み量に分ける（接しているだけなら追加しない）
+		const float depth = XMVector3Length(tempReject).m128_f32[0];
+		if (depth <= 0.0f) return true;
+
+		CONTACT_POINT contact;
+		contact.collider = col;
+		contact.point = tempInter;
+		contact.normal = tempReject / depth;
+		contact.depth = depth;
+		_manifold->AddContact(contact);
+		return true;
+	});
+
+	return !_manifold->IsEmpty();
 }
 
 bool CollisionManager::QueryCapsule(const Capsule& _capsule, const unsigned short& _attribute)
 {
 	bool result = false;
-	std::forward_list<BaseCollider*>::iterator it;
-	std::forward_list<BaseCollider*>::iterator it_hit;
-	XMVECTOR inter;
 
-	// 全てのコライダーと総当りチェック
-	it = colliders.begin();
-	for (; it != colliders.end(); ++it) {
-		BaseCollider* colA = *it;
+	//カプセルを囲むAABB
+	const XMFLOAT3 capsuleMin = {
+		(std::min)(_capsule.startPosition.x, _capsule.endPosition.x) - _capsule.radius,
+		(std::min)(_capsule.startPosition.y, _capsule.endPosition.y) - _capsule.radius,
+		(std::min)(_capsule.startPosition.z, _capsule.endPosition.z) - _capsule.radius };
+	const XMFLOAT3 capsuleMax = {
+		(std::max)(_capsule.startPosition.x, _capsule.endPosition.x) + _capsule.radius,
+		(std::max)(_capsule.startPosition.y, _capsule.endPosition.y) + _capsule.radius,
+		(std::max)(_capsule.startPosition.z, _capsule.endPosition.z) + _capsule.radius };
+
+	// 属性が合うレイヤーの木から、AABBが重なるコライダーだけをチェックし、1つでも当たれば打ち切る
+	QueryColliders(_attribute, capsuleMin, capsuleMax, [&](BaseCollider* colA) {
+		if (colA->GetShapeType() == COLLISIONSHAPE_SPHERE) {
+			SphereCollider* sphere = static_cast<SphereCollider*>(colA);
+			result = Collision::CheckSphere2Capsule(*sphere, _capsule);
+		} else if (colA->GetShapeType() == COLLISIONSHAPE_MESH) {
+			MeshCollider* meshCollider = static_cast<MeshCollider*>(colA);
+			result = meshCollider->CheckCollisionCapsule(_capsule);
+		} else if (colA->GetShapeType() == COLLISIONSHAPE_HEIGHTFIELD) {
+			HeightfieldCollider* heightfield = static_cast<HeightfieldCollider*>(colA);
+			result = heightfield->CheckCollisionCapsule(_capsule);
+		} else if (colA->GetShapeType() == COLLISIONSHAPE_CAPSULE) {
+			CapsuleCollider* capsule = static_cast<CapsuleCollider*>(colA);
+			result = Collision::CheckCapsule2Capsule(_capsule, *capsule);
+		} else if (colA->GetShapeType() == COLLISIONSHAPE_AABB) {
+			AABBCollider* aabb = static_cast<AABBCollider*>(colA);
+			result = Collision::CheckCapsule2OBB(_capsule, aabb->ToOBB());
+		} else if (colA->GetShapeType() == COLLISIONSHAPE_OBB) {
+			OBBCollider* obb = static_cast<OBBCollider*>(colA);
+			result = Collision::CheckCapsule2OBB(_capsule, *obb);
+		}
+		return !result;
+	});
+
+	return result;
+}
 
-		// 属性が合わなければスキップ
-		if (!(colA->attribute & _attribute)) {
-			continue;
+bool CollisionManager::SweepSphere(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement, const unsigned short& _attribute, SWEEP_HIT* _hitInfo)
+{
+	bool result = false;
+	BaseCollider* hitCollider = nullptr;
+	float time = 1.0f;
+	XMVECTOR inter = {};
+	XMVECTOR normal = {};
+
+	// 球の中心の軌跡を、半径だけ広げたAABBに対するレイとして扱う
+	XMFLOAT3 start;
+	XMStoreFloat3(&start, _sphere.center);
+	const XMFLOAT3 invDir = Collision::ComputeInvDir(_displacement);
+	const float radius = _sphere.radius;
+
+	// 接触を見つけるまでは終了時刻ちょうどの接触も拾う
+	float maxTime = time + 1.0e-6f;
+
+	// 属性が合うレイヤーの木から、球の軌跡が届くコライダーだけをチェック
+	RaycastColliders(_attribute, start, invDir, radius, maxTime, [&](BaseCollider* colA) {
+		// 広げたワールドAABBに届かない、または既知の接触より後ならスキップ
+		const XMFLOAT3 aabbMin = { colA->aabbMin.x - radius, colA->aabbMin.y - radius, colA->aabbMin.z - radius };
+		const XMFLOAT3 aabbMax = { colA->aabbMax.x + radius, colA->aabbMax.y + radius, colA->aabbMax.z + radius };
+		if (!Collision::CheckRay2AABB(start, invDir, aabbMin, aabbMax, result ? time : time + 1.0e-6f)) {
+			return true;
 		}
 
+		float tempTime;
+		XMVECTOR tempInter, tempNormal;
+		bool isHit = false;
 		if (colA->GetShapeType() == COLLISIONSHAPE_SPHERE) {
-			Sphere* sphere = dynamic_cast<Sphere*>(colA);
-
-			float tempDistance;
+			SphereCollider* sphere = static_cast<SphereCollider*>(colA);
+			isHit = Collision::CheckSweptSphere2Sphere(_sphere, _displacement, *sphere, &tempTime, &tempInter, &tempNormal);
+		}
+		else if (colA->GetShapeType() == COLLISIONSHAPE_MESH) {
+			MeshCollider* meshCollider = static_cast<MeshCollider*>(colA);
+			isHit = meshCollider->SweepSphere(_sphere, _displacement, &tempTime, &tempInter, &tempNormal);
+		}
+		else if (colA->GetShapeType() == COLLISIONSHAPE_HEIGHTFIELD) {
+			HeightfieldCollider* heightfield = static_cast<HeightfieldCollider*>(colA);
+			isHit = heightfield->SweepSphere(_sphere, _displacement, &tempTime, &tempInter, &tempNormal);
+		}
 
-			if (!Collision::CheckSphereCapsule(*sphere, _capsule, &tempDistance)) continue;
-			//if (tempDistance >= distance) continue;
-			result = true;
-			inter = {};
-			it_hit = it;
-		} else if (colA->GetShapeType() == COLLISIONSHAPE_MESH) {
-			MeshCollider* meshCollider = dynamic_cast<MeshCollider*>(colA);
+		if (!isHit) return true;
+		if (result && tempTime >= time) return true;
 
-			if (!meshCollider->CheckCollisionCapsule(_capsule)) continue;
+		result = true;
+		hitCollider = colA;
+		time = tempTime;
+		maxTime = time;
+		inter = tempInter;
+		normal = tempNormal;
+		return true;
+	});
 
-			result = true;
-			inter = {};
-			it_hit = it;
-		}
+	if (result && _hitInfo) {
+		_hitInfo->time = time;
+		_hitInfo->inter = inter;
+		_hitInfo->normal = normal;
+		_hitInfo->collider = hitCollider;
+		_hitInfo->object = hitCollider->GetObject3d();
 	}
 
 	return result;
@@ -2,10 +2,17 @@
 
 #include "CollisionPrimitive.h"
 #include "RaycastHit.h"
+#include "SweepHit.h"
 #include "QueryCallback.h"
+#include "CollisionInfo.h"
+#include "ContactManifold.h"
+#include "DynamicAABBTree.h"
 
 #include <d3d12.h>
-#include <forward_list>
+#include <array>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
 
 class BaseCollider;
 
@@ -14,25 +21,58 @@ class CollisionManager
 public:// 静的メンバ関数
 	static CollisionManager* GetInstance();
 
+public:// 定数
+	// レイヤーの数（当たり判定属性の1bitが1レイヤー）
+	static const int layerNum = 16;
+	// 属性0のコライダーを総当たり判定で入れるレイヤー（レイヤー0）
+	static const unsigned short defaultLayerAttribute = 1;
+
 public:// メンバ関数
 	/// <summary>
 	/// コライダーの追加
 	/// </summary>
 	/// <param name="collider">コライダー</param>
-	inline void AddCollider(BaseCollider* _collider) {
-		colliders.push_front(_collider);
-	}
+	void AddCollider(BaseCollider* _collider);
 
 	/// <summary>
 	/// コライダーの削除
 	/// </summary>
 	/// <param name="collider">コライダー</param>
-	inline void RemoveCollider(BaseCollider* _collider) {
-		colliders.remove(_collider);
-	}
+	void RemoveCollider(BaseCollider* _collider);
+
+	/// <summary>
+	/// コライダーの当たり判定属性を変更し、レイヤー分けを更新する（BaseCollider::SetAttributeから呼ばれる）
+	/// </summary>
+	/// <param name="_collider">コライダー</param>
+	/// <param name="_attribute">新しい当たり判定属性</param>
+	void ChangeAttribute(BaseCollider* _collider, unsigned short _attribute);
+
+	/// <summary>
+	/// コライダーのワールドAABBの変更を動的AABB木へ反映する（BaseCollider::UpdateProxyから呼ばれる）
+	/// </summary>
+	/// <param name="_collider">コライダー</param>
+	void MoveCollider(BaseCollider* _collider);
+
+	/// <summary>
+	/// レイヤー同士が衝突するかをセット（対称に設定される。初期状態は全て衝突する）
+	/// </summary>
+	/// <param name="_layerA">レイヤー番号A（0～layerNum-1）</param>
+	/// <param name="_layerB">レイヤー番号B（0～layerNum-1）</param>
+	/// <param name="_isCollide">衝突するか</param>
+	void SetLayerCollision(int _layerA, int _layerB, bool _isCollide);
+
+	/// <summary>
+	/// レイヤー同士が衝突するかを取得
+	/// </summary>
+	/// <param name="_layerA">レイヤー番号A（0～layerNum-1）</param>
+	/// <param name="_layerB">レイヤー番号B（0～layerNum-1）</param>
+	/// <returns>衝突するか</returns>
+	bool IsLayerCollision(int _layerA, int _layerB) const;
 
 	/// <summary>
 	/// 全ての衝突チェック
+	/// （詳細判定はワーカースレッドで分担し、衝突時コールバックは判定後に呼び出し元のスレッドでまとめて呼ぶ。
+	/// 前フレームとの比較でEnter/Stay/Exitを通知し、どちらも動いていないペアは前フレームの結果を使い回す）
 	/// </summary>
 	void CheckAllCollisions();
 
@@ -55,6 +95,31 @@ public:// メンバ関数
 	/// <returns>レイが任意のコライダーと交わる場合はtrue、それ以外はfalse</returns>
 	bool Raycast(const Ray& _ray, const unsigned short& _attribute, RAYCAST_HIT* _hitInfo = nullptr, float _maxDistance = D3D12_FLOAT32_MAX);
 
+	/// <summary>
+	/// 複数レイの一括レイキャスト（コライダーごとにまとめて判定する）
+	/// </summary>
+	/// <param name="_rays">レイの配列</param>
+	/// <param name="_rayNum">レイの数</param>
+	/// <param name="_attribute">対象の衝突属性</param>
+	/// <param name="_hitInfos">レイごとの衝突情報（出力用）。当たらなかったレイはcolliderがnullptr</param>
+	/// <param name="_maxDistance">最大距離</param>
+	/// <param name="_threadNum">使用するスレッド数（ThreadPoolのスレッド数まで。レイが少ない場合は減らす）</param>
+	/// <returns>いずれかのコライダーと交わったレイの数</returns>
+	int RaycastBatch(const Ray* _rays, int _rayNum, const unsigned short& _attribute, RAYCAST_HIT* _hitInfos,
+		float _maxDistance = D3D12_FLOAT32_MAX, int _threadNum = 1);
+
+	/// <summary>
+	/// 複数レイの一括レイキャスト（コライダーごとにまとめて判定する）
+	/// </summary>
+	/// <param name="_rays">レイの配列</param>
+	/// <param name="_attribute">対象の衝突属性</param>
+	/// <param name="_hitInfos">レイごとの衝突情報（出力用、レイの数に合わせる）</param>
+	/// <param name="_maxDistance">最大距離</param>
+	/// <param name="_threadNum">使用するスレッド数（ThreadPoolのスレッド数まで。レイが少ない場合は減らす）</param>
+	/// <returns>いずれかのコライダーと交わったレイの数</returns>
+	int RaycastBatch(const std::vector<Ray>& _rays, const unsigned short& _attribute, std::vector<RAYCAST_HIT>& _hitInfos,
+		float _maxDistance = D3D12_FLOAT32_MAX, int _threadNum = 1);
+
 	/// <summary>
 	/// 球による衝突全検索
 	/// </summary>
@@ -63,6 +128,16 @@ public:// メンバ関数
 	/// <param name="_attribute">対象の衝突属性</param>
 	void QuerySphere(const Sphere& _sphere, QueryCallback* _callback, const unsigned short& _attribute = (unsigned short)0xffffffff);
 
+	/// <summary>
+	/// 球と重なる全ての接触点を一度の検索で集める
+	/// （メッシュ・ハイトフィールドは重なる三角形を全て集めるので、押し出しはComputeRejectの結果を一度適用すればよい）
+	/// </summary>
+	/// <param name="_sphere">球</param>
+	/// <param name="_manifold">接触多様体（出力用、最初に破棄する）</param>
+	/// <param name="_attribute">対象の衝突属性</param>
+	/// <returns>いずれかのコライダーと交差しているか否か</returns>
+	bool QuerySphereContacts(const Sphere& _sphere, ContactManifold* _manifold, const unsigned short& _attribute = (unsigned short)0xffffffff);
+
 	/// <summary>
 	/// カプセルによる衝突全検索
 	/// </summary>
@@ -71,13 +146,251 @@ public:// メンバ関数
 	/// <param name="_maxDistance">最大距離</param>
 	bool QueryCapsule(const Capsule& _capsule, const unsigned short& _attribute);
 
+	/// <summary>
+	/// 移動する球と最初に接触するコライダーを求める（すり抜け防止の連続判定。球・メッシュ・ハイトフィールドが対象）
+	/// </summary>
+	/// <param name="_sphere">移動する球（移動開始時）</param>
+	/// <param name="_displacement">移動量</param>
+	/// <param name="_attribute">対象の衝突属性</param>
+	/// <param name="_hitInfo">衝突情報</param>
+	/// <returns>移動中に接触するか否か</returns>
+	bool SweepSphere(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement, const unsigned short& _attribute, SWEEP_HIT* _hitInfo = nullptr);
+
+private: // エイリアス
+	// 形状の組ごとの詳細判定関数（衝突していれば交点を書き込みtrueを返す）
+	using CheckFunction = bool(*)(BaseCollider* _colA, BaseCollider* _colB, DirectX::XMVECTOR* _inter);
+	// 形状の組を添字とする詳細判定関数の表（判定しない組はnullptr）
+	using CheckFunctionTable = std::array<std::array<CheckFunction, COLLISIONSHAPE_NUM>, COLLISIONSHAPE_NUM>;
+
+private: // サブクラス
+
+	// 候補ペアと詳細判定の結果（次のフレームへ接触キャッシュとして持ち越す）
+	struct CONTACT_PAIR
+	{
+		// コライダーの通し番号から作るキー（小さい方が上位32bit）
+		uint64_t key;
+		// 通し番号が小さい方のコライダー
+		BaseCollider* colA;
+		// 通し番号が大きい方のコライダー
+		BaseCollider* colB;
+		// 衝突点
+		DirectX::XMVECTOR inter;
+		// 接触しているか
+		bool isTouching;
+		// 前フレームの同じペアの番号（前フレームに候補でなければ-1）
+		int prevIndex;
+
+		// 通し番号が小さい方のコライダーの通し番号（コライダーが解放済みでも読める）
+		unsigned int GetIdA() const { return static_cast<unsigned int>(key >> 32); }
+		// 通し番号が大きい方のコライダーの通し番号
+		unsigned int GetIdB() const { return static_cast<unsigned int>(key & 0xffffffff); }
+	};
+
+	// 当たり判定属性が同じコライダーのまとまり
+	struct LAYER_BUCKET
+	{
+		// 当たり判定属性
+		unsigned short attribute;
+		// 属性が一致するコライダー
+		std::vector<BaseCollider*> colliders;
+		// 属性が一致するコライダーの動的AABB木
+		DynamicAABBTree tree;
+	};
+
+
 private:
-	CollisionManager() = default;
+	CollisionManager();
 	CollisionManager(const CollisionManager&) = delete;
 	~CollisionManager() = default;
 	CollisionManager& operator=(const CollisionManager&) = delete;
 
-	// コライダーのリスト
-	std::forward_list<BaseCollider*> colliders;
+	/// <summary>
+	/// 形状の組ごとの詳細判定関数の表を作る
+	/// </summary>
+	/// <returns>詳細判定関数の表</returns>
+	static CheckFunctionTable CreateCheckFunctionTable();
+
+	/// <summary>
+	/// 総当たり判定で使うレイヤーを求める（属性0は以前どの相手とも判定していたので、レイヤー0として扱う）
+	/// </summary>
+	/// <param name="_attribute">当たり判定属性</param>
+	/// <returns>レイヤーの属性</returns>
+	static unsigned short GetCollisionLayers(unsigned short _attribute) { return _attribute != 0 ? _attribute : defaultLayerAttribute; }
+
+	/// <summary>
+	/// 当たり判定属性と衝突する相手の属性をレイヤー行列から求める
+	/// </summary>
+	/// <param name="_attribute">当たり判定属性</param>
+	/// <returns>衝突する相手の属性</returns>
+	unsigned short ComputeCollideMask(unsigned short _attribute) const;
+
+	/// <summary>
+	/// 当たり判定属性が一致するまとまりを探す
+	/// </summary>
+	/// <param name="_attribute">当たり判定属性</param>
+	/// <returns>まとまり（無ければnullptr）</returns>
+	LAYER_BUCKET* FindBucket(unsigned short _attribute);
+
+	/// <summary>
+	/// 当たり判定属性が一致するまとまりへコライダーを加える
+	/// </summary>
+	/// <param name="_collider">コライダー</param>
+	void AddToBucket(BaseCollider* _collider);
+
+	/// <summary>
+	/// 所属するまとまりからコライダーを外す
+	/// </summary>
+	/// <param name="_collider">コライダー</param>
+	void RemoveFromBucket(BaseCollider* _collider);
+
+	/// <summary>
+	/// 当たり判定属性が_attributeと重なるまとまりのコライダーだけを辿る
+	/// （_functionがfalseを返したら打ち切る）
+	/// </summary>
+	/// <param name="_attribute">対象の衝突属性</param>
+	/// <param name="_function">コライダーごとの処理</param>
+	template <typename Function>
+	void ForEachCollider(unsigned short _attribute, Function _function)
+	{
+		for (LAYER_BUCKET& bucket : layerBuckets)
+		{
+			// 属性が合わないまとまりは中身を見ずに飛ばす
+			if (!(bucket.attribute & _attribute)) { continue; }
+
+			for (BaseCollider* col : bucket.colliders)
+			{
+				if (!_function(col)) { return; }
+			}
+		}
+	}
+
+	/// <summary>
+	/// 属性が合うまとまりの動的AABB木から、ワールドAABBが重なるコライダーだけを辿る
+	/// （_functionがfalseを返したら打ち切る）
+	/// </summary>
+	/// <param name="_attribute">対象の衝突属性</param>
+	/// <param name="_min">AABB最小値</param>
+	/// <param name="_max">AABB最大値</param>
+	/// <param name="_function">コライダーごとの処理</param>
+	template <typename Function>
+	void QueryColliders(unsigned short _attribute, const DirectX::XMFLOAT3& _min, const DirectX::XMFLOAT3& _max, Function _function)
+	{
+		bool isContinue = true;
+		for (LAYER_BUCKET& bucket : layerBuckets)
+		{
+			if (!(bucket.attribute & _attribute)) { continue; }
+
+			const DynamicAABBTree& tree = bucket.tree;
+			tree.Query(_min, _max, [&](int _proxyId)
+				{
+					// 木は太いAABBで辿るので、実際のAABBで確かめ直す
+					BaseCollider* col = tree.GetCollider(_proxyId);
+					if (!CheckAABB2AABB(_min, _max, col->aabbMin, col->aabbMax)) { return true; }
+					isContinue = _function(col);
+					return isContinue;
+				});
+			if (!isContinue) { return; }
+		}
+	}
+
+	/// <summary>
+	/// 属性が合うまとまりの動的AABB木から、レイ（_radiusだけ太らせる）が届くコライダーだけを辿る
+	/// （_maxDistanceは_functionの中で縮めてよい。_functionがfalseを返したら打ち切る）
+	/// </summary>
+	/// <param name="_attribute">対象の衝突属性</param>
+	/// <param name="_start">レイの始点</param>
+	/// <param name="_invDir">レイの方向の逆数</param>
+	/// <param name="_radius">AABBを太らせる量</param>
+	/// <param name="_maxDistance">最大距離</param>
+	/// <param name="_function">コライダーごとの処理</param>
+	template <typename Function>
+	void RaycastColliders(unsigned short _attribute, const DirectX::XMFLOAT3& _start, const DirectX::XMFLOAT3& _invDir,
+		float _radius, const float& _maxDistance, Function _function)
+	{
+		bool isContinue = true;
+		for (LAYER_BUCKET& bucket : layerBuckets)
+		{
+			if (!(bucket.attribute & _attribute)) { continue; }
+
+			const DynamicAABBTree& tree = bucket.tree;
+			tree.Raycast(_start, _invDir, _radius, _maxDistance, [&](int _proxyId)
+				{
+					isContinue = _function(tree.GetCollider(_proxyId));
+					return isContinue;
+				});
+			if (!isContinue) { return; }
+		}
+	}
+
+	/// <summary>
+	/// AABBとAABBの当たり判定
+	/// </summary>
+	static bool CheckAABB2AABB(const DirectX::XMFLOAT3& _minA, const DirectX::XMFLOAT3& _maxA,
+		const DirectX::XMFLOAT3& _minB, const DirectX::XMFLOAT3& _maxB)
+	{
+		return _minA.x <= _maxB.x && _minB.x <= _maxA.x &&
+			_minA.y <= _maxB.y && _minB.y <= _maxA.y &&
+			_minA.z <= _maxB.z && _minB.z <= _maxA.z;
+	}
+
+	/// <summary>
+	/// 候補ペアの詳細判定（形状の組で判定関数の表を引く）
+	/// </summary>
+	/// <param name="_colA">コライダーA</param>
+	/// <param name="_colB">コライダーB</param>
+	/// <param name="_inter">衝突点（出力用）</param>
+	/// <returns>衝突しているか</returns>
+	bool CheckPair(BaseCollider* _colA, BaseCollider* _colB, DirectX::XMVECTOR* _inter);
+
+	/// <summary>
+	/// 通し番号のコライダーが前回の全衝突チェック以降（通知中を含む）に削除されたか
+	/// </summary>
+	/// <param name="_colliderId">通し番号</param>
+	/// <returns>削除されたか</returns>
+	bool IsRemoved(unsigned int _colliderId) const { return removedColliderIds.count(_colliderId) != 0; }
+
+	/// <summary>
+	/// 接触していたペアの接触終了を、削除されていない側へ通知する（通知中に削除された側にもそれ以降は触らない）
+	/// </summary>
+	/// <param name="_pair">候補ペア</param>
+	void NotifyContactExit(const CONTACT_PAIR& _pair);
+
+	/// <summary>
+	/// 一括レイキャストの範囲分の判定（batchCollidersに対して行う）
+	/// </summary>
+	/// <param name="_rays">レイの配列</param>
+	/// <param name="_rayNum">レイの数</param>
+	/// <param name="_hitInfos">レイごとの衝突情報（出力用）</param>
+	/// <param name="_maxDistance">最大距離</param>
+	void RaycastBatchRange(const Ray* _rays, int _rayNum, RAYCAST_HIT* _hitInfos, float _maxDistance);
+
+	// 形状の組ごとの詳細判定関数
+	static const CheckFunctionTable checkFunctions;
+	// 当たり判定属性ごとのコライダー（空になっても残し、木のノードを使い回す）
+	std::vector<LAYER_BUCKET> layerBuckets;
+	// レイヤーごとの衝突するレイヤーのビット（レイヤー行列）
+	std::array<unsigned short, layerNum> layerMasks;
+	// 広域判定を通過した候補ペア
+	std::vector<CONTACT_PAIR> contactPairs;
+	// 前フレームの候補ペア（接触キャッシュ、キー順）
+	std::vector<CONTACT_PAIR> prevContactPairs;
+	// 前フレームの候補ペアが今フレームも候補になったか
+	std::vector<bool> isPrevContactFound;
+	// 詳細判定をやり直す候補ペアの番号
+	std::vector<int> narrowphaseIndices;
+	// 前回の全衝突チェック以降に削除されたコライダーの通し番号
+	std::unordered_set<unsigned int> removedColliderIds;
+	// 次に割り当てるコライダーの通し番号
+	unsigned int nextColliderId = 0;
+	// 詳細判定で1スレッドが1度に取り出す候補ペアの数
+	static const int narrowphaseGrainSize = 16;
+	// まとまりの組のペア数がこれ以下なら木を辿らず総当たりで候補を作る（少数では木を辿る手間の方が大きい）
+	static const size_t bruteForcePairMax = 8192;
+	// 総当たりで比べる側のAABB（4つずつSoA形式で、最小値xyz・最大値xyzの順に並べる）
+	std::vector<DirectX::XMFLOAT4A> bruteForceBounds;
+	// 一括レイキャストで属性が一致したコライダー
+	std::vector<BaseCollider*> batchColliders;
+	// 一括レイキャストで1スレッドに割り当てるレイの最小数
+	static const int raycastBatchThreadMin = 128;
 };
 
@@ -0,0 +1,189 @@
+﻿#include "CollisionMesh.h"
+#include "CookedBinary.h"
+#include <d3d12.h>
+#include <algorithm>
+
+using namespace DirectX;
+
+void CollisionMesh::Create(const std::vector<XMFLOAT3>& _positions, const std::vector<uint32_t>& _indices, bool _isQuantize)
+{
+	Clear();
+
+	isQuantized = _isQuantize;
+	indices.assign(_indices.begin(), _indices.begin() + _indices.size() / 3 * 3);
+
+	if (isQuantized)
+	{
+		// メッシュのAABBを求め、その範囲を16bitで等分する
+		XMFLOAT3 meshMin = { D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX };
+		XMFLOAT3 meshMax = { -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX };
+		for (const XMFLOAT3& position : _positions)
+		{
+			meshMin = { (std::min)(meshMin.x, position.x), (std::min)(meshMin.y, position.y), (std::min)(meshMin.z, position.z) };
+			meshMax = { (std::max)(meshMax.x, position.x), (std::max)(meshMax.y, position.y), (std::max)(meshMax.z, position.z) };
+		}
+
+		const float quantizeMax = 65535.0f;
+		quantizeMin = meshMin;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const float extent = (&meshMax.x)[axis] - (&meshMin.x)[axis];
+			(&quantizeScale.x)[axis] = extent > 0.0f ? extent / quantizeMax : 0.0f;
+		}
+
+		quantizedPositions.resize(_positions.size());
+		for (size_t i = 0; i < _positions.size(); i++)
+		{
+			uint16_t* quantized = &quantizedPositions[i].x;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const float scale = (&quantizeScale.x)[axis];
+				const float value = scale > 0.0f ? ((&_positions[i].x)[axis] - (&quantizeMin.x)[axis]) / scale : 0.0f;
+				quantized[axis] = static_cast<uint16_t>((std::min)((std::max)(value + 0.5f, 0.0f), quantizeMax));
+			}
+		}
+	}
+	else
+	{
+		positions = _positions;
+	}
+
+	// 法線は復元後の座標から計算し、判定に使う座標と一致させる
+	const int triangleNum = static_cast<int>(indices.size() / 3);
+	normals.resize(triangleNum);
+	for (int i = 0; i < triangleNum; i++)
+	{
+		XMFLOAT3 p0 = GetPosition(indices[i * 3 + 0]);
+		XMFLOAT3 p1 = GetPosition(indices[i * 3 + 1]);
+		XMFLOAT3 p2 = GetPosition(indices[i * 3 + 2]);
+		XMVECTOR p0_p1 = XMLoadFloat3(&p1) - XMLoadFloat3(&p0);
+		XMVECTOR p0_p2 = XMLoadFloat3(&p2) - XMLoadFloat3(&p0);
+		XMStoreFloat3(&normals[i], XMVector3Normalize(XMVector3Cross(p0_p1, p0_p2)));
+	}
+}
+
+void CollisionMesh::Clear()
+{
+	positions.clear();
+	quantizedPositions.clear();
+	indices.clear();
+	normals.clear();
+	quantizeMin = {};
+	quantizeScale = {};
+	isQuantized = false;
+}
+
+bool CollisionMesh::Write(FILE* _fp) const
+{
+	COOKED_HEADER header;
+	header.positionNum = static_cast<uint32_t>(positions.size());
+	header.quantizedPositionNum = static_cast<uint32_t>(quantizedPositions.size());
+	header.triangleNum = static_cast<uint32_t>(normals.size());
+	header.isQuantized = isQuantized ? 1 : 0;
+	header.quantizeMin = quantizeMin;
+	header.quantizeScale = quantizeScale;
+
+	return CookedBinary::Write(_fp, &header, 1) &&
+		CookedBinary::Write(_fp, positions.data(), positions.size()) &&
+		CookedBinary::Write(_fp, quantizedPositions.data(), quantizedPositions.size()) &&
+		CookedBinary::Write(_fp, indices.data(), indices.size()) &&
+		CookedBinary::Write(_fp, normals.data(), normals.size());
+}
+
+bool CollisionMesh::Read(const char*& _cursor, const char* _end)
+{
+	Clear();
+
+	COOKED_HEADER header;
+	if (!CookedBinary::Read(_cursor, _end, &header, 1)) {
+		return false;
+	}
+
+	isQuantized = header.isQuantized != 0;
+	quantizeMin = header.quantizeMin;
+	quantizeScale = header.quantizeScale;
+
+	// 各配列は書き出した並びのまま複写する
+	if (!CookedBinary::Read(_cursor, _end, positions, header.positionNum) ||
+		!CookedBinary::Read(_cursor, _end, quantizedPositions, header.quantizedPositionNum) ||
+		!CookedBinary::Read(_cursor, _end, indices, static_cast<size_t>(header.triangleNum) * 3) ||
+		!CookedBinary::Read(_cursor, _end, normals, header.triangleNum))
+	{
+		Clear();
+		return false;
+	}
+
+	//範囲外の頂点を指すインデックスがあれば使わない
+	const uint32_t vertexNum = static_cast<uint32_t>(GetVertexNum());
+	for (uint32_t index : indices)
+	{
+		if (index >= vertexNum)
+		{
+			Clear();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void CollisionMesh::ReorderTriangles(const std::vector<int>& _order)
+{
+	std::vector<uint32_t> sortIndices(_order.size() * 3);
+	std::vector<XMFLOAT3> sortNormals(_order.size());
+	for (size_t i = 0; i < _order.size(); i++)
+	{
+		const int source = _order[i];
+		sortIndices[i * 3 + 0] = indices[source * 3 + 0];
+		sortIndices[i * 3 + 1] = indices[source * 3 + 1];
+		sortIndices[i * 3 + 2] = indices[source * 3 + 2];
+		sortNormals[i] = normals[source];
+	}
+
+	indices.swap(sortIndices);
+	normals.swap(sortNormals);
+}
+
+XMFLOAT3 CollisionMesh::GetPosition(uint32_t _index) const
+{
+	if (!isQuantized) {
+		return positions[_index];
+	}
+
+	const QUANTIZED_POSITION& quantized = quantizedPositions[_index];
+	return {
+		quantizeMin.x + quantized.x * quantizeScale.x,
+		quantizeMin.y + quantized.y * quantizeScale.y,
+		quantizeMin.z + quantized.z * quantizeScale.z };
+}
+
+void CollisionMesh::GetTriangle(int _index, Triangle* _triangle) const
+{
+	const XMFLOAT3 p0 = GetPosition(indices[_index * 3 + 0]);
+	const XMFLOAT3 p1 = GetPosition(indices[_index * 3 + 1]);
+	const XMFLOAT3 p2 = GetPosition(indices[_index * 3 + 2]);
+	const XMFLOAT3& normal = normals[_index];
+
+	_triangle->p0 = { p0.x, p0.y, p0.z, 1 };
+	_triangle->p1 = { p1.x, p1.y, p1.z, 1 };
+	_triangle->p2 = { p2.x, p2.y, p2.z, 1 };
+	_triangle->normal = { normal.x, normal.y, normal.z, 0 };
+}
+
+void CollisionMesh::GetTriangle4(int _start, int _count, Triangle4* _triangle4) const
+{
+	Triangle triangles[4];
+	for (int i = 0; i < _count; i++)
+	{
+		GetTriangle(_start + i, &triangles[i]);
+	}
+	_triangle4->Set(triangles, _count);
+}
+
+size_t CollisionMesh::GetMemorySize() const
+{
+	return positions.size() * sizeof(XMFLOAT3) +
+		quantizedPositions.size() * sizeof(QUANTIZED_POSITION) +
+		indices.size() * sizeof(uint32_t) +
+		normals.size() * sizeof(XMFLOAT3);
+}
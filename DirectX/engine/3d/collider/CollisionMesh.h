@@ -0,0 +1,140 @@
+﻿#pragma once
+
+#include "CollisionPrimitive.h"
+
+#include <DirectXMath.h>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+/// <summary>
+/// 判定用の三角形メッシュ（頂点を共有し、インデックスで三角形を表す）
+/// </summary>
+class CollisionMesh
+{
+private: // サブクラス
+
+	// 量子化した頂点座標（メッシュのAABB内を16bitで表す）
+	struct QUANTIZED_POSITION
+	{
+		uint16_t x;
+		uint16_t y;
+		uint16_t z;
+	};
+
+	// 書き出し用のヘッダ
+	struct COOKED_HEADER
+	{
+		// 頂点座標の数
+		uint32_t positionNum;
+		// 量子化した頂点座標の数
+		uint32_t quantizedPositionNum;
+		// 三角形の数
+		uint32_t triangleNum;
+		// 量子化しているか
+		uint32_t isQuantized;
+		// 量子化の基準点
+		DirectX::XMFLOAT3 quantizeMin;
+		// 量子化した値1あたりの大きさ
+		DirectX::XMFLOAT3 quantizeScale;
+	};
+
+public:// メンバ関数
+
+	/// <summary>
+	/// 生成
+	/// </summary>
+	/// <param name="_positions">頂点座標</param>
+	/// <param name="_indices">インデックス（3つで三角形1つ）</param>
+	/// <param name="_isQuantize">頂点座標を16bitに量子化するか</param>
+	void Create(const std::vector<DirectX::XMFLOAT3>& _positions, const std::vector<uint32_t>& _indices, bool _isQuantize = false);
+
+	/// <summary>
+	/// 全て破棄
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// バイナリへ書き出す
+	/// </summary>
+	/// <param name="_fp">書き出し先</param>
+	/// <returns>成功か</returns>
+	bool Write(FILE* _fp) const;
+
+	/// <summary>
+	/// Writeで書き出したバイナリから読み込む
+	/// </summary>
+	/// <param name="_cursor">読み込み位置（読み込んだ分進める）</param>
+	/// <param name="_end">データの終端</param>
+	/// <returns>成功か</returns>
+	bool Read(const char*& _cursor, const char* _end);
+
+	/// <summary>
+	/// 三角形の並びを入れ替える
+	/// </summary>
+	/// <param name="_order">新しい並びでの元の三角形番号</param>
+	void ReorderTriangles(const std::vector<int>& _order);
+
+	/// <summary>
+	/// 頂点座標を取得
+	/// </summary>
+	/// <param name="_index">頂点番号</param>
+	/// <returns>頂点座標</returns>
+	DirectX::XMFLOAT3 GetPosition(uint32_t _index) const;
+
+	/// <summary>
+	/// 三角形を取得（Collisionの判定関数にそのまま渡せる形で復元する）
+	/// </summary>
+	/// <param name="_index">三角形番号</param>
+	/// <param name="_triangle">三角形（出力用）</param>
+	void GetTriangle(int _index, Triangle* _triangle) const;
+
+	/// <summary>
+	/// 連続する三角形をSoA形式で取得
+	/// </summary>
+	/// <param name="_start">先頭の三角形番号</param>
+	/// <param name="_count">三角形の数（最大4）</param>
+	/// <param name="_triangle4">三角形4つ（出力用）</param>
+	void GetTriangle4(int _start, int _count, Triangle4* _triangle4) const;
+
+	/// <summary>
+	/// 三角形の数を取得
+	/// </summary>
+	/// <returns>三角形の数</returns>
+	int GetTriangleNum() const { return static_cast<int>(normals.size()); }
+
+	/// <summary>
+	/// 頂点の数を取得
+	/// </summary>
+	/// <returns>頂点の数</returns>
+	int GetVertexNum() const { return static_cast<int>(isQuantized ? quantizedPositions.size() : positions.size()); }
+
+	/// <summary>
+	/// 頂点座標を量子化しているか
+	/// </summary>
+	/// <returns>量子化しているか</returns>
+	bool IsQuantized() const { return isQuantized; }
+
+	/// <summary>
+	/// 使用しているメモリ量を取得
+	/// </summary>
+	/// <returns>バイト数</returns>
+	size_t GetMemorySize() const;
+
+private:
+
+	//頂点座標
+	std::vector<DirectX::XMFLOAT3> positions;
+	//量子化した頂点座標
+	std::vector<QUANTIZED_POSITION> quantizedPositions;
+	//インデックス（3つで三角形1つ）
+	std::vector<uint32_t> indices;
+	//三角形ごとの法線
+	std::vector<DirectX::XMFLOAT3> normals;
+	//量子化の基準点（メッシュのAABB最小値）
+	DirectX::XMFLOAT3 quantizeMin = {};
+	//量子化した値1あたりの大きさ
+	DirectX::XMFLOAT3 quantizeScale = {};
+	//頂点座標を量子化しているか
+	bool isQuantized = false;
+};
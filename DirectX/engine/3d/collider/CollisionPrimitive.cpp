@@ -11,3 +11,61 @@ void Triangle::ComputeNormal()
 	normal = XMVector3Cross(p0_p1, p0_p2);
 	normal = XMVector3Normalize(normal);
 }
+
+void Triangle4::Set(const Triangle* _triangles, int _count)
+{
+	XMFLOAT4A p0[3] = {};
+	XMFLOAT4A e1[3] = {};
+	XMFLOAT4A e2[3] = {};
+
+	for (int i = 0; i < _count && i < 4; i++)
+	{
+		XMFLOAT3 pos0, edge1, edge2;
+		XMStoreFloat3(&pos0, _triangles[i].p0);
+		XMStoreFloat3(&edge1, _triangles[i].p1 - _triangles[i].p0);
+		XMStoreFloat3(&edge2, _triangles[i].p2 - _triangles[i].p0);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			(&p0[axis].x)[i] = (&pos0.x)[axis];
+			(&e1[axis].x)[i] = (&edge1.x)[axis];
+			(&e2[axis].x)[i] = (&edge2.x)[axis];
+		}
+	}
+
+	p0x = XMLoadFloat4A(&p0[0]); p0y = XMLoadFloat4A(&p0[1]); p0z = XMLoadFloat4A(&p0[2]);
+	e1x = XMLoadFloat4A(&e1[0]); e1y = XMLoadFloat4A(&e1[1]); e1z = XMLoadFloat4A(&e1[2]);
+	e2x = XMLoadFloat4A(&e2[0]); e2y = XMLoadFloat4A(&e2[1]); e2z = XMLoadFloat4A(&e2[2]);
+}
+
+void Ray4::Set(const Ray* _rays, int _count)
+{
+	XMFLOAT4A start[3] = {};
+	XMFLOAT4A dir[3] = {};
+
+	for (int i = 0; i < _count && i < 4; i++)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			(&start[axis].x)[i] = _rays[i].start.m128_f32[axis];
+			(&dir[axis].x)[i] = _rays[i].dir.m128_f32[axis];
+		}
+	}
+
+	startX = XMLoadFloat4A(&start[0]); startY = XMLoadFloat4A(&start[1]); startZ = XMLoadFloat4A(&start[2]);
+	dirX = XMLoadFloat4A(&dir[0]); dirY = XMLoadFloat4A(&dir[1]); dirZ = XMLoadFloat4A(&dir[2]);
+}
+
+void OBB::GetBounds(XMFLOAT3* _min, XMFLOAT3* _max) const
+{
+	// 各軸の大きさの半分を座標軸へ射影した和が、AABBの大きさの半分になる
+	XMFLOAT3 extent = {};
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			(&extent.x)[i] += fabsf(axis[j].m128_f32[i]) * (&halfSize.x)[j];
+		}
+	}
+	*_min = { center.m128_f32[0] - extent.x, center.m128_f32[1] - extent.y, center.m128_f32[2] - extent.z };
+	*_max = { center.m128_f32[0] + extent.x, center.m128_f32[1] + extent.y, center.m128_f32[2] + extent.z };
+}
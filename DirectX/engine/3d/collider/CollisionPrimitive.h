@@ -42,15 +42,32 @@ public:
 	// 法線ベクトル
 	DirectX::XMVECTOR	normal;
 
-	//八分木
-	std::vector<int> Octree;
-
 	/// <summary>
 	/// 法線の計算
 	/// </summary>
 	void ComputeNormal();
 };
 
+/// <summary>
+/// 三角形4つをまとめたSoA形式（SIMD判定用）
+/// </summary>
+struct Triangle4
+{
+	// 頂点p0の各成分（レーンごとに三角形が並ぶ）
+	DirectX::XMVECTOR p0x, p0y, p0z;
+	// 辺p0→p1の各成分
+	DirectX::XMVECTOR e1x, e1y, e1z;
+	// 辺p0→p2の各成分
+	DirectX::XMVECTOR e2x, e2y, e2z;
+
+	/// <summary>
+	/// 三角形をセット（4つに満たないレーンは当たらない縮退三角形で埋める）
+	/// </summary>
+	/// <param name="_triangles">三角形の配列</param>
+	/// <param name="_count">三角形の数（最大4）</param>
+	void Set(const Triangle* _triangles, int _count);
+};
+
 /// <summary>
 /// レイ（半直線）
 /// </summary>
@@ -62,6 +79,24 @@ struct Ray
 	DirectX::XMVECTOR dir = { 1,0,0,0 };
 };
 
+/// <summary>
+/// レイ4本をまとめたSoA形式（SIMD判定用）
+/// </summary>
+struct Ray4
+{
+	// 始点座標の各成分（レーンごとにレイが並ぶ）
+	DirectX::XMVECTOR startX, startY, startZ;
+	// 方向の各成分
+	DirectX::XMVECTOR dirX, dirY, dirZ;
+
+	/// <summary>
+	/// レイをセット（4本に満たないレーンは方向0の当たらないレイで埋める）
+	/// </summary>
+	/// <param name="_rays">レイの配列</param>
+	/// <param name="_count">レイの数（最大4）</param>
+	void Set(const Ray* _rays, int _count);
+};
+
 /// <summary>
 /// カプセル
 /// </summary>
@@ -73,4 +108,47 @@ struct Capsule
 	Vector3 endPosition = { 0,0,0 };
 	// 半径
 	float radius = 1.0f;
+};
+
+/// <summary>
+/// 有向ボックス
+/// </summary>
+struct OBB
+{
+	// 中心座標
+	DirectX::XMVECTOR center = {};
+	// ローカル軸（正規化済みで互いに直交）
+	DirectX::XMVECTOR axis[3] = { { 1,0,0,0 }, { 0,1,0,0 }, { 0,0,1,0 } };
+	// 各軸方向の大きさの半分
+	DirectX::XMFLOAT3 halfSize = { 0.5f,0.5f,0.5f };
+
+	/// <summary>
+	/// 囲むAABBを求める
+	/// </summary>
+	/// <param name="_min">AABB最小値（出力用）</param>
+	/// <param name="_max">AABB最大値（出力用）</param>
+	void GetBounds(DirectX::XMFLOAT3* _min, DirectX::XMFLOAT3* _max) const;
+};
+
+/// <summary>
+/// 軸平行ボックス
+/// </summary>
+struct AABB
+{
+	// 中心座標
+	DirectX::XMVECTOR center = {};
+	// 各軸方向の大きさの半分
+	DirectX::XMFLOAT3 halfSize = { 0.5f,0.5f,0.5f };
+
+	/// <summary>
+	/// 軸が座標軸と一致するOBBとして取得
+	/// </summary>
+	/// <returns>OBB</returns>
+	OBB ToOBB() const
+	{
+		OBB obb;
+		obb.center = center;
+		obb.halfSize = halfSize;
+		return obb;
+	}
 };
\ No newline at end of file
@@ -10,4 +10,10 @@ enum COLILSION_SHAPE_TYPE
 
 	COLLISIONSHAPE_SPHERE, // 球
 	COLLISIONSHAPE_MESH, // メッシュ
+	COLLISIONSHAPE_HEIGHTFIELD, // ハイトフィールド
+	COLLISIONSHAPE_CAPSULE, // カプセル
+	COLLISIONSHAPE_AABB, // 軸平行ボックス
+	COLLISIONSHAPE_OBB, // 有向ボックス
+
+	COLLISIONSHAPE_NUM, // 形状の数（判定関数表の大きさ）
 };
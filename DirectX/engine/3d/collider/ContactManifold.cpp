@@ -0,0 +1,72 @@
+﻿#include "ContactManifold.h"
+
+using namespace DirectX;
+
+void ContactManifold::AddContact(const CONTACT_POINT& _contact)
+{
+	// 同一平面上で隣り合う三角形などは、法線がほぼ同じなので深い方だけ残す
+	const float sameNormalDot = 0.999f;
+	for (int i = 0; i < contactNum; i++)
+	{
+		if (XMVector3Dot(contacts[i].normal, _contact.normal).m128_f32[0] < sameNormalDot) { continue; }
+
+		if (_contact.depth > contacts[i].depth) {
+			contacts[i] = _contact;
+		}
+		return;
+	}
+
+	if (contactNum < maxContactNum)
+	{
+		contacts[contactNum++] = _contact;
+		return;
+	}
+
+	// 満杯なら最も浅い接触点と入れ替える
+	int shallowest = 0;
+	for (int i = 1; i < contactNum; i++)
+	{
+		if (contacts[i].depth < contacts[shallowest].depth) {
+			shallowest = i;
+		}
+	}
+	if (_contact.depth > contacts[shallowest].depth) {
+		contacts[shallowest] = _contact;
+	}
+}
+
+void ContactManifold::AddContact(const CONTACT_POINT& _contact, const XMMATRIX& _matWorld)
+{
+	// 法線を変換した長さがその向きの拡大率なので、めり込み量にも掛ける
+	const XMVECTOR worldNormal = XMVector3TransformNormal(_contact.normal, _matWorld);
+	const float scale = XMVector3Length(worldNormal).m128_f32[0];
+	if (scale <= 0.0f) { return; }
+
+	CONTACT_POINT contact = _contact;
+	contact.point = XMVector3Transform(_contact.point, _matWorld);
+	contact.normal = worldNormal / scale;
+	contact.depth = _contact.depth * scale;
+	AddContact(contact);
+}
+
+XMVECTOR ContactManifold::ComputeReject() const
+{
+	// 法線同士が鋭角で交わる折り目では一度の足し込みで収まらないので、数回繰り返す
+	const int iterationNum = 4;
+	XMVECTOR reject = XMVectorZero();
+	for (int iteration = 0; iteration < iterationNum; iteration++)
+	{
+		bool isChanged = false;
+		for (int i = 0; i < contactNum; i++)
+		{
+			const float shortage = contacts[i].depth - XMVector3Dot(reject, contacts[i].normal).m128_f32[0];
+			if (shortage <= 0.0f) { continue; }
+
+			reject += contacts[i].normal * shortage;
+			isChanged = true;
+		}
+		if (!isChanged) { break; }
+	}
+
+	return reject;
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include <DirectXMath.h>
+
+class BaseCollider;
+
+/// <summary>
+/// 接触点1つ分の情報
+/// </summary>
+struct CONTACT_POINT
+{
+	// 接触相手のコライダー
+	BaseCollider* collider = nullptr;
+	// 接触点（相手の表面上の最近接点）
+	DirectX::XMVECTOR point;
+	// 接触面の法線（相手から離れる向き、正規化済み）
+	DirectX::XMVECTOR normal;
+	// めり込み量（法線方向にこれだけ動かせば離れる）
+	float depth = 0.0f;
+};
+
+/// <summary>
+/// 複数の接触点をまとめた接触多様体（容量固定で、一度の検索で重なる三角形を全て集める）
+/// </summary>
+class ContactManifold
+{
+public:// 定数
+	// 保持できる接触点の最大数
+	static const int maxContactNum = 8;
+
+public:// メンバ関数
+
+	/// <summary>
+	/// 接触点を全て破棄
+	/// </summary>
+	void Clear() { contactNum = 0; }
+
+	/// <summary>
+	/// 接触点を追加（法線がほぼ同じ接触点は深い方にまとめ、満杯なら最も浅い接触点と入れ替える）
+	/// </summary>
+	/// <param name="_contact">接触点</param>
+	void AddContact(const CONTACT_POINT& _contact);
+
+	/// <summary>
+	/// コライダーのローカル座標系で求めた接触点をワールド座標系へ変換して追加
+	/// </summary>
+	/// <param name="_contact">ローカル座標系の接触点</param>
+	/// <param name="_matWorld">コライダーのワールド行列</param>
+	void AddContact(const CONTACT_POINT& _contact, const DirectX::XMMATRIX& _matWorld);
+
+	/// <summary>
+	/// 全ての接触点から離れる排斥ベクトルを求める
+	/// （各法線方向への移動量がめり込み量以上になるよう、接触点ごとの不足分を繰り返し足し込む）
+	/// </summary>
+	/// <returns>排斥ベクトル</returns>
+	DirectX::XMVECTOR ComputeReject() const;
+
+	/// <summary>
+	/// 接触点の数を取得
+	/// </summary>
+	/// <returns>接触点の数</returns>
+	int GetContactNum() const { return contactNum; }
+
+	/// <summary>
+	/// 接触点を取得
+	/// </summary>
+	/// <param name="_index">接触点の番号</param>
+	/// <returns>接触点</returns>
+	const CONTACT_POINT& GetContact(int _index) const { return contacts[_index]; }
+
+	/// <summary>
+	/// 接触点が1つもないか
+	/// </summary>
+	/// <returns>接触点が1つもないか</returns>
+	bool IsEmpty() const { return contactNum == 0; }
+
+private:
+	//接触点
+	CONTACT_POINT contacts[maxContactNum];
+	//接触点の数
+	int contactNum = 0;
+};
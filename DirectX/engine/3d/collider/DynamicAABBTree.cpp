@@ -0,0 +1,279 @@
+﻿#include "DynamicAABBTree.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+const float DynamicAABBTree::fatMarginRate = 0.1f;
+const float DynamicAABBTree::fatMarginMin = 0.1f;
+
+/// <summary>
+/// AABBの表面積
+/// </summary>
+static float GetSurfaceArea(const XMFLOAT3& _min, const XMFLOAT3& _max)
+{
+	const float x = _max.x - _min.x;
+	const float y = _max.y - _min.y;
+	const float z = _max.z - _min.z;
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+/// <summary>
+/// 2つのAABBを囲むAABB
+/// </summary>
+static void Union(const XMFLOAT3& _minA, const XMFLOAT3& _maxA, const XMFLOAT3& _minB, const XMFLOAT3& _maxB,
+	XMFLOAT3* _min, XMFLOAT3* _max)
+{
+	*_min = { (std::min)(_minA.x, _minB.x), (std::min)(_minA.y, _minB.y), (std::min)(_minA.z, _minB.z) };
+	*_max = { (std::max)(_maxA.x, _maxB.x), (std::max)(_maxA.y, _maxB.y), (std::max)(_maxA.z, _maxB.z) };
+}
+
+int DynamicAABBTree::CreateProxy(const XMFLOAT3& _min, const XMFLOAT3& _max, BaseCollider* _collider)
+{
+	const int proxyId = AllocateNode();
+	NODE& node = nodes[proxyId];
+	node.collider = _collider;
+	node.height = 0;
+
+	MoveProxy(proxyId, _min, _max);
+	proxyNum++;
+	return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int _proxyId)
+{
+	assert(0 <= _proxyId && _proxyId < static_cast<int>(nodes.size()));
+	assert(nodes[_proxyId].IsLeaf());
+
+	RemoveLeaf(_proxyId);
+	FreeNode(_proxyId);
+	proxyNum--;
+}
+
+bool DynamicAABBTree::MoveProxy(int _proxyId, const XMFLOAT3& _min, const XMFLOAT3& _max)
+{
+	assert(0 <= _proxyId && _proxyId < static_cast<int>(nodes.size()));
+	assert(nodes[_proxyId].IsLeaf());
+
+	NODE& node = nodes[_proxyId];
+	const bool isInTree = node.parent != nullNode || root == _proxyId;
+
+	// 太いAABBに収まっていれば木はそのまま
+	if (isInTree &&
+		node.min.x <= _min.x && node.min.y <= _min.y && node.min.z <= _min.z &&
+		_max.x <= node.max.x && _max.y <= node.max.y && _max.z <= node.max.z)
+	{
+		return false;
+	}
+
+	if (isInTree) {
+		RemoveLeaf(_proxyId);
+	}
+
+	// 大きさに応じた余裕を持たせる
+	const XMFLOAT3 margin = {
+		(std::max)((_max.x - _min.x) * fatMarginRate, fatMarginMin),
+		(std::max)((_max.y - _min.y) * fatMarginRate, fatMarginMin),
+		(std::max)((_max.z - _min.z) * fatMarginRate, fatMarginMin) };
+	node.min = { _min.x - margin.x, _min.y - margin.y, _min.z - margin.z };
+	node.max = { _max.x + margin.x, _max.y + margin.y, _max.z + margin.z };
+
+	InsertLeaf(_proxyId);
+	return true;
+}
+
+int DynamicAABBTree::AllocateNode()
+{
+	// 未使用のノードが無ければ増やす
+	if (freeList == nullNode)
+	{
+		NODE node = {};
+		node.parent = nullNode;
+		node.height = -1;
+		nodes.push_back(node);
+		freeList = static_cast<int>(nodes.size()) - 1;
+	}
+
+	const int index = freeList;
+	NODE& node = nodes[index];
+	freeList = node.parent;
+	node.parent = nullNode;
+	node.child1 = nullNode;
+	node.child2 = nullNode;
+	node.collider = nullptr;
+	node.height = 0;
+	return index;
+}
+
+void DynamicAABBTree::FreeNode(int _index)
+{
+	NODE& node = nodes[_index];
+	node.parent = freeList;
+	node.collider = nullptr;
+	node.height = -1;
+	freeList = _index;
+}
+
+void DynamicAABBTree::InsertLeaf(int _leaf)
+{
+	if (root == nullNode)
+	{
+		root = _leaf;
+		nodes[root].parent = nullNode;
+		return;
+	}
+
+	// 兄弟にしたときの表面積の増加が最も小さいノードを探す
+	const XMFLOAT3 leafMin = nodes[_leaf].min;
+	const XMFLOAT3 leafMax = nodes[_leaf].max;
+	int index = root;
+	while (!nodes[index].IsLeaf())
+	{
+		const NODE& node = nodes[index];
+		XMFLOAT3 unionMin, unionMax;
+		Union(node.min, node.max, leafMin, leafMax, &unionMin, &unionMax);
+		const float area = GetSurfaceArea(node.min, node.max);
+		const float unionArea = GetSurfaceArea(unionMin, unionMax);
+
+		// このノードを兄弟にする場合
+		const float cost = 2.0f * unionArea;
+		// 子へ降りる場合に、このノード以下の祖先が負う増加分
+		const float inheritanceCost = 2.0f * (unionArea - area);
+
+		float childCosts[2];
+		const int children[2] = { node.child1, node.child2 };
+		for (int i = 0; i < 2; i++)
+		{
+			const NODE& child = nodes[children[i]];
+			Union(child.min, child.max, leafMin, leafMax, &unionMin, &unionMax);
+			childCosts[i] = GetSurfaceArea(unionMin, unionMax) + inheritanceCost;
+			if (!child.IsLeaf()) {
+				childCosts[i] -= GetSurfaceArea(child.min, child.max);
+			}
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1]) { break; }
+
+		index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+	}
+	const int sibling = index;
+
+	// 兄弟と葉をまとめる節を作る（確保で配列が伸びるので参照は後で取る）
+	const int newParent = AllocateNode();
+	const int oldParent = nodes[sibling].parent;
+	NODE& parentNode = nodes[newParent];
+	parentNode.parent = oldParent;
+	parentNode.child1 = sibling;
+	parentNode.child2 = _leaf;
+	parentNode.height = nodes[sibling].height + 1;
+	Union(nodes[sibling].min, nodes[sibling].max, leafMin, leafMax, &parentNode.min, &parentNode.max);
+	nodes[sibling].parent = newParent;
+	nodes[_leaf].parent = newParent;
+
+	if (oldParent == nullNode) {
+		root = newParent;
+	}
+	else if (nodes[oldParent].child1 == sibling) {
+		nodes[oldParent].child1 = newParent;
+	}
+	else {
+		nodes[oldParent].child2 = newParent;
+	}
+
+	FixUpwards(oldParent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int _leaf)
+{
+	if (_leaf == root)
+	{
+		root = nullNode;
+		return;
+	}
+
+	// 親の節を取り除き、兄弟を祖父へつなぐ
+	const int parent = nodes[_leaf].parent;
+	const int grandParent = nodes[parent].parent;
+	const int sibling = nodes[parent].child1 == _leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grandParent == nullNode) {
+		root = sibling;
+	}
+	else if (nodes[grandParent].child1 == parent) {
+		nodes[grandParent].child1 = sibling;
+	}
+	else {
+		nodes[grandParent].child2 = sibling;
+	}
+	nodes[sibling].parent = grandParent;
+	nodes[_leaf].parent = nullNode;
+	FreeNode(parent);
+
+	FixUpwards(grandParent);
+}
+
+void DynamicAABBTree::FixUpwards(int _index)
+{
+	int index = _index;
+	while (index != nullNode)
+	{
+		index = Balance(index);
+		UpdateNode(index);
+		index = nodes[index].parent;
+	}
+}
+
+int DynamicAABBTree::Balance(int _index)
+{
+	const int iA = _index;
+	if (nodes[iA].IsLeaf() || nodes[iA].height < 2) { return iA; }
+
+	const int iB = nodes[iA].child1;
+	const int iC = nodes[iA].child2;
+	const int balance = nodes[iC].height - nodes[iB].height;
+
+	// 子の高さの差が1以内なら回転しない
+	if (balance >= -1 && balance <= 1) { return iA; }
+
+	// 高い方の子(iUp)をAの位置へ上げ、その子のうち低い方をAへ渡す
+	const int iUp = balance > 0 ? iC : iB;
+	const int iKeep = balance > 0 ? iB : iC;
+	const int iF = nodes[iUp].child1;
+	const int iG = nodes[iUp].child2;
+
+	nodes[iUp].child1 = iA;
+	nodes[iUp].parent = nodes[iA].parent;
+	nodes[iA].parent = iUp;
+
+	const int upParent = nodes[iUp].parent;
+	if (upParent == nullNode) {
+		root = iUp;
+	}
+	else if (nodes[upParent].child1 == iA) {
+		nodes[upParent].child1 = iUp;
+	}
+	else {
+		nodes[upParent].child2 = iUp;
+	}
+
+	const int iHigh = nodes[iF].height > nodes[iG].height ? iF : iG;
+	const int iLow = iHigh == iF ? iG : iF;
+	nodes[iUp].child2 = iHigh;
+	nodes[iA].child1 = iKeep;
+	nodes[iA].child2 = iLow;
+	nodes[iLow].parent = iA;
+
+	UpdateNode(iA);
+	UpdateNode(iUp);
+	return iUp;
+}
+
+void DynamicAABBTree::UpdateNode(int _index)
+{
+	NODE& node = nodes[_index];
+	if (node.IsLeaf()) { return; }
+
+	const NODE& child1 = nodes[node.child1];
+	const NODE& child2 = nodes[node.child2];
+	node.height = 1 + (std::max)(child1.height, child2.height);
+	Union(child1.min, child1.max, child2.min, child2.max, &node.min, &node.max);
+}
@@ -0,0 +1,291 @@
+﻿#pragma once
+
+#include "Collision.h"
+
+#include <DirectXMath.h>
+#include <vector>
+#include <utility>
+#include <cassert>
+
+class BaseCollider;
+
+/// <summary>
+/// 動くコライダー用の動的AABB木
+/// （葉は余裕を持たせた「太い」AABBを持ち、はみ出した時だけ挿入し直す）
+/// </summary>
+class DynamicAABBTree
+{
+public: // 定数
+	// 無効なノード番号
+	static const int nullNode = -1;
+
+private: // サブクラス
+
+	// 木のノード
+	struct NODE
+	{
+		// AABB最小値（葉では太いAABB）
+		DirectX::XMFLOAT3 min;
+		// AABB最大値（葉では太いAABB）
+		DirectX::XMFLOAT3 max;
+		// 葉が持つコライダー
+		BaseCollider* collider;
+		// 親ノード（未使用のノードでは次の未使用ノード）
+		int parent;
+		// 子ノード（葉ではnullNode）
+		int child1;
+		int child2;
+		// 葉からの高さ（葉は0、未使用は-1）
+		int height;
+
+		bool IsLeaf() const { return child1 == nullNode; }
+	};
+
+public: // メンバ関数
+
+	/// <summary>
+	/// 葉を追加
+	/// </summary>
+	/// <param name="_min">AABB最小値</param>
+	/// <param name="_max">AABB最大値</param>
+	/// <param name="_collider">コライダー</param>
+	/// <returns>葉の番号</returns>
+	int CreateProxy(const DirectX::XMFLOAT3& _min, const DirectX::XMFLOAT3& _max, BaseCollider* _collider);
+
+	/// <summary>
+	/// 葉を削除
+	/// </summary>
+	/// <param name="_proxyId">葉の番号</param>
+	void DestroyProxy(int _proxyId);
+
+	/// <summary>
+	/// 葉のAABBを更新（太いAABBからはみ出した場合のみ挿入し直す）
+	/// </summary>
+	/// <param name="_proxyId">葉の番号</param>
+	/// <param name="_min">AABB最小値</param>
+	/// <param name="_max">AABB最大値</param>
+	/// <returns>挿入し直したか</returns>
+	bool MoveProxy(int _proxyId, const DirectX::XMFLOAT3& _min, const DirectX::XMFLOAT3& _max);
+
+	/// <summary>
+	/// 葉のコライダーを取得
+	/// </summary>
+	/// <param name="_proxyId">葉の番号</param>
+	/// <returns>コライダー</returns>
+	BaseCollider* GetCollider(int _proxyId) const { return nodes[_proxyId].collider; }
+
+	/// <summary>
+	/// 木の高さを取得
+	/// </summary>
+	/// <returns>高さ（空なら0）</returns>
+	int GetHeight() const { return root == nullNode ? 0 : nodes[root].height; }
+
+	/// <summary>
+	/// 葉の数を取得
+	/// </summary>
+	/// <returns>葉の数</returns>
+	int GetProxyNum() const { return proxyNum; }
+
+	/// <summary>
+	/// AABBと太いAABBが重なる葉を辿る（_functionがfalseを返したら打ち切る）
+	/// </summary>
+	/// <param name="_min">AABB最小値</param>
+	/// <param name="_max">AABB最大値</param>
+	/// <param name="_function">葉ごとの処理（引数は葉の番号）</param>
+	template <typename Function>
+	void Query(const DirectX::XMFLOAT3& _min, const DirectX::XMFLOAT3& _max, Function _function) const
+	{
+		if (root == nullNode) { return; }
+
+		int stack[queryStackSize];
+		int stackSize = 0;
+		stack[stackSize++] = root;
+		while (stackSize > 0)
+		{
+			const int index = stack[--stackSize];
+			const NODE& node = nodes[index];
+			if (!CheckAABB2AABB(_min, _max, node.min, node.max)) { continue; }
+
+			if (node.IsLeaf())
+			{
+				if (!_function(index)) { return; }
+				continue;
+			}
+
+			assert(stackSize + 2 <= queryStackSize);
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+		}
+	}
+
+	/// <summary>
+	/// 2つの木を同時に辿り、太いAABBが重なる葉の組を1度ずつ列挙する（_otherに自身を渡すと木の中の組を列挙する）
+	/// </summary>
+	/// <param name="_other">相手の木</param>
+	/// <param name="_function">組ごとの処理（引数は自身の葉の番号、相手の葉の番号）</param>
+	template <typename Function>
+	void QueryOverlaps(const DynamicAABBTree& _other, Function _function) const
+	{
+		if (root == nullNode || _other.root == nullNode) { return; }
+
+		const bool isSelf = this == &_other;
+
+		// 辿る節の組（自身同士の組は、その節の中の組を表す）
+		std::vector<std::pair<int, int>>& stack = overlapStack;
+		stack.clear();
+		stack.push_back({ root, _other.root });
+		while (!stack.empty())
+		{
+			const std::pair<int, int> pair = stack.back();
+			stack.pop_back();
+			const NODE& nodeA = nodes[pair.first];
+			const NODE& nodeB = _other.nodes[pair.second];
+
+			// 同じ木の同じ節なら、子同士とそれぞれの子の中を調べる
+			if (isSelf && pair.first == pair.second)
+			{
+				if (nodeA.IsLeaf()) { continue; }
+				stack.push_back({ nodeA.child1, nodeA.child1 });
+				stack.push_back({ nodeA.child2, nodeA.child2 });
+				stack.push_back({ nodeA.child1, nodeA.child2 });
+				continue;
+			}
+
+			if (!CheckAABB2AABB(nodeA.min, nodeA.max, nodeB.min, nodeB.max)) { continue; }
+
+			if (nodeA.IsLeaf() && nodeB.IsLeaf())
+			{
+				_function(pair.first, pair.second);
+				continue;
+			}
+
+			// 葉でない方のうち、大きい方を分ける
+			const bool isSplitA = nodeB.IsLeaf() ||
+				(!nodeA.IsLeaf() && nodeA.height >= nodeB.height);
+			if (isSplitA)
+			{
+				stack.push_back({ nodeA.child2, pair.second });
+				stack.push_back({ nodeA.child1, pair.second });
+			}
+			else
+			{
+				stack.push_back({ pair.first, nodeB.child2 });
+				stack.push_back({ pair.first, nodeB.child1 });
+			}
+		}
+	}
+
+	/// <summary>
+	/// レイ（_radiusだけ太らせた移動する球の中心の軌跡）が太いAABBに当たる葉を辿る
+	/// （_maxDistanceは_functionの中で縮めてよく、以降の枝刈りに使われる。_functionがfalseを返したら打ち切る）
+	/// </summary>
+	/// <param name="_start">レイの始点</param>
+	/// <param name="_invDir">レイの方向の逆数</param>
+	/// <param name="_radius">AABBを太らせる量</param>
+	/// <param name="_maxDistance">最大距離（方向ベクトルの長さ単位）</param>
+	/// <param name="_function">葉ごとの処理（引数は葉の番号）</param>
+	template <typename Function>
+	void Raycast(const DirectX::XMFLOAT3& _start, const DirectX::XMFLOAT3& _invDir, float _radius,
+		const float& _maxDistance, Function _function) const
+	{
+		if (root == nullNode) { return; }
+
+		int stack[queryStackSize];
+		int stackSize = 0;
+		stack[stackSize++] = root;
+		while (stackSize > 0)
+		{
+			const int index = stack[--stackSize];
+			const NODE& node = nodes[index];
+			const DirectX::XMFLOAT3 nodeMin = { node.min.x - _radius, node.min.y - _radius, node.min.z - _radius };
+			const DirectX::XMFLOAT3 nodeMax = { node.max.x + _radius, node.max.y + _radius, node.max.z + _radius };
+			if (!Collision::CheckRay2AABB(_start, _invDir, nodeMin, nodeMax, _maxDistance)) { continue; }
+
+			if (node.IsLeaf())
+			{
+				if (!_function(index)) { return; }
+				continue;
+			}
+
+			assert(stackSize + 2 <= queryStackSize);
+			stack[stackSize++] = node.child1;
+			stack[stackSize++] = node.child2;
+		}
+	}
+
+private: // メンバ関数
+
+	/// <summary>
+	/// ノードを確保
+	/// </summary>
+	/// <returns>ノード番号</returns>
+	int AllocateNode();
+
+	/// <summary>
+	/// ノードを解放
+	/// </summary>
+	/// <param name="_index">ノード番号</param>
+	void FreeNode(int _index);
+
+	/// <summary>
+	/// 葉を木に挿入（表面積が最も増えない位置を探す）
+	/// </summary>
+	/// <param name="_leaf">葉の番号</param>
+	void InsertLeaf(int _leaf);
+
+	/// <summary>
+	/// 葉を木から外す
+	/// </summary>
+	/// <param name="_leaf">葉の番号</param>
+	void RemoveLeaf(int _leaf);
+
+	/// <summary>
+	/// 親を辿りながら回転で高さの偏りを直し、AABBと高さを更新する
+	/// </summary>
+	/// <param name="_index">開始ノード番号</param>
+	void FixUpwards(int _index);
+
+	/// <summary>
+	/// 子の高さの差が2以上なら回転して釣り合わせる
+	/// </summary>
+	/// <param name="_index">ノード番号</param>
+	/// <returns>回転後にその位置にあるノード番号</returns>
+	int Balance(int _index);
+
+	/// <summary>
+	/// 子のAABBと高さから節を更新
+	/// </summary>
+	/// <param name="_index">ノード番号</param>
+	void UpdateNode(int _index);
+
+	/// <summary>
+	/// AABBとAABBの当たり判定
+	/// </summary>
+	static bool CheckAABB2AABB(const DirectX::XMFLOAT3& _minA, const DirectX::XMFLOAT3& _maxA,
+		const DirectX::XMFLOAT3& _minB, const DirectX::XMFLOAT3& _maxB)
+	{
+		return _minA.x <= _maxB.x && _minB.x <= _maxA.x &&
+			_minA.y <= _maxB.y && _minB.y <= _maxA.y &&
+			_minA.z <= _maxB.z && _minB.z <= _maxA.z;
+	}
+
+private: // メンバ変数
+
+	// ノード
+	std::vector<NODE> nodes;
+	// 根ノード
+	int root = nullNode;
+	// 未使用ノードの先頭
+	int freeList = nullNode;
+	// 葉の数
+	int proxyNum = 0;
+	// QueryOverlapsで辿る節の組（確保を使い回す）
+	mutable std::vector<std::pair<int, int>> overlapStack;
+
+	// 太いAABBの余裕（大きさに対する割合）
+	static const float fatMarginRate;
+	// 太いAABBの余裕の最小値
+	static const float fatMarginMin;
+	// 探索用スタックの大きさ（高さは釣り合わせているので十分）
+	static const int queryStackSize = 256;
+};
@@ -0,0 +1,584 @@
+﻿#include "HeightfieldCollider.h"
+#include "Collision.h"
+#include "HeightMap.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+void HeightfieldCollider::ConstructHeightfield(HeightMap* _heightMap)
+{
+	const int terrainWidth = _heightMap->GetTerrainWidth();
+	const int terrainHeight = _heightMap->GetTerrainHeight();
+	const std::vector<XMFLOAT3>& positions = _heightMap->GetHeightMapPositions();
+
+	// ハイトマップと同じ並び（terrainHeight * j + i）から高さのみを取り出す
+	std::vector<float> sampleHeights(positions.size());
+	for (int j = 0; j < terrainHeight; j++)
+	{
+		for (int i = 0; i < terrainWidth; i++)
+		{
+			sampleHeights[j * terrainWidth + i] = positions[terrainHeight * j + i].y;
+		}
+	}
+
+	ConstructHeightfield(sampleHeights, terrainWidth, terrainHeight);
+}
+
+void HeightfieldCollider::ConstructHeightfield(const std::vector<float>& _heights, int _width, int _depth)
+{
+	assert(_width >= 2 && _depth >= 2);
+	assert(static_cast<int>(_heights.size()) >= _width * _depth);
+
+	width = _width;
+	depth = _depth;
+	heights.assign(_heights.begin(), _heights.begin() + _width * _depth);
+
+	minHeight = *std::min_element(heights.begin(), heights.end());
+	maxHeight = *std::max_element(heights.begin(), heights.end());
+
+	//形状が変わったので接触キャッシュを使わせない
+	isMoved = true;
+}
+
+void HeightfieldCollider::Update()
+{
+	matWorld = GetObject3d()->GetMatWorld();
+	invMatWorld = XMMatrixInverse(nullptr, matWorld);
+
+	// ローカルAABBの8頂点をワールド変換し、ブロードフェーズ用のAABBを更新
+	const XMFLOAT3 localMin = { 0.0f, minHeight, 0.0f };
+	const XMFLOAT3 localMax = { static_cast<float>(width - 1), maxHeight, static_cast<float>(depth - 1) };
+	XMVECTOR worldMin = XMVectorReplicate(D3D12_FLOAT32_MAX);
+	XMVECTOR worldMax = XMVectorReplicate(-D3D12_FLOAT32_MAX);
+	for (int i = 0; i < 8; i++)
+	{
+		XMVECTOR corner = {
+			(i & 1) ? localMax.x : localMin.x,
+			(i & 2) ? localMax.y : localMin.y,
+			(i & 4) ? localMax.z : localMin.z,
+			1 };
+		corner = XMVector3Transform(corner, matWorld);
+		worldMin = XMVectorMin(worldMin, corner);
+		worldMax = XMVectorMax(worldMax, corner);
+	}
+	XMStoreFloat3(&aabbMin, worldMin);
+	XMStoreFloat3(&aabbMax, worldMax);
+	UpdateProxy();
+}
+
+void HeightfieldCollider::Draw()
+{
+}
+
+bool HeightfieldCollider::GetHeightAt(float _x, float _z, float* _height)
+{
+	if (heights.empty()) { return false; }
+
+	// ローカル座標での位置を得る
+	XMVECTOR localPos = XMVector3Transform({ _x, 0.0f, _z, 1.0f }, invMatWorld);
+	const float x = localPos.m128_f32[0];
+	const float z = localPos.m128_f32[2];
+	if (x < 0.0f || z < 0.0f || x > width - 1 || z > depth - 1) { return false; }
+
+	// 所属するセルと、セル内での位置
+	const int cellX = (std::min)(static_cast<int>(x), width - 2);
+	const int cellZ = (std::min)(static_cast<int>(z), depth - 2);
+	const float fx = x - cellX;
+	const float fz = z - cellZ;
+
+	// 当たり判定と同じく対角線p01-p10で分けた三角形の平面上で補間する
+	const float h00 = GetSample(cellX, cellZ);
+	const float h10 = GetSample(cellX + 1, cellZ);
+	const float h01 = GetSample(cellX, cellZ + 1);
+	const float h11 = GetSample(cellX + 1, cellZ + 1);
+	const float localHeight = fx + fz <= 1.0f ?
+		h00 + (h10 - h00) * fx + (h01 - h00) * fz :
+		h11 + (h01 - h11) * (1.0f - fx) + (h10 - h11) * (1.0f - fz);
+
+	if (_height) {
+		*_height = XMVector3Transform({ x, localHeight, z, 1.0f }, matWorld).m128_f32[1];
+	}
+
+	return true;
+}
+
+void HeightfieldCollider::GetCellTriangles(int _x, int _z, Triangle* _triangles) const
+{
+	const float x0 = static_cast<float>(_x);
+	const float x1 = static_cast<float>(_x + 1);
+	const float z0 = static_cast<float>(_z);
+	const float z1 = static_cast<float>(_z + 1);
+
+	const XMVECTOR p00 = { x0, GetSample(_x, _z), z0, 1 };
+	const XMVECTOR p10 = { x1, GetSample(_x + 1, _z), z0, 1 };
+	const XMVECTOR p01 = { x0, GetSample(_x, _z + 1), z1, 1 };
+	const XMVECTOR p11 = { x1, GetSample(_x + 1, _z + 1), z1, 1 };
+
+	// 対角線p01-p10で分割する
+	_triangles[0].p0 = p00;
+	_triangles[0].p1 = p01;
+	_triangles[0].p2 = p10;
+	_triangles[0].ComputeNormal();
+
+	_triangles[1].p0 = p10;
+	_triangles[1].p1 = p01;
+	_triangles[1].p2 = p11;
+	_triangles[1].ComputeNormal();
+}
+
+void HeightfieldCollider::GetCellHeightRange(int _x, int _z, float* _minHeight, float* _maxHeight) const
+{
+	const float h00 = GetSample(_x, _z);
+	const float h10 = GetSample(_x + 1, _z);
+	const float h01 = GetSample(_x, _z + 1);
+	const float h11 = GetSample(_x + 1, _z + 1);
+	*_minHeight = (std::min)((std::min)(h00, h10), (std::min)(h01, h11));
+	*_maxHeight = (std::max)((std::max)(h00, h10), (std::max)(h01, h11));
+}
+
+bool HeightfieldCollider::GetCellRange(const XMFLOAT3& _min, const XMFLOAT3& _max, XMINT2* _cellMin, XMINT2* _cellMax) const
+{
+	// 高さ方向で重ならなければセルを調べるまでもない
+	if (_max.y < minHeight || _min.y > maxHeight) { return false; }
+	if (_max.x < 0.0f || _max.z < 0.0f || _min.x > width - 1 || _min.z > depth - 1) { return false; }
+
+	_cellMin->x = (std::max)(static_cast<int>(floorf(_min.x)), 0);
+	_cellMin->y = (std::max)(static_cast<int>(floorf(_min.z)), 0);
+	_cellMax->x = (std::min)(static_cast<int>(floorf(_max.x)), width - 2);
+	_cellMax->y = (std::min)(static_cast<int>(floorf(_max.z)), depth - 2);
+
+	return true;
+}
+
+bool HeightfieldCollider::CheckCollisionSphere(const Sphere& _sphere, DirectX::XMVECTOR* _inter, DirectX::XMVECTOR* _reject)
+{
+	if (heights.empty()) { return false; }
+
+	// オブジェクトのローカル座標系での球を得る（半径はXスケールを参照)
+	Sphere localSphere;
+	localSphere.center = XMVector3Transform(_sphere.center, invMatWorld);
+	localSphere.radius = _sphere.radius * XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+
+	const XMFLOAT3 sphereMin = {
+		localSphere.center.m128_f32[0] - localSphere.radius,
+		localSphere.center.m128_f32[1] - localSphere.radius,
+		localSphere.center.m128_f32[2] - localSphere.radius };
+	const XMFLOAT3 sphereMax = {
+		localSphere.center.m128_f32[0] + localSphere.radius,
+		localSphere.center.m128_f32[1] + localSphere.radius,
+		localSphere.center.m128_f32[2] + localSphere.radius };
+
+	XMINT2 cellMin, cellMax;
+	if (!GetCellRange(sphereMin, sphereMax, &cellMin, &cellMax)) { return false; }
+
+	// 球と重なるセルの三角形のみ判定する
+	Triangle cellTriangles[2];
+	for (int z = cellMin.y; z <= cellMax.y; z++)
+	{
+		for (int x = cellMin.x; x <= cellMax.x; x++)
+		{
+			GetCellTriangles(x, z, cellTriangles);
+			for (const Triangle& triangle : cellTriangles)
+			{
+				if (!Collision::CheckSphere2Triangle(localSphere, triangle, _inter, _reject)) { continue; }
+
+				if (_inter) {
+					*_inter = XMVector3Transform(*_inter, matWorld);
+				}
+				if (_reject) {
+					*_reject = XMVector3TransformNormal(*_reject, matWorld);
+				}
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool HeightfieldCollider::CheckCollisionSphereContacts(const Sphere& _sphere, ContactManifold* _manifold)
+{
+	assert(_manifold);
+	if (heights.empty()) { return false; }
+
+	// オブジェクトのローカル座標系での球を得る（半径はXスケールを参照)
+	Sphere localSphere;
+	localSphere.center = XMVector3Transform(_sphere.center, invMatWorld);
+	localSphere.radius = _sphere.radius * XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+
+	const XMFLOAT3 sphereMin = {
+		localSphere.center.m128_f32[0] - localSphere.radius,
+		localSphere.center.m128_f32[1] - localSphere.radius,
+		localSphere.center.m128_f32[2] - localSphere.radius };
+	const XMFLOAT3 sphereMax = {
+		localSphere.center.m128_f32[0] + localSphere.radius,
+		localSphere.center.m128_f32[1] + localSphere.radius,
+		localSphere.center.m128_f32[2] + localSphere.radius };
+
+	XMINT2 cellMin, cellMax;
+	if (!GetCellRange(sphereMin, sphereMax, &cellMin, &cellMax)) { return false; }
+
+	// 球と重なるセルの三角形を全て接触点にする
+	bool isHit = false;
+	Triangle cellTriangles[2];
+	for (int z = cellMin.y; z <= cellMax.y; z++)
+	{
+		for (int x = cellMin.x; x <= cellMax.x; x++)
+		{
+			GetCellTriangles(x, z, cellTriangles);
+			for (const Triangle& triangle : cellTriangles)
+			{
+				CONTACT_POINT contact;
+				if (!Collision::CheckSphere2Triangle(localSphere, triangle, &contact)) { continue; }
+
+				contact.collider = this;
+				_manifold->AddContact(contact, matWorld);
+				isHit = true;
+			}
+		}
+	}
+
+	return isHit;
+}
+
+bool HeightfieldCollider::CheckCollisionRay(const Ray& _ray, float* _distance, DirectX::XMVECTOR* _inter)
+{
+	if (heights.empty()) { return false; }
+
+	// オブジェクトのローカル座標系でのレイを得る（レイの媒介変数はワールド・ローカルで共通）
+	Ray localRay;
+	localRay.start = XMVector3Transform(_ray.start, invMatWorld);
+	localRay.dir = XMVector3TransformNormal(_ray.dir, invMatWorld);
+
+	XMFLOAT3 start, dir;
+	XMStoreFloat3(&start, localRay.start);
+	XMStoreFloat3(&dir, localRay.dir);
+	const XMFLOAT3 invDir = Collision::ComputeInvDir(localRay.dir);
+
+	// 格子全体のAABBでレイを切り取る
+	const XMFLOAT3 fieldMin = { 0.0f, minHeight, 0.0f };
+	const XMFLOAT3 fieldMax = { static_cast<float>(width - 1), maxHeight, static_cast<float>(depth - 1) };
+	float tEnter = 0.0f;
+	float tExit = D3D12_FLOAT32_MAX;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float t1 = ((&fieldMin.x)[axis] - (&start.x)[axis]) * (&invDir.x)[axis];
+		float t2 = ((&fieldMax.x)[axis] - (&start.x)[axis]) * (&invDir.x)[axis];
+		tEnter = (std::max)(tEnter, (std::min)(t1, t2));
+		tExit = (std::min)(tExit, (std::max)(t1, t2));
+	}
+	if (tEnter > tExit) { return false; }
+
+	// 進入位置のセル
+	int cellX = static_cast<int>(floorf(start.x + dir.x * tEnter));
+	int cellZ = static_cast<int>(floorf(start.z + dir.z * tEnter));
+	cellX = (std::max)((std::min)(cellX, width - 2), 0);
+	cellZ = (std::max)((std::min)(cellZ, depth - 2), 0);
+
+	// 隣のセル境界までの距離と、1セル進むのにかかる距離
+	const int stepX = dir.x >= 0.0f ? 1 : -1;
+	const int stepZ = dir.z >= 0.0f ? 1 : -1;
+	const float deltaX = fabsf(invDir.x);
+	const float deltaZ = fabsf(invDir.z);
+	float nextX = fabsf(dir.x) > 1.0e-8f ? ((cellX + (stepX > 0 ? 1 : 0)) - start.x) * invDir.x : D3D12_FLOAT32_MAX;
+	float nextZ = fabsf(dir.z) > 1.0e-8f ? ((cellZ + (stepZ > 0 ? 1 : 0)) - start.z) * invDir.z : D3D12_FLOAT32_MAX;
+
+	// レイが通るセルを近い順に辿り、最初に当たったセルで終了する
+	//（平らなセルにちょうど届くレイが丸め誤差で高さ範囲から外れないよう、範囲を少し広げて比べる）
+	const float heightEpsilon = 1.0e-3f;
+	float t = tEnter;
+	Triangle cellTriangles[2];
+	while (t <= tExit && cellX >= 0 && cellX < width - 1 && cellZ >= 0 && cellZ < depth - 1)
+	{
+		const float tCellExit = (std::min)((std::min)(nextX, nextZ), tExit);
+
+		// セル内でのレイの高さ範囲とセルの高さ範囲が重なる場合のみ三角形を判定
+		const float y0 = start.y + dir.y * t;
+		const float y1 = start.y + dir.y * tCellExit;
+		float cellMinHeight, cellMaxHeight;
+		GetCellHeightRange(cellX, cellZ, &cellMinHeight, &cellMaxHeight);
+		if ((std::max)(y0, y1) >= cellMinHeight - heightEpsilon && (std::min)(y0, y1) <= cellMaxHeight + heightEpsilon)
+		{
+			// セルの角を原点にして判定する（格子の端では座標が大きく、丸め誤差が辺の許容誤差を超えて
+			// 隣り合う三角形の境目をすり抜けるため。平行移動なので距離はそのまま使える）
+			const XMVECTOR cellOrigin = { static_cast<float>(cellX), 0.0f, static_cast<float>(cellZ), 0.0f };
+			Ray cellRay;
+			cellRay.start = localRay.start - cellOrigin;
+			cellRay.dir = localRay.dir;
+
+			bool isHit = false;
+			float closestDistance = D3D12_FLOAT32_MAX;
+			GetCellTriangles(cellX, cellZ, cellTriangles);
+			for (Triangle& triangle : cellTriangles)
+			{
+				triangle.p0 -= cellOrigin;
+				triangle.p1 -= cellOrigin;
+				triangle.p2 -= cellOrigin;
+
+				float tempDistance;
+				if (!Collision::CheckRay2Triangle(cellRay, triangle, &tempDistance)) { continue; }
+				if (tempDistance >= closestDistance) { continue; }
+
+				isHit = true;
+				closestDistance = tempDistance;
+			}
+
+			if (isHit)
+			{
+				XMVECTOR closestInter = localRay.start + closestDistance * localRay.dir;
+				XMVECTOR worldInter = XMVector3Transform(closestInter, matWorld);
+
+				if (_distance) {
+					XMVECTOR sub = worldInter - _ray.start;
+					*_distance = XMVector3Dot(sub, _ray.dir).m128_f32[0];
+				}
+
+				if (_inter) {
+					*_inter = worldInter;
+				}
+
+				return true;
+			}
+		}
+
+		// 次のセルへ
+		if (nextX < nextZ)
+		{
+			t = nextX;
+			nextX += deltaX;
+			cellX += stepX;
+		}
+		else
+		{
+			t = nextZ;
+			nextZ += deltaZ;
+			cellZ += stepZ;
+		}
+	}
+
+	return false;
+}
+
+bool HeightfieldCollider::CheckCollisionCapsule(const Capsule& _capsule, DirectX::XMVECTOR* _inter)
+{
+	if (heights.empty()) { return false; }
+
+	// オブジェクトのローカル座標系でのカプセルを得る（半径はXスケールを参照)
+	Capsule localCapsule;
+	localCapsule.startPosition = _capsule.startPosition.DirectXVector3Transform(invMatWorld);
+	localCapsule.endPosition = _capsule.endPosition.DirectXVector3Transform(invMatWorld);
+	localCapsule.radius = _capsule.radius * XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+
+	//カプセルを囲むAABB
+	const XMFLOAT3 capsuleMin = {
+		(std::min)(localCapsule.startPosition.x, localCapsule.endPosition.x) - localCapsule.radius,
+		(std::min)(localCapsule.startPosition.y, localCapsule.endPosition.y) - localCapsule.radius,
+		(std::min)(localCapsule.startPosition.z, localCapsule.endPosition.z) - localCapsule.radius };
+	const XMFLOAT3 capsuleMax = {
+		(std::max)(localCapsule.startPosition.x, localCapsule.endPosition.x) + localCapsule.radius,
+		(std::max)(localCapsule.startPosition.y, localCapsule.endPosition.y) + localCapsule.radius,
+		(std::max)(localCapsule.startPosition.z, localCapsule.endPosition.z) + localCapsule.radius };
+
+	XMINT2 cellMin, cellMax;
+	if (!GetCellRange(capsuleMin, capsuleMax, &cellMin, &cellMax)) { return false; }
+
+	// カプセルと重なるセルの三角形のみ判定する
+	Triangle cellTriangles[2];
+	for (int z = cellMin.y; z <= cellMax.y; z++)
+	{
+		for (int x = cellMin.x; x <= cellMax.x; x++)
+		{
+			GetCellTriangles(x, z, cellTriangles);
+			for (const Triangle& triangle : cellTriangles)
+			{
+				XMVECTOR tempInter;
+				if (Collision::CheckCapsule2Triangle(localCapsule, triangle, &tempInter)) {
+					if (_inter) {
+						*_inter = XMVector3Transform(tempInter, matWorld);
+					}
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+bool HeightfieldCollider::CheckCollisionOBB(const OBB& _obb, DirectX::XMVECTOR* _inter)
+{
+	if (heights.empty()) { return false; }
+
+	// オブジェクトのローカル座標系でのOBBを得る（大きさはXスケールを参照)
+	const float scale = XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+	OBB localOBB;
+	localOBB.center = XMVector3Transform(_obb.center, invMatWorld);
+	for (int i = 0; i < 3; i++)
+	{
+		localOBB.axis[i] = XMVector3Normalize(XMVector3TransformNormal(_obb.axis[i], invMatWorld));
+		(&localOBB.halfSize.x)[i] = (&_obb.halfSize.x)[i] * scale;
+	}
+
+	//OBBを囲むAABB
+	XMFLOAT3 obbMin, obbMax;
+	localOBB.GetBounds(&obbMin, &obbMax);
+
+	XMINT2 cellMin, cellMax;
+	if (!GetCellRange(obbMin, obbMax, &cellMin, &cellMax)) { return false; }
+
+	// OBBと重なるセルの三角形のみ判定する
+	Triangle cellTriangles[2];
+	for (int z = cellMin.y; z <= cellMax.y; z++)
+	{
+		for (int x = cellMin.x; x <= cellMax.x; x++)
+		{
+			GetCellTriangles(x, z, cellTriangles);
+			for (const Triangle& triangle : cellTriangles)
+			{
+				XMVECTOR tempInter;
+				if (Collision::CheckOBB2Triangle(localOBB, triangle, &tempInter)) {
+					if (_inter) {
+						*_inter = XMVector3Transform(tempInter, matWorld);
+					}
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+bool HeightfieldCollider::SweepSphere(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement,
+	float* _time, DirectX::XMVECTOR* _inter, DirectX::XMVECTOR* _normal)
+{
+	if (heights.empty()) { return false; }
+
+	// オブジェクトのローカル座標系での球と移動量を得る（半径はXスケールを参照)
+	Sphere localSphere;
+	localSphere.center = XMVector3Transform(_sphere.center, invMatWorld);
+	localSphere.radius = _sphere.radius * XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+	const XMVECTOR localDisplacement = XMVector3TransformNormal(_displacement, invMatWorld);
+	const float radius = localSphere.radius;
+
+	XMFLOAT3 start, move;
+	XMStoreFloat3(&start, localSphere.center);
+	XMStoreFloat3(&move, localDisplacement);
+	const XMFLOAT3 invMove = Collision::ComputeInvDir(localDisplacement);
+
+	// 半径分広げた格子全体のAABBで、中心の軌跡（時間0～1）を切り取る
+	const XMFLOAT3 fieldMin = { -radius, minHeight - radius, -radius };
+	const XMFLOAT3 fieldMax = { width - 1 + radius, maxHeight + radius, depth - 1 + radius };
+	float tEnter = 0.0f;
+	float tExit = 1.0f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float t1 = ((&fieldMin.x)[axis] - (&start.x)[axis]) * (&invMove.x)[axis];
+		float t2 = ((&fieldMax.x)[axis] - (&start.x)[axis]) * (&invMove.x)[axis];
+		tEnter = (std::max)(tEnter, (std::min)(t1, t2));
+		tExit = (std::min)(tExit, (std::max)(t1, t2));
+	}
+	if (tEnter > tExit) { return false; }
+
+	// 中心が通るセル（格子の外も含む）の境界をレイと同じ方法で辿る
+	const int cellX = static_cast<int>(floorf(start.x + move.x * tEnter));
+	const int cellZ = static_cast<int>(floorf(start.z + move.z * tEnter));
+	const int stepX = move.x >= 0.0f ? 1 : -1;
+	const int stepZ = move.z >= 0.0f ? 1 : -1;
+	const float deltaX = fabsf(invMove.x);
+	const float deltaZ = fabsf(invMove.z);
+	float nextX = fabsf(move.x) > 1.0e-8f ? ((cellX + (stepX > 0 ? 1 : 0)) - start.x) * invMove.x : D3D12_FLOAT32_MAX;
+	float nextZ = fabsf(move.z) > 1.0e-8f ? ((cellZ + (stepZ > 0 ? 1 : 0)) - start.z) * invMove.z : D3D12_FLOAT32_MAX;
+
+	float hitTime = 1.0f;
+	XMVECTOR hitInter = {};
+	XMVECTOR hitNormal = {};
+	bool isHit = false;
+
+	// 中心がセルを通る区間ごとに、その区間を半径分広げた範囲のセルを判定する
+	//（範囲は進むにつれて各軸とも同じ向きにずれるので、直前の範囲に含まれるセルは判定済み）
+	XMINT2 prevMin = { 0, 0 };
+	XMINT2 prevMax = { -1, -1 };
+	float t = tEnter;
+	Triangle cellTriangles[2];
+	while (true)
+	{
+		const float tCellExit = (std::min)((std::min)(nextX, nextZ), tExit);
+
+		// 高さは区間の始めから軌跡の終わりまでを使う（後の区間で同じセルを判定しないため）
+		const float x0 = start.x + move.x * t;
+		const float x1 = start.x + move.x * tCellExit;
+		const float z0 = start.z + move.z * t;
+		const float z1 = start.z + move.z * tCellExit;
+		const float y0 = start.y + move.y * t;
+		const float y1 = start.y + move.y * tExit;
+		const XMFLOAT3 rangeMin = { (std::min)(x0, x1) - radius, (std::min)(y0, y1) - radius, (std::min)(z0, z1) - radius };
+		const XMFLOAT3 rangeMax = { (std::max)(x0, x1) + radius, (std::max)(y0, y1) + radius, (std::max)(z0, z1) + radius };
+
+		XMINT2 cellMin, cellMax;
+		if (GetCellRange(rangeMin, rangeMax, &cellMin, &cellMax))
+		{
+			for (int z = cellMin.y; z <= cellMax.y; z++)
+			{
+				for (int x = cellMin.x; x <= cellMax.x; x++)
+				{
+					if (x >= prevMin.x && x <= prevMax.x && z >= prevMin.y && z <= prevMax.y) { continue; }
+
+					float cellMinHeight, cellMaxHeight;
+					GetCellHeightRange(x, z, &cellMinHeight, &cellMaxHeight);
+					if (rangeMax.y < cellMinHeight || rangeMin.y > cellMaxHeight) { continue; }
+
+					GetCellTriangles(x, z, cellTriangles);
+					for (const Triangle& triangle : cellTriangles)
+					{
+						float time;
+						XMVECTOR inter, normal;
+						if (!Collision::CheckSweptSphere2Triangle(localSphere, localDisplacement, triangle, &time, &inter, &normal)) { continue; }
+						if (isHit && time >= hitTime) { continue; }
+
+						isHit = true;
+						hitTime = time;
+						hitInter = inter;
+						hitNormal = normal;
+					}
+				}
+			}
+			prevMin = cellMin;
+			prevMax = cellMax;
+		}
+		else
+		{
+			prevMin = { 0, 0 };
+			prevMax = { -1, -1 };
+		}
+
+		// この区間までの接触は全て判定済みなので、区間内で当たっていれば終了
+		if ((isHit && hitTime <= tCellExit) || tCellExit >= tExit) { break; }
+
+		// 次のセルへ
+		if (nextX < nextZ)
+		{
+			t = nextX;
+			nextX += deltaX;
+		}
+		else
+		{
+			t = nextZ;
+			nextZ += deltaZ;
+		}
+	}
+
+	if (!isHit) { return false; }
+
+	if (_time) {
+		*_time = hitTime;
+	}
+	if (_inter) {
+		*_inter = XMVector3Transform(hitInter, matWorld);
+	}
+	if (_normal) {
+		//法線は逆行列の転置で戻す
+		*_normal = XMVector3Normalize(XMVector3TransformNormal(hitNormal, XMMatrixTranspose(invMatWorld)));
+	}
+	return true;
+}
@@ -0,0 +1,167 @@
+﻿#pragma once
+
+#include "BaseCollider.h"
+#include "CollisionPrimitive.h"
+#include "ContactManifold.h"
+
+#include <DirectXMath.h>
+#include <vector>
+
+class HeightMap;
+
+/// <summary>
+/// ハイトフィールド衝突判定オブジェクト
+/// （高さのみを格子状に保持し、判定時にセルの三角形を生成する）
+/// </summary>
+class HeightfieldCollider :
+	public BaseCollider
+{
+public:
+	HeightfieldCollider()
+	{
+		// ハイトフィールド形状をセット
+		shapeType = COLLISIONSHAPE_HEIGHTFIELD;
+	}
+
+	/// <summary>
+	/// 高さの格子を構築する
+	/// </summary>
+	/// <param name="_heightMap">ハイトマップ</param>
+	void ConstructHeightfield(HeightMap* _heightMap);
+
+	/// <summary>
+	/// 高さの格子を構築する（サンプル(i,j)のローカル座標は(i,高さ,j)）
+	/// </summary>
+	/// <param name="_heights">高さ（_width*_depth個、x方向が連続）</param>
+	/// <param name="_width">x方向のサンプル数</param>
+	/// <param name="_depth">z方向のサンプル数</param>
+	void ConstructHeightfield(const std::vector<float>& _heights, int _width, int _depth);
+
+	/// <summary>
+	/// 更新
+	/// </summary>
+	void Update() override;
+
+	/// <summary>
+	/// 描画
+	/// </summary>
+	void Draw() override;
+
+	/// <summary>
+	/// ワールド座標(x,z)での地面の高さを取得（当たり判定と同じ三角形の平面上で補間）
+	/// </summary>
+	/// <param name="_x">ワールドx座標</param>
+	/// <param name="_z">ワールドz座標</param>
+	/// <param name="_height">ワールドy座標での高さ（出力用）</param>
+	/// <returns>範囲内か否か</returns>
+	bool GetHeightAt(float _x, float _z, float* _height);
+
+	/// <summary>
+	/// 球との当たり判定
+	/// </summary>
+	/// <param name="_sphere">球</param>
+	/// <param name="_inter">交点（出力用）</param>
+	/// <param name="_reject">排斥ベクトル（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	bool CheckCollisionSphere(const Sphere& _sphere, DirectX::XMVECTOR* _inter = nullptr, DirectX::XMVECTOR* _reject = nullptr);
+
+	/// <summary>
+	/// 球との当たり判定（重なる三角形を全て接触点として集める）
+	/// </summary>
+	/// <param name="_sphere">球</param>
+	/// <param name="_manifold">接触点の追加先</param>
+	/// <returns>交差しているか否か</returns>
+	bool CheckCollisionSphereContacts(const Sphere& _sphere, ContactManifold* _manifold);
+
+	/// <summary>
+	/// レイとの当たり判定（格子をDDAで辿り、最も近い交点を返す）
+	/// </summary>
+	/// <param name="_ray">レイ</param>
+	/// <param name="_distance">距離（出力用）</param>
+	/// <param name="_inter">交点（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	bool CheckCollisionRay(const Ray& _ray, float* _distance, DirectX::XMVECTOR* _inter);
+
+	/// <summary>
+	/// カプセルとの当たり判定
+	/// </summary>
+	/// <param name="_capsule">カプセル</param>
+	/// <param name="_inter">交点（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	bool CheckCollisionCapsule(const Capsule& _capsule, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// OBBとの当たり判定
+	/// </summary>
+	/// <param name="_obb">OBB</param>
+	/// <param name="_inter">交点（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	bool CheckCollisionOBB(const OBB& _obb, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// 移動する球との当たり判定（最初に接触する時刻を求める）
+	/// </summary>
+	/// <param name="_sphere">移動する球（移動開始時）</param>
+	/// <param name="_displacement">移動量</param>
+	/// <param name="_time">最初に接触する時刻0～1（出力用）</param>
+	/// <param name="_inter">接触点（出力用）</param>
+	/// <param name="_normal">接触面の法線（出力用）</param>
+	/// <returns>移動中に接触するか否か</returns>
+	bool SweepSphere(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement,
+		float* _time, DirectX::XMVECTOR* _inter = nullptr, DirectX::XMVECTOR* _normal = nullptr);
+
+private:
+
+	/// <summary>
+	/// サンプルの高さを取得
+	/// </summary>
+	/// <param name="_x">x方向の番号</param>
+	/// <param name="_z">z方向の番号</param>
+	/// <returns>ローカル座標での高さ</returns>
+	float GetSample(int _x, int _z) const { return heights[_z * width + _x]; }
+
+	/// <summary>
+	/// セルを分割した三角形を取得（左下・右上の順、上向きが表面）
+	/// </summary>
+	/// <param name="_x">セルのx方向の番号</param>
+	/// <param name="_z">セルのz方向の番号</param>
+	/// <param name="_triangles">三角形2つ（出力用）</param>
+	void GetCellTriangles(int _x, int _z, Triangle* _triangles) const;
+
+	/// <summary>
+	/// セルの4隅の高さの範囲を取得
+	/// </summary>
+	/// <param name="_x">セルのx方向の番号</param>
+	/// <param name="_z">セルのz方向の番号</param>
+	/// <param name="_minHeight">最小の高さ（出力用）</param>
+	/// <param name="_maxHeight">最大の高さ（出力用）</param>
+	void GetCellHeightRange(int _x, int _z, float* _minHeight, float* _maxHeight) const;
+
+	/// <summary>
+	/// ローカル座標のAABBと重なるセルの範囲を求める
+	/// </summary>
+	/// <param name="_min">AABB最小値</param>
+	/// <param name="_max">AABB最大値</param>
+	/// <param name="_cellMin">セル番号の最小値（出力用）</param>
+	/// <param name="_cellMax">セル番号の最大値（出力用）</param>
+	/// <returns>重なるセルがあるか否か</returns>
+	bool GetCellRange(const DirectX::XMFLOAT3& _min, const DirectX::XMFLOAT3& _max,
+		DirectX::XMINT2* _cellMin, DirectX::XMINT2* _cellMax) const;
+
+private:
+
+	//高さ（x方向が連続）
+	std::vector<float> heights;
+	//x方向のサンプル数
+	int width = 0;
+	//z方向のサンプル数
+	int depth = 0;
+	//高さの最小値
+	float minHeight = 0.0f;
+	//高さの最大値
+	float maxHeight = 0.0f;
+	// ワールド行列
+	DirectX::XMMATRIX matWorld;
+	// ワールド行列の逆行列
+	DirectX::XMMATRIX invMatWorld;
+};
@@ -2,21 +2,48 @@
 #include "Collision.h"
 #include <bitset>
 #include "Matrix4.h"
+#include "CookedBinary.h"
+#include "MappedFile.h"
 
 using namespace DirectX;
 
-const bool operator==(const XMINT2& a, const XMINT2& b) {
-	bool x = a.x == b.x;
-	bool y = a.y == b.y;
+/// <summary>
+/// AABBの表面積
+/// </summary>
+static float SurfaceArea(const XMFLOAT3& _min, const XMFLOAT3& _max)
+{
+	XMFLOAT3 extent = { _max.x - _min.x, _max.y - _min.y, _max.z - _min.z };
+	return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
 
-	return x * y;
+/// <summary>
+/// AABBを点で拡張する
+/// </summary>
+static void GrowAABB(XMFLOAT3& _min, XMFLOAT3& _max, const XMFLOAT3& _point)
+{
+	_min = { (std::min)(_min.x, _point.x), (std::min)(_min.y, _point.y), (std::min)(_min.z, _point.z) };
+	_max = { (std::max)(_max.x, _point.x), (std::max)(_max.y, _point.y), (std::max)(_max.z, _point.z) };
 }
 
-const bool operator!=(const XMINT2& a, const XMINT2& b) {
-	bool x = a.x == b.x;
-	bool y = a.y == b.y;
+/// <summary>
+/// 球とAABBの当たり判定
+/// </summary>
+static bool CheckSphere2AABB(const XMFLOAT3& _center, float _radius, const XMFLOAT3& _min, const XMFLOAT3& _max)
+{
+	float dx = (std::max)((std::max)(_min.x - _center.x, 0.0f), _center.x - _max.x);
+	float dy = (std::max)((std::max)(_min.y - _center.y, 0.0f), _center.y - _max.y);
+	float dz = (std::max)((std::max)(_min.z - _center.z, 0.0f), _center.z - _max.z);
+	return dx * dx + dy * dy + dz * dz <= _radius * _radius;
+}
 
-	return !x || !y;
+/// <summary>
+/// AABB同士の当たり判定
+/// </summary>
+static bool CheckAABB2AABB(const XMFLOAT3& _minA, const XMFLOAT3& _maxA, const XMFLOAT3& _minB, const XMFLOAT3& _maxB)
+{
+	return _minA.x <= _maxB.x && _minB.x <= _maxA.x &&
+		_minA.y <= _maxB.y && _minB.y <= _maxA.y &&
+		_minA.z <= _maxB.z && _minB.z <= _maxA.z;
 }
 
 void MeshCollider::MinMax(Model* _model)
@@ -24,109 +51,71 @@ void MeshCollider::MinMax(Model* _model)
 	const std::vector<Mesh*>& meshes = _model->GetMeshes();
 	std::vector<Mesh*>::const_iterator it = meshes.cbegin();
 
-	//[0]最大[1]最小
-	XMFLOAT3 minmax[2] = { {0,0,0},{100,100,100} };
+	XMVECTOR meshMin = XMVectorReplicate(D3D12_FLOAT32_MAX);
+	XMVECTOR meshMax = XMVectorReplicate(-D3D12_FLOAT32_MAX);
 
 	for (; it != meshes.cend(); ++it) {
 		Mesh* mesh = *it;
-		const std::vector<Mesh::VERTEX>& vertices = mesh->GetVertices();
-		const int size = static_cast<int>(vertices.size());
-
-		for (int i = 0; i < size; i++)
+		for (const Mesh::VERTEX& vertex : mesh->GetVertices())
 		{
-			if (vertices[i].pos.x > minmax[0].x)
-			{
-				minmax[0].x = vertices[i].pos.x;
-			} else if (vertices[i].pos.x < minmax[1].x)
-			{
-				minmax[1].x = vertices[i].pos.x;
-			}
-
-			if (vertices[i].pos.y > minmax[0].y)
-			{
-				minmax[0].y = vertices[i].pos.y;
-			} else if (vertices[i].pos.y < minmax[1].y)
-			{
-				minmax[1].y = vertices[i].pos.y;
-			}
-
-			if (vertices[i].pos.z > minmax[0].z)
-			{
-				minmax[0].z = vertices[i].pos.z;
-			} else if (vertices[i].pos.z < minmax[1].z)
-			{
-				minmax[1].z = vertices[i].pos.z;
-			}
+			XMVECTOR pos = XMLoadFloat3(&vertex.pos);
+			meshMin = XMVectorMin(meshMin, pos);
+			meshMax = XMVectorMax(meshMax, pos);
 		}
 	}
 
-	min = { minmax[1].x,minmax[1].y,minmax[1].z };
-	max = { minmax[0].x,minmax[0].y,minmax[0].z };
+	min = meshMin;
+	max = meshMax;
 }
 
 void MeshCollider::MinMax(const std::vector<Mesh::VERTEX>& _vertices)
 {
-	//[0]最大[1]最小
-	XMFLOAT3 minmax[2] = { {0,0,0},{100,100,100} };
+	XMVECTOR meshMin = XMVectorReplicate(D3D12_FLOAT32_MAX);
+	XMVECTOR meshMax = XMVectorReplicate(-D3D12_FLOAT32_MAX);
 
-	const std::vector<Mesh::VERTEX> vertices = _vertices;
-	const int size = static_cast<int>(vertices.size());
-
-	for (int i = 0; i < size; i++)
+	for (const Mesh::VERTEX& vertex : _vertices)
 	{
-		if (vertices[i].pos.x > minmax[0].x)
-		{
-			minmax[0].x = vertices[i].pos.x;
-		} else if (vertices[i].pos.x < minmax[1].x)
-		{
-			minmax[1].x = vertices[i].pos.x;
-		}
+		XMVECTOR pos = XMLoadFloat3(&vertex.pos);
+		meshMin = XMVectorMin(meshMin, pos);
+		meshMax = XMVectorMax(meshMax, pos);
+	}
 
-		if (vertices[i].pos.y > minmax[0].y)
-		{
-			minmax[0].y = vertices[i].pos.y;
-		} else if (vertices[i].pos.y < minmax[1].y)
-		{
-			minmax[1].y = vertices[i].pos.y;
-		}
+	min = meshMin;
+	max = meshMax;
+}
 
-		if (vertices[i].pos.z > minmax[0].z)
-		{
-			minmax[0].z = vertices[i].pos.z;
-		} else if (vertices[i].pos.z < minmax[1].z)
-		{
-			minmax[1].z = vertices[i].pos.z;
-		}
-	}
+void MeshCollider::ConstructTriangles(Model* _model, bool _isQuantize)
+{
+	std::vector<XMFLOAT3> positions;
+	std::vector<uint32_t> indices;
+	GatherTriangles(_model, positions, indices);
 
-	min = { minmax[1].x,minmax[1].y,minmax[1].z };
-	max = { minmax[0].x,minmax[0].y,minmax[0].z };
+	CreateCollisionMesh(positions, indices, _isQuantize);
 }
 
-XMINT2 MeshCollider::OctreeSet(const XMFLOAT3& _pos)
+void MeshCollider::ConstructTriangles(const std::vector<Mesh::VERTEX>& _vertices, const std::vector<unsigned long>& _indices, bool _isQuantize)
 {
-	XMINT2 octtreenum = {};
-	for (int i = 0; i < 8; i++)
-	{
-		if (octtreeRange[i].x <= _pos.x && _pos.x < octtreeRange[i + 1].x)
-		{
-			octtreenum.x = i;
-			break;
-		}
+	std::vector<XMFLOAT3> positions(_vertices.size());
+	for (size_t i = 0; i < _vertices.size(); i++) {
+		positions[i] = _vertices[i].pos;
 	}
-	for (int i = 0; i < 8; i++)
-	{
-		if (octtreeRange[i].z <= _pos.z && _pos.z < octtreeRange[i + 1].z)
-		{
-			octtreenum.y = i;
-			break;
-		}
+
+	std::vector<uint32_t> indices(_indices.size() / 3 * 3);
+	for (size_t i = 0; i < indices.size(); i++) {
+		indices[i] = static_cast<uint32_t>(_indices[i]);
 	}
 
-	return octtreenum;
+	CreateCollisionMesh(positions, indices, _isQuantize);
+}
+
+size_t MeshCollider::GetMemorySize() const
+{
+	return collisionMesh.GetMemorySize() +
+		bvhNodes.size() * sizeof(BVH_NODE) +
+		trianglePacks.size() * sizeof(Triangle4);
 }
 
-void MeshCollider::ConstructTriangles(Model* _model)
+void MeshCollider::CreateCollisionMesh(const std::vector<XMFLOAT3>& _positions, const std::vector<uint32_t>& _indices, bool _isQuantize)
 {
 	if (!isInit)
 	{
@@ -134,189 +123,434 @@ void MeshCollider::ConstructTriangles(Model* _model)
 		isInit = true;
 	}
 
-	for (int i = 0; i < octreeSplit; i++)
+	collisionMesh.Create(_positions, _indices, _isQuantize);
+	sourceHash = HashSource(_positions, _indices, _isQuantize);
+	SetDebugVertices();
+
+	BuildBVH();
+
+	//形状が変わったので接触キャッシュを使わせない
+	isMoved = true;
+}
+
+void MeshCollider::ConstructTrianglesWithCache(Model* _model, const std::string& _cookedFilename, bool _isQuantize)
+{
+	std::vector<XMFLOAT3> positions;
+	std::vector<uint32_t> indices;
+	GatherTriangles(_model, positions, indices);
+
+	//モデルの頂点座標・インデックスから作ったデータである場合のみ調理済みデータを使う
+	if (LoadCookedData(_cookedFilename) &&
+		sourceHash == HashSource(positions, indices, _isQuantize))
 	{
-		for (int j = 0; j < octreeSplit; j++)
-		{
-			triangle[i][j].clear();
-		}
+		return;
 	}
 
+	CreateCollisionMesh(positions, indices, _isQuantize);
+	SaveCookedData(_cookedFilename);
+}
+
+void MeshCollider::GatherTriangles(Model* _model, std::vector<XMFLOAT3>& _positions, std::vector<uint32_t>& _indices)
+{
 	const std::vector<Mesh*>& meshes = _model->GetMeshes();
 
-	int start = 0;
+	//全メッシュの頂点を1つの配列にまとめる
+	size_t vertexNum = 0;
+	size_t indexNum = 0;
+	for (Mesh* mesh : meshes) {
+		vertexNum += mesh->GetVertices().size();
+		indexNum += mesh->GetIndices().size() / 3 * 3;
+	}
 
-	MinMax(_model);
+	_positions.clear();
+	_indices.clear();
+	_positions.reserve(vertexNum);
+	_indices.reserve(indexNum);
 
-	XMFLOAT3 minmaxRange = {
-		max.m128_f32[0] - min.m128_f32[0],
-		max.m128_f32[1] - min.m128_f32[1],
-		max.m128_f32[2] - min.m128_f32[2]
-	};
+	for (Mesh* mesh : meshes) {
+		const uint32_t baseVertex = static_cast<uint32_t>(_positions.size());
+		for (const Mesh::VERTEX& vertex : mesh->GetVertices()) {
+			_positions.push_back(vertex.pos);
+		}
 
-	for (int i = 0; i < 9; i++)
-	{
-		octtreeRange[i].x = minmaxRange.x / 8 * i;
-		octtreeRange[i].y = minmaxRange.y / 8 * i;
-		octtreeRange[i].z = minmaxRange.z / 8 * i;
+		const std::vector<unsigned long>& meshIndices = mesh->GetIndices();
+		const size_t meshIndexNum = meshIndices.size() / 3 * 3;
+		for (size_t i = 0; i < meshIndexNum; i++) {
+			_indices.push_back(baseVertex + static_cast<uint32_t>(meshIndices[i]));
+		}
 	}
+}
 
-	octtreeRange[8].x++;
-	octtreeRange[8].y++;
-	octtreeRange[8].z++;
+uint64_t MeshCollider::HashSource(const std::vector<XMFLOAT3>& _positions, const std::vector<uint32_t>& _indices, bool _isQuantize)
+{
+	//Createは3の倍数に切り詰めたインデックスを使うので、ハッシュも同じ範囲で取る
+	const size_t indexNum = _indices.size() / 3 * 3;
+	const uint32_t isQuantize = _isQuantize ? 1 : 0;
 
-	std::vector<Mesh*>::const_iterator it = meshes.cbegin();
-	for (; it != meshes.cend(); ++it) {
-		Mesh* mesh = *it;
-		const std::vector<Mesh::VERTEX>& vertices = mesh->GetVertices();
-		const std::vector<unsigned long>& indices = mesh->GetIndices();
+	uint64_t hash = CookedBinary::Hash(_positions.data(), _positions.size() * sizeof(XMFLOAT3));
+	hash = CookedBinary::Hash(_indices.data(), indexNum * sizeof(uint32_t), hash);
+	return CookedBinary::Hash(&isQuantize, sizeof(isQuantize), hash);
+}
 
-		size_t triangleNum = indices.size() / 3;
+bool MeshCollider::SaveCookedData(const std::string& _filename) const
+{
+	FILE* fp = nullptr;
+	if (fopen_s(&fp, _filename.c_str(), "wb") != 0) {
+		return false;
+	}
 
-		for (int i = 0; i < triangleNum; i++)
-		{
-			Triangle addTriangle;
-			int idx0 = indices[i * 3 + 0];
-			int idx1 = indices[i * 3 + 1];
-			int idx2 = indices[i * 3 + 2];
-
-			addTriangle.p0 = {
-				vertices[idx0].pos.x,
-				vertices[idx0].pos.y,
-				vertices[idx0].pos.z,
-				1 };
-			addTriangle.p1 = {
-				vertices[idx1].pos.x,
-				vertices[idx1].pos.y,
-				vertices[idx1].pos.z,
-				1 };
-
-			addTriangle.p2 = {
-				vertices[idx2].pos.x,
-				vertices[idx2].pos.y,
-				vertices[idx2].pos.z,
-				1 };
-
-			addTriangle.ComputeNormal();
-
-			XMINT2 Octree1 = OctreeSet(vertices[idx0].pos);
-			XMINT2 Octree2 = OctreeSet(vertices[idx1].pos);
-			XMINT2 Octree3 = OctreeSet(vertices[idx2].pos);
-
-			triangle[Octree1.x][Octree1.y].emplace_back(addTriangle);
-			if (Octree1 != Octree2)
-			{
-				triangle[Octree2.x][Octree2.y].emplace_back(addTriangle);
-			}
-			if (Octree1 != Octree3 && Octree2 != Octree3)
-			{
-				triangle[Octree3.x][Octree3.y].emplace_back(addTriangle);
-			}
+	COOKED_HEADER header = {};
+	memcpy(header.magic, "MCOL", sizeof(header.magic));
+	header.version = cookedVersion;
+	header.nodeNum = static_cast<uint32_t>(bvhNodes.size());
+	header.packNum = static_cast<uint32_t>(trianglePacks.size());
+	header.sourceHash = sourceHash;
 
-			object->SetVertex(vertices[idx0].pos);
-			object->SetVertex(vertices[idx1].pos);
-			object->SetVertex(vertices[idx2].pos);
-		}
-	}
+	const bool result = CookedBinary::Write(fp, &header, 1) &&
+		CookedBinary::Write(fp, bvhNodes.data(), bvhNodes.size()) &&
+		CookedBinary::Write(fp, trianglePacks.data(), trianglePacks.size()) &&
+		collisionMesh.Write(fp);
+
+	fclose(fp);
+	return result;
 }
 
-void MeshCollider::ConstructTriangles(const std::vector<Mesh::VERTEX>& _vertices, const std::vector<unsigned long>& _indices)
+bool MeshCollider::LoadCookedData(const std::string& _filename)
 {
+	MappedFile file;
+	if (!file.Open(_filename)) {
+		return false;
+	}
+
+	const char* cursor = file.GetData();
+	const char* end = cursor + file.GetSize();
+
+	//識別子とバージョンが一致しなければ使わない
+	COOKED_HEADER header;
+	if (!CookedBinary::Read(cursor, end, &header, 1) ||
+		memcmp(header.magic, "MCOL", sizeof(header.magic)) != 0 ||
+		header.version != cookedVersion ||
+		header.nodeNum == 0)
+	{
+		return false;
+	}
+
+	if (!CookedBinary::Read(cursor, end, bvhNodes, header.nodeNum) ||
+		!CookedBinary::Read(cursor, end, trianglePacks, header.packNum) ||
+		!collisionMesh.Read(cursor, end) ||
+		!IsValidBVH())
+	{
+		bvhNodes.clear();
+		trianglePacks.clear();
+		collisionMesh.Clear();
+		return false;
+	}
+	sourceHash = header.sourceHash;
+
 	if (!isInit)
 	{
 		object = std::make_unique<PrimitiveObject3D>();
 		isInit = true;
 	}
+	SetDebugVertices();
 
-	for (int i = 0; i < octreeSplit; i++)
+	//メッシュ全体の範囲は根ノードの範囲
+	min = { bvhNodes[0].min.x, bvhNodes[0].min.y, bvhNodes[0].min.z, 1 };
+	max = { bvhNodes[0].max.x, bvhNodes[0].max.y, bvhNodes[0].max.z, 1 };
+
+	//形状が変わったので接触キャッシュを使わせない
+	isMoved = true;
+
+	return true;
+}
+
+bool MeshCollider::IsValidBVH() const
+{
+	const int nodeNum = static_cast<int>(bvhNodes.size());
+	const int packNum = static_cast<int>(trianglePacks.size());
+	const int triangleNum = collisionMesh.GetTriangleNum();
+
+	//量子化している場合はパックを持たない
+	if (collisionMesh.IsQuantized() && packNum != 0) { return false; }
+
+	//子は必ず親より後ろに置かれるので、前から順に深さを求められる
+	std::vector<int> depths(nodeNum, 0);
+	for (int i = 0; i < nodeNum; i++)
 	{
-		for (int j = 0; j < octreeSplit; j++)
+		const BVH_NODE& node = bvhNodes[i];
+
+		//節（子の番号が範囲内で、走査のスタックに収まる深さか）
+		if (node.count == 0)
 		{
-			triangle[i][j].clear();
+			if (node.start <= i || node.start >= nodeNum - 1 || depths[i] >= bvhMaxDepth) { return false; }
+			depths[node.start] = depths[i] + 1;
+			depths[node.start + 1] = depths[i] + 1;
+			continue;
+		}
+
+		//葉（三角形とパックの範囲が配列内か）
+		if (node.count < 0 || node.start < 0 || node.start > triangleNum - node.count) { return false; }
+		if (packNum > 0 &&
+			(node.packStart < 0 || node.packStart > packNum - (node.count + 3) / 4)) {
+			return false;
 		}
 	}
 
-	int start = 0;
+	return true;
+}
 
-	MinMax(_vertices);
+void MeshCollider::SetDebugVertices()
+{
+	//作り直し・読み込み直しで前の形状が残らないよう空にしてから詰める
+	object->ResetVertex();
 
-	XMFLOAT3 minmaxRange = {
-		max.m128_f32[0] - min.m128_f32[0],
-		max.m128_f32[1] - min.m128_f32[1],
-		max.m128_f32[2] - min.m128_f32[2]
-	};
-	for (int i = 0; i < 9; i++)
+	const int triangleNum = collisionMesh.GetTriangleNum();
+	for (int i = 0; i < triangleNum; i++)
 	{
-		octtreeRange[i].x = minmaxRange.x / 8 * i;
-		octtreeRange[i].y = minmaxRange.y / 8 * i;
-		octtreeRange[i].z = minmaxRange.z / 8 * i;
+		Triangle triangle;
+		collisionMesh.GetTriangle(i, &triangle);
+
+		XMFLOAT3 position;
+		XMStoreFloat3(&position, triangle.p0);
+		object->SetVertex(position);
+		XMStoreFloat3(&position, triangle.p1);
+		object->SetVertex(position);
+		XMStoreFloat3(&position, triangle.p2);
+		object->SetVertex(position);
+	}
+}
+
+void MeshCollider::BuildBVH()
+{
+	bvhNodes.clear();
+	trianglePacks.clear();
+
+	const int triangleNum = collisionMesh.GetTriangleNum();
+	if (triangleNum == 0) {
+		min = {};
+		max = {};
+		return;
 	}
-	octtreeRange[8].x++;
-	octtreeRange[8].y++;
-	octtreeRange[8].z++;
 
-	const std::vector<Mesh::VERTEX> vertices = _vertices;
-	const std::vector<unsigned long> indices = _indices;
+	// ノード数は最大で三角形数*2-1
+	bvhNodes.reserve(triangleNum * 2);
+
+	//三角形ごとのAABBと重心
+	std::vector<BVH_PRIMITIVE> primitives(triangleNum);
+	for (int i = 0; i < triangleNum; i++)
+	{
+		Triangle triangle;
+		collisionMesh.GetTriangle(i, &triangle);
+
+		BVH_PRIMITIVE& primitive = primitives[i];
+		XMStoreFloat3(&primitive.min, XMVectorMin(XMVectorMin(triangle.p0, triangle.p1), triangle.p2));
+		XMStoreFloat3(&primitive.max, XMVectorMax(XMVectorMax(triangle.p0, triangle.p1), triangle.p2));
+		XMStoreFloat3(&primitive.centroid, (triangle.p0 + triangle.p1 + triangle.p2) / 3.0f);
+		primitive.index = i;
+	}
 
-	size_t triangleNum = indices.size() / 3;
+	//根ノード
+	BVH_NODE root;
+	root.start = 0;
+	root.count = triangleNum;
+	UpdateNodeBounds(root, primitives);
+	bvhNodes.push_back(root);
 
-	XMINT2 aa = { 0,1 };
-	XMINT2 bb = { 0,1 };
-	bool aaa=aa!=bb;
+	SubdivideNode(0, primitives, 0);
 
+	//三角形を葉の順に並べ替える
+	std::vector<int> order(triangleNum);
 	for (int i = 0; i < triangleNum; i++)
 	{
-		Triangle addTriangle;
-		int idx0 = indices[i * 3 + 0];
-		int idx1 = indices[i * 3 + 1];
-		int idx2 = indices[i * 3 + 2];
-
-		addTriangle.p0 = {
-			vertices[idx0].pos.x,
-			vertices[idx0].pos.y,
-			vertices[idx0].pos.z,
-			1 };
-		addTriangle.p1 = {
-			vertices[idx1].pos.x,
-			vertices[idx1].pos.y,
-			vertices[idx1].pos.z,
-			1 };
+		order[i] = primitives[i].index;
+	}
+	collisionMesh.ReorderTriangles(order);
 
-		addTriangle.p2 = {
-			vertices[idx2].pos.x,
-			vertices[idx2].pos.y,
-			vertices[idx2].pos.z,
-			1 };
+	//葉ごとに三角形を4つずつSoA形式にまとめる
+	for (BVH_NODE& node : bvhNodes)
+	{
+		node.packStart = static_cast<int>(trianglePacks.size());
+		if (collisionMesh.IsQuantized()) { continue; }
+
+		for (int i = 0; i < node.count; i += 4)
+		{
+			Triangle4 pack;
+			collisionMesh.GetTriangle4(node.start + i, (std::min)(4, node.count - i), &pack);
+			trianglePacks.push_back(pack);
+		}
+	}
+
+	//メッシュ全体の範囲は根ノードの範囲
+	min = { bvhNodes[0].min.x, bvhNodes[0].min.y, bvhNodes[0].min.z, 1 };
+	max = { bvhNodes[0].max.x, bvhNodes[0].max.y, bvhNodes[0].max.z, 1 };
+}
+
+void MeshCollider::UpdateNodeBounds(BVH_NODE& _node, const std::vector<BVH_PRIMITIVE>& _primitives)
+{
+	_node.min = { D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX };
+	_node.max = { -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX };
+
+	for (int i = _node.start; i < _node.start + _node.count; i++)
+	{
+		GrowAABB(_node.min, _node.max, _primitives[i].min);
+		GrowAABB(_node.min, _node.max, _primitives[i].max);
+	}
+}
+
+void MeshCollider::SubdivideNode(int _nodeIndex, std::vector<BVH_PRIMITIVE>& _primitives, int _depth)
+{
+	const int start = bvhNodes[_nodeIndex].start;
+	const int count = bvhNodes[_nodeIndex].count;
+
+	if (count <= bvhLeafSize || _depth >= bvhMaxDepth) { return; }
+
+	//重心の範囲
+	XMFLOAT3 centroidMin = { D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX };
+	XMFLOAT3 centroidMax = { -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX };
+	for (int i = start; i < start + count; i++)
+	{
+		GrowAABB(centroidMin, centroidMax, _primitives[i].centroid);
+	}
 
-		addTriangle.ComputeNormal();
+	//全軸のビン境界でSAHコストを評価し、最小の分割を探す
+	int bestAxis = -1;
+	int bestSplit = 0;
+	float bestCost = D3D12_FLOAT32_MAX;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		const float axisMin = (&centroidMin.x)[axis];
+		const float extent = (&centroidMax.x)[axis] - axisMin;
+		if (extent <= 0.0f) { continue; }
+		const float binScale = bvhBinNum / extent;
+
+		int binCount[bvhBinNum] = {};
+		XMFLOAT3 binMin[bvhBinNum];
+		XMFLOAT3 binMax[bvhBinNum];
+		for (int b = 0; b < bvhBinNum; b++)
+		{
+			binMin[b] = { D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX };
+			binMax[b] = { -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX };
+		}
 
-		XMINT2 Octree1 = OctreeSet(vertices[idx0].pos);
-		XMINT2 Octree2 = OctreeSet(vertices[idx1].pos);
-		XMINT2 Octree3 = OctreeSet(vertices[idx2].pos);
+		for (int i = start; i < start + count; i++)
+		{
+			const int b = (std::min)(bvhBinNum - 1, static_cast<int>(((&_primitives[i].centroid.x)[axis] - axisMin) * binScale));
+			binCount[b]++;
+			GrowAABB(binMin[b], binMax[b], _primitives[i].min);
+			GrowAABB(binMin[b], binMax[b], _primitives[i].max);
+		}
 
-		triangle[Octree1.x][Octree1.y].emplace_back(addTriangle);
-		if (Octree1 != Octree2)
+		//左側から累積した面積と個数
+		float leftArea[bvhBinNum - 1];
+		int leftCount[bvhBinNum - 1];
+		XMFLOAT3 accumMin = { D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX };
+		XMFLOAT3 accumMax = { -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX };
+		int accumCount = 0;
+		for (int b = 0; b < bvhBinNum - 1; b++)
 		{
-			triangle[Octree2.x][Octree2.y].emplace_back(addTriangle);
+			accumCount += binCount[b];
+			if (binCount[b] > 0)
+			{
+				GrowAABB(accumMin, accumMax, binMin[b]);
+				GrowAABB(accumMin, accumMax, binMax[b]);
+			}
+			leftCount[b] = accumCount;
+			leftArea[b] = accumCount > 0 ? SurfaceArea(accumMin, accumMax) : 0.0f;
 		}
-		if ((Octree1 != Octree3) && (Octree2 != Octree3))
+
+		//右側から累積しながらコストを評価
+		accumMin = { D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX };
+		accumMax = { -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX, -D3D12_FLOAT32_MAX };
+		accumCount = 0;
+		for (int b = bvhBinNum - 1; b > 0; b--)
 		{
-			triangle[Octree3.x][Octree3.y].emplace_back(addTriangle);
+			accumCount += binCount[b];
+			if (binCount[b] > 0)
+			{
+				GrowAABB(accumMin, accumMax, binMin[b]);
+				GrowAABB(accumMin, accumMax, binMax[b]);
+			}
+			if (leftCount[b - 1] == 0 || accumCount == 0) { continue; }
+
+			const float cost = leftCount[b - 1] * leftArea[b - 1] + accumCount * SurfaceArea(accumMin, accumMax);
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = b;
+			}
 		}
+	}
+
+	//分割しない方が安いなら葉にする
+	const float leafCost = count * SurfaceArea(bvhNodes[_nodeIndex].min, bvhNodes[_nodeIndex].max);
+	if (bestAxis < 0 || bestCost >= leafCost) { return; }
 
-		object->SetVertex(vertices[idx0].pos);
-		object->SetVertex(vertices[idx1].pos);
-		object->SetVertex(vertices[idx2].pos);
+	//分割位置で三角形を並べ替える
+	const float axisMin = (&centroidMin.x)[bestAxis];
+	const float binScale = bvhBinNum / ((&centroidMax.x)[bestAxis] - axisMin);
+	int i = start;
+	int j = start + count - 1;
+	while (i <= j)
+	{
+		const int b = (std::min)(bvhBinNum - 1, static_cast<int>(((&_primitives[i].centroid.x)[bestAxis] - axisMin) * binScale));
+		if (b < bestSplit)
+		{
+			i++;
+		}
+		else
+		{
+			std::swap(_primitives[i], _primitives[j]);
+			j--;
+		}
 	}
 
-	int a = 0;
-	a = 1;
+	const int leftCount = i - start;
+	if (leftCount == 0 || leftCount == count) { return; }
+
+	//子ノードの生成
+	const int leftIndex = static_cast<int>(bvhNodes.size());
+	BVH_NODE left;
+	left.start = start;
+	left.count = leftCount;
+	UpdateNodeBounds(left, _primitives);
+	BVH_NODE right;
+	right.start = i;
+	right.count = count - leftCount;
+	UpdateNodeBounds(right, _primitives);
+	bvhNodes.push_back(left);
+	bvhNodes.push_back(right);
+
+	bvhNodes[_nodeIndex].start = leftIndex;
+	bvhNodes[_nodeIndex].count = 0;
+
+	SubdivideNode(leftIndex, _primitives, _depth + 1);
+	SubdivideNode(leftIndex + 1, _primitives, _depth + 1);
 }
 
 void MeshCollider::Update()
 {
 	matWorld = GetObject3d()->GetMatWorld();
 	invMatWorld = XMMatrixInverse(nullptr, matWorld);
+
+	// ローカルAABBの8頂点をワールド変換し、ブロードフェーズ用のAABBを更新
+	XMVECTOR worldMin = XMVectorReplicate(D3D12_FLOAT32_MAX);
+	XMVECTOR worldMax = XMVectorReplicate(-D3D12_FLOAT32_MAX);
+	for (int i = 0; i < 8; i++)
+	{
+		XMVECTOR corner = {
+			(i & 1) ? max.m128_f32[0] : min.m128_f32[0],
+			(i & 2) ? max.m128_f32[1] : min.m128_f32[1],
+			(i & 4) ? max.m128_f32[2] : min.m128_f32[2],
+			1 };
+		corner = XMVector3Transform(corner, matWorld);
+		worldMin = XMVectorMin(worldMin, corner);
+		worldMax = XMVectorMax(worldMax, corner);
+	}
+	XMStoreFloat3(&aabbMin, worldMin);
+	XMStoreFloat3(&aabbMax, worldMax);
+	UpdateProxy();
+
 	if (isInit && !isCreateBuffer)
 	{
 		object->Initialize();
@@ -331,147 +565,457 @@ void MeshCollider::Draw()
 
 bool MeshCollider::CheckCollisionSphere(const Sphere& _sphere, DirectX::XMVECTOR* _inter, DirectX::XMVECTOR* _reject)
 {
+	if (bvhNodes.empty()) { return false; }
+
 	// オブジェクトのローカル座標系での球を得る（半径はXスケールを参照)
 	Sphere localSphere;
 	localSphere.center = XMVector3Transform(_sphere.center, invMatWorld);
-	localSphere.radius *= XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+	localSphere.radius = _sphere.radius * XMVector3Length(invMatWorld.r[0]).m128_f32[0];
 
-	XMVECTOR worldmax = XMVector3Transform(max, matWorld);
-	XMVECTOR worldmin = XMVector3Transform(min, matWorld);
+	const XMFLOAT3 center = { localSphere.center.m128_f32[0],localSphere.center.m128_f32[1],localSphere.center.m128_f32[2] };
 
-	if (_sphere.center.m128_f32[0] < worldmin.m128_f32[0] || _sphere.center.m128_f32[0] > worldmax.m128_f32[0] ||
-		_sphere.center.m128_f32[2] <  worldmin.m128_f32[2] || _sphere.center.m128_f32[2] >  worldmax.m128_f32[2])
+	//BVHを辿り、球と重なる葉の三角形のみ判定する
+	int stack[bvhStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
 	{
-		return false;
+		const BVH_NODE& node = bvhNodes[stack[--stackSize]];
+		if (!CheckSphere2AABB(center, localSphere.radius, node.min, node.max)) { continue; }
+
+		//節
+		if (node.count == 0)
+		{
+			stack[stackSize++] = node.start;
+			stack[stackSize++] = node.start + 1;
+			continue;
+		}
+
+		//葉
+		for (int i = node.start; i < node.start + node.count; i++)
+		{
+			Triangle triangle;
+			collisionMesh.GetTriangle(i, &triangle);
+			if (Collision::CheckSphere2Triangle(localSphere, triangle, _inter, _reject)) {
+				if (_inter) {
+					*_inter = XMVector3Transform(*_inter, matWorld);
+				}
+				if (_reject) {
+					*_reject = XMVector3TransformNormal(*_reject, matWorld);
+				}
+				return true;
+			}
+		}
 	}
 
-	//プレイヤーの八分木位置
-	const XMINT2 Octree = OctreeSet({ localSphere.center.m128_f32[0],localSphere.center.m128_f32[1],localSphere.center.m128_f32[2] });
+	return false;
+}
 
-	std::vector<Triangle>::const_iterator it = triangle[Octree.x][Octree.y].cbegin();
-	for (; it != triangle[Octree.x][Octree.y].cend(); ++it) {
-		const Triangle& mesh = *it;
+bool MeshCollider::CheckCollisionSphereContacts(const Sphere& _sphere, ContactManifold* _manifold)
+{
+	assert(_manifold);
+	if (bvhNodes.empty()) { return false; }
 
-		if (Collision::CheckSphere2Triangle(localSphere, mesh, _inter, _reject)) {
-			if (_inter) {
-				const XMMATRIX& matWorld = GetObject3d()->GetMatWorld();
+	// オブジェクトのローカル座標系での球を得る（半径はXスケールを参照)
+	Sphere localSphere;
+	localSphere.center = XMVector3Transform(_sphere.center, invMatWorld);
+	localSphere.radius = _sphere.radius * XMVector3Length(invMatWorld.r[0]).m128_f32[0];
 
-				*_inter = XMVector3Transform(*_inter, matWorld);
-			}
-			if (_reject) {
-				const XMMATRIX& matWorld = GetObject3d()->GetMatWorld();
+	const XMFLOAT3 center = { localSphere.center.m128_f32[0],localSphere.center.m128_f32[1],localSphere.center.m128_f32[2] };
 
-				*_reject = XMVector3TransformNormal(*_reject, matWorld);
-			}
-			return true;
+	//BVHを一度だけ辿り、球と重なる三角形を全て接触点にする
+	bool isHit = false;
+	int stack[bvhStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const BVH_NODE& node = bvhNodes[stack[--stackSize]];
+		if (!CheckSphere2AABB(center, localSphere.radius, node.min, node.max)) { continue; }
+
+		//節
+		if (node.count == 0)
+		{
+			stack[stackSize++] = node.start;
+			stack[stackSize++] = node.start + 1;
+			continue;
+		}
+
+		//葉
+		for (int i = node.start; i < node.start + node.count; i++)
+		{
+			Triangle triangle;
+			collisionMesh.GetTriangle(i, &triangle);
+			CONTACT_POINT contact;
+			if (!Collision::CheckSphere2Triangle(localSphere, triangle, &contact)) { continue; }
+
+			contact.collider = this;
+			_manifold->AddContact(contact, matWorld);
+			isHit = true;
 		}
 	}
 
-	return false;
+	return isHit;
 }
 
 bool MeshCollider::CheckCollisionRay(const Ray& _ray, float* _distance, DirectX::XMVECTOR* _inter)
 {
+	if (bvhNodes.empty()) { return false; }
+
 	// オブジェクトのローカル座標系でのレイを得る
 	Ray localRay;
 	localRay.start = XMVector3Transform(_ray.start, invMatWorld);
 	localRay.dir = XMVector3TransformNormal(_ray.dir, invMatWorld);
 
-	XMVECTOR worldmax = XMVector3Transform(max, matWorld);
-	XMVECTOR worldmin = XMVector3Transform(min, matWorld);
+	const XMFLOAT3 start = { localRay.start.m128_f32[0],localRay.start.m128_f32[1],localRay.start.m128_f32[2] };
+	const XMFLOAT3 invDir = Collision::ComputeInvDir(localRay.dir);
+
+	//レイ上で最も近い交点を探す（レイの媒介変数はワールド・ローカルで共通）
+	bool isHit = false;
+	float closestDistance = D3D12_FLOAT32_MAX;
 
-	if (_ray.start.m128_f32[0] < worldmin.m128_f32[0] || _ray.start.m128_f32[0] > worldmax.m128_f32[0] ||
-		_ray.start.m128_f32[2] <  worldmin.m128_f32[2] || _ray.start.m128_f32[2] >  worldmax.m128_f32[2])
+	int stack[bvhStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
 	{
-		return false;
+		const BVH_NODE& node = bvhNodes[stack[--stackSize]];
+		if (!Collision::CheckRay2AABB(start, invDir, node.min, node.max, closestDistance)) { continue; }
+
+		//節
+		if (node.count == 0)
+		{
+			stack[stackSize++] = node.start;
+			stack[stackSize++] = node.start + 1;
+			continue;
+		}
+
+		//葉（三角形4つずつSIMDで判定）
+		for (int i = 0; i < node.count; i += 4)
+		{
+			//量子化している場合はその場でSoA形式に復元する
+			Triangle4 tempPack;
+			const Triangle4* pack = &tempPack;
+			if (trianglePacks.empty()) {
+				collisionMesh.GetTriangle4(node.start + i, (std::min)(4, node.count - i), &tempPack);
+			}
+			else {
+				pack = &trianglePacks[node.packStart + i / 4];
+			}
+
+			float tempDistance;
+			if (!Collision::CheckRay2Triangle4(localRay, *pack, closestDistance, &tempDistance)) { continue; }
+
+			isHit = true;
+			closestDistance = tempDistance;
+		}
+	}
+
+	if (!isHit) { return false; }
+
+	XMVECTOR closestInter = localRay.start + closestDistance * localRay.dir;
+	XMVECTOR worldInter = XMVector3Transform(closestInter, matWorld);
+
+	if (_distance) {
+		XMVECTOR sub = worldInter - _ray.start;
+		*_distance = XMVector3Dot(sub, _ray.dir).m128_f32[0];
+	}
+
+	if (_inter) {
+		*_inter = worldInter;
 	}
 
-	//プレイヤーの八分木位置
-	const XMINT2 Octree = OctreeSet({ localRay.start.m128_f32[0],localRay.start.m128_f32[1],localRay.start.m128_f32[2] });
+	return true;
+}
 
-	std::vector<Triangle>::const_iterator it = triangle[Octree.x][Octree.y].cbegin();
+int MeshCollider::CheckCollisionRays(const Ray* _rays, int _rayNum, bool* _isHits, float* _distances, DirectX::XMVECTOR* _inters)
+{
+	int hitNum = 0;
 
-	for (; it != triangle[Octree.x][Octree.y].cend(); ++it) {
-		const Triangle& mesh = *it;
+	for (int first = 0; first < _rayNum; first += 4)
+	{
+		const int packetNum = (std::min)(4, _rayNum - first);
 
-		XMVECTOR tempInter;
-		if (Collision::CheckRay2Triangle(localRay, mesh, nullptr, &tempInter)) {
+		// オブジェクトのローカル座標系でのレイを得る
+		Ray localRays[4];
+		XMFLOAT4A invDirs[3] = {};
+		for (int i = 0; i < packetNum; i++)
+		{
+			localRays[i].start = XMVector3Transform(_rays[first + i].start, invMatWorld);
+			localRays[i].dir = XMVector3TransformNormal(_rays[first + i].dir, invMatWorld);
+			const XMFLOAT3 invDir = Collision::ComputeInvDir(localRays[i].dir);
+			(&invDirs[0].x)[i] = invDir.x;
+			(&invDirs[1].x)[i] = invDir.y;
+			(&invDirs[2].x)[i] = invDir.z;
+		}
 
-			const XMMATRIX& matWorld = GetObject3d()->GetMatWorld();
+		Ray4 ray4;
+		ray4.Set(localRays, packetNum);
+		const XMVECTOR invDirX = XMLoadFloat4A(&invDirs[0]);
+		const XMVECTOR invDirY = XMLoadFloat4A(&invDirs[1]);
+		const XMVECTOR invDirZ = XMLoadFloat4A(&invDirs[2]);
 
-			tempInter = XMVector3Transform(tempInter, matWorld);
+		//レイごとの最も近い交点までの距離
+		XMFLOAT4A closest = { D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX, D3D12_FLOAT32_MAX };
+		int hitMask = 0;
 
-			if (_distance) {
-				XMVECTOR sub = tempInter - _ray.start;
-				*_distance = XMVector3Dot(sub, _ray.dir).m128_f32[0];
+		if (!bvhNodes.empty())
+		{
+			//ノードと、そのノードに当たる可能性のあるレイのビットを積む
+			//（レイが離れていても、各レイが辿るノードは1本ずつ辿る場合と変わらない）
+			int stack[bvhStackSize];
+			int stackMask[bvhStackSize];
+			int stackSize = 0;
+			stack[stackSize] = 0;
+			stackMask[stackSize++] = (1 << packetNum) - 1;
+			while (stackSize > 0)
+			{
+				stackSize--;
+				const BVH_NODE& node = bvhNodes[stack[stackSize]];
+
+				//AABBに当たるレイだけを残す
+				const int activeMask = stackMask[stackSize] &
+					Collision::CheckRay4AABB(ray4, invDirX, invDirY, invDirZ, node.min, node.max, XMLoadFloat4A(&closest));
+				if (activeMask == 0) { continue; }
+
+				//節
+				if (node.count == 0)
+				{
+					stack[stackSize] = node.start;
+					stackMask[stackSize++] = activeMask;
+					stack[stackSize] = node.start + 1;
+					stackMask[stackSize++] = activeMask;
+					continue;
+				}
+
+				//葉（三角形4つずつ、残ったレイ1本ごとにSIMDで判定する）
+				for (int i = 0; i < node.count; i += 4)
+				{
+					//量子化している場合はその場でSoA形式に復元し、残ったレイで使い回す
+					Triangle4 tempPack;
+					const Triangle4* pack = &tempPack;
+					if (trianglePacks.empty()) {
+						collisionMesh.GetTriangle4(node.start + i, (std::min)(4, node.count - i), &tempPack);
+					}
+					else {
+						pack = &trianglePacks[node.packStart + i / 4];
+					}
+
+					for (int ray = 0; ray < packetNum; ray++)
+					{
+						if (((activeMask >> ray) & 1) == 0) { continue; }
+
+						float tempDistance;
+						if (!Collision::CheckRay2Triangle4(localRays[ray], *pack, (&closest.x)[ray], &tempDistance)) { continue; }
+
+						(&closest.x)[ray] = tempDistance;
+						hitMask |= 1 << ray;
+					}
+				}
 			}
+		}
+
+		for (int i = 0; i < packetNum; i++)
+		{
+			const int rayIndex = first + i;
+			_isHits[rayIndex] = ((hitMask >> i) & 1) != 0;
+			if (!_isHits[rayIndex]) { continue; }
+
+			hitNum++;
+			XMVECTOR closestInter = localRays[i].start + (&closest.x)[i] * localRays[i].dir;
+			XMVECTOR worldInter = XMVector3Transform(closestInter, matWorld);
 
-			if (_inter) {
-				*_inter = tempInter;
+			if (_distances) {
+				XMVECTOR sub = worldInter - _rays[rayIndex].start;
+				_distances[rayIndex] = XMVector3Dot(sub, _rays[rayIndex].dir).m128_f32[0];
 			}
 
-			return true;
+			if (_inters) {
+				_inters[rayIndex] = worldInter;
+			}
 		}
 	}
 
-	return false;
+	return hitNum;
 }
 
-bool MeshCollider::CheckCollisionCapsule(const Capsule& _capsule)
+bool MeshCollider::CheckCollisionCapsule(const Capsule& _capsule, DirectX::XMVECTOR* _inter)
 {
-	// オブジェクトのローカル座標系での球を得る（半径はXスケールを参照)
+	if (bvhNodes.empty()) { return false; }
+
+	// オブジェクトのローカル座標系でのカプセルを得る（半径はXスケールを参照)
 	Capsule localCapsule;
 	localCapsule.startPosition = _capsule.startPosition.DirectXVector3Transform(invMatWorld);
 	localCapsule.endPosition = _capsule.endPosition.DirectXVector3Transform(invMatWorld);
-	localCapsule.radius *= XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+	localCapsule.radius = _capsule.radius * XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+
+	//カプセルを囲むAABB
+	const XMFLOAT3 capsuleMin = {
+		(std::min)(localCapsule.startPosition.x, localCapsule.endPosition.x) - localCapsule.radius,
+		(std::min)(localCapsule.startPosition.y, localCapsule.endPosition.y) - localCapsule.radius,
+		(std::min)(localCapsule.startPosition.z, localCapsule.endPosition.z) - localCapsule.radius };
+	const XMFLOAT3 capsuleMax = {
+		(std::max)(localCapsule.startPosition.x, localCapsule.endPosition.x) + localCapsule.radius,
+		(std::max)(localCapsule.startPosition.y, localCapsule.endPosition.y) + localCapsule.radius,
+		(std::max)(localCapsule.startPosition.z, localCapsule.endPosition.z) + localCapsule.radius };
+
+	int stack[bvhStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const BVH_NODE& node = bvhNodes[stack[--stackSize]];
+		if (!CheckAABB2AABB(capsuleMin, capsuleMax, node.min, node.max)) { continue; }
 
-	XMVECTOR worldmax = XMVector3Transform(max, matWorld);
-	XMVECTOR worldmin = XMVector3Transform(min, matWorld);
+		//節
+		if (node.count == 0)
+		{
+			stack[stackSize++] = node.start;
+			stack[stackSize++] = node.start + 1;
+			continue;
+		}
 
-	if (_capsule.startPosition.x < worldmin.m128_f32[0] || _capsule.startPosition.x > worldmax.m128_f32[0] ||
-		_capsule.startPosition.z <  worldmin.m128_f32[2] || _capsule.startPosition.z >  worldmax.m128_f32[2] ||
-		_capsule.endPosition.x < worldmin.m128_f32[0] || _capsule.endPosition.x > worldmax.m128_f32[0] ||
-		_capsule.endPosition.z <  worldmin.m128_f32[2] || _capsule.endPosition.z >  worldmax.m128_f32[2])
-	{
-		return false;
+		//葉
+		for (int i = node.start; i < node.start + node.count; i++)
+		{
+			Triangle triangle;
+			collisionMesh.GetTriangle(i, &triangle);
+			XMVECTOR tempInter;
+			if (Collision::CheckCapsule2Triangle(localCapsule, triangle, &tempInter)) {
+				if (_inter) {
+					*_inter = XMVector3Transform(tempInter, matWorld);
+				}
+				return true;
+			}
+		}
 	}
 
-	//プレイヤーの八分木位置
-	const XMINT2 Octree[2] = {
-		OctreeSet({ localCapsule.startPosition.x,localCapsule.startPosition.y,localCapsule.startPosition.z }),
-		OctreeSet({ localCapsule.endPosition.x,localCapsule.endPosition.y,localCapsule.endPosition.z })
-	};
+	return false;
+}
+
+bool MeshCollider::CheckCollisionOBB(const OBB& _obb, DirectX::XMVECTOR* _inter)
+{
+	if (bvhNodes.empty()) { return false; }
+
+	// オブジェクトのローカル座標系でのOBBを得る（大きさはXスケールを参照)
+	const float scale = XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+	OBB localOBB;
+	localOBB.center = XMVector3Transform(_obb.center, invMatWorld);
+	for (int i = 0; i < 3; i++)
+	{
+		localOBB.axis[i] = XMVector3Normalize(XMVector3TransformNormal(_obb.axis[i], invMatWorld));
+		(&localOBB.halfSize.x)[i] = (&_obb.halfSize.x)[i] * scale;
+	}
 
-	const int roopNum = 1 + (Octree[0] != Octree[1]);
+	//OBBを囲むAABB
+	XMFLOAT3 obbMin, obbMax;
+	localOBB.GetBounds(&obbMin, &obbMax);
 
-	for (int i = 0; i < roopNum; i++)
+	int stack[bvhStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
 	{
-		std::vector<Triangle>::const_iterator it = triangle[Octree[i].x][Octree[i].y].cbegin();
+		const BVH_NODE& node = bvhNodes[stack[--stackSize]];
+		if (!CheckAABB2AABB(obbMin, obbMax, node.min, node.max)) { continue; }
 
-		for (; it != triangle[Octree[i].x][Octree[i].y].cend(); ++it) {
-			const Triangle& mesh = *it;
+		//節
+		if (node.count == 0)
+		{
+			stack[stackSize++] = node.start;
+			stack[stackSize++] = node.start + 1;
+			continue;
+		}
 
-			if (Collision::CheckTriangleCapsule(mesh, localCapsule)) {
+		//葉
+		for (int i = node.start; i < node.start + node.count; i++)
+		{
+			Triangle triangle;
+			collisionMesh.GetTriangle(i, &triangle);
+			XMVECTOR tempInter;
+			if (Collision::CheckOBB2Triangle(localOBB, triangle, &tempInter)) {
+				if (_inter) {
+					*_inter = XMVector3Transform(tempInter, matWorld);
+				}
 				return true;
 			}
 		}
 	}
 
-	//for (int x = 0; x < 8; x++)
-	//{
-	//	for (int y = 0; y < 8; y++)
-	//	{
-	//		std::vector<Triangle>::const_iterator it = triangle[x][y].cbegin();
+	return false;
+}
 
-	//		for (; it != triangle[x][y].cend(); ++it) {
-	//			const Triangle& mesh = *it;
+bool MeshCollider::SweepSphere(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement,
+	float* _time, DirectX::XMVECTOR* _inter, DirectX::XMVECTOR* _normal)
+{
+	if (bvhNodes.empty()) { return false; }
 
-	//			if (Collision::CheckTriangleCapsule(mesh, localCapsule)) {
-	//				return true;
-	//			}
-	//		}
-	//	}
-	//}
+	// オブジェクトのローカル座標系での球と移動量を得る（半径はXスケールを参照)
+	Sphere localSphere;
+	localSphere.center = XMVector3Transform(_sphere.center, invMatWorld);
+	localSphere.radius = _sphere.radius * XMVector3Length(invMatWorld.r[0]).m128_f32[0];
+	const XMVECTOR localDisplacement = XMVector3TransformNormal(_displacement, invMatWorld);
+
+	//球の中心の軌跡を、半径だけ広げたノードのAABBに対するレイとして扱う
+	const XMFLOAT3 start = { localSphere.center.m128_f32[0],localSphere.center.m128_f32[1],localSphere.center.m128_f32[2] };
+	const XMFLOAT3 invDir = Collision::ComputeInvDir(localDisplacement);
+	const float radius = localSphere.radius;
+
+	float hitTime = 1.0f;
+	XMVECTOR hitInter = {};
+	XMVECTOR hitNormal = {};
+	bool isHit = false;
+
+	int stack[bvhStackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const BVH_NODE& node = bvhNodes[stack[--stackSize]];
+		const XMFLOAT3 nodeMin = { node.min.x - radius, node.min.y - radius, node.min.z - radius };
+		const XMFLOAT3 nodeMax = { node.max.x + radius, node.max.y + radius, node.max.z + radius };
+		//既に見つけた接触より後にしか届かないノードは辿らない
+		if (!Collision::CheckRay2AABB(start, invDir, nodeMin, nodeMax, isHit ? hitTime : hitTime + 1.0e-6f)) { continue; }
+
+		//節
+		if (node.count == 0)
+		{
+			stack[stackSize++] = node.start;
+			stack[stackSize++] = node.start + 1;
+			continue;
+		}
 
-	return false;
+		//葉
+		for (int i = node.start; i < node.start + node.count; i++)
+		{
+			Triangle triangle;
+			collisionMesh.GetTriangle(i, &triangle);
+			float time;
+			XMVECTOR inter, normal;
+			if (!Collision::CheckSweptSphere2Triangle(localSphere, localDisplacement, triangle, &time, &inter, &normal)) { continue; }
+			if (isHit && time >= hitTime) { continue; }
+
+			isHit = true;
+			hitTime = time;
+			hitInter = inter;
+			hitNormal = normal;
+		}
+
+		//開始時点で接触しているならそれより早い接触はない
+		if (isHit && hitTime <= 0.0f) { break; }
+	}
+
+	if (!isHit) { return false; }
+
+	if (_time) {
+		*_time = hitTime;
+	}
+	if (_inter) {
+		*_inter = XMVector3Transform(hitInter, matWorld);
+	}
+	if (_normal) {
+		//法線は逆行列の転置で戻す
+		*_normal = XMVector3Normalize(XMVector3TransformNormal(hitNormal, XMMatrixTranspose(invMatWorld)));
+	}
+	return true;
 }
\ No newline at end of file
@@ -2,8 +2,11 @@
 
 #include "BaseCollider.h"
 #include "CollisionPrimitive.h"
+#include "ContactManifold.h"
+#include "CollisionMesh.h"
 
 #include <DirectXMath.h>
+#include <string>
 #include "PrimitiveObject3D.h"
 
 #include "Vector3.h"
@@ -14,6 +17,51 @@
 class MeshCollider :
 	public BaseCollider
 {
+private: // サブクラス
+
+	// BVHノード
+	struct BVH_NODE
+	{
+		// AABB最小値
+		DirectX::XMFLOAT3 min;
+		// AABB最大値
+		DirectX::XMFLOAT3 max;
+		// 葉なら三角形の開始番号、節なら左の子のノード番号（右の子は+1）
+		int start;
+		// 葉の三角形数（0なら節）
+		int count;
+		// 葉のSoA三角形パックの開始番号
+		int packStart;
+	};
+
+	// BVH構築用の三角形情報
+	struct BVH_PRIMITIVE
+	{
+		// AABB最小値
+		DirectX::XMFLOAT3 min;
+		// AABB最大値
+		DirectX::XMFLOAT3 max;
+		// 重心
+		DirectX::XMFLOAT3 centroid;
+		// 元の三角形番号
+		int index;
+	};
+
+	// 調理済みデータのヘッダ
+	struct COOKED_HEADER
+	{
+		// ファイル識別子
+		char magic[4];
+		// 形式のバージョン
+		uint32_t version;
+		// BVHノードの数
+		uint32_t nodeNum;
+		// SoA三角形パックの数
+		uint32_t packNum;
+		// 元の頂点座標・インデックス・量子化の有無のハッシュ
+		uint64_t sourceHash;
+	};
+
 public:
 	MeshCollider()
 	{
@@ -22,36 +70,60 @@ public:
 	}
 
 	/// <summary>
-	/// 八分木の最大最小の保存
+	/// メッシュ全体の最大最小の保存
 	/// </summary>
 	/// <param name="_model">モデル</param>
 	void MinMax(Model* _model);
 
 	/// <summary>
-	/// 八分木の最大最小の保存
+	/// メッシュ全体の最大最小の保存
 	/// </summary>
 	/// <param name="_vertices">頂点</param>
 	void MinMax(const std::vector<Mesh::VERTEX>& _vertices);
 
-	/// <summary>
-	/// 八分木の現在地セット
-	/// </summary>
-	/// <param name="_pos">座標</param>
-	/// <returns>現在番号</returns>
-	DirectX::XMINT2 OctreeSet(const DirectX::XMFLOAT3& _pos);
-
 	/// <summary>
 	/// 三角形の配列を構築する
 	/// </summary>
 	/// <param name="_model">モデル</param>
-	void ConstructTriangles(Model* _model);
+	/// <param name="_isQuantize">頂点座標を16bitに量子化してメモリを節約するか</param>
+	void ConstructTriangles(Model* _model, bool _isQuantize = false);
 
 	/// <summary>
 	/// 三角形の配列を構築する
 	/// </summary>
 	/// <param name="_vertices">頂点</param>
 	/// <param name="_indices">インデック</param>
-	void ConstructTriangles(const std::vector<Mesh::VERTEX>& _vertices, const std::vector<unsigned long>& _indices);
+	/// <param name="_isQuantize">頂点座標を16bitに量子化してメモリを節約するか</param>
+	void ConstructTriangles(const std::vector<Mesh::VERTEX>& _vertices, const std::vector<unsigned long>& _indices, bool _isQuantize = false);
+
+	/// <summary>
+	/// 調理済みデータがあれば読み込み、なければ三角形の配列を構築して書き出す
+	/// （モデルの頂点座標・インデックスのハッシュが一致しなければ作り直す）
+	/// </summary>
+	/// <param name="_model">モデル</param>
+	/// <param name="_cookedFilename">調理済みデータのファイル名</param>
+	/// <param name="_isQuantize">頂点座標を16bitに量子化してメモリを節約するか</param>
+	void ConstructTrianglesWithCache(Model* _model, const std::string& _cookedFilename, bool _isQuantize = false);
+
+	/// <summary>
+	/// 構築済みの判定データ（メッシュとBVH）をバイナリファイルへ書き出す
+	/// </summary>
+	/// <param name="_filename">ファイル名</param>
+	/// <returns>成功か</returns>
+	bool SaveCookedData(const std::string& _filename) const;
+
+	/// <summary>
+	/// SaveCookedDataで書き出した判定データを読み込む（メモリマップし、解析せずに複写する）
+	/// </summary>
+	/// <param name="_filename">ファイル名</param>
+	/// <returns>成功か</returns>
+	bool LoadCookedData(const std::string& _filename);
+
+	/// <summary>
+	/// 判定用データが使用しているメモリ量を取得
+	/// </summary>
+	/// <returns>バイト数</returns>
+	size_t GetMemorySize() const;
 
 	/// <summary>
 	/// 更新
@@ -73,7 +145,15 @@ public:
 	bool CheckCollisionSphere(const Sphere& _sphere, DirectX::XMVECTOR* _inter = nullptr, DirectX::XMVECTOR* _reject = nullptr);
 
 	/// <summary>
-	/// レイとの当たり判定
+	/// 球との当たり判定（重なる三角形を全て接触点として集める）
+	/// </summary>
+	/// <param name="_sphere">球</param>
+	/// <param name="_manifold">接触点の追加先</param>
+	/// <returns>交差しているか否か</returns>
+	bool CheckCollisionSphereContacts(const Sphere& _sphere, ContactManifold* _manifold);
+
+	/// <summary>
+	/// レイとの当たり判定（最も近い交点を返す）
 	/// </summary>
 	/// <param name="_sphere">レイ</param>
 	/// <param name="_distance">距離（出力用）</param>
@@ -81,25 +161,129 @@ public:
 	/// <returns>交差しているか否か</returns>
 	bool CheckCollisionRay(const Ray& _ray, float* _distance, DirectX::XMVECTOR* _inter);
 
+	/// <summary>
+	/// 複数のレイとの当たり判定（4本ずつまとめてBVHを辿り、レイごとに最も近い交点を返す）
+	/// ノードのAABBは4本同時に判定し、葉ではAABBに当たったレイだけを三角形4つずつ判定する
+	/// </summary>
+	/// <param name="_rays">レイの配列</param>
+	/// <param name="_rayNum">レイの数</param>
+	/// <param name="_isHits">レイごとに交差しているか否か（出力用）</param>
+	/// <param name="_distances">レイごとの距離（出力用）</param>
+	/// <param name="_inters">レイごとの交点（出力用）</param>
+	/// <returns>交差したレイの数</returns>
+	int CheckCollisionRays(const Ray* _rays, int _rayNum, bool* _isHits,
+		float* _distances = nullptr, DirectX::XMVECTOR* _inters = nullptr);
+
 	/// <summary>
 	/// カプセルとの当たり判定
 	/// </summary>
 	/// <param name="_capsule">カプセル</param>
+	/// <param name="_inter">交点（出力用）</param>
 	/// <returns>交差しているか否か</returns>
-	bool CheckCollisionCapsule(const Capsule& _capsule);
+	bool CheckCollisionCapsule(const Capsule& _capsule, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// OBBとの当たり判定
+	/// </summary>
+	/// <param name="_obb">OBB</param>
+	/// <param name="_inter">交点（出力用）</param>
+	/// <returns>交差しているか否か</returns>
+	bool CheckCollisionOBB(const OBB& _obb, DirectX::XMVECTOR* _inter = nullptr);
+
+	/// <summary>
+	/// 移動する球との当たり判定（最初に接触する時刻を求める）
+	/// </summary>
+	/// <param name="_sphere">移動する球（移動開始時）</param>
+	/// <param name="_displacement">移動量</param>
+	/// <param name="_time">最初に接触する時刻0～1（出力用）</param>
+	/// <param name="_inter">接触点（出力用）</param>
+	/// <param name="_normal">接触面の法線（出力用）</param>
+	/// <returns>移動中に接触するか否か</returns>
+	bool SweepSphere(const Sphere& _sphere, const DirectX::XMVECTOR& _displacement,
+		float* _time, DirectX::XMVECTOR* _inter = nullptr, DirectX::XMVECTOR* _normal = nullptr);
+
+private:
+
+	/// <summary>
+	/// 判定用メッシュを生成し、BVHを構築する
+	/// </summary>
+	/// <param name="_positions">頂点座標</param>
+	/// <param name="_indices">インデックス</param>
+	/// <param name="_isQuantize">頂点座標を量子化するか</param>
+	void CreateCollisionMesh(const std::vector<DirectX::XMFLOAT3>& _positions, const std::vector<uint32_t>& _indices, bool _isQuantize);
+
+	/// <summary>
+	/// モデルの全メッシュの頂点座標とインデックスを1つの配列にまとめる
+	/// </summary>
+	/// <param name="_model">モデル</param>
+	/// <param name="_positions">頂点座標（出力用）</param>
+	/// <param name="_indices">インデックス（出力用）</param>
+	static void GatherTriangles(Model* _model, std::vector<DirectX::XMFLOAT3>& _positions, std::vector<uint32_t>& _indices);
+
+	/// <summary>
+	/// 判定用メッシュの元データのハッシュ
+	/// </summary>
+	/// <param name="_positions">頂点座標</param>
+	/// <param name="_indices">インデックス</param>
+	/// <param name="_isQuantize">頂点座標を量子化するか</param>
+	/// <returns>ハッシュ値</returns>
+	static uint64_t HashSource(const std::vector<DirectX::XMFLOAT3>& _positions, const std::vector<uint32_t>& _indices, bool _isQuantize);
+
+	/// <summary>
+	/// 読み込んだBVHのノードが三角形・パック・ノードの範囲内を指しているか
+	/// </summary>
+	/// <returns>走査して安全か</returns>
+	bool IsValidBVH() const;
+
+	/// <summary>
+	/// 視覚化用オブジェクトに判定用メッシュの頂点をセットする
+	/// </summary>
+	void SetDebugVertices();
+
+	/// <summary>
+	/// 三角形配列からBVHを構築する
+	/// </summary>
+	void BuildBVH();
+
+	/// <summary>
+	/// ノードを表面積ヒューリスティック(SAH)で分割する
+	/// </summary>
+	/// <param name="_nodeIndex">ノード番号</param>
+	/// <param name="_primitives">構築用の三角形情報</param>
+	/// <param name="_depth">ノードの深さ</param>
+	void SubdivideNode(int _nodeIndex, std::vector<BVH_PRIMITIVE>& _primitives, int _depth);
+
+	/// <summary>
+	/// ノードのAABBを所属する三角形から計算する
+	/// </summary>
+	/// <param name="_node">ノード</param>
+	/// <param name="_primitives">構築用の三角形情報</param>
+	void UpdateNodeBounds(BVH_NODE& _node, const std::vector<BVH_PRIMITIVE>& _primitives);
 
 private:
 
-	//八分木分割個数
-	static const int octreeSplit = 8;
-	//判定用メッシュの情報
-	std::array<std::array<std::vector<Triangle>, octreeSplit>, octreeSplit> triangle;
-	//八分木の最小値
+	//葉に入れる三角形の最大数
+	static const int bvhLeafSize = 4;
+	//SAHで評価する分割候補の数
+	static const int bvhBinNum = 12;
+	//BVHの最大の深さ（走査用スタックの大きさを超えないようにする）
+	static const int bvhMaxDepth = 60;
+	//BVH走査用スタックの大きさ
+	static const int bvhStackSize = 64;
+	//調理済みデータの形式のバージョン（BVH_NODEやCollisionMeshの形式を変えたら上げる）
+	static const uint32_t cookedVersion = 2;
+	//判定用メッシュ（三角形はBVHの葉の順に並ぶ）
+	CollisionMesh collisionMesh;
+	//BVHノード（0番が根）
+	std::vector<BVH_NODE> bvhNodes;
+	//葉の三角形を4つずつまとめたSoA形式（レイ判定用、量子化時はメモリ節約のため持たない）
+	std::vector<Triangle4> trianglePacks;
+	//判定用メッシュの元データのハッシュ（調理済みデータに書き出す）
+	uint64_t sourceHash = 0;
+	//メッシュ全体の最小値
 	DirectX::XMVECTOR min = {};
-	//八分木の最大値
+	//メッシュ全体の最大値
 	DirectX::XMVECTOR max = {};
-	//八分木の分割範囲
-	DirectX::XMFLOAT3 octtreeRange[9] = {};
 	// ワールド行列
 	DirectX::XMMATRIX matWorld;
 	// ワールド行列の逆行列
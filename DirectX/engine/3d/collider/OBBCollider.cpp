@@ -0,0 +1,25 @@
+﻿#include "OBBCollider.h"
+
+using namespace DirectX;
+
+void OBBCollider::Update()
+{
+	const XMMATRIX& matWorld = object3d->GetMatWorld();
+
+	// ボックスのメンバ変数を更新（ワールド行列の各行から軸と拡大率を取り出す）
+	OBB::center = XMVector3Transform(offset, matWorld);
+	for (int i = 0; i < 3; i++)
+	{
+		const float scale = XMVector3Length(matWorld.r[i]).m128_f32[0];
+		OBB::axis[i] = XMVector3Normalize(XMVectorSetW(matWorld.r[i], 0.0f));
+		(&OBB::halfSize.x)[i] = (&halfSize.x)[i] * scale;
+	}
+
+	// ブロードフェーズ用のAABBを更新
+	GetBounds(&aabbMin, &aabbMax);
+	UpdateProxy();
+}
+
+void OBBCollider::Draw()
+{
+}
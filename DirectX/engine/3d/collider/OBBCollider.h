@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "BaseCollider.h"
+#include "CollisionPrimitive.h"
+
+#include <DirectXMath.h>
+
+/// <summary>
+/// 有向ボックス衝突判定オブジェクト
+/// （中心のオフセットと大きさはオブジェクトのローカル座標で持ち、ワールド行列で回転・拡大する）
+/// </summary>
+class OBBCollider : public BaseCollider, public OBB
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMVECTOR = DirectX::XMVECTOR;
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+public:
+	OBBCollider(XMVECTOR _offset = { 0,0,0,0 }, const XMFLOAT3& _halfSize = { 0.5f,0.5f,0.5f }) :
+		offset(_offset),
+		halfSize(_halfSize)
+	{
+		// 有向ボックス形状をセット
+		shapeType = COLLISIONSHAPE_OBB;
+	}
+
+	/// <summary>
+	/// 更新
+	/// </summary>
+	void Update() override;
+
+	/// <summary>
+	/// 判定描画
+	/// </summary>
+	void Draw() override;
+
+	inline const XMVECTOR& GetOffset() { return offset; }
+
+	inline void SetOffset(const XMVECTOR& _offset) { this->offset = _offset; }
+
+	inline const XMFLOAT3& GetHalfSize() { return halfSize; }
+
+	inline void SetHalfSize(const XMFLOAT3& _halfSize) { this->halfSize = _halfSize; }
+
+private:
+	// オブジェクトのローカル座標での中心
+	XMVECTOR offset;
+	// オブジェクトのローカル座標での各軸方向の大きさの半分
+	XMFLOAT3 halfSize;
+};
@@ -10,6 +10,11 @@ void SphereCollider::Update()
 	// 球のメンバ変数を更新
 	Sphere::center = matWorld.r[3] + offset;
 	Sphere::radius = radius;
+
+	// ブロードフェーズ用のAABBを更新
+	aabbMin = { center.m128_f32[0] - radius, center.m128_f32[1] - radius, center.m128_f32[2] - radius };
+	aabbMax = { center.m128_f32[0] + radius, center.m128_f32[1] + radius, center.m128_f32[2] + radius };
+	UpdateProxy();
 }
 
 void SphereCollider::Draw()
@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include "BaseCollider.h"
+#include <DirectXMath.h>
+
+class InterfaceObject3d;
+
+/// <summary>
+/// スイープ（移動する形状の連続判定）による情報を得る為の構造体
+/// </summary>
+struct SWEEP_HIT
+{
+	// 衝突相手のオブジェクト
+	InterfaceObject3d* object = nullptr;
+	// 衝突相手のコライダー
+	BaseCollider* collider = nullptr;
+	// 最初に接触する時刻（0で移動開始時、1で移動終了時）
+	float time = 0.0f;
+	// 接触点
+	DirectX::XMVECTOR inter;
+	// 接触面の法線（衝突相手から離れる向き）
+	DirectX::XMVECTOR normal;
+};
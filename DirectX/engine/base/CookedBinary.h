@@ -0,0 +1,142 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/// <summary>
+/// ς݃oCi̓ǂݏ⏕
+/// ieubN16oCgEɑA}bv擪炻̂܂܎QƂł悤ɂj
+/// </summary>
+class CookedBinary
+{
+public:
+
+	//ubN̋E
+	static const size_t alignment = 16;
+
+	/// <summary>
+	/// EɑubN̑傫
+	/// </summary>
+	/// <param name="_size">oCg</param>
+	/// <returns>EɑoCg</returns>
+	static size_t AlignSize(size_t _size) { return (_size + alignment - 1) / alignment * alignment; }
+
+	/// <summary>
+	/// f[^̃nbViFNV-1a8oCg悤ɂ́Aς݃f[^ÂȂĂȂ̊mFpj
+	/// iǂݍ݂̂тɌt@CŜʂ̂ŁA1oCg葬Ăj
+	/// </summary>
+	/// <param name="_data">f[^̐擪</param>
+	/// <param name="_size">oCg</param>
+	/// <param name="_hash">ČvZꍇ͑Ǒ</param>
+	/// <returns>nbVl</returns>
+	static uint64_t Hash(const void* _data, size_t _size, uint64_t _hash = 14695981039346656037ull)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(_data);
+		size_t i = 0;
+		for (; i + sizeof(uint64_t) <= _size; i += sizeof(uint64_t))
+		{
+			//Z͉ʂʂւ`Ȃ̂ŁAʂʂ֐܂Ԃ
+			uint64_t word;
+			memcpy(&word, bytes + i, sizeof(word));
+			_hash = (_hash ^ word) * 1099511628211ull;
+			_hash ^= _hash >> 32;
+		}
+		for (; i < _size; i++)
+		{
+			_hash ^= bytes[i];
+			_hash *= 1099511628211ull;
+		}
+		return _hash;
+	}
+
+	/// <summary>
+	/// zoAE܂0Ŗ߂
+	/// </summary>
+	/// <param name="_fp">o</param>
+	/// <param name="_data">z̐擪</param>
+	/// <param name="_count">vf</param>
+	/// <returns></returns>
+	template <class T>
+	static bool Write(FILE* _fp, const T* _data, size_t _count)
+	{
+		const size_t size = sizeof(T) * _count;
+		if (size > 0 && fwrite(_data, 1, size, _fp) != size) { return false; }
+
+		const char padding[alignment] = {};
+		const size_t paddingSize = AlignSize(size) - size;
+		return paddingSize == 0 || fwrite(padding, 1, paddingSize, _fp) == paddingSize;
+	}
+
+	/// <summary>
+	/// zǂݍ݁AE܂œǂݐi߂
+	/// </summary>
+	/// <param name="_cursor">ǂݍ݈ʒuiǂݍ񂾕i߂j</param>
+	/// <param name="_end">f[^̏I[</param>
+	/// <param name="_data">ǂݍݐ</param>
+	/// <param name="_count">vf</param>
+	/// <returns></returns>
+	template <class T>
+	static bool Read(const char*& _cursor, const char* _end, T* _data, size_t _count)
+	{
+		if (!IsAvailable<T>(_cursor, _end, _count)) { return false; }
+
+		const size_t size = sizeof(T) * _count;
+
+		if (size > 0) { memcpy(_data, _cursor, size); }
+		_cursor += AlignSize(size);
+		return true;
+	}
+
+	/// <summary>
+	/// zǂݍ݁AE܂œǂݐi߂
+	/// </summary>
+	/// <param name="_cursor">ǂݍ݈ʒuiǂݍ񂾕i߂j</param>
+	/// <param name="_end">f[^̏I[</param>
+	/// <param name="_data">ǂݍݐivfɍ킹j</param>
+	/// <param name="_count">vf</param>
+	/// <returns></returns>
+	template <class T>
+	static bool Read(const char*& _cursor, const char* _end, std::vector<T>& _data, size_t _count)
+	{
+		//ꂽvfŋȊmۂȂ悤AɎc̑傫m߂
+		if (!IsAvailable<T>(_cursor, _end, _count)) { return false; }
+
+		_data.resize(_count);
+		return Read(_cursor, _end, _data.data(), _count);
+	}
+
+	/// <summary>
+	/// zRs[ɎQƂAE܂œǂݐi߂if[^̐擪EɑĂOj
+	/// </summary>
+	/// <param name="_cursor">ǂݍ݈ʒuiǂݍ񂾕i߂j</param>
+	/// <param name="_end">f[^̏I[</param>
+	/// <param name="_data">z̐擪io͗pAvf0Ȃnullptrj</param>
+	/// <param name="_count">vf</param>
+	/// <returns></returns>
+	template <class T>
+	static bool Map(const char*& _cursor, const char* _end, const T** _data, size_t _count)
+	{
+		if (!IsAvailable<T>(_cursor, _end, _count)) { return false; }
+
+		*_data = _count > 0 ? reinterpret_cast<const T*>(_cursor) : nullptr;
+		_cursor += AlignSize(sizeof(T) * _count);
+		return true;
+	}
+
+private:
+
+	/// <summary>
+	/// ǂݍ݈ʒuvf̃ubNcĂ邩ivfĂĂӂꂵȂj
+	/// </summary>
+	/// <param name="_cursor">ǂݍ݈ʒu</param>
+	/// <param name="_end">f[^̏I[</param>
+	/// <param name="_count">vf</param>
+	/// <returns>cĂ邩</returns>
+	template <class T>
+	static bool IsAvailable(const char* _cursor, const char* _end, size_t _count)
+	{
+		const size_t available = static_cast<size_t>(_end - _cursor);
+		return _count <= available / sizeof(T) && AlignSize(sizeof(T) * _count) <= available;
+	}
+};
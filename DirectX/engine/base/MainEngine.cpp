@@ -12,6 +12,7 @@
 #include "GraphicsPipelineManager.h"
 #include "Texture.h"
 #include "HeightMap.h"
+#include "TransformSystem.h"
 
 using namespace DirectX;
 using namespace Microsoft::WRL;
@@ -80,6 +81,9 @@ bool MainEngine::Update()
 	//XV
 	//Fbx::SetCubeTex(cubemap->SetTexture());
 	scene->Update();
+	//V[̍XVŔfꂽ[JlAgXtH[̐eqKw1xɂ܂Ƃ߂čXV
+	//i`撆̃IuWFNg̓[hsǂނj
+	TransformSystem::GetInstance()->Update();
 	//cubemap->Update();
 
 	return false;
@@ -0,0 +1,111 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::string& _filename)
+{
+	Close();
+
+#ifdef _WIN32
+	//t@CJ
+	HANDLE file = CreateFileA(_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	fileHandle = file;
+
+	//傫擾ĩt@C̓}bvłȂj
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+	size = static_cast<size_t>(fileSize.QuadPart);
+
+	//ǂݍݐpŃ}bv
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+	mappingHandle = mapping;
+
+	data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (data == nullptr)
+	{
+		Close();
+		return false;
+	}
+#else
+	//t@CJ
+	const int file = open(_filename.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	//傫擾ĩt@C̓}bvłȂj
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+	size = static_cast<size_t>(fileStat.st_size);
+
+	//ǂݍݐpŃ}bvi}bv̓t@CĂ悢j
+	void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (mapped == MAP_FAILED)
+	{
+		size = 0;
+		return false;
+	}
+	data = static_cast<const char*>(mapped);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (data)
+	{
+		UnmapViewOfFile(data);
+		data = nullptr;
+	}
+	if (mappingHandle)
+	{
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+	}
+	if (fileHandle)
+	{
+		CloseHandle(fileHandle);
+		fileHandle = nullptr;
+	}
+#else
+	if (data)
+	{
+		munmap(const_cast<char*>(data), size);
+		data = nullptr;
+	}
+#endif
+	size = 0;
+}
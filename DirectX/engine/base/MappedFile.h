@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+
+/// <summary>
+/// ǂݍݐpŃ}bvt@C
+/// </summary>
+class MappedFile
+{
+public:
+
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/// <summary>
+	/// t@CJă}bv
+	/// </summary>
+	/// <param name="_filename">t@C</param>
+	/// <returns></returns>
+	bool Open(const std::string& _filename);
+
+	/// <summary>
+	/// }bvăt@C
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// t@C̐擪AhX擾
+	/// </summary>
+	/// <returns>擪AhXiJĂȂnullptrj</returns>
+	const char* GetData() const { return data; }
+
+	/// <summary>
+	/// t@C̑傫擾
+	/// </summary>
+	/// <returns>oCg</returns>
+	size_t GetSize() const { return size; }
+
+private:
+
+	//t@Cnh
+	void* fileHandle = nullptr;
+	//t@C}bsOnh
+	void* mappingHandle = nullptr;
+	//}bvt@C̐擪
+	const char* data = nullptr;
+	//t@C̑傫
+	size_t size = 0;
+};
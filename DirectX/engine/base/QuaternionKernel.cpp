@@ -0,0 +1,138 @@
+﻿#include "QuaternionKernel.h"
+#include "SimdMath.h"
+#include "Quaternion.h"
+
+#include <algorithm>
+
+using namespace SimdMath;
+
+namespace
+{
+	/// <summary>
+	/// 最大4個分のクォータニオンを読み、成分ごとに並べ替える（足りない分は最後の1個を繰り返す）
+	/// </summary>
+	/// <param name="_source">読み込み元</param>
+	/// <param name="_count">個数（1～4）</param>
+	/// <returns>r[0]～r[3]にx,y,z,wの4個分</returns>
+	Mat4 LoadSoA4(const Quaternion* _source, int _count)
+	{
+		Mat4 result;
+		for (int i = 0; i < 4; i++)
+		{
+			result.r[i] = detail::Load4(&_source[(std::min)(i, _count - 1)].x);
+		}
+		return Transpose(result);
+	}
+
+	/// <summary>
+	/// 最大4個分の補間係数を読む（足りない分は最後の1個を繰り返す）
+	/// </summary>
+	/// <param name="_source">読み込み元</param>
+	/// <param name="_count">個数（1～4）</param>
+	/// <returns>4個分の補間係数</returns>
+	detail::Float4 LoadFactors(const float* _source, int _count)
+	{
+		if (_count == 4) {
+			return detail::Load4(_source);
+		}
+		return detail::Set(_source[0], _source[(std::min)(1, _count - 1)],
+			_source[(std::min)(2, _count - 1)], _source[_count - 1]);
+	}
+
+	/// <summary>
+	/// 成分ごとに並べた4個分を正規化し、元の並びに戻して書き出す
+	/// </summary>
+	/// <param name="_soa">r[0]～r[3]にx,y,z,wの4個分</param>
+	/// <param name="_count">書き出す個数（1～4）</param>
+	/// <param name="_results">書き出し先</param>
+	void NormalizeStoreSoA4(Mat4 _soa, int _count, Quaternion* _results)
+	{
+		detail::Float4 lengthSq = detail::Mul(_soa.r[0], _soa.r[0]);
+		for (int i = 1; i < 4; i++)
+		{
+			lengthSq = detail::MulAdd(_soa.r[i], _soa.r[i], lengthSq);
+		}
+		const detail::Float4 invLength = detail::Div(detail::Splat(1.0f), detail::Sqrt(lengthSq));
+		for (int i = 0; i < 4; i++)
+		{
+			_soa.r[i] = detail::Mul(_soa.r[i], invLength);
+		}
+
+		const Mat4 aos = Transpose(_soa);
+		for (int i = 0; i < _count; i++)
+		{
+			detail::Store4(&_results[i].x, aos.r[i]);
+		}
+	}
+
+	/// <summary>
+	/// 4組分の補間（始点・終点を読み、近い側を通るように終点の符号を揃えて重みを求める）
+	/// </summary>
+	/// <typeparam name="IsSlerp">slerpか（falseならnlerp）</typeparam>
+	template <bool IsSlerp>
+	void Interpolate(const Quaternion* _starts, const Quaternion* _ends, const float* _ts, int _num, Quaternion* _results)
+	{
+		const detail::Float4 one = detail::Splat(1.0f);
+		for (int i = 0; i < _num; i += 4)
+		{
+			const int count = (std::min)(_num - i, 4);
+			const Mat4 starts = LoadSoA4(&_starts[i], count);
+			Mat4 ends = LoadSoA4(&_ends[i], count);
+			const detail::Float4 t = LoadFactors(&_ts[i], count);
+
+			detail::Float4 cos = detail::Mul(starts.r[0], ends.r[0]);
+			for (int j = 1; j < 4; j++)
+			{
+				cos = detail::MulAdd(starts.r[j], ends.r[j], cos);
+			}
+
+			// 内積が負なら終点の符号を反転する（0にcosの符号を付けた値とのxor）
+			const detail::Float4 sign = detail::CopySign(detail::Zero(), cos);
+			for (int j = 0; j < 4; j++)
+			{
+				ends.r[j] = detail::Xor(ends.r[j], sign);
+			}
+			cos = detail::Abs(cos);
+
+			// nlerpの重み
+			detail::Float4 k0 = detail::Sub(one, t);
+			detail::Float4 k1 = t;
+
+			if (IsSlerp)
+			{
+				// 4組ともほぼ平行なら、nlerpの重みのままにする
+				const detail::Float4 isNear = detail::Greater(cos, detail::Splat(QuaternionKernel::nlerpThreshold));
+				if (detail::MoveMask(isNear) != 0xf)
+				{
+					// θ,(1-t)θ,tθは0～π/2に収まるので、sinは範囲を畳まずに求める
+					const detail::Float4 theta = detail::ACos(cos);
+					const detail::Float4 sinTheta = detail::Max(detail::SinReduced(theta), detail::Splat(1e-6f));
+					const detail::Float4 invSin = detail::Div(one, sinTheta);
+					const detail::Float4 slerpK0 = detail::Mul(detail::SinReduced(detail::Mul(theta, k0)), invSin);
+					const detail::Float4 slerpK1 = detail::Mul(detail::SinReduced(detail::Mul(theta, k1)), invSin);
+					k0 = detail::Select(slerpK0, k0, isNear);
+					k1 = detail::Select(slerpK1, k1, isNear);
+				}
+			}
+
+			Mat4 results;
+			for (int j = 0; j < 4; j++)
+			{
+				results.r[j] = detail::MulAdd(starts.r[j], k0, detail::Mul(ends.r[j], k1));
+			}
+			NormalizeStoreSoA4(results, count, &_results[i]);
+		}
+	}
+}
+
+const float QuaternionKernel::nlerpThreshold = 0.9995f;
+
+void QuaternionKernel::Slerp(const Quaternion* _starts, const Quaternion* _ends, const float* _ts, int _num, Quaternion* _results)
+{
+	Interpolate<true>(_starts, _ends, _ts, _num, _results);
+}
+
+void QuaternionKernel::Nlerp(const Quaternion* _starts, const Quaternion* _ends, const float* _ts, int _num, Quaternion* _results)
+{
+	Interpolate<false>(_starts, _ends, _ts, _num, _results);
+}
@@ -0,0 +1,38 @@
+﻿#pragma once
+
+struct Quaternion;
+
+/// <summary>
+/// クォータニオンの補間をまとめて行う処理（4組ずつ成分ごとに並べてSIMDで計算する）
+/// </summary>
+class QuaternionKernel
+{
+public:// 定数
+	// 内積がこれより大きい組（ほぼ平行）はnlerpで補間する
+	// （この範囲でのslerpとのずれは回転角で1e-6ラジアン以下）
+	static const float nlerpThreshold;
+
+public:
+
+	/// <summary>
+	/// 球面線形補間
+	/// （acosとsinを多項式で近似し、結果は正規化する。補間結果の各成分の最大誤差は1e-6程度。
+	/// 　ほぼ平行な組はnlerpに切り替え、4組とも平行ならacos・sinの計算を省く）
+	/// </summary>
+	/// <param name="_starts">始点（正規化済み）</param>
+	/// <param name="_ends">終点（正規化済み、始点との内積が負なら符号を反転して近い側を通る）</param>
+	/// <param name="_ts">補間係数（0～1）</param>
+	/// <param name="_num">個数</param>
+	/// <param name="_results">補間結果（出力用、_num個）</param>
+	static void Slerp(const Quaternion* _starts, const Quaternion* _ends, const float* _ts, int _num, Quaternion* _results);
+
+	/// <summary>
+	/// 正規化線形補間（角度差が大きいほど速さが一定でなくなるが、slerpより軽い）
+	/// </summary>
+	/// <param name="_starts">始点（正規化済み）</param>
+	/// <param name="_ends">終点（正規化済み、始点との内積が負なら符号を反転して近い側を通る）</param>
+	/// <param name="_ts">補間係数（0～1）</param>
+	/// <param name="_num">個数</param>
+	/// <param name="_results">補間結果（出力用、_num個）</param>
+	static void Nlerp(const Quaternion* _starts, const Quaternion* _ends, const float* _ts, int _num, Quaternion* _results);
+};
@@ -0,0 +1,724 @@
+﻿#pragma once
+
+// SIMD演算をまとめたヘッダオンリーの数学ライブラリ
+// （16byte境界に揃えたVec3A・Vec4・Mat4・Quatを提供し、既存のVector3・Quaternion・Matrix4と相互に変換できる）
+//
+// 使う命令セットはコンパイラの設定から決まる
+//   AVX2（__AVX2__）: 行列積を2行ずつ256bitで計算し、FMAがあれば積和に使う
+//   SSE4.1（__SSE4_1__）: 内積にdpps、成分の差し替えにblendpsを使う
+//   SSE2（x64は常に有効）: 基本の実装
+//   スカラー: SSEのない環境、またはSIMD_MATH_NO_SIMDを定義した場合
+// MSVCは/arch:AVX2で__AVX2__が定義される。GCC/Clangは-msse4.1・-mavx2 -mfmaなどで切り替える
+
+#include <DirectXMath.h>
+#include <cmath>
+#include "Vector3.h"
+#include "Quaternion.h"
+#include "Matrix4.h"
+
+#if !defined(SIMD_MATH_NO_SIMD) && (defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SIMD_MATH_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define SIMD_MATH_SSE4 1
+#include <smmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define SIMD_MATH_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define SIMD_MATH_FMA 1
+#endif
+#endif
+
+namespace SimdMath
+{
+	namespace detail
+	{
+#if defined(SIMD_MATH_SSE2)
+		// 4成分のレジスタ
+		using Float4 = __m128;
+
+		inline Float4 Set(float _x, float _y, float _z, float _w) { return _mm_set_ps(_w, _z, _y, _x); }
+		inline Float4 Splat(float _s) { return _mm_set1_ps(_s); }
+		inline Float4 Zero() { return _mm_setzero_ps(); }
+		inline Float4 Load4(const float* _p) { return _mm_loadu_ps(_p); }
+		inline void Store4(float* _p, Float4 _v) { _mm_storeu_ps(_p, _v); }
+
+		inline Float4 Load3(const float* _p)
+		{
+			// xyを8byteで、zを4byteで読み、wは0にする（4成分目の先を読まない）
+			const __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(_p)));
+			const __m128 z = _mm_load_ss(_p + 2);
+			return _mm_movelh_ps(xy, z);
+		}
+
+		inline void Store3(float* _p, Float4 _v)
+		{
+			_mm_store_sd(reinterpret_cast<double*>(_p), _mm_castps_pd(_v));
+			_mm_store_ss(_p + 2, _mm_movehl_ps(_v, _v));
+		}
+
+		inline Float4 Add(Float4 _a, Float4 _b) { return _mm_add_ps(_a, _b); }
+		inline Float4 Sub(Float4 _a, Float4 _b) { return _mm_sub_ps(_a, _b); }
+		inline Float4 Mul(Float4 _a, Float4 _b) { return _mm_mul_ps(_a, _b); }
+		inline Float4 Div(Float4 _a, Float4 _b) { return _mm_div_ps(_a, _b); }
+		inline Float4 Min(Float4 _a, Float4 _b) { return _mm_min_ps(_a, _b); }
+		inline Float4 Max(Float4 _a, Float4 _b) { return _mm_max_ps(_a, _b); }
+		inline Float4 Sqrt(Float4 _v) { return _mm_sqrt_ps(_v); }
+		inline Float4 Negate(Float4 _v) { return _mm_xor_ps(_v, _mm_set1_ps(-0.0f)); }
+		inline Float4 Abs(Float4 _v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), _v); }
+		inline Float4 Xor(Float4 _a, Float4 _b) { return _mm_xor_ps(_a, _b); }
+
+		/// <summary>
+		/// _a*_b+_c（FMAがあれば丸めは1回）
+		/// </summary>
+		inline Float4 MulAdd(Float4 _a, Float4 _b, Float4 _c)
+		{
+#if defined(SIMD_MATH_FMA)
+			return _mm_fmadd_ps(_a, _b, _c);
+#else
+			return _mm_add_ps(_mm_mul_ps(_a, _b), _c);
+#endif
+		}
+
+		/// <summary>
+		/// 成分の並べ替え（結果のi番目に_v[Ii]を入れる）
+		/// </summary>
+		template <int I0, int I1, int I2, int I3>
+		inline Float4 Permute(Float4 _v) { return _mm_shuffle_ps(_v, _v, _MM_SHUFFLE(I3, I2, I1, I0)); }
+
+		template <int I>
+		inline float GetLane(Float4 _v) { return _mm_cvtss_f32(Permute<I, I, I, I>(_v)); }
+
+		/// <summary>
+		/// xyzの内積（全成分に同じ値が入る）
+		/// </summary>
+		inline Float4 Dot3(Float4 _a, Float4 _b)
+		{
+#if defined(SIMD_MATH_SSE4)
+			return _mm_dp_ps(_a, _b, 0x7f);
+#else
+			const __m128 product = _mm_mul_ps(_a, _b);
+			const __m128 sum = _mm_add_ss(_mm_add_ss(product, Permute<1, 1, 1, 1>(product)), Permute<2, 2, 2, 2>(product));
+			return Permute<0, 0, 0, 0>(sum);
+#endif
+		}
+
+		/// <summary>
+		/// xyzwの内積（全成分に同じ値が入る）
+		/// </summary>
+		inline Float4 Dot4(Float4 _a, Float4 _b)
+		{
+#if defined(SIMD_MATH_SSE4)
+			return _mm_dp_ps(_a, _b, 0xff);
+#else
+			const __m128 product = _mm_mul_ps(_a, _b);
+			const __m128 sum = _mm_add_ps(product, Permute<2, 3, 0, 1>(product));
+			return _mm_add_ps(sum, Permute<1, 0, 3, 2>(sum));
+#endif
+		}
+
+		/// <summary>
+		/// 最も近い整数に丸める（|_v|が2^31未満の範囲で使う）
+		/// </summary>
+		inline Float4 Round(Float4 _v)
+		{
+#if defined(SIMD_MATH_SSE4)
+			return _mm_round_ps(_v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else
+			return _mm_cvtepi32_ps(_mm_cvtps_epi32(_v));
+#endif
+		}
+
+		/// <summary>
+		/// _magnitudeの絶対値に_signの符号を付ける
+		/// </summary>
+		inline Float4 CopySign(Float4 _magnitude, Float4 _sign)
+		{
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+			return _mm_or_ps(_mm_andnot_ps(signMask, _magnitude), _mm_and_ps(signMask, _sign));
+		}
+
+		/// <summary>
+		/// _a>_bの成分を選ぶマスク（Selectに渡す）
+		/// </summary>
+		inline Float4 Greater(Float4 _a, Float4 _b) { return _mm_cmpgt_ps(_a, _b); }
+
+		/// <summary>
+		/// マスクが立っている成分は_b、それ以外は_aを選ぶ
+		/// </summary>
+		inline Float4 Select(Float4 _a, Float4 _b, Float4 _mask)
+		{
+#if defined(SIMD_MATH_SSE4)
+			return _mm_blendv_ps(_a, _b, _mask);
+#else
+			return _mm_or_ps(_mm_andnot_ps(_mask, _a), _mm_and_ps(_mask, _b));
+#endif
+		}
+
+		/// <summary>
+		/// マスクの各成分を1bitにまとめる（x成分が最下位bit）
+		/// </summary>
+		inline int MoveMask(Float4 _mask) { return _mm_movemask_ps(_mask); }
+
+		/// <summary>
+		/// w成分を差し替える
+		/// </summary>
+		inline Float4 SetW(Float4 _v, float _w)
+		{
+#if defined(SIMD_MATH_SSE4)
+			return _mm_blend_ps(_v, _mm_set1_ps(_w), 0x8);
+#else
+			const __m128 zw = _mm_shuffle_ps(_v, _mm_set_ss(_w), _MM_SHUFFLE(0, 0, 2, 2));
+			return _mm_shuffle_ps(_v, zw, _MM_SHUFFLE(2, 0, 1, 0));
+#endif
+		}
+#else
+		// 4成分のレジスタ（SIMDなし）
+		struct Float4
+		{
+			float f[4];
+		};
+
+		inline Float4 Set(float _x, float _y, float _z, float _w) { return { { _x, _y, _z, _w } }; }
+		inline Float4 Splat(float _s) { return { { _s, _s, _s, _s } }; }
+		inline Float4 Zero() { return { { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+		inline Float4 Load4(const float* _p) { return { { _p[0], _p[1], _p[2], _p[3] } }; }
+		inline void Store4(float* _p, Float4 _v) { for (int i = 0; i < 4; i++) { _p[i] = _v.f[i]; } }
+		inline Float4 Load3(const float* _p) { return { { _p[0], _p[1], _p[2], 0.0f } }; }
+		inline void Store3(float* _p, Float4 _v) { for (int i = 0; i < 3; i++) { _p[i] = _v.f[i]; } }
+
+		/// <summary>
+		/// 成分ごとに関数を適用する
+		/// </summary>
+		template <class Function>
+		inline Float4 Map(Float4 _a, Float4 _b, Function _function)
+		{
+			return { { _function(_a.f[0], _b.f[0]), _function(_a.f[1], _b.f[1]), _function(_a.f[2], _b.f[2]), _function(_a.f[3], _b.f[3]) } };
+		}
+
+		inline Float4 Add(Float4 _a, Float4 _b) { return Map(_a, _b, [](float _x, float _y) { return _x + _y; }); }
+		inline Float4 Sub(Float4 _a, Float4 _b) { return Map(_a, _b, [](float _x, float _y) { return _x - _y; }); }
+		inline Float4 Mul(Float4 _a, Float4 _b) { return Map(_a, _b, [](float _x, float _y) { return _x * _y; }); }
+		inline Float4 Div(Float4 _a, Float4 _b) { return Map(_a, _b, [](float _x, float _y) { return _x / _y; }); }
+		inline Float4 Min(Float4 _a, Float4 _b) { return Map(_a, _b, [](float _x, float _y) { return _x < _y ? _x : _y; }); }
+		inline Float4 Max(Float4 _a, Float4 _b) { return Map(_a, _b, [](float _x, float _y) { return _x > _y ? _x : _y; }); }
+		inline Float4 Sqrt(Float4 _v) { return Map(_v, _v, [](float _x, float) { return std::sqrt(_x); }); }
+		inline Float4 Negate(Float4 _v) { return Map(_v, _v, [](float _x, float) { return -_x; }); }
+		inline Float4 Abs(Float4 _v) { return Map(_v, _v, [](float _x, float) { return std::fabs(_x); }); }
+		inline Float4 Xor(Float4 _a, Float4 _b)
+		{
+			// 符号の反転にだけ使うので、_bが-0の成分は符号を反転する
+			return Map(_a, _b, [](float _x, float _y) { return std::signbit(_y) ? -_x : _x; });
+		}
+		inline Float4 MulAdd(Float4 _a, Float4 _b, Float4 _c) { return Add(Mul(_a, _b), _c); }
+
+		template <int I0, int I1, int I2, int I3>
+		inline Float4 Permute(Float4 _v) { return { { _v.f[I0], _v.f[I1], _v.f[I2], _v.f[I3] } }; }
+
+		template <int I>
+		inline float GetLane(Float4 _v) { return _v.f[I]; }
+
+		inline Float4 Dot3(Float4 _a, Float4 _b) { return Splat(_a.f[0] * _b.f[0] + _a.f[1] * _b.f[1] + _a.f[2] * _b.f[2]); }
+		inline Float4 Dot4(Float4 _a, Float4 _b) { return Splat(_a.f[0] * _b.f[0] + _a.f[1] * _b.f[1] + _a.f[2] * _b.f[2] + _a.f[3] * _b.f[3]); }
+		inline Float4 SetW(Float4 _v, float _w) { _v.f[3] = _w; return _v; }
+		inline Float4 Round(Float4 _v) { return Map(_v, _v, [](float _x, float) { return std::nearbyint(_x); }); }
+		inline Float4 CopySign(Float4 _magnitude, Float4 _sign) { return Map(_magnitude, _sign, [](float _x, float _y) { return std::copysign(_x, _y); }); }
+		// マスクは成分ごとに1か0で表す
+		inline Float4 Greater(Float4 _a, Float4 _b) { return Map(_a, _b, [](float _x, float _y) { return _x > _y ? 1.0f : 0.0f; }); }
+		inline Float4 Select(Float4 _a, Float4 _b, Float4 _mask)
+		{
+			return { { _mask.f[0] != 0.0f ? _b.f[0] : _a.f[0], _mask.f[1] != 0.0f ? _b.f[1] : _a.f[1],
+				_mask.f[2] != 0.0f ? _b.f[2] : _a.f[2], _mask.f[3] != 0.0f ? _b.f[3] : _a.f[3] } };
+		}
+		inline int MoveMask(Float4 _mask)
+		{
+			return (_mask.f[0] != 0.0f ? 1 : 0) | (_mask.f[1] != 0.0f ? 2 : 0) | (_mask.f[2] != 0.0f ? 4 : 0) | (_mask.f[3] != 0.0f ? 8 : 0);
+		}
+#endif
+
+		/// <summary>
+		/// -π/2～π/2の角度のsin（範囲を畳まずに11次のミニマックス多項式で近似する。最大誤差は1e-7程度）
+		/// </summary>
+		/// <param name="_angle">角度（ラジアン、|角度|≦π/2）</param>
+		/// <returns>sin</returns>
+		inline Float4 SinReduced(Float4 _angle)
+		{
+			const Float4 x2 = Mul(_angle, _angle);
+			Float4 sinPoly = MulAdd(Splat(-2.3889859e-08f), x2, Splat(2.7525562e-06f));
+			sinPoly = MulAdd(sinPoly, x2, Splat(-0.00019840874f));
+			sinPoly = MulAdd(sinPoly, x2, Splat(0.0083333310f));
+			sinPoly = MulAdd(sinPoly, x2, Splat(-0.16666667f));
+			sinPoly = MulAdd(sinPoly, x2, Splat(1.0f));
+			return Mul(sinPoly, _angle);
+		}
+
+		/// <summary>
+		/// 4つの値のacos
+		/// （0～1ではsqrt(1-x)に7次多項式を掛けて近似し、負の値はπ-acos(|x|)で求める。
+		/// 　多項式の誤差は2e-8以下で、float演算込みの最大誤差は3e-7程度）
+		/// </summary>
+		/// <param name="_x">値（-1～1）</param>
+		/// <returns>角度（ラジアン、0～π）</returns>
+		inline Float4 ACos(Float4 _x)
+		{
+			const Float4 a = Min(Abs(_x), Splat(1.0f));
+			Float4 poly = MulAdd(Splat(-0.0012624911f), a, Splat(0.0066700901f));
+			poly = MulAdd(poly, a, Splat(-0.0170881256f));
+			poly = MulAdd(poly, a, Splat(0.0308918810f));
+			poly = MulAdd(poly, a, Splat(-0.0501743046f));
+			poly = MulAdd(poly, a, Splat(0.0889789874f));
+			poly = MulAdd(poly, a, Splat(-0.2145988016f));
+			poly = MulAdd(poly, a, Splat(1.5707963050f));
+			const Float4 result = Mul(poly, Sqrt(Sub(Splat(1.0f), a)));
+			return Select(result, Sub(Splat(3.141592654f), result), Greater(Zero(), _x));
+		}
+
+		/// <summary>
+		/// 4つの角度のsinとcosを同時に求める
+		/// （-π～πへ畳み、さらに-π/2～π/2へ折り返してから11次・10次のミニマックス多項式で近似する。
+		/// 　最大誤差は|角度|が数百ラジアン以内で2e-6程度）
+		/// </summary>
+		/// <param name="_angle">角度（ラジアン）</param>
+		/// <param name="_sin">sin（出力用）</param>
+		/// <param name="_cos">cos（出力用）</param>
+		inline void SinCos(Float4 _angle, Float4* _sin, Float4* _cos)
+		{
+			const float pi = 3.141592654f;
+			Float4 x = Sub(_angle, Mul(Round(Mul(_angle, Splat(0.5f / pi))), Splat(2.0f * pi)));
+
+			// |x|>π/2なら±π-xへ折り返す（sinは同じ値、cosは符号が反転する）
+			const Float4 isReflect = Greater(Abs(x), Splat(pi * 0.5f));
+			x = Select(x, Sub(CopySign(Splat(pi), x), x), isReflect);
+			const Float4 cosSign = Select(Splat(1.0f), Splat(-1.0f), isReflect);
+
+			*_sin = SinReduced(x);
+
+			const Float4 x2 = Mul(x, x);
+			Float4 cosPoly = MulAdd(Splat(-2.6051615e-07f), x2, Splat(2.4760495e-05f));
+			cosPoly = MulAdd(cosPoly, x2, Splat(-0.0013888378f));
+			cosPoly = MulAdd(cosPoly, x2, Splat(0.041666638f));
+			cosPoly = MulAdd(cosPoly, x2, Splat(-0.5f));
+			cosPoly = MulAdd(cosPoly, x2, Splat(1.0f));
+			*_cos = Mul(cosPoly, cosSign);
+		}
+	}
+
+	/// <summary>
+	/// 使っている命令セットの名前
+	/// </summary>
+	/// <returns>"avx2"・"sse4"・"sse2"・"scalar"のいずれか</returns>
+	inline const char* GetBackendName()
+	{
+#if defined(SIMD_MATH_AVX2)
+		return "avx2";
+#elif defined(SIMD_MATH_SSE4)
+		return "sse4";
+#elif defined(SIMD_MATH_SSE2)
+		return "sse2";
+#else
+		return "scalar";
+#endif
+	}
+
+	/// <summary>
+	/// 4成分ベクトル
+	/// </summary>
+	struct alignas(16) Vec4
+	{
+		detail::Float4 v;
+
+		Vec4() : v(detail::Zero()) {}
+		explicit Vec4(detail::Float4 _v) : v(_v) {}
+		Vec4(float _x, float _y, float _z, float _w) : v(detail::Set(_x, _y, _z, _w)) {}
+		explicit Vec4(const DirectX::XMFLOAT4& _v) : v(detail::Load4(&_v.x)) {}
+
+		float X() const { return detail::GetLane<0>(v); }
+		float Y() const { return detail::GetLane<1>(v); }
+		float Z() const { return detail::GetLane<2>(v); }
+		float W() const { return detail::GetLane<3>(v); }
+
+		void Store(DirectX::XMFLOAT4* _destination) const { detail::Store4(&_destination->x, v); }
+
+		Vec4& operator+=(const Vec4& _v) { v = detail::Add(v, _v.v); return *this; }
+		Vec4& operator-=(const Vec4& _v) { v = detail::Sub(v, _v.v); return *this; }
+		Vec4& operator*=(float _s) { v = detail::Mul(v, detail::Splat(_s)); return *this; }
+		Vec4& operator/=(float _s) { v = detail::Div(v, detail::Splat(_s)); return *this; }
+	};
+
+	inline Vec4 operator-(const Vec4& _v) { return Vec4(detail::Negate(_v.v)); }
+	inline Vec4 operator+(const Vec4& _a, const Vec4& _b) { return Vec4(detail::Add(_a.v, _b.v)); }
+	inline Vec4 operator-(const Vec4& _a, const Vec4& _b) { return Vec4(detail::Sub(_a.v, _b.v)); }
+	inline Vec4 operator*(const Vec4& _a, const Vec4& _b) { return Vec4(detail::Mul(_a.v, _b.v)); }
+	inline Vec4 operator*(const Vec4& _v, float _s) { return Vec4(detail::Mul(_v.v, detail::Splat(_s))); }
+	inline Vec4 operator*(float _s, const Vec4& _v) { return Vec4(detail::Mul(_v.v, detail::Splat(_s))); }
+	inline Vec4 operator/(const Vec4& _v, float _s) { return Vec4(detail::Div(_v.v, detail::Splat(_s))); }
+	inline float Dot(const Vec4& _a, const Vec4& _b) { return detail::GetLane<0>(detail::Dot4(_a.v, _b.v)); }
+	inline Vec4 Min(const Vec4& _a, const Vec4& _b) { return Vec4(detail::Min(_a.v, _b.v)); }
+	inline Vec4 Max(const Vec4& _a, const Vec4& _b) { return Vec4(detail::Max(_a.v, _b.v)); }
+	inline Vec4 Lerp(const Vec4& _a, const Vec4& _b, float _t) { return Vec4(detail::MulAdd(detail::Sub(_b.v, _a.v), detail::Splat(_t), _a.v)); }
+
+	/// <summary>
+	/// 3成分ベクトル（4成分のレジスタに入れ、wは0で扱う）
+	/// </summary>
+	struct alignas(16) Vec3A
+	{
+		detail::Float4 v;
+
+		Vec3A() : v(detail::Zero()) {}
+		explicit Vec3A(detail::Float4 _v) : v(_v) {}
+		Vec3A(float _x, float _y, float _z) : v(detail::Set(_x, _y, _z, 0.0f)) {}
+		explicit Vec3A(const DirectX::XMFLOAT3& _v) : v(detail::Load3(&_v.x)) {}
+
+		float X() const { return detail::GetLane<0>(v); }
+		float Y() const { return detail::GetLane<1>(v); }
+		float Z() const { return detail::GetLane<2>(v); }
+
+		void Store(DirectX::XMFLOAT3* _destination) const { detail::Store3(&_destination->x, v); }
+
+		/// <summary>
+		/// 既存のVector3へ変換
+		/// </summary>
+		/// <returns>Vector3</returns>
+		Vector3 ToVector3() const
+		{
+			Vector3 result;
+			detail::Store3(&result.x, v);
+			return result;
+		}
+
+		Vec3A& operator+=(const Vec3A& _v) { v = detail::Add(v, _v.v); return *this; }
+		Vec3A& operator-=(const Vec3A& _v) { v = detail::Sub(v, _v.v); return *this; }
+		Vec3A& operator*=(float _s) { v = detail::Mul(v, detail::Splat(_s)); return *this; }
+		Vec3A& operator/=(float _s) { v = detail::Div(v, detail::Splat(_s)); return *this; }
+	};
+
+	inline Vec3A operator-(const Vec3A& _v) { return Vec3A(detail::Negate(_v.v)); }
+	inline Vec3A operator+(const Vec3A& _a, const Vec3A& _b) { return Vec3A(detail::Add(_a.v, _b.v)); }
+	inline Vec3A operator-(const Vec3A& _a, const Vec3A& _b) { return Vec3A(detail::Sub(_a.v, _b.v)); }
+	inline Vec3A operator*(const Vec3A& _a, const Vec3A& _b) { return Vec3A(detail::Mul(_a.v, _b.v)); }
+	inline Vec3A operator*(const Vec3A& _v, float _s) { return Vec3A(detail::Mul(_v.v, detail::Splat(_s))); }
+	inline Vec3A operator*(float _s, const Vec3A& _v) { return Vec3A(detail::Mul(_v.v, detail::Splat(_s))); }
+	inline Vec3A operator/(const Vec3A& _v, float _s) { return Vec3A(detail::Div(_v.v, detail::Splat(_s))); }
+	inline float Dot(const Vec3A& _a, const Vec3A& _b) { return detail::GetLane<0>(detail::Dot3(_a.v, _b.v)); }
+	inline float LengthSq(const Vec3A& _v) { return Dot(_v, _v); }
+	inline float Length(const Vec3A& _v) { return detail::GetLane<0>(detail::Sqrt(detail::Dot3(_v.v, _v.v))); }
+	inline Vec3A Min(const Vec3A& _a, const Vec3A& _b) { return Vec3A(detail::Min(_a.v, _b.v)); }
+	inline Vec3A Max(const Vec3A& _a, const Vec3A& _b) { return Vec3A(detail::Max(_a.v, _b.v)); }
+	inline Vec3A Abs(const Vec3A& _v) { return Vec3A(detail::Abs(_v.v)); }
+	inline Vec3A Lerp(const Vec3A& _a, const Vec3A& _b, float _t) { return Vec3A(detail::MulAdd(detail::Sub(_b.v, _a.v), detail::Splat(_t), _a.v)); }
+
+	inline Vec3A Cross(const Vec3A& _a, const Vec3A& _b)
+	{
+		// (a.yzx*b.zxy - a.zxy*b.yzx)、wは0*0-0*0で0のまま
+		const detail::Float4 aYZX = detail::Permute<1, 2, 0, 3>(_a.v);
+		const detail::Float4 bYZX = detail::Permute<1, 2, 0, 3>(_b.v);
+		const detail::Float4 crossZXY = detail::Sub(detail::Mul(_a.v, bYZX), detail::Mul(aYZX, _b.v));
+		return Vec3A(detail::Permute<1, 2, 0, 3>(crossZXY));
+	}
+
+	inline Vec3A Normalize(const Vec3A& _v)
+	{
+		// 長さ0のベクトルはそのまま返す（Vector3::normalizeと同じ）
+		const float length = Length(_v);
+		return length != 0.0f ? _v / length : _v;
+	}
+
+	/// <summary>
+	/// 4x4行列（DirectXと同じ行ベクトル形式で、v*Mで変換する）
+	/// </summary>
+	struct alignas(16) Mat4
+	{
+		detail::Float4 r[4];
+
+		Mat4() : r{ detail::Set(1, 0, 0, 0), detail::Set(0, 1, 0, 0), detail::Set(0, 0, 1, 0), detail::Set(0, 0, 0, 1) } {}
+		Mat4(detail::Float4 _r0, detail::Float4 _r1, detail::Float4 _r2, detail::Float4 _r3) : r{ _r0, _r1, _r2, _r3 } {}
+
+		/// <summary>
+		/// 既存のMatrix4（XMMATRIX）から変換
+		/// </summary>
+		/// <param name="_m">行列</param>
+		explicit Mat4(const Matrix4& _m)
+		{
+			const float* source = reinterpret_cast<const float*>(&_m);
+			for (int i = 0; i < 4; i++)
+			{
+				r[i] = detail::Load4(source + i * 4);
+			}
+		}
+
+		/// <summary>
+		/// 既存のMatrix4（XMMATRIX）へ変換
+		/// </summary>
+		/// <returns>Matrix4</returns>
+		Matrix4 ToMatrix4() const
+		{
+			Matrix4 result;
+			float* destination = reinterpret_cast<float*>(&result);
+			for (int i = 0; i < 4; i++)
+			{
+				detail::Store4(destination + i * 4, r[i]);
+			}
+			return result;
+		}
+
+		static Mat4 Identity() { return Mat4(); }
+
+		static Mat4 Scaling(const Vec3A& _s)
+		{
+			return Mat4(detail::Set(_s.X(), 0, 0, 0), detail::Set(0, _s.Y(), 0, 0), detail::Set(0, 0, _s.Z(), 0), detail::Set(0, 0, 0, 1));
+		}
+
+		static Mat4 Translation(const Vec3A& _t)
+		{
+			return Mat4(detail::Set(1, 0, 0, 0), detail::Set(0, 1, 0, 0), detail::Set(0, 0, 1, 0), detail::SetW(_t.v, 1.0f));
+		}
+
+		static Mat4 RotationX(float _angle)
+		{
+			const float s = std::sin(_angle);
+			const float c = std::cos(_angle);
+			return Mat4(detail::Set(1, 0, 0, 0), detail::Set(0, c, s, 0), detail::Set(0, -s, c, 0), detail::Set(0, 0, 0, 1));
+		}
+
+		static Mat4 RotationY(float _angle)
+		{
+			const float s = std::sin(_angle);
+			const float c = std::cos(_angle);
+			return Mat4(detail::Set(c, 0, -s, 0), detail::Set(0, 1, 0, 0), detail::Set(s, 0, c, 0), detail::Set(0, 0, 0, 1));
+		}
+
+		static Mat4 RotationZ(float _angle)
+		{
+			const float s = std::sin(_angle);
+			const float c = std::cos(_angle);
+			return Mat4(detail::Set(c, s, 0, 0), detail::Set(-s, c, 0, 0), detail::Set(0, 0, 1, 0), detail::Set(0, 0, 0, 1));
+		}
+	};
+
+	/// <summary>
+	/// 行ベクトル1本と行列の積
+	/// </summary>
+	inline detail::Float4 MultiplyRow(detail::Float4 _row, const Mat4& _m)
+	{
+		detail::Float4 result = detail::Mul(detail::Permute<0, 0, 0, 0>(_row), _m.r[0]);
+		result = detail::MulAdd(detail::Permute<1, 1, 1, 1>(_row), _m.r[1], result);
+		result = detail::MulAdd(detail::Permute<2, 2, 2, 2>(_row), _m.r[2], result);
+		return detail::MulAdd(detail::Permute<3, 3, 3, 3>(_row), _m.r[3], result);
+	}
+
+	inline Mat4 operator*(const Mat4& _a, const Mat4& _b)
+	{
+#if defined(SIMD_MATH_AVX2)
+		// 2行ずつ256bitに詰め、右辺の各行を上下に複製して掛ける
+		const __m256 b0 = _mm256_broadcast_ps(&_b.r[0]);
+		const __m256 b1 = _mm256_broadcast_ps(&_b.r[1]);
+		const __m256 b2 = _mm256_broadcast_ps(&_b.r[2]);
+		const __m256 b3 = _mm256_broadcast_ps(&_b.r[3]);
+		__m256 rows[2];
+		for (int i = 0; i < 2; i++)
+		{
+			const __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_a.r[i * 2]), _a.r[i * 2 + 1], 1);
+			__m256 result = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0);
+#if defined(SIMD_MATH_FMA)
+			result = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0x55), b1, result);
+			result = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xaa), b2, result);
+			result = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xff), b3, result);
+#else
+			result = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), b1), result);
+			result = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xaa), b2), result);
+			result = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xff), b3), result);
+#endif
+			rows[i] = result;
+		}
+		return Mat4(_mm256_castps256_ps128(rows[0]), _mm256_extractf128_ps(rows[0], 1),
+			_mm256_castps256_ps128(rows[1]), _mm256_extractf128_ps(rows[1], 1));
+#else
+		return Mat4(MultiplyRow(_a.r[0], _b), MultiplyRow(_a.r[1], _b), MultiplyRow(_a.r[2], _b), MultiplyRow(_a.r[3], _b));
+#endif
+	}
+
+	inline Mat4& operator*=(Mat4& _a, const Mat4& _b) { _a = _a * _b; return _a; }
+
+	inline Mat4 Transpose(const Mat4& _m)
+	{
+#if defined(SIMD_MATH_SSE2)
+		Mat4 result = _m;
+		_MM_TRANSPOSE4_PS(result.r[0], result.r[1], result.r[2], result.r[3]);
+		return result;
+#else
+		Mat4 result;
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				result.r[i].f[j] = _m.r[j].f[i];
+			}
+		}
+		return result;
+#endif
+	}
+
+	/// <summary>
+	/// 座標の変換（w=1として平行移動も含める。射影による除算はしない）
+	/// </summary>
+	inline Vec3A TransformPoint(const Vec3A& _v, const Mat4& _m)
+	{
+		detail::Float4 result = detail::MulAdd(detail::Permute<0, 0, 0, 0>(_v.v), _m.r[0], _m.r[3]);
+		result = detail::MulAdd(detail::Permute<1, 1, 1, 1>(_v.v), _m.r[1], result);
+		result = detail::MulAdd(detail::Permute<2, 2, 2, 2>(_v.v), _m.r[2], result);
+		return Vec3A(detail::SetW(result, 0.0f));
+	}
+
+	/// <summary>
+	/// 向きの変換（w=0として平行移動を含めない）
+	/// </summary>
+	inline Vec3A TransformNormal(const Vec3A& _v, const Mat4& _m)
+	{
+		detail::Float4 result = detail::Mul(detail::Permute<0, 0, 0, 0>(_v.v), _m.r[0]);
+		result = detail::MulAdd(detail::Permute<1, 1, 1, 1>(_v.v), _m.r[1], result);
+		result = detail::MulAdd(detail::Permute<2, 2, 2, 2>(_v.v), _m.r[2], result);
+		return Vec3A(detail::SetW(result, 0.0f));
+	}
+
+	inline Vec4 Transform(const Vec4& _v, const Mat4& _m) { return Vec4(MultiplyRow(_v.v, _m)); }
+
+	/// <summary>
+	/// クォータニオン（x,y,zが虚部、wが実部。積はQuaternionと同じハミルトン積）
+	/// </summary>
+	struct alignas(16) Quat
+	{
+		detail::Float4 v;
+
+		Quat() : v(detail::Set(0.0f, 0.0f, 0.0f, 1.0f)) {}
+		explicit Quat(detail::Float4 _v) : v(_v) {}
+		Quat(float _x, float _y, float _z, float _w) : v(detail::Set(_x, _y, _z, _w)) {}
+
+		/// <summary>
+		/// 既存のQuaternionから変換（成分の並びが同じなのでそのまま読む）
+		/// </summary>
+		/// <param name="_q">クォータニオン</param>
+		explicit Quat(const Quaternion& _q) : v(detail::Load4(&_q.x)) {}
+
+		/// <summary>
+		/// 既存のQuaternionへ変換
+		/// </summary>
+		/// <returns>Quaternion</returns>
+		Quaternion ToQuaternion() const
+		{
+			Quaternion result;
+			detail::Store4(&result.x, v);
+			return result;
+		}
+
+		float X() const { return detail::GetLane<0>(v); }
+		float Y() const { return detail::GetLane<1>(v); }
+		float Z() const { return detail::GetLane<2>(v); }
+		float W() const { return detail::GetLane<3>(v); }
+
+		static Quat Identity() { return Quat(); }
+
+		/// <summary>
+		/// 任意軸まわりの回転
+		/// </summary>
+		/// <param name="_axis">回転軸（正規化済み）</param>
+		/// <param name="_angle">回転角（ラジアン）</param>
+		static Quat AxisAngle(const Vec3A& _axis, float _angle)
+		{
+			const float s = std::sin(_angle * 0.5f);
+			return Quat(detail::SetW(detail::Mul(_axis.v, detail::Splat(s)), std::cos(_angle * 0.5f)));
+		}
+	};
+
+	inline Quat operator-(const Quat& _q) { return Quat(detail::Negate(_q.v)); }
+	inline Quat operator+(const Quat& _a, const Quat& _b) { return Quat(detail::Add(_a.v, _b.v)); }
+	inline Quat operator-(const Quat& _a, const Quat& _b) { return Quat(detail::Sub(_a.v, _b.v)); }
+	inline Quat operator*(const Quat& _q, float _s) { return Quat(detail::Mul(_q.v, detail::Splat(_s))); }
+	inline Quat operator*(float _s, const Quat& _q) { return Quat(detail::Mul(_q.v, detail::Splat(_s))); }
+	inline float Dot(const Quat& _a, const Quat& _b) { return detail::GetLane<0>(detail::Dot4(_a.v, _b.v)); }
+
+	inline Quat operator*(const Quat& _a, const Quat& _b)
+	{
+		// a.x*( bw,-bz, by,-bx) + a.y*( bz, bw,-bx,-by) + a.z*(-by, bx, bw,-bz) + a.w*b
+		const detail::Float4 signX = detail::Set(0.0f, -0.0f, 0.0f, -0.0f);
+		const detail::Float4 signY = detail::Set(0.0f, 0.0f, -0.0f, -0.0f);
+		const detail::Float4 signZ = detail::Set(-0.0f, 0.0f, 0.0f, -0.0f);
+		detail::Float4 result = detail::Mul(detail::Permute<3, 3, 3, 3>(_a.v), _b.v);
+		result = detail::MulAdd(detail::Permute<0, 0, 0, 0>(_a.v), detail::Xor(detail::Permute<3, 2, 1, 0>(_b.v), signX), result);
+		result = detail::MulAdd(detail::Permute<1, 1, 1, 1>(_a.v), detail::Xor(detail::Permute<2, 3, 0, 1>(_b.v), signY), result);
+		result = detail::MulAdd(detail::Permute<2, 2, 2, 2>(_a.v), detail::Xor(detail::Permute<1, 0, 3, 2>(_b.v), signZ), result);
+		return Quat(result);
+	}
+
+	inline Quat& operator*=(Quat& _a, const Quat& _b) { _a = _a * _b; return _a; }
+
+	inline Quat Conjugate(const Quat& _q) { return Quat(detail::Xor(_q.v, detail::Set(-0.0f, -0.0f, -0.0f, 0.0f))); }
+
+	inline Quat Normalize(const Quat& _q)
+	{
+		const detail::Float4 lengthSq = detail::Dot4(_q.v, _q.v);
+		if (detail::GetLane<0>(lengthSq) == 0.0f) { return _q; }
+		return Quat(detail::Div(_q.v, detail::Sqrt(lengthSq)));
+	}
+
+	/// <summary>
+	/// ベクトルの回転（q*v*conj(q)を v + 2w(u×v) + 2u×(u×v) で求める）
+	/// </summary>
+	inline Vec3A Rotate(const Vec3A& _v, const Quat& _q)
+	{
+		const Vec3A u(detail::SetW(_q.v, 0.0f));
+		const Vec3A uv = Cross(u, _v) * 2.0f;
+		return _v + uv * _q.W() + Cross(u, uv);
+	}
+
+	/// <summary>
+	/// 回転行列へ変換（Quaternionのrotateと同じ行列）
+	/// </summary>
+	inline Mat4 ToMat4(const Quat& _q)
+	{
+		const float x = _q.X(), y = _q.Y(), z = _q.Z(), w = _q.W();
+		const float xx = x * x * 2.0f, yy = y * y * 2.0f, zz = z * z * 2.0f;
+		const float xy = x * y * 2.0f, xz = x * z * 2.0f, yz = y * z * 2.0f;
+		const float wx = w * x * 2.0f, wy = w * y * 2.0f, wz = w * z * 2.0f;
+		return Mat4(
+			detail::Set(1.0f - yy - zz, xy + wz, xz - wy, 0.0f),
+			detail::Set(xy - wz, 1.0f - xx - zz, yz + wx, 0.0f),
+			detail::Set(xz + wy, yz - wx, 1.0f - xx - yy, 0.0f),
+			detail::Set(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	/// <summary>
+	/// 正規化線形補間（近い側の経路を通る）
+	/// </summary>
+	inline Quat Nlerp(const Quat& _a, const Quat& _b, float _t)
+	{
+		const Quat b = Dot(_a, _b) < 0.0f ? -_b : _b;
+		return Normalize(Quat(detail::MulAdd(detail::Sub(b.v, _a.v), detail::Splat(_t), _a.v)));
+	}
+
+	/// <summary>
+	/// 球面線形補間（Quaternionのslerpと同じく、ほぼ同じ向きなら線形補間にする）
+	/// </summary>
+	inline Quat Slerp(const Quat& _a, const Quat& _b, float _t)
+	{
+		float cos = Dot(_a, _b);
+		Quat b = _b;
+		if (cos < 0.0f)
+		{
+			cos = -cos;
+			b = -_b;
+		}
+		float k0 = 1.0f - _t;
+		float k1 = _t;
+		if ((1.0f - cos) > 0.001f)
+		{
+			const float theta = std::acos(cos);
+			const float invSin = 1.0f / std::sin(theta);
+			k0 = std::sin(theta * k0) * invSin;
+			k1 = std::sin(theta * k1) * invSin;
+		}
+		return Quat(detail::MulAdd(_a.v, detail::Splat(k0), detail::Mul(b.v, detail::Splat(k1))));
+	}
+}
@@ -0,0 +1,99 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool* ThreadPool::GetInstance()
+{
+	static ThreadPool instance;
+	return &instance;
+}
+
+ThreadPool::ThreadPool()
+{
+	//ĂяõXbĥŁA_RA-1̃[J[N
+	const int hardwareNum = static_cast<int>(std::thread::hardware_concurrency());
+	const int workerNum = (std::max)(hardwareNum - 1, 0);
+	workers.reserve(workerNum);
+	for (int i = 0; i < workerNum; i++)
+	{
+		workers.emplace_back(&ThreadPool::WorkerMain, this, i + 1);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isExit = true;
+	}
+	startCondition.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::ParallelFor(int _count, int _grainSize, const RangeFunction& _function)
+{
+	if (_count <= 0) { return; }
+	_grainSize = (std::max)(_grainSize, 1);
+
+	//̗ʂA܂͓q̌ĂяoȂ炻̏ŏ
+	if (workers.empty() || _count <= _grainSize || isRunning)
+	{
+		_function(0, _count, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		function = &_function;
+		count = _count;
+		grainSize = _grainSize;
+		nextIndex = 0;
+		runningNum = static_cast<int>(workers.size());
+		isRunning = true;
+		generation++;
+	}
+	startCondition.notify_all();
+
+	//ĂяõXbhɉ
+	RunRanges(0);
+
+	//SẴ[J[dI܂ő҂
+	std::unique_lock<std::mutex> lock(mutex);
+	finishCondition.wait(lock, [this]() { return runningNum == 0; });
+	function = nullptr;
+	isRunning = false;
+}
+
+void ThreadPool::WorkerMain(int _threadIndex)
+{
+	unsigned int doneGeneration = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			startCondition.wait(lock, [this, doneGeneration]() { return isExit || generation != doneGeneration; });
+			if (isExit) { return; }
+			doneGeneration = generation;
+		}
+
+		RunRanges(_threadIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			runningNum--;
+		}
+		finishCondition.notify_one();
+	}
+}
+
+void ThreadPool::RunRanges(int _threadIndex)
+{
+	while (true)
+	{
+		const int start = nextIndex.fetch_add(grainSize);
+		if (start >= count) { return; }
+		(*function)(start, (std::min)(start + grainSize, count), _threadIndex);
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/// <summary>
+/// 풓[J[Xbhŏ𕪒S
+/// </summary>
+class ThreadPool
+{
+public:
+
+	/// <summary>
+	/// ͈͏̊֐iJnԍ, Iԍi܂܂Ȃj, Xbhԍj
+	/// </summary>
+	using RangeFunction = std::function<void(int _start, int _end, int _threadIndex)>;
+
+	/// <summary>
+	/// CX^X̎擾
+	/// </summary>
+	/// <returns>CX^X</returns>
+	static ThreadPool* GetInstance();
+
+	/// <summary>
+	/// sXbh̐擾iĂяõXbh܂ށj
+	/// </summary>
+	/// <returns>Xbh̐</returns>
+	int GetThreadNum() const { return static_cast<int>(workers.size()) + 1; }
+
+	/// <summary>
+	/// 0`_count-1 _grainSizeɋ؂ASXbhŕSď
+	/// iSďI܂Ŗ߂ȂBĂяõXbhԍ0j
+	/// </summary>
+	/// <param name="_count">vf</param>
+	/// <param name="_grainSize">1xɎovf</param>
+	/// <param name="_function">͈͏̊֐</param>
+	void ParallelFor(int _count, int _grainSize, const RangeFunction& _function);
+
+private:
+	ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	~ThreadPool();
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// [J[Xbh̏
+	/// </summary>
+	/// <param name="_threadIndex">Xbhԍ</param>
+	void WorkerMain(int _threadIndex);
+
+	/// <summary>
+	/// ̎d͈͂oď
+	/// </summary>
+	/// <param name="_threadIndex">Xbhԍ</param>
+	void RunRanges(int _threadIndex);
+
+private:
+
+	//[J[Xbh
+	std::vector<std::thread> workers;
+	//d̎󂯓np
+	std::mutex mutex;
+	//d̊JnEI̒ʒm
+	std::condition_variable startCondition;
+	std::condition_variable finishCondition;
+	//̎d
+	const RangeFunction* function = nullptr;
+	//vf
+	int count = 0;
+	//1xɎovf
+	int grainSize = 1;
+	//Ɏovfԍ
+	std::atomic<int> nextIndex{ 0 };
+	//d̒ʂԍi[J[Vdj
+	unsigned int generation = 0;
+	//d̃[J[̐
+	int runningNum = 0;
+	//diq̌Ăяo͂̏ŏj
+	std::atomic<bool> isRunning{ false };
+	//Iv
+	bool isExit = false;
+};
@@ -0,0 +1,162 @@
+﻿#include "TransformKernel.h"
+#include "SimdMath.h"
+#include "Quaternion.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace DirectX;
+using namespace SimdMath;
+
+namespace
+{
+	/// <summary>
+	/// 最大4個分の3成分を読み、成分ごとに並べ替える（足りない分は最後の1個を繰り返す）
+	/// </summary>
+	/// <param name="_source">読み込み元</param>
+	/// <param name="_count">個数（1～4）</param>
+	/// <returns>r[0]がx、r[1]がy、r[2]がzの4個分</returns>
+	Mat4 LoadSoA3(const XMFLOAT3* _source, int _count)
+	{
+		Mat4 result;
+		for (int i = 0; i < 4; i++)
+		{
+			result.r[i] = detail::Load3(&_source[(std::min)(i, _count - 1)].x);
+		}
+		return Transpose(result);
+	}
+
+	/// <summary>
+	/// 成分ごとに並べた3x3の回転・拡大と座標から行列を組み立てて書き出す
+	/// </summary>
+	/// <param name="_rows">_rows[行][列]に4個分の成分</param>
+	/// <param name="_positions">r[0]～r[2]に4個分の座標</param>
+	/// <param name="_count">書き出す個数（1～4）</param>
+	/// <param name="_matWorlds">書き出し先</param>
+	void StoreSoAMatrices(const detail::Float4 _rows[3][3], const Mat4& _positions, int _count, XMMATRIX* _matWorlds)
+	{
+		const detail::Float4 zero = detail::Zero();
+		const detail::Float4 one = detail::Splat(1.0f);
+		Mat4 rows[4] = {
+			Transpose(Mat4(_rows[0][0], _rows[0][1], _rows[0][2], zero)),
+			Transpose(Mat4(_rows[1][0], _rows[1][1], _rows[1][2], zero)),
+			Transpose(Mat4(_rows[2][0], _rows[2][1], _rows[2][2], zero)),
+			Transpose(Mat4(_positions.r[0], _positions.r[1], _positions.r[2], one)) };
+
+		for (int i = 0; i < _count; i++)
+		{
+			float* destination = reinterpret_cast<float*>(&_matWorlds[i]);
+			for (int row = 0; row < 4; row++)
+			{
+				detail::Store4(destination + row * 4, rows[row].r[i]);
+			}
+		}
+	}
+}
+
+void TransformKernel::ComposeEuler(const XMFLOAT3* _positions, const XMFLOAT3* _rotations,
+	const XMFLOAT3* _scales, int _num, XMMATRIX* _matWorlds)
+{
+	const detail::Float4 toRadian = detail::Splat(XM_PI / 180.0f);
+	for (int start = 0; start < _num; start += 4)
+	{
+		const int count = (std::min)(4, _num - start);
+		const Mat4 positions = LoadSoA3(_positions + start, count);
+		const Mat4 rotations = LoadSoA3(_rotations + start, count);
+		const Mat4 scales = LoadSoA3(_scales + start, count);
+
+		// x軸回り(pitch)・y軸回り(yaw)・z軸回り(roll)のsin,cos
+		detail::Float4 sp, cp, sy, cy, sr, cr;
+		detail::SinCos(detail::Mul(rotations.r[0], toRadian), &sp, &cp);
+		detail::SinCos(detail::Mul(rotations.r[1], toRadian), &sy, &cy);
+		detail::SinCos(detail::Mul(rotations.r[2], toRadian), &sr, &cr);
+
+		// Rz*Rx*Ryを展開した式に、各行へスケールを掛ける
+		const detail::Float4 spsy = detail::Mul(sp, sy);
+		const detail::Float4 spcy = detail::Mul(sp, cy);
+		const detail::Float4 rows[3][3] = {
+			{
+				detail::Mul(detail::MulAdd(sr, spsy, detail::Mul(cr, cy)), scales.r[0]),
+				detail::Mul(detail::Mul(sr, cp), scales.r[0]),
+				detail::Mul(detail::Sub(detail::Mul(sr, spcy), detail::Mul(cr, sy)), scales.r[0]),
+			},
+			{
+				detail::Mul(detail::Sub(detail::Mul(cr, spsy), detail::Mul(sr, cy)), scales.r[1]),
+				detail::Mul(detail::Mul(cr, cp), scales.r[1]),
+				detail::Mul(detail::MulAdd(cr, spcy, detail::Mul(sr, sy)), scales.r[1]),
+			},
+			{
+				detail::Mul(detail::Mul(cp, sy), scales.r[2]),
+				detail::Mul(detail::Negate(sp), scales.r[2]),
+				detail::Mul(detail::Mul(cp, cy), scales.r[2]),
+			},
+		};
+		StoreSoAMatrices(rows, positions, count, _matWorlds + start);
+	}
+}
+
+void TransformKernel::ComposeQuaternion(const XMFLOAT3* _positions, const Quaternion* _rotations,
+	const XMFLOAT3* _scales, int _num, XMMATRIX* _matWorlds)
+{
+	const detail::Float4 one = detail::Splat(1.0f);
+	for (int start = 0; start < _num; start += 4)
+	{
+		const int count = (std::min)(4, _num - start);
+		const Mat4 positions = LoadSoA3(_positions + start, count);
+		const Mat4 scales = LoadSoA3(_scales + start, count);
+
+		Mat4 rotations;
+		for (int i = 0; i < 4; i++)
+		{
+			rotations.r[i] = Quat(_rotations[start + (std::min)(i, count - 1)]).v;
+		}
+		rotations = Transpose(rotations);
+		const detail::Float4& x = rotations.r[0];
+		const detail::Float4& y = rotations.r[1];
+		const detail::Float4& z = rotations.r[2];
+		const detail::Float4& w = rotations.r[3];
+
+		// rotate(q)と同じ式
+		const detail::Float4 x2 = detail::Add(x, x);
+		const detail::Float4 y2 = detail::Add(y, y);
+		const detail::Float4 z2 = detail::Add(z, z);
+		const detail::Float4 xx = detail::Mul(x, x2), yy = detail::Mul(y, y2), zz = detail::Mul(z, z2);
+		const detail::Float4 xy = detail::Mul(x, y2), xz = detail::Mul(x, z2), yz = detail::Mul(y, z2);
+		const detail::Float4 wx = detail::Mul(w, x2), wy = detail::Mul(w, y2), wz = detail::Mul(w, z2);
+		const detail::Float4 rows[3][3] = {
+			{
+				detail::Mul(detail::Sub(detail::Sub(one, yy), zz), scales.r[0]),
+				detail::Mul(detail::Add(xy, wz), scales.r[0]),
+				detail::Mul(detail::Sub(xz, wy), scales.r[0]),
+			},
+			{
+				detail::Mul(detail::Sub(xy, wz), scales.r[1]),
+				detail::Mul(detail::Sub(detail::Sub(one, xx), zz), scales.r[1]),
+				detail::Mul(detail::Add(yz, wx), scales.r[1]),
+			},
+			{
+				detail::Mul(detail::Add(xz, wy), scales.r[2]),
+				detail::Mul(detail::Sub(yz, wx), scales.r[2]),
+				detail::Mul(detail::Sub(detail::Sub(one, xx), yy), scales.r[2]),
+			},
+		};
+		StoreSoAMatrices(rows, positions, count, _matWorlds + start);
+	}
+}
+
+void TransformKernel::UpdateHierarchy(const XMMATRIX* _matLocals, const int* _parents, int _num, XMMATRIX* _matWorlds)
+{
+	for (int i = 0; i < _num; i++)
+	{
+		const int parent = _parents[i];
+		if (parent < 0)
+		{
+			_matWorlds[i] = _matLocals[i];
+			continue;
+		}
+
+		// 親は先に求め終わっている
+		assert(parent < i);
+		_matWorlds[i] = (Mat4(_matLocals[i]) * Mat4(_matWorlds[parent])).ToMatrix4();
+	}
+}
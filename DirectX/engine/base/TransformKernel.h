@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include <DirectXMath.h>
+
+struct Quaternion;
+
+/// <summary>
+/// ワールド行列をまとめて作る処理（4個ずつ成分ごとに並べてSIMDで計算する）
+/// </summary>
+class TransformKernel
+{
+public:
+
+	/// <summary>
+	/// オイラー角のTRSからワールド行列を作る
+	/// （スケール→Z→X→Y軸回転→平行移動の順で、5つの行列を掛けた結果と同じになる）
+	/// </summary>
+	/// <param name="_positions">座標</param>
+	/// <param name="_rotations">X,Y,Z軸回りの回転角（度）</param>
+	/// <param name="_scales">スケール</param>
+	/// <param name="_num">個数</param>
+	/// <param name="_matWorlds">ワールド行列（出力用、_num個）</param>
+	static void ComposeEuler(const DirectX::XMFLOAT3* _positions, const DirectX::XMFLOAT3* _rotations,
+		const DirectX::XMFLOAT3* _scales, int _num, DirectX::XMMATRIX* _matWorlds);
+
+	/// <summary>
+	/// クォータニオンのTRSからワールド行列を作る（scale*rotate(q)*translateと同じ）
+	/// </summary>
+	/// <param name="_positions">座標</param>
+	/// <param name="_rotations">回転（正規化済み）</param>
+	/// <param name="_scales">スケール</param>
+	/// <param name="_num">個数</param>
+	/// <param name="_matWorlds">ワールド行列（出力用、_num個）</param>
+	static void ComposeQuaternion(const DirectX::XMFLOAT3* _positions, const Quaternion* _rotations,
+		const DirectX::XMFLOAT3* _scales, int _num, DirectX::XMMATRIX* _matWorlds);
+
+	/// <summary>
+	/// 親子階層のワールド行列を1回の走査で求める（親は必ず子より前に並べておく）
+	/// </summary>
+	/// <param name="_matLocals">親から見た行列</param>
+	/// <param name="_parents">親の番号（親がなければ-1）</param>
+	/// <param name="_num">個数</param>
+	/// <param name="_matWorlds">ワールド行列（出力用、_num個）</param>
+	static void UpdateHierarchy(const DirectX::XMMATRIX* _matLocals, const int* _parents, int _num, DirectX::XMMATRIX* _matWorlds);
+};
@@ -0,0 +1,309 @@
+﻿#include "TransformSystem.h"
+#include "TransformKernel.h"
+#include "SimdMath.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace DirectX;
+
+namespace
+{
+	/// <summary>
+	/// 3成分が全て等しいか
+	/// </summary>
+	bool IsEqual(const XMFLOAT3& _a, const XMFLOAT3& _b)
+	{
+		return _a.x == _b.x && _a.y == _b.y && _a.z == _b.z;
+	}
+
+	/// <summary>
+	/// 並べ替え後のi番目に_order[i]番目の要素が来るように並べ替える
+	/// </summary>
+	template <class T>
+	void Permute(std::vector<T>* _values, const std::vector<int>& _order)
+	{
+		std::vector<T> result;
+		result.reserve(_order.size());
+		for (int index : _order)
+		{
+			result.push_back((*_values)[index]);
+		}
+		_values->swap(result);
+	}
+}
+
+TransformSystem* TransformSystem::GetInstance()
+{
+	static TransformSystem instance;
+	return &instance;
+}
+
+int TransformSystem::Create(int _parent)
+{
+	assert(_parent == invalid_handle || (_parent < static_cast<int>(indices.size()) && indices[_parent] >= 0));
+
+	//ハンドルは削除されたものを使い回す
+	int handle;
+	if (!freeHandles.empty())
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
+	else
+	{
+		handle = static_cast<int>(indices.size());
+		indices.push_back(-1);
+	}
+
+	//末尾に追加し、次のUpdateで深さ順に並べ直す
+	const int index = static_cast<int>(handles.size());
+	indices[handle] = index;
+	positions.push_back({ 0,0,0 });
+	rotations.push_back({ 0,0,0 });
+	scales.push_back({ 1,1,1 });
+	matLocals.push_back(XMMatrixIdentity());
+	matWorlds.push_back(XMMatrixIdentity());
+	parentIndices.push_back(-1);
+	parentHandles.push_back(_parent);
+	handles.push_back(handle);
+	flags.push_back(0);
+	MarkDirty(index);
+	isSorted = false;
+
+	return handle;
+}
+
+void TransformSystem::Destroy(int _handle)
+{
+	assert(_handle >= 0 && _handle < static_cast<int>(indices.size()) && indices[_handle] >= 0);
+
+	//子は親なしにする
+	const int num = static_cast<int>(handles.size());
+	for (int i = 0; i < num; i++)
+	{
+		if (parentHandles[i] == _handle)
+		{
+			parentHandles[i] = invalid_handle;
+			MarkDirty(i);
+		}
+	}
+
+	//末尾の要素で埋める
+	const int index = indices[_handle];
+	const int last = num - 1;
+	if (index != last)
+	{
+		positions[index] = positions[last];
+		rotations[index] = rotations[last];
+		scales[index] = scales[last];
+		matLocals[index] = matLocals[last];
+		matWorlds[index] = matWorlds[last];
+		parentHandles[index] = parentHandles[last];
+		handles[index] = handles[last];
+		flags[index] = flags[last];
+		indices[handles[index]] = index;
+	}
+	positions.pop_back();
+	rotations.pop_back();
+	scales.pop_back();
+	matLocals.pop_back();
+	matWorlds.pop_back();
+	parentIndices.pop_back();
+	parentHandles.pop_back();
+	handles.pop_back();
+	flags.pop_back();
+
+	indices[_handle] = -1;
+	freeHandles.push_back(_handle);
+	isSorted = false;
+}
+
+void TransformSystem::SetParent(int _handle, int _parent)
+{
+	assert(_handle >= 0 && _handle < static_cast<int>(indices.size()) && indices[_handle] >= 0);
+
+	//自身の子孫を親にすると循環する
+	for (int ancestor = _parent; ancestor != invalid_handle; ancestor = parentHandles[indices[ancestor]])
+	{
+		assert(ancestor != _handle);
+		if (ancestor == _handle) { return; }
+	}
+
+	const int index = indices[_handle];
+	if (parentHandles[index] == _parent) { return; }
+
+	parentHandles[index] = _parent;
+	MarkDirty(index);
+	isSorted = false;
+}
+
+int TransformSystem::GetParent(int _handle) const
+{
+	return parentHandles[indices[_handle]];
+}
+
+void TransformSystem::SetLocal(int _handle, const XMFLOAT3& _position, const XMFLOAT3& _rotation, const XMFLOAT3& _scale)
+{
+	const int index = indices[_handle];
+
+	//毎フレーム同じ値をセットする静的な物体は変更として扱わない
+	if (IsEqual(positions[index], _position) && IsEqual(rotations[index], _rotation) && IsEqual(scales[index], _scale)) {
+		return;
+	}
+
+	positions[index] = _position;
+	rotations[index] = _rotation;
+	scales[index] = _scale;
+	MarkDirty(index);
+}
+
+const XMMATRIX& TransformSystem::GetMatWorld(int _handle)
+{
+	if (!isSorted || dirtyMin <= dirtyMax) {
+		Update();
+	}
+
+	return matWorlds[indices[_handle]];
+}
+
+void TransformSystem::Update()
+{
+	if (!isSorted) {
+		Sort();
+	}
+
+	updatedNum = 0;
+	if (dirtyMin > dirtyMax) { return; }
+
+	//ローカル値が変わったものは、連続する区間ごとにまとめて行列を作る
+	for (int i = dirtyMin; i <= dirtyMax;)
+	{
+		if (!(flags[i] & flag_local_dirty))
+		{
+			i++;
+			continue;
+		}
+
+		int end = i + 1;
+		while (end <= dirtyMax && (flags[end] & flag_local_dirty)) { end++; }
+		TransformKernel::ComposeEuler(&positions[i], &rotations[i], &scales[i], end - i, &matLocals[i]);
+		i = end;
+	}
+
+	//最初に変更のあった深さから順に、自身か親が変わったものだけワールド行列を求める
+	const int levelNum = static_cast<int>(levelStarts.size()) - 1;
+	int level = static_cast<int>(std::upper_bound(levelStarts.begin(), levelStarts.end(), dirtyMin) - levelStarts.begin()) - 1;
+	int clearEnd = dirtyMin;
+	for (; level < levelNum; level++)
+	{
+		const int start = (std::max)(levelStarts[level], dirtyMin);
+		const int end = levelStarts[level + 1];
+		bool isChanged = false;
+		for (int i = start; i < end; i++)
+		{
+			const int parent = parentIndices[i];
+			const bool isParentChanged = parent >= 0 && (flags[parent] & flag_world_changed);
+			if (!(flags[i] & flag_local_dirty) && !isParentChanged) { continue; }
+
+			if (parent >= 0) {
+				matWorlds[i] = (SimdMath::Mat4(matLocals[i]) * SimdMath::Mat4(matWorlds[parent])).ToMatrix4();
+			}
+			else {
+				matWorlds[i] = matLocals[i];
+			}
+			flags[i] = flag_world_changed;
+			isChanged = true;
+			updatedNum++;
+		}
+		clearEnd = end;
+
+		//この深さで何も変わらず、これより後に変更もなければ、より深い階層も変わらない
+		if (!isChanged && end > dirtyMax) { break; }
+	}
+
+	std::fill(flags.begin() + dirtyMin, flags.begin() + clearEnd, static_cast<unsigned char>(0));
+	dirtyMin = INT_MAX;
+	dirtyMax = -1;
+}
+
+void TransformSystem::MarkDirty(int _index)
+{
+	flags[_index] |= flag_local_dirty;
+	dirtyMin = (std::min)(dirtyMin, _index);
+	dirtyMax = (std::max)(dirtyMax, _index);
+}
+
+void TransformSystem::Sort()
+{
+	const int num = static_cast<int>(handles.size());
+
+	//深さを求める（親を辿り、分かっている深さから足していく）
+	std::vector<int> depths(num, -1);
+	std::vector<int> chain;
+	int maxDepth = 0;
+	for (int i = 0; i < num; i++)
+	{
+		int index = i;
+		while (depths[index] < 0 && parentHandles[index] != invalid_handle)
+		{
+			chain.push_back(index);
+			index = indices[parentHandles[index]];
+		}
+		if (depths[index] < 0) { depths[index] = 0; }
+
+		int depth = depths[index];
+		while (!chain.empty())
+		{
+			depths[chain.back()] = ++depth;
+			chain.pop_back();
+		}
+		maxDepth = (std::max)(maxDepth, depths[i]);
+	}
+
+	//深さごとの個数から先頭位置を求め、同じ深さの中は元の順番のまま並べる
+	levelStarts.assign(maxDepth + 2, 0);
+	for (int i = 0; i < num; i++)
+	{
+		levelStarts[depths[i] + 1]++;
+	}
+	for (int level = 0; level <= maxDepth; level++)
+	{
+		levelStarts[level + 1] += levelStarts[level];
+	}
+	std::vector<int> order(num);
+	std::vector<int> cursors(levelStarts.begin(), levelStarts.end() - 1);
+	for (int i = 0; i < num; i++)
+	{
+		order[cursors[depths[i]]++] = i;
+	}
+
+	Permute(&positions, order);
+	Permute(&rotations, order);
+	Permute(&scales, order);
+	Permute(&matLocals, order);
+	Permute(&matWorlds, order);
+	Permute(&parentHandles, order);
+	Permute(&handles, order);
+	Permute(&flags, order);
+
+	//ハンドルと親の番号を付け直し、変更の範囲を求め直す
+	dirtyMin = INT_MAX;
+	dirtyMax = -1;
+	for (int i = 0; i < num; i++)
+	{
+		indices[handles[i]] = i;
+	}
+	parentIndices.resize(num);
+	for (int i = 0; i < num; i++)
+	{
+		parentIndices[i] = parentHandles[i] == invalid_handle ? -1 : indices[parentHandles[i]];
+		if (flags[i] & flag_local_dirty)
+		{
+			dirtyMin = (std::min)(dirtyMin, i);
+			dirtyMax = (std::max)(dirtyMax, i);
+		}
+	}
+
+	isSorted = true;
+}
@@ -0,0 +1,143 @@
+﻿#pragma once
+
+#include <DirectXMath.h>
+#include <vector>
+#include <climits>
+
+/// <summary>
+/// 親子関係のあるトランスフォームをまとめて管理する
+/// （深さ順に並べた連続配列にローカル・ワールド行列を持ち、変化した部分木だけを計算し直す）
+/// </summary>
+class TransformSystem
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+	using XMMATRIX = DirectX::XMMATRIX;
+
+public:// 静的メンバ関数
+	static TransformSystem* GetInstance();
+
+public:// 定数
+	// 無効なハンドル
+	static const int invalid_handle = -1;
+
+public:// メンバ関数
+
+	/// <summary>
+	/// トランスフォームの生成（座標0、回転0、スケール1）
+	/// </summary>
+	/// <param name="_parent">親のハンドル（親がなければinvalid_handle）</param>
+	/// <returns>ハンドル</returns>
+	int Create(int _parent = invalid_handle);
+
+	/// <summary>
+	/// トランスフォームの削除（子は現在のローカル値のまま親なしになる）
+	/// </summary>
+	/// <param name="_handle">ハンドル</param>
+	void Destroy(int _handle);
+
+	/// <summary>
+	/// 親のセット（ローカル値は親から見た値として扱う）
+	/// </summary>
+	/// <param name="_handle">ハンドル</param>
+	/// <param name="_parent">親のハンドル（親をなくす場合はinvalid_handle）</param>
+	void SetParent(int _handle, int _parent);
+
+	/// <summary>
+	/// 親の取得
+	/// </summary>
+	/// <param name="_handle">ハンドル</param>
+	/// <returns>親のハンドル</returns>
+	int GetParent(int _handle) const;
+
+	/// <summary>
+	/// ローカルの座標・回転・スケールのセット（値が変わらなければ何もしない）
+	/// </summary>
+	/// <param name="_handle">ハンドル</param>
+	/// <param name="_position">座標</param>
+	/// <param name="_rotation">X,Y,Z軸回りの回転角（度、Z→X→Yの順に回す）</param>
+	/// <param name="_scale">スケール</param>
+	void SetLocal(int _handle, const XMFLOAT3& _position, const XMFLOAT3& _rotation, const XMFLOAT3& _scale);
+
+	/// <summary>
+	/// ワールド行列の取得（通常はフレームのUpdate後に読むだけ。変更が残っていれば先にUpdateを行う）
+	/// </summary>
+	/// <param name="_handle">ハンドル</param>
+	/// <returns>ワールド行列</returns>
+	const XMMATRIX& GetMatWorld(int _handle);
+
+	/// <summary>
+	/// 変更のあったトランスフォームと、その子孫のワールド行列を計算し直す
+	/// （変更がなければ何もしないため、静的な物体はフレームごとの負荷にならない）
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// トランスフォームの数を取得
+	/// </summary>
+	/// <returns>トランスフォームの数</returns>
+	int GetTransformNum() const { return static_cast<int>(handles.size()); }
+
+	/// <summary>
+	/// 直前のUpdateでワールド行列を計算し直した数を取得
+	/// </summary>
+	/// <returns>計算し直した数</returns>
+	int GetUpdatedNum() const { return updatedNum; }
+
+private:
+
+	/// <summary>
+	/// 配列の番号に変更を記録する
+	/// </summary>
+	/// <param name="_index">配列の番号</param>
+	void MarkDirty(int _index);
+
+	/// <summary>
+	/// 親が子より前に来るように、深さ順に並べ直す
+	/// </summary>
+	void Sort();
+
+private:// フラグ
+	// ローカル値が変更された
+	static const unsigned char flag_local_dirty = 1 << 0;
+	// このUpdateでワールド行列が変わった
+	static const unsigned char flag_world_changed = 1 << 1;
+
+private:
+
+	//以下は配列の番号ごと（深さ順）
+	//ローカル座標
+	std::vector<XMFLOAT3> positions;
+	//ローカル回転角
+	std::vector<XMFLOAT3> rotations;
+	//ローカルスケール
+	std::vector<XMFLOAT3> scales;
+	//親から見た行列
+	std::vector<XMMATRIX> matLocals;
+	//ワールド行列
+	std::vector<XMMATRIX> matWorlds;
+	//親の配列の番号（親がなければ-1、並べ直すまでは無効）
+	std::vector<int> parentIndices;
+	//親のハンドル
+	std::vector<int> parentHandles;
+	//配列の番号からハンドル
+	std::vector<int> handles;
+	//変更フラグ
+	std::vector<unsigned char> flags;
+	//深さごとの先頭の配列の番号（最後に総数を入れる）
+	std::vector<int> levelStarts;
+
+	//ハンドルから配列の番号（未使用は-1）
+	std::vector<int> indices;
+	//未使用のハンドル
+	std::vector<int> freeHandles;
+
+	//変更のあった配列の番号の範囲
+	int dirtyMin = INT_MAX;
+	int dirtyMax = -1;
+	//深さ順に並んでいるか
+	bool isSorted = true;
+	//直前のUpdateで計算し直した数
+	int updatedNum = 0;
+};
@@ -1,6 +1,7 @@
 #include "Camera.h"
 #include "WindowApp.h"
 #include "GameHelper.h"
+#include <limits>
 
 using namespace DirectX;
 
@@ -14,6 +15,7 @@ Camera::Camera()
 		aspectRatio,
 		0.1f, 1200.0f//s/O,ŉ
 	);
+	frustum.Update(matView * matProjection);
 }
 
 std::unique_ptr<Camera> Camera::Create()
@@ -33,6 +35,9 @@ void Camera::Update()
 	XMFLOAT3 inoutEye = { ShakeDifference.x + eye.x,ShakeDifference.y + eye.y,ShakeDifference.z + eye.z };
 
 	matView = XMMatrixLookAtLH(XMLoadFloat3(&inoutEye), XMLoadFloat3(&target), XMLoadFloat3(&up));
+
+	// `ÕJOɎgXV
+	frustum.Update(matView * matProjection);
 }
 
 void Camera::StartCameraShake(int _strength)
@@ -58,4 +63,17 @@ void Camera::SetMatProjection(float _back)
 		aspectRatio,
 		0.1f, _back//s/O,ŉ
 	);
+	frustum.Update(matView * matProjection);
+}
+
+float Camera::GetPixelsPerUnit(const XMFLOAT3& _position)
+{
+	// r[Ԃł̉s
+	const float depth = XMVectorGetZ(XMVector3TransformCoord(XMLoadFloat3(&_position), matView));
+	if (depth <= 0.0f) {
+		return (std::numeric_limits<float>::max)();
+	}
+
+	// ˉes_221/tan(p/2)Ȃ̂ŁAʂ̍̔|Ɖs1ł1̃sNZɂȂ
+	return XMVectorGetY(matProjection.r[1]) * static_cast<float>(WindowApp::GetWindowHeight()) * 0.5f / depth;
 }
\ No newline at end of file
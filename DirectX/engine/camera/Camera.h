@@ -1,6 +1,7 @@
 #pragma once
 #include <d3dx12.h>
 #include <DirectXMath.h>
+#include "Frustum.h"
 
 /// <summary>
 /// J{@\
@@ -81,6 +82,19 @@ public: // 
 	/// <returns>xNg</returns>
 	inline const XMFLOAT3& GetUp() { return up; }
 
+	/// <summary>
+	/// ̎擾iUpdateESetMatProjection_̃r[s*ˉes񂩂狁߂́j
+	/// </summary>
+	/// <returns></returns>
+	inline const Frustum& GetFrustum() { return frustum; }
+
+	/// <summary>
+	/// [hW̓_̈ʒuŁA1ʏŉsNZɂȂ邩iڍדx̑IɎgj
+	/// </summary>
+	/// <param name="_position">[hW</param>
+	/// <returns>sNZi_Ȃőlj</returns>
+	float GetPixelsPerUnit(const XMFLOAT3& _position);
+
 	/// <summary>
 	/// _WZbg
 	/// </summary>
@@ -120,4 +134,6 @@ protected: // 
 	float aspectRatio = 1.0f;
 	//VFCNW
 	XMFLOAT3 ShakeDifference = {};
+	//
+	Frustum frustum;
 };
\ No newline at end of file
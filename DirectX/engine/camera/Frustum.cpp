@@ -0,0 +1,127 @@
+﻿#include "Frustum.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+void Frustum::Update(const XMMATRIX& _viewProjection)
+{
+	// 行ベクトルなのでクリップ座標は v*M、各平面は列の組み合わせになる
+	// （転置すれば列を行として扱える。DirectXの深度は0～wなので手前は第3列だけ）
+	const XMMATRIX columns = XMMatrixTranspose(_viewProjection);
+	const XMVECTOR rawPlanes[planeNum] = {
+		columns.r[3] + columns.r[0],
+		columns.r[3] - columns.r[0],
+		columns.r[3] + columns.r[1],
+		columns.r[3] - columns.r[1],
+		columns.r[2],
+		columns.r[3] - columns.r[2] };
+
+	for (int i = 0; i < planeNum; i++)
+	{
+		const float length = XMVector3Length(rawPlanes[i]).m128_f32[0];
+		const XMVECTOR plane = length > 0.0f ? rawPlanes[i] / length : rawPlanes[i];
+		XMStoreFloat4(&planes[i], plane);
+	}
+
+	// 余りの2枚は法線0・距離1にして、どのAABBも内側と判定させる
+	XMFLOAT4 padded[8];
+	for (int i = 0; i < 8; i++)
+	{
+		padded[i] = i < planeNum ? planes[i] : XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+	for (int group = 0; group < 2; group++)
+	{
+		const XMFLOAT4* p = &padded[group * 4];
+		planeX[group] = XMVectorSet(p[0].x, p[1].x, p[2].x, p[3].x);
+		planeY[group] = XMVectorSet(p[0].y, p[1].y, p[2].y, p[3].y);
+		planeZ[group] = XMVectorSet(p[0].z, p[1].z, p[2].z, p[3].z);
+		planeW[group] = XMVectorSet(p[0].w, p[1].w, p[2].w, p[3].w);
+		absPlaneX[group] = XMVectorAbs(planeX[group]);
+		absPlaneY[group] = XMVectorAbs(planeY[group]);
+		absPlaneZ[group] = XMVectorAbs(planeZ[group]);
+	}
+}
+
+bool Frustum::IsVisibleAABB(const XMFLOAT3& _center, const XMFLOAT3& _extent) const
+{
+	// 中心の符号付き距離に、半径を法線方向へ射影した長さを足したものが負なら完全に外側
+	const XMVECTOR zero = XMVectorZero();
+	for (int group = 0; group < 2; group++)
+	{
+		XMVECTOR distance = XMVectorMultiplyAdd(planeX[group], XMVectorReplicate(_center.x), planeW[group]);
+		distance = XMVectorMultiplyAdd(planeY[group], XMVectorReplicate(_center.y), distance);
+		distance = XMVectorMultiplyAdd(planeZ[group], XMVectorReplicate(_center.z), distance);
+		distance = XMVectorMultiplyAdd(absPlaneX[group], XMVectorReplicate(_extent.x), distance);
+		distance = XMVectorMultiplyAdd(absPlaneY[group], XMVectorReplicate(_extent.y), distance);
+		distance = XMVectorMultiplyAdd(absPlaneZ[group], XMVectorReplicate(_extent.z), distance);
+		if (!XMVector4GreaterOrEqual(distance, zero)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::IsVisibleAABB(const XMMATRIX& _matWorld, const XMFLOAT3& _localMin, const XMFLOAT3& _localMax) const
+{
+	// 中心は行列で変換し、半径は行列の各成分の絶対値で変換する（8頂点を変換したAABBと同じ大きさ）
+	const XMVECTOR localMin = XMLoadFloat3(&_localMin);
+	const XMVECTOR localMax = XMLoadFloat3(&_localMax);
+	const XMVECTOR localCenter = (localMin + localMax) * 0.5f;
+	const XMVECTOR localExtent = (localMax - localMin) * 0.5f;
+
+	const XMVECTOR worldCenter = XMVector3Transform(localCenter, _matWorld);
+	const XMVECTOR worldExtent =
+		XMVectorAbs(_matWorld.r[0]) * XMVectorSplatX(localExtent) +
+		XMVectorAbs(_matWorld.r[1]) * XMVectorSplatY(localExtent) +
+		XMVectorAbs(_matWorld.r[2]) * XMVectorSplatZ(localExtent);
+
+	XMFLOAT3 center, extent;
+	XMStoreFloat3(&center, worldCenter);
+	XMStoreFloat3(&extent, worldExtent);
+	return IsVisibleAABB(center, extent);
+}
+
+int Frustum::CullAABBs(const XMFLOAT3* _centers, const XMFLOAT3* _extents, int _num, bool* _isVisible) const
+{
+	int visibleNum = 0;
+	const XMVECTOR zero = XMVectorZero();
+	for (int start = 0; start < _num; start += 4)
+	{
+		// 4個のAABBを成分ごとに並べ替える（足りない分は最後の1個を繰り返す）
+		XMMATRIX centers, extents;
+		for (int i = 0; i < 4; i++)
+		{
+			const int index = (std::min)(start + i, _num - 1);
+			centers.r[i] = XMLoadFloat3(&_centers[index]);
+			extents.r[i] = XMLoadFloat3(&_extents[index]);
+		}
+		centers = XMMatrixTranspose(centers);
+		extents = XMMatrixTranspose(extents);
+
+		// 平面を1枚ずつ4個のAABBと比べ、全平面で内側に掛かっているものだけ残す
+		XMVECTOR isInside = XMVectorGreaterOrEqual(zero, zero);
+		for (int i = 0; i < planeNum; i++)
+		{
+			const XMFLOAT4& plane = planes[i];
+			XMVECTOR distance = XMVectorMultiplyAdd(centers.r[0], XMVectorReplicate(plane.x), XMVectorReplicate(plane.w));
+			distance = XMVectorMultiplyAdd(centers.r[1], XMVectorReplicate(plane.y), distance);
+			distance = XMVectorMultiplyAdd(centers.r[2], XMVectorReplicate(plane.z), distance);
+			distance = XMVectorMultiplyAdd(extents.r[0], XMVectorReplicate(std::fabs(plane.x)), distance);
+			distance = XMVectorMultiplyAdd(extents.r[1], XMVectorReplicate(std::fabs(plane.y)), distance);
+			distance = XMVectorMultiplyAdd(extents.r[2], XMVectorReplicate(std::fabs(plane.z)), distance);
+			isInside = XMVectorAndInt(isInside, XMVectorGreaterOrEqual(distance, zero));
+		}
+
+		XMUINT4 result;
+		XMStoreUInt4(&result, isInside);
+		const uint32_t lanes[4] = { result.x, result.y, result.z, result.w };
+		const int count = (std::min)(4, _num - start);
+		for (int i = 0; i < count; i++)
+		{
+			_isVisible[start + i] = lanes[i] != 0;
+			visibleNum += lanes[i] != 0 ? 1 : 0;
+		}
+	}
+	return visibleNum;
+}
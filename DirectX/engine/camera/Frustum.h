@@ -0,0 +1,75 @@
+﻿#pragma once
+
+#include <DirectXMath.h>
+
+/// <summary>
+/// 視錐台（ビュープロジェクション行列から6平面を取り出し、AABBが視界に入るか判定する）
+/// </summary>
+class Frustum
+{
+private: // エイリアス
+	// DirectX::を省略
+	using XMFLOAT3 = DirectX::XMFLOAT3;
+	using XMFLOAT4 = DirectX::XMFLOAT4;
+	using XMVECTOR = DirectX::XMVECTOR;
+	using XMMATRIX = DirectX::XMMATRIX;
+
+public:// 定数
+	// 平面の数（左・右・下・上・手前・奥）
+	static const int planeNum = 6;
+
+public: // メンバ関数
+
+	/// <summary>
+	/// ビュープロジェクション行列から平面を求める
+	/// </summary>
+	/// <param name="_viewProjection">ビュー行列*射影行列</param>
+	void Update(const XMMATRIX& _viewProjection);
+
+	/// <summary>
+	/// AABBが視錐台と重なるか（平面の外側に完全に出ていれば見えない）
+	/// </summary>
+	/// <param name="_center">ワールド座標でのAABB中心</param>
+	/// <param name="_extent">AABBの半径（各軸の半分の長さ）</param>
+	/// <returns>見えるか否か</returns>
+	bool IsVisibleAABB(const XMFLOAT3& _center, const XMFLOAT3& _extent) const;
+
+	/// <summary>
+	/// ローカル座標のAABBをワールド行列で変換し、視錐台と重なるか
+	/// </summary>
+	/// <param name="_matWorld">ワールド行列</param>
+	/// <param name="_localMin">ローカル座標でのAABB最小値</param>
+	/// <param name="_localMax">ローカル座標でのAABB最大値</param>
+	/// <returns>見えるか否か</returns>
+	bool IsVisibleAABB(const XMMATRIX& _matWorld, const XMFLOAT3& _localMin, const XMFLOAT3& _localMax) const;
+
+	/// <summary>
+	/// 複数のAABBをまとめて判定（4個ずつ並べて全平面と比べる）
+	/// </summary>
+	/// <param name="_centers">ワールド座標でのAABB中心</param>
+	/// <param name="_extents">AABBの半径</param>
+	/// <param name="_num">AABBの数</param>
+	/// <param name="_isVisible">見えるか否か（出力用、_num個）</param>
+	/// <returns>見えるAABBの数</returns>
+	int CullAABBs(const XMFLOAT3* _centers, const XMFLOAT3* _extents, int _num, bool* _isVisible) const;
+
+	/// <summary>
+	/// 平面を取得（xyzが内向きの単位法線、wが原点からの距離）
+	/// </summary>
+	/// <param name="_index">平面の番号</param>
+	/// <returns>平面</returns>
+	const XMFLOAT4& GetPlane(int _index) const { return planes[_index]; }
+
+private:
+	//平面（内側で正になる）
+	XMFLOAT4 planes[planeNum] = {};
+	//平面を4枚ずつ成分ごとに並べたもの（余りは常に内側になる平面で埋める）
+	XMVECTOR planeX[2];
+	XMVECTOR planeY[2];
+	XMVECTOR planeZ[2];
+	XMVECTOR planeW[2];
+	//法線の絶対値（AABBの半径を法線方向へ射影するのに使う）
+	XMVECTOR absPlaneX[2];
+	XMVECTOR absPlaneY[2];
+	XMVECTOR absPlaneZ[2];
+};